@@ -163,7 +163,8 @@ class HermesRuntimeImpl final : public HermesRuntime,
         weakHermesValues_(runtimeConfig.getGCConfig().getOccupancyTarget()),
         rt_(::hermes::vm::Runtime::create(runtimeConfig)),
         runtime_(*rt_),
-        vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()) {
+        vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
+        shareBytecode_(runtimeConfig.getShareBytecode()) {
 #ifdef HERMES_ENABLE_DEBUGGER
     compileFlags_.debug = true;
 #endif
@@ -1038,6 +1039,9 @@ class HermesRuntimeImpl final : public HermesRuntime,
   friend class debugger::Debugger;
   std::unique_ptr<debugger::Debugger> debugger_;
   ::hermes::vm::experiments::VMExperimentFlags vmExperimentFlags_{0};
+  /// Whether bytecode passed to prepareJavaScript() is shared with the other
+  /// runtimes in the process that load the same bytecode.
+  bool shareBytecode_{false};
 
   /// Compilation flags used by prepareJavaScript().
   ::hermes::hbc::CompileFlags compileFlags_{};
@@ -1409,7 +1413,7 @@ class HermesPreparedJavaScript final : public jsi::PreparedJavaScript {
 
  public:
   explicit HermesPreparedJavaScript(
-      std::unique_ptr<hbc::BCProvider> bcProvider,
+      std::shared_ptr<hbc::BCProvider> bcProvider,
       vm::RuntimeModuleFlags runtimeFlags,
       std::string sourceURL)
       : bcProvider_(std::move(bcProvider)),
@@ -1436,7 +1440,7 @@ HermesRuntimeImpl::prepareJavaScriptWithSourceMap(
     const std::shared_ptr<const jsi::Buffer> &jsiBuffer,
     const std::shared_ptr<const jsi::Buffer> &sourceMapBuf,
     std::string sourceURL) {
-  std::pair<std::unique_ptr<hbc::BCProvider>, std::string> bcErr{};
+  std::pair<std::shared_ptr<hbc::BCProvider>, std::string> bcErr{};
   auto buffer = std::make_unique<BufferAdapter>(jsiBuffer);
   vm::RuntimeModuleFlags runtimeFlags{};
   runtimeFlags.persistent = true;
@@ -1457,8 +1461,13 @@ HermesRuntimeImpl::prepareJavaScriptWithSourceMap(
     if (sourceMapBuf) {
       throw std::logic_error("Source map cannot be specified with bytecode");
     }
-    bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
-        std::move(buffer));
+    if (shareBytecode_) {
+      bcErr = hbc::BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+          std::move(buffer));
+    } else {
+      bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+          std::move(buffer));
+    }
   } else {
 #if defined(HERMESVM_LEAN)
     bcErr.second = "prepareJavaScript source compilation not supported";
@@ -1541,10 +1550,16 @@ jsi::Value HermesRuntimeImpl::evaluateJavaScript(
 #if JSI_VERSION >= 4
 bool HermesRuntimeImpl::drainMicrotasks(int maxMicrotasksHint) {
   if (runtime_.hasMicrotaskQueue()) {
-    checkStatus(runtime_.drainJobs());
+    // A negative hint means that the queue should be drained completely.
+    checkStatus(runtime_.drainJobs(
+        maxMicrotasksHint < 0 ? std::numeric_limits<size_t>::max()
+                              : static_cast<size_t>(maxMicrotasksHint)));
+  }
+  // The kept objects may only be cleared at the end of a microtask
+  // checkpoint, i.e. once the queue has been drained.
+  if (runtime_.hasPendingJobs()) {
+    return false;
   }
-  // \c drainJobs is currently an unbounded execution, hence no exceptions
-  // implies drained until TODO(T89426441): \c maxMicrotasksHint is supported
   runtime_.clearKeptObjects();
   return true;
 }
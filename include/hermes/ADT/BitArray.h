@@ -11,6 +11,7 @@
 #include "llvh/Support/MathExtras.h"
 
 #include <array>
+#include <atomic>
 #include <bitset>
 
 #pragma GCC diagnostic push
@@ -142,6 +143,21 @@ class BitArray {
       allBits_[wordIdx] &= ~mask;
   }
 
+  /// Set the bit at \p idx to 1 using an atomic read-modify-write of the word
+  /// containing it, so that concurrent calls on bits sharing a word do not
+  /// lose updates.
+  /// \return true if this call changed the bit from 0 to 1.
+  inline bool atomicTestAndSet(size_t idx) {
+    static_assert(
+        sizeof(std::atomic<uintptr_t>) == sizeof(uintptr_t),
+        "Atomic words must have the same layout as plain words");
+    assert(idx < N && "Index must be within the bitset");
+    const uintptr_t mask = 1ULL << (idx % kBitsPerWord);
+    auto *word = reinterpret_cast<std::atomic<uintptr_t> *>(
+        &allBits_[idx / kBitsPerWord]);
+    return !(word->fetch_or(mask, std::memory_order_relaxed) & mask);
+  }
+
   /// Set all bits to 0.
   inline void reset() {
     std::fill_n(allBits_.begin(), kNumWords, 0);
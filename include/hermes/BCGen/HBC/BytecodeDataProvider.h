@@ -21,6 +21,7 @@
 #include "llvh/ADT/ArrayRef.h"
 
 #include <atomic>
+#include <mutex>
 #include <thread>
 
 #pragma GCC diagnostic push
@@ -145,7 +146,8 @@ class BCProviderBase {
   /// Pointer to the global debug info. This will not be eagerly initialized
   /// when loading bytecode from a buffer. Instead it will be constructed
   /// when first needed. Most likely we should never need to use it.
-  const hbc::DebugInfo *debugInfo_{};
+  /// Atomic because a shared provider may be used from several threads.
+  std::atomic<const hbc::DebugInfo *> debugInfo_{nullptr};
 
   /// Error message when there is an error parsing the bytecode.
   /// We can use this to throw an exception to JSI.
@@ -229,10 +231,10 @@ class BCProviderBase {
 
   /// Get the global debug info, lazily create it.
   const hbc::DebugInfo *getDebugInfo() const {
-    if (!debugInfo_) {
+    if (!debugInfo_.load(std::memory_order_acquire)) {
       const_cast<BCProviderBase *>(this)->createDebugInfo();
     }
-    return debugInfo_;
+    return debugInfo_.load(std::memory_order_acquire);
   }
 
   /// Get any trailing data after the real bytecode (only possible for buffers).
@@ -353,6 +355,11 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   std::unique_ptr<volatile PageAccessTracker> tracker_;
 
+  /// Guards the state that is initialized after loading (the warmup thread,
+  /// the page access tracker and the debug info), since a shared provider
+  /// may be used by several runtimes on different threads.
+  std::mutex mutex_;
+
   /// End of the bytecode file.
   const uint8_t *end_;
 
@@ -384,6 +391,15 @@ class BCProviderFromBuffer final : public BCProviderBase {
     return {errstr.empty() ? std::move(ret) : nullptr, errstr};
   }
 
+  /// Like createBCProviderFromBuffer, but if a provider for bytecode with the
+  /// same file hash is still alive anywhere in the process, return it instead
+  /// and release \p buffer. This lets runtimes that load the same bundle share
+  /// its string tables, function headers and identifier hashes. The stored
+  /// hash is trusted, not verified. Bytecode followed by an epilogue is never
+  /// shared.
+  static std::pair<std::shared_ptr<BCProviderFromBuffer>, std::string>
+  createSharedBCProviderFromBuffer(std::unique_ptr<const Buffer> buffer);
+
   /// Checks whether the data is actually bytecode.
   static bool isBytecodeStream(llvh::ArrayRef<uint8_t> aref) {
     const auto *header =
@@ -504,7 +520,7 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   ~BCProviderFromBuffer() override {
     stopWarmup();
-    delete debugInfo_;
+    delete debugInfo_.load();
   }
 
   bool isFunctionLazy(uint32_t functionID) const override {
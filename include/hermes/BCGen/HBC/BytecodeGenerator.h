@@ -56,6 +56,14 @@ class AllocationTable {
     return nextId;
   }
 
+  /// \return the ID of \p val if it was allocated one.
+  llvh::Optional<unsigned> find(T val) const {
+    auto it = indexMap_.find(val);
+    if (it == indexMap_.end())
+      return llvh::None;
+    return it->second;
+  }
+
   const ArrayRef<T> getElements() const {
     return elements_;
   }
@@ -467,11 +475,12 @@ class BytecodeModuleGenerator {
   /// obtain the offset of the literal in the associated buffer. In case of
   /// an object literal, it is a pair of offsets (key and value). In case of
   /// array literal, only the first offset is used.
-  LiteralOffset serializedLiteralOffsetFor(const Instruction *inst) {
+  LiteralOffset serializedLiteralOffsetFor(const Instruction *inst) const {
+    auto it = literalOffsetMap_.find(inst);
     assert(
-        literalOffsetMap_.count(inst) &&
+        it != literalOffsetMap_.end() &&
         "instruction has no serialized literal");
-    return literalOffsetMap_[inst];
+    return it->second;
   }
 
   /// \return a BytecodeModule.
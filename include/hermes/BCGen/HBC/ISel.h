@@ -215,6 +215,17 @@ class HBCISel {
   /// Generate the bytecode stream for the function.
   void generate(SourceMapGenerator *outSourceMap);
 
+  /// The first half of generate(): select the instructions and resolve the
+  /// jumps. This only reads the state shared with other functions, unless
+  /// the function creates regular expressions, loads BigInts, is the global
+  /// scope or has out of reach environments, so it can run concurrently with
+  /// other functions.
+  void generateCode();
+
+  /// The second half of generate(): add the debug info, which goes to the
+  /// module-wide filename table, and complete the bytecode.
+  void finishGeneration(SourceMapGenerator *outSourceMap);
+
   /// Get the current debug cache, to allow pre-populating another HBCISel in
   /// the same module.
   HBCISelDebugCache getDebugCache() {
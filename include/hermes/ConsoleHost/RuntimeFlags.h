@@ -89,6 +89,34 @@ static opt<double> OccupancyTarget(
     cat(GCCategory),
     init(GCConfig::getDefaultOccupancyTarget()));
 
+static opt<unsigned> GCMarkingThreads(
+    "gc-marking-threads",
+    desc("Number of threads that mark the old generation in Hades. Values "
+         "above 1 enable parallel marking."),
+    cat(GCCategory),
+    init(GCConfig::getDefaultMarkingThreads()));
+
+static opt<unsigned> GCEvacuationThreads(
+    "gc-evacuation-threads",
+    desc("Number of threads that evacuate the young generation in Hades. "
+         "Values above 1 enable parallel evacuation."),
+    cat(GCCategory),
+    init(GCConfig::getDefaultEvacuationThreads()));
+
+static opt<MemorySize, false, MemorySizeParser> GCMinYoungGenSize(
+    "gc-min-young-gen-size",
+    desc("Smallest size the young generation shrinks to in Hades. 0 uses "
+         "the default.  Format: <unsigned>{K,M,G}{iB}"),
+    cat(GCCategory),
+    init(MemorySize{GCConfig::getDefaultMinYoungGenSize()}));
+
+static opt<MemorySize, false, MemorySizeParser> GCMaxYoungGenSize(
+    "gc-max-young-gen-size",
+    desc("Largest size the young generation grows to in Hades. 0 uses the "
+         "default.  Format: <unsigned>{K,M,G}{iB}"),
+    cat(GCCategory),
+    init(MemorySize{GCConfig::getDefaultMaxYoungGenSize()}));
+
 static opt<bool> SampleProfiling(
     "sample-profiling",
     init(false),
@@ -125,6 +153,19 @@ static opt<bool> MicrotaskQueue(
     init(RuntimeConfig::getDefaultMicrotaskQueue()),
     cat(RuntimeCategory));
 
+static opt<bool> EnableJIT(
+    "Xjit",
+    desc("Compile hot functions with the baseline JIT, where supported"),
+    init(RuntimeConfig::getDefaultEnableJIT()),
+    cat(RuntimeCategory));
+
+static opt<uint32_t> JITThreshold(
+    "Xjit-threshold",
+    desc("Number of calls after which a function is compiled by the JIT"),
+    init(RuntimeConfig::getDefaultJITThreshold()),
+    Hidden,
+    cat(RuntimeCategory));
+
 static llvh::cl::opt<bool> StopAfterInit(
     "stop-after-module-init",
     llvh::cl::desc("Exit once module loading is finished. Useful "
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// Scans, substring searches and ASCII case conversion of 8 and 16 bit
+/// character buffers, vectorized with SSE2 where available.
+/// SSE2 is part of the x86-64 baseline, so the vectorized loops are used there
+/// without runtime dispatch. Other targets use the scalar loops.
+//===----------------------------------------------------------------------===//
+
+#ifndef HERMES_SUPPORT_CHARACTERSCAN_H
+#define HERMES_SUPPORT_CHARACTERSCAN_H
+
+#include "llvh/ADT/ArrayRef.h"
+#include "llvh/Support/MathExtras.h"
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace hermes {
+
+/// The maximum number of characters findFirstOf searches for at once.
+constexpr unsigned kMaxScanChars = 4;
+
+namespace detail {
+
+#ifdef __SSE2__
+/// \return a vector with every lane set to \p c.
+inline __m128i splat(char c) {
+  return _mm_set1_epi8(c);
+}
+inline __m128i splat(char16_t c) {
+  return _mm_set1_epi16((short)c);
+}
+
+/// \return a vector whose lanes are all ones where the lanes of \p a and \p b
+/// are equal, and zero elsewhere.
+inline __m128i lanesEqual(__m128i a, __m128i b, char) {
+  return _mm_cmpeq_epi8(a, b);
+}
+inline __m128i lanesEqual(__m128i a, __m128i b, char16_t) {
+  return _mm_cmpeq_epi16(a, b);
+}
+
+/// \return a vector whose lanes are all ones where the lanes of \p a are at
+/// most those of \p b, compared as unsigned, and zero elsewhere.
+inline __m128i lanesAtMost(__m128i a, __m128i b, char) {
+  return _mm_cmpeq_epi8(_mm_subs_epu8(a, b), _mm_setzero_si128());
+}
+inline __m128i lanesAtMost(__m128i a, __m128i b, char16_t) {
+  return _mm_cmpeq_epi16(_mm_subs_epu16(a, b), _mm_setzero_si128());
+}
+
+/// \return a vector whose lanes are those of \p a minus those of \p b,
+/// wrapping around on underflow.
+inline __m128i lanesSub(__m128i a, __m128i b, char) {
+  return _mm_sub_epi8(a, b);
+}
+inline __m128i lanesSub(__m128i a, __m128i b, char16_t) {
+  return _mm_sub_epi16(a, b);
+}
+
+/// \return a movemask with one bit per lane of \p CharT, set where the lanes
+/// of \p v are all ones.
+template <typename CharT>
+inline unsigned laneMask(__m128i v) {
+  unsigned mask = (unsigned)_mm_movemask_epi8(v);
+  // Keep the bit of the low byte of each 16 bit lane.
+  return sizeof(CharT) == 1 ? mask : mask & 0x5555;
+}
+
+/// \return a vector whose lanes are all ones where the lanes of \p v are in
+/// the range [\p lo, \p lo + \p span], and zero elsewhere.
+template <typename CharT>
+inline __m128i lanesInRange(__m128i v, __m128i lo, __m128i span) {
+  return lanesAtMost(lanesSub(v, lo, CharT{}), span, CharT{});
+}
+
+/// \return a vector whose lanes are all ones where the lanes of \p haystack
+/// are equal to one of the first \p count lanes of \p needles.
+template <typename CharT>
+inline __m128i
+lanesEqualAny(__m128i haystack, const __m128i *needles, size_t count) {
+  __m128i eq = lanesEqual(haystack, needles[0], CharT{});
+  for (size_t i = 1; i < count; ++i)
+    eq = _mm_or_si128(eq, lanesEqual(haystack, needles[i], CharT{}));
+  return eq;
+}
+#endif
+
+/// \return true if \p c is one of \p chars.
+template <typename CharT>
+inline bool isAnyOf(CharT c, llvh::ArrayRef<CharT> chars) {
+  for (CharT x : chars) {
+    if (c == x)
+      return true;
+  }
+  return false;
+}
+
+} // namespace detail
+
+/// \return a pointer to the first character in [\p first, \p last) that is
+/// equal to one of \p chars, or \p last if there is none. \p chars must hold
+/// between 1 and kMaxScanChars characters.
+template <typename CharT>
+inline const CharT *findFirstOf(
+    const CharT *first,
+    const CharT *last,
+    llvh::ArrayRef<CharT> chars) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  assert(
+      !chars.empty() && chars.size() <= kMaxScanChars &&
+      "Invalid number of characters to scan for");
+  if (sizeof(CharT) == 1 && chars.size() == 1) {
+    // The C library has the fastest scan for a single byte.
+    const void *found = std::memchr(first, chars[0], last - first);
+    return found ? static_cast<const CharT *>(found) : last;
+  }
+
+#ifdef __SSE2__
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(last - first) >= kLanes) {
+    __m128i needles[kMaxScanChars];
+    for (size_t i = 0; i < chars.size(); ++i)
+      needles[i] = detail::splat(chars[i]);
+    for (; (size_t)(last - first) >= kLanes; first += kLanes) {
+      __m128i haystack =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      __m128i eq =
+          detail::lanesEqualAny<CharT>(haystack, needles, chars.size());
+      // The mask has one bit per byte, so sizeof(CharT) bits per character.
+      if (unsigned mask = (unsigned)_mm_movemask_epi8(eq))
+        return first + llvh::countTrailingZeros(mask) / sizeof(CharT);
+    }
+  }
+#endif
+
+  for (; first != last; ++first) {
+    if (detail::isAnyOf(*first, chars))
+      return first;
+  }
+  return last;
+}
+
+/// \return a pointer to the first character in [\p first, \p last) that is
+/// not equal to any of \p chars, or \p last if there is none. \p chars must
+/// hold between 1 and kMaxScanChars characters.
+template <typename CharT>
+inline const CharT *findFirstNotOf(
+    const CharT *first,
+    const CharT *last,
+    llvh::ArrayRef<CharT> chars) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  assert(
+      !chars.empty() && chars.size() <= kMaxScanChars &&
+      "Invalid number of characters to scan for");
+
+#ifdef __SSE2__
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(last - first) >= kLanes) {
+    __m128i needles[kMaxScanChars];
+    for (size_t i = 0; i < chars.size(); ++i)
+      needles[i] = detail::splat(chars[i]);
+    for (; (size_t)(last - first) >= kLanes; first += kLanes) {
+      __m128i haystack =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      __m128i eq =
+          detail::lanesEqualAny<CharT>(haystack, needles, chars.size());
+      if (unsigned mask = ~(unsigned)_mm_movemask_epi8(eq) & 0xffff)
+        return first + llvh::countTrailingZeros(mask) / sizeof(CharT);
+    }
+  }
+#endif
+
+  for (; first != last; ++first) {
+    if (!detail::isAnyOf(*first, chars))
+      return first;
+  }
+  return last;
+}
+
+/// \return a pointer to the first character in [\p first, \p last) that is
+/// equal to one of \p chars or, compared as unsigned, less than \p bound, or
+/// \p last if there is none. \p chars must hold between 1 and kMaxScanChars
+/// characters, and \p bound must not be 0.
+template <typename CharT>
+inline const CharT *findFirstOfOrBelow(
+    const CharT *first,
+    const CharT *last,
+    llvh::ArrayRef<CharT> chars,
+    CharT bound) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  assert(
+      !chars.empty() && chars.size() <= kMaxScanChars &&
+      "Invalid number of characters to scan for");
+  assert(bound != 0 && "Nothing is below 0");
+  using UCharT = typename std::make_unsigned<CharT>::type;
+
+#ifdef __SSE2__
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(last - first) >= kLanes) {
+    __m128i needles[kMaxScanChars];
+    for (size_t i = 0; i < chars.size(); ++i)
+      needles[i] = detail::splat(chars[i]);
+    __m128i maxBelow = detail::splat(CharT(bound - 1));
+    for (; (size_t)(last - first) >= kLanes; first += kLanes) {
+      __m128i haystack =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      __m128i found = _mm_or_si128(
+          detail::lanesEqualAny<CharT>(haystack, needles, chars.size()),
+          detail::lanesAtMost(haystack, maxBelow, CharT{}));
+      if (unsigned mask = (unsigned)_mm_movemask_epi8(found))
+        return first + llvh::countTrailingZeros(mask) / sizeof(CharT);
+    }
+  }
+#endif
+
+  for (; first != last; ++first) {
+    if ((UCharT)*first < (UCharT)bound || detail::isAnyOf(*first, chars))
+      return first;
+  }
+  return last;
+}
+
+/// \return a pointer to the first character in [\p first, \p last) that is in
+/// the range [\p lo, \p hi], or \p last if there is none.
+template <typename CharT>
+inline const CharT *
+findFirstInRange(const CharT *first, const CharT *last, CharT lo, CharT hi) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  using UCharT = typename std::make_unsigned<CharT>::type;
+  assert((UCharT)lo <= (UCharT)hi && "Invalid character range");
+  UCharT span = (UCharT)hi - (UCharT)lo;
+
+#ifdef __SSE2__
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(last - first) >= kLanes) {
+    __m128i loV = detail::splat(lo);
+    __m128i spanV = detail::splat(CharT(span));
+    for (; (size_t)(last - first) >= kLanes; first += kLanes) {
+      __m128i haystack =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      __m128i in = detail::lanesInRange<CharT>(haystack, loV, spanV);
+      if (unsigned mask = (unsigned)_mm_movemask_epi8(in))
+        return first + llvh::countTrailingZeros(mask) / sizeof(CharT);
+    }
+  }
+#endif
+
+  for (; first != last; ++first) {
+    if ((UCharT)((UCharT)*first - (UCharT)lo) <= span)
+      return first;
+  }
+  return last;
+}
+
+/// \return a pointer to the start of the first occurrence of the \p needleLen
+/// characters at \p needle in [\p first, \p last), or \p last if there is
+/// none. An empty needle is found at \p first.
+template <typename CharT>
+inline const CharT *findSubstring(
+    const CharT *first,
+    const CharT *last,
+    const CharT *needle,
+    size_t needleLen) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  if (needleLen == 0)
+    return first;
+  if ((size_t)(last - first) < needleLen)
+    return last;
+  if (needleLen == 1)
+    return findFirstOf(first, last, llvh::ArrayRef<CharT>(needle, 1));
+  // One past the last position at which a match can start.
+  const CharT *startsEnd = last - needleLen + 1;
+
+#ifdef __SSE2__
+  // Compare the first and last characters of the needle against a block of
+  // candidate starts at once, and only compare the middle of the needle at the
+  // candidates where both match.
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(startsEnd - first) >= kLanes) {
+    __m128i head = detail::splat(needle[0]);
+    __m128i tail = detail::splat(needle[needleLen - 1]);
+    for (; (size_t)(startsEnd - first) >= kLanes; first += kLanes) {
+      __m128i heads =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      __m128i tails = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(first + needleLen - 1));
+      unsigned mask = detail::laneMask<CharT>(_mm_and_si128(
+          detail::lanesEqual(heads, head, CharT{}),
+          detail::lanesEqual(tails, tail, CharT{})));
+      for (; mask; mask &= mask - 1) {
+        const CharT *start =
+            first + llvh::countTrailingZeros(mask) / sizeof(CharT);
+        if (std::memcmp(
+                start + 1, needle + 1, (needleLen - 2) * sizeof(CharT)) == 0)
+          return start;
+      }
+    }
+  }
+#endif
+
+  while (first != startsEnd) {
+    first = findFirstOf(first, startsEnd, llvh::ArrayRef<CharT>(needle, 1));
+    if (first == startsEnd)
+      break;
+    if (std::memcmp(first + 1, needle + 1, (needleLen - 1) * sizeof(CharT)) ==
+        0)
+      return first;
+    ++first;
+  }
+  return last;
+}
+
+/// \return a pointer to the start of the last occurrence of the \p needleLen
+/// characters at \p needle in [\p first, \p last), or \p last if there is
+/// none. An empty needle is found at \p last.
+template <typename CharT>
+inline const CharT *findLastSubstring(
+    const CharT *first,
+    const CharT *last,
+    const CharT *needle,
+    size_t needleLen) {
+  static_assert(
+      sizeof(CharT) == 1 || sizeof(CharT) == 2, "Unsupported character type");
+  if (needleLen == 0 || (size_t)(last - first) < needleLen)
+    return last;
+  // One past the last position at which a match can start. Candidates are
+  // consumed from the end, so this moves down towards first.
+  const CharT *startsEnd = last - needleLen + 1;
+
+#ifdef __SSE2__
+  // Filter the candidates on the first and last characters of the needle, as
+  // in findSubstring, but take the blocks and the candidates in them from the
+  // end.
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(CharT);
+  if ((size_t)(startsEnd - first) >= kLanes) {
+    __m128i head = detail::splat(needle[0]);
+    __m128i tail = detail::splat(needle[needleLen - 1]);
+    // A needle of one character has no middle.
+    size_t middleBytes = needleLen > 2 ? (needleLen - 2) * sizeof(CharT) : 0;
+    for (; (size_t)(startsEnd - first) >= kLanes; startsEnd -= kLanes) {
+      const CharT *block = startsEnd - kLanes;
+      __m128i heads =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      __m128i tails = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(block + needleLen - 1));
+      unsigned mask = detail::laneMask<CharT>(_mm_and_si128(
+          detail::lanesEqual(heads, head, CharT{}),
+          detail::lanesEqual(tails, tail, CharT{})));
+      while (mask) {
+        unsigned bit = 31 - llvh::countLeadingZeros(mask);
+        const CharT *start = block + bit / sizeof(CharT);
+        if (std::memcmp(start + 1, needle + 1, middleBytes) == 0)
+          return start;
+        mask &= ~(1u << bit);
+      }
+    }
+  }
+#endif
+
+  while (startsEnd != first) {
+    const CharT *start = --startsEnd;
+    if (*start == needle[0] &&
+        std::memcmp(start + 1, needle + 1, (needleLen - 1) * sizeof(CharT)) ==
+            0)
+      return start;
+  }
+  return last;
+}
+
+/// Copy the \p len ASCII characters at \p src to \p dst, converting them to
+/// upper case if \p upperCase is set and to lower case otherwise.
+inline void
+convertASCIICase(const char *src, size_t len, char *dst, bool upperCase) {
+  // The letters to convert, which differ from the converted ones only in the
+  // 0x20 bit.
+  char lo = upperCase ? 'a' : 'A';
+  size_t i = 0;
+
+#ifdef __SSE2__
+  constexpr size_t kLanes = sizeof(__m128i);
+  __m128i loV = detail::splat(lo);
+  __m128i spanV = detail::splat(char('z' - 'a'));
+  __m128i caseBit = detail::splat(char(0x20));
+  for (; len - i >= kLanes; i += kLanes) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i letters = detail::lanesInRange<char>(chars, loV, spanV);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i),
+        _mm_xor_si128(chars, _mm_and_si128(letters, caseBit)));
+  }
+#endif
+
+  for (; i != len; ++i) {
+    char c = src[i];
+    dst[i] = (unsigned char)(c - lo) <= 'z' - 'a' ? c ^ 0x20 : c;
+  }
+}
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_CHARACTERSCAN_H
@@ -9,6 +9,7 @@
 #define HERMES_SUPPORT_MEMORYBUFFER_H
 
 #include "hermes/Public/Buffer.h"
+#include "hermes/Support/OSCompat.h"
 #include "llvh/Support/MemoryBuffer.h"
 
 namespace hermes {
@@ -35,6 +36,29 @@ class OwnedMemoryBuffer : public MemoryBuffer {
   std::unique_ptr<llvh::MemoryBuffer> data_;
 };
 
+// A read-only mapping of a whole file, used to run bytecode in place. Pages
+// are only read from the file when they are first touched.
+class MappedFileBuffer final : public Buffer {
+ public:
+  /// \return a buffer mapping the file at \p path, or nullptr if it could not
+  /// be mapped (e.g. it is empty or not a regular file).
+  static std::unique_ptr<MappedFileBuffer> create(const std::string &path) {
+    size_t size = 0;
+    auto mapping = oscompat::vm_map_file(path.c_str(), size);
+    if (!mapping)
+      return nullptr;
+    return std::unique_ptr<MappedFileBuffer>(
+        new MappedFileBuffer(static_cast<const uint8_t *>(*mapping), size));
+  }
+
+  ~MappedFileBuffer() override {
+    oscompat::vm_unmap_file(const_cast<uint8_t *>(data_), size_);
+  }
+
+ private:
+  MappedFileBuffer(const uint8_t *data, size_t size) : Buffer(data, size) {}
+};
+
 // An adapter that wraps a hermes::Buffer in a llvh::MemoryBuffer
 class HermesLLVMMemoryBuffer : public llvh::MemoryBuffer {
  public:
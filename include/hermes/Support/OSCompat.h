@@ -121,9 +121,10 @@ void vm_prefetch(void *p, size_t sz);
 /// for a process (e.g. by /proc/<pid>/maps).
 void vm_name(void *p, size_t sz, const char *name);
 
-/// None indicates no access; ReadWrite allows reading and writing.
+/// None indicates no access; ReadWrite allows reading and writing;
+/// ReadExecute allows reading and executing (used for JIT-compiled code).
 /// (We can add finer granularity, like read-only, if required.)
-enum class ProtectMode { ReadWrite, None };
+enum class ProtectMode { ReadWrite, ReadExecute, None };
 
 /// Set the \p sz byte region of memory starting at \p p to the specified
 /// \p mode. \p p must be page-aligned. \return true if successful,
@@ -136,6 +137,17 @@ enum class MAdvice { Random, Sequential };
 /// \return true on success, false on error.
 bool vm_madvise(void *p, size_t sz, MAdvice advice);
 
+/// Map the whole file at \p path read-only into memory, and store its size in
+/// \p sz. The mapping is private and backed by the file, so pages are only
+/// read in when they are first touched and can be dropped without being
+/// written back.
+/// \return the page-aligned start of the mapping, or an error if the file
+/// could not be mapped (including not supported).
+llvh::ErrorOr<void *> vm_map_file(const char *path, size_t &sz);
+
+/// Unmap a region of \p sz bytes returned by \p vm_map_file.
+void vm_unmap_file(void *p, size_t sz);
+
 /// Return the footprint of the memory-mapping starting at \p start (inclusive)
 /// and ending at \p end (exclusive). The notions of "footprint" and "mapping"
 /// are platform-specific, conforming to the following specification:
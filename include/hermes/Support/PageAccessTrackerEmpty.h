@@ -40,6 +40,8 @@ class PageAccessTracker {
     json.emitNullValue();
   }
 
+  void markStartupComplete() volatile {}
+
   bool printPageAccessedOrder(llvh::raw_ostream &OS, bool json) volatile {
     return false;
   }
@@ -13,6 +13,7 @@
 #include <memory>
 #include <vector>
 
+#include "llvh/ADT/Optional.h"
 #include "llvh/Support/raw_ostream.h"
 
 #include "hermes/Support/JSONEmitter.h"
@@ -39,6 +40,10 @@ class PageAccessTracker {
   std::unique_ptr<uint32_t[]> accessedMicros_{nullptr};
   /// Total number of pages accessed during executing bytecode.
   uint32_t accessedPageCount_{0};
+  /// Number of pages accessed when startup was marked complete, i.e. the
+  /// first startupPageCount_ entries of accessedPageIds_. Equal to
+  /// accessedPageCount_ until then.
+  llvh::Optional<uint32_t> startupPageCount_;
   /// Signal number that we are tracking.
   const int signal_;
   /// Signal handling framework data.
@@ -114,6 +119,10 @@ class PageAccessTracker {
   /// Public wrapper around the non-volatile version of this method.
   void getJSONStats(JSONEmitter &json) volatile;
 
+  /// Record that startup is complete: the pages accessed so far are reported
+  /// as the startup pages. Only the first call has an effect.
+  void markStartupComplete() volatile;
+
   /// Print only the page ids in the accessed order.
   /// \param json If true, print in json format, otherwise in a more readable
   /// format.
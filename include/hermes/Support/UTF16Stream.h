@@ -60,6 +60,23 @@ class UTF16Stream {
     return *this;
   }
 
+  /// Returns the UTF16 units from the current stream position that can be
+  /// consumed without converting more input. These may be scanned in bulk,
+  /// and stay valid until the stream is advanced past them.
+  /// \pre hasChar returns true.
+  llvh::ArrayRef<char16_t> available() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return {cur_, end_};
+  }
+
+  /// Advances the stream by \p n UTF16 units.
+  /// \pre n <= available().size().
+  UTF16Stream &operator+=(size_t n) {
+    assert(n <= (size_t)(end_ - cur_) && "advancing past available units");
+    cur_ += n;
+    return *this;
+  }
+
   /// Begin capturing the stream of values. Once the capture is completed with a
   /// call to endCapture(), the captured stream can be viewed via an ArrayRef.
   void beginCapture();
@@ -59,6 +59,10 @@ struct BytecodeGenerationOptions {
   /// Strip the source map URL.
   bool stripSourceMappingURL = false;
 
+  /// The number of threads selecting the instructions of functions. 1 does
+  /// all the work on the calling thread.
+  unsigned numThreads = 1;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
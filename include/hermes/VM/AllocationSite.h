@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_ALLOCATIONSITE_H
+#define HERMES_VM_ALLOCATIONSITE_H
+
+#include "hermes/VM/WeakRoot.h"
+
+namespace hermes {
+namespace vm {
+
+class JSObject;
+
+/// Feedback for an instruction allocating objects that get their properties
+/// afterwards: NewObject, object literals, and the `this` objects made by
+/// CreateThis. Objects from one site usually end up with the same properties,
+/// so when the site allocates an object, it looks at how many properties the
+/// previous one has reached. New objects get property storage for the largest
+/// count seen, instead of growing it as properties are added.
+struct AllocationSite {
+  /// The object most recently allocated at this site, to be sampled when the
+  /// next one is allocated. Since it is usually young, this weak root is
+  /// updated by every collection, not only those of the old generation.
+  WeakRoot<JSObject> lastObject{nullptr};
+
+  /// The largest number of properties seen in an object from this site.
+  uint32_t numProperties{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_ALLOCATIONSITE_H
@@ -56,7 +56,7 @@ ExecutionStatus createListFromArrayLike(
       // checks and the handle loads & stores. Directly call ArrayImpl::at,
       // and only call getComputed if the element is empty.
       PseudoHandle<> elem = createPseudoHandle(
-          elemArray->at(runtime, elemIdx).unboxToHV(runtime));
+          elemArray->at(runtime, elemIdx));
       if (LLVM_LIKELY(!elem->isEmpty())) {
         if (LLVM_UNLIKELY(
                 elementCB(runtime, elemIdx, std::move(elem)) ==
@@ -12,11 +12,14 @@
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Inst/Inst.h"
 #include "hermes/Support/SourceErrorManager.h"
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/IdentifierTable.h"
+#include "hermes/VM/JIT/Config.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/SerializedLiteralParser.h"
+#include "llvh/ADT/DenseMap.h"
 #include "llvh/ADT/DenseSet.h"
 #include "llvh/ADT/Optional.h"
 #include "llvh/Support/TrailingObjects.h"
@@ -34,6 +37,19 @@ namespace vm {
 class RuntimeModule;
 class CodeBlock;
 
+/// Signature of the native code produced by the JIT for a function. It runs
+/// the function in the register frame starting at \p frameRegs, beginning at
+/// \p ip, which is either the first instruction of the function or the
+/// instruction following a call. When it reaches an instruction that it must
+/// leave to the interpreter (calls, returns and throws), it stores the address
+/// of that instruction in the runtime's current IP and returns RETURNED. If an
+/// exception is raised, the current IP points to the faulting instruction and
+/// EXCEPTION is returned.
+using JITCompiledFunctionPtr = ExecutionStatus (*)(
+    Runtime &runtime,
+    PinnedHermesValue *frameRegs,
+    const inst::Inst *ip);
+
 /// A sequence of instructions representing the body of a function.
 class CodeBlock final
     : private llvh::TrailingObjects<CodeBlock, PropertyCacheEntry> {
@@ -58,6 +74,24 @@ class CodeBlock final
   /// cache.
   const uint32_t writePropCacheOffset_;
 
+  /// Allocation sites of the instructions in this function that allocate
+  /// objects, keyed by the offset of the instruction. An entry is added the
+  /// first time an instruction runs.
+  llvh::DenseMap<uint32_t, AllocationSite> allocationSites_;
+
+#ifdef HERMESVM_JIT
+  /// Native code for this function, or nullptr if it hasn't been compiled.
+  JITCompiledFunctionPtr JITCompiled_{nullptr};
+
+  /// Number of times this function has been entered while it was eligible for
+  /// compilation. Compared against the JIT threshold.
+  uint32_t jitHotness_{0};
+
+  /// Set when the JIT has given up on this function, so that it is not
+  /// attempted again.
+  bool dontJIT_{false};
+#endif
+
 #ifndef HERMESVM_LEAN
   /// Compiles a lazy CodeBlock. Intended to be called from lazyCompile.
   ExecutionStatus lazyCompileImpl(Runtime &runtime);
@@ -90,7 +124,7 @@ class CodeBlock final
         functionID_(functionID),
         propertyCacheSize_(cacheSize),
         writePropCacheOffset_(writePropCacheOffset) {
-    std::uninitialized_fill_n(propertyCache(), cacheSize, PropertyCacheEntry{});
+    std::uninitialized_fill_n(propertyCache(), cacheSize, PropertyCacheEntry());
   }
 
  public:
@@ -274,9 +308,49 @@ class CodeBlock final
     return &propertyCache()[writePropCacheOffset_ + idx];
   }
 
+#ifdef HERMESVM_JIT
+  /// \return the native code for this function, or nullptr if it has not been
+  /// compiled by the JIT.
+  JITCompiledFunctionPtr getJITCompiled() const {
+    return JITCompiled_;
+  }
+
+  void setJITCompiled(JITCompiledFunctionPtr fn) {
+    JITCompiled_ = fn;
+  }
+
+  /// Count one more entry into this function. \return the updated count.
+  uint32_t incJITHotness() {
+    return ++jitHotness_;
+  }
+
+  bool getDontJIT() const {
+    return dontJIT_;
+  }
+
+  void setDontJIT(bool dontJIT) {
+    dontJIT_ = dontJIT;
+  }
+#endif
+
   // Mark all hidden classes in the property cache as roots.
   void markCachedHiddenClasses(Runtime &runtime, WeakRootAcceptor &acceptor);
 
+  /// \return the allocation site of the instruction at \p offset.
+  AllocationSite &getAllocationSite(uint32_t offset) {
+    auto it = allocationSites_.find(offset);
+    if (LLVM_LIKELY(it != allocationSites_.end()))
+      return it->second;
+    return addAllocationSite(offset);
+  }
+
+  /// Add an allocation site for the instruction at \p offset, registering
+  /// this CodeBlock with its RuntimeModule if it is the first one.
+  AllocationSite &addAllocationSite(uint32_t offset);
+
+  /// Mark the objects referenced by the allocation sites as weak roots.
+  void markAllocationSites(WeakRootAcceptor &acceptor);
+
   static CodeBlock *createCodeBlock(
       RuntimeModule *runtimeModule,
       hbc::RuntimeFunctionHeader header,
@@ -286,7 +360,8 @@ class CodeBlock final
   /// \return an estimate of the size of additional memory used by this
   /// CodeBlock.
   size_t additionalMemorySize() const {
-    return propertyCacheSize_ * sizeof(PropertyCacheEntry);
+    return propertyCacheSize_ * sizeof(PropertyCacheEntry) +
+        allocationSites_.getMemorySize();
   }
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_DOUBLESTORAGE_H
+#define HERMES_VM_DOUBLESTORAGE_H
+
+#include "hermes/VM/Runtime.h"
+
+#include "llvh/Support/TrailingObjects.h"
+
+namespace hermes {
+namespace vm {
+
+/// A variable size array of raw doubles, used as the indexed storage of arrays
+/// that only ever held numbers. The GC never scans the elements, and storing
+/// a number that is not a small integer does not allocate a BoxedDouble.
+/// Missing elements ("holes") are represented by a NaN bit pattern that is
+/// never produced by storing a number, because every stored NaN is
+/// canonicalized.
+class DoubleStorage final
+    : public VariableSizeRuntimeCell,
+      private llvh::TrailingObjects<DoubleStorage, double> {
+  friend llvh::TrailingObjects<DoubleStorage, double>;
+  friend void DoubleStorageBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+
+ public:
+  using size_type = uint32_t;
+
+  static const VTable vt;
+
+  static constexpr CellKind getCellKind() {
+    return CellKind::DoubleStorageKind;
+  }
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::DoubleStorageKind;
+  }
+
+  static constexpr uint32_t allocationSize(size_type capacity) {
+    return totalSizeToAlloc<double>(capacity);
+  }
+
+  static constexpr size_type capacityForAllocationSize(uint32_t allocSize) {
+    return (allocSize - allocationSize(0)) / sizeof(double);
+  }
+
+  static constexpr size_type maxElements() {
+    return capacityForAllocationSize(GC::maxAllocationSize());
+  }
+
+  /// Create a new storage with capacity for \p capacity elements and \p size
+  /// holes.
+  static CallResult<PseudoHandle<DoubleStorage>>
+  create(Runtime &runtime, size_type capacity, size_type size = 0);
+
+  double *data() {
+    return getTrailingObjects<double>();
+  }
+  const double *data() const {
+    return getTrailingObjects<double>();
+  }
+
+  size_type capacity() const {
+    return capacityForAllocationSize(getAllocatedSize());
+  }
+  size_type size() const {
+    return size_;
+  }
+
+  /// \return true if the element at \p index is a hole.
+  bool isHole(size_type index) const {
+    assert(index < size() && "index out of range");
+    return llvh::DoubleToBits(data()[index]) == kHoleBits;
+  }
+
+  /// \return the element at \p index as a number, or empty for a hole.
+  HermesValue at(size_type index) const {
+    return isHole(index) ? HermesValue::encodeEmptyValue()
+                         : HermesValue::encodeDoubleValue(data()[index]);
+  }
+
+  /// Store the number \p num at \p index.
+  void set(size_type index, double num) {
+    assert(index < size() && "index out of range");
+    if (LLVM_UNLIKELY(std::isnan(num)))
+      num = std::numeric_limits<double>::quiet_NaN();
+    data()[index] = num;
+  }
+
+  /// Turn the element at \p index into a hole.
+  void setHole(size_type index) {
+    assert(index < size() && "index out of range");
+    data()[index] = hole();
+  }
+
+  /// Change the size to \p newSize, which must not exceed the capacity. New
+  /// elements are holes.
+  static void resizeWithinCapacity(DoubleStorage *self, size_type newSize);
+
+  /// Change the size to \p newSize, reallocating if needed. New elements are
+  /// holes.
+  static ExecutionStatus resize(
+      MutableHandle<DoubleStorage> &selfHandle,
+      Runtime &runtime,
+      size_type newSize) {
+    return shift(selfHandle, runtime, 0, 0, newSize);
+  }
+
+  /// The same as resize, but add holes to the left instead of the right.
+  static ExecutionStatus resizeLeft(
+      MutableHandle<DoubleStorage> &selfHandle,
+      Runtime &runtime,
+      size_type newSize) {
+    return shift(selfHandle, runtime, 0, newSize - selfHandle->size(), newSize);
+  }
+
+  DoubleStorage() = default;
+
+ private:
+  /// The NaN bit pattern marking a hole. std::isnan() is true for it, but it
+  /// differs from the canonical quiet NaN stored for real NaN values.
+  static constexpr uint64_t kHoleBits = 0x7ff4000000000000ull;
+
+  static double hole() {
+    return llvh::BitsToDouble(kHoleBits);
+  }
+
+  /// Same as ArrayStorage::shift(): resize the storage to \p toLast elements,
+  /// moving the elements starting at \p fromFirst to \p toFirst and filling
+  /// everything else with holes.
+  static ExecutionStatus shift(
+      MutableHandle<DoubleStorage> &selfHandle,
+      Runtime &runtime,
+      size_type fromFirst,
+      size_type toFirst,
+      size_type toLast);
+
+  /// Shrink the storage to its size during GC compaction.
+  static gcheapsize_t _trimSizeCallback(const GCCell *self);
+
+  /// Number of elements in use. The GC does not read it, because the
+  /// elements contain no pointers.
+  size_type size_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_DOUBLESTORAGE_H
@@ -40,6 +40,7 @@
 #include "llvh/ADT/DenseMap.h"
 #include "llvh/Support/ErrorHandling.h"
 
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
@@ -359,6 +360,14 @@ class GCBase {
 
     /// Bytes alive after a collection.
     StatsAccumulator<gcheapsize_t, uint64_t> usedAfter;
+
+    /// The number of buckets in pauseHistogram.
+    static constexpr size_t kNumPauseBuckets = 11;
+
+    /// The number of collections that paused the mutator, by pause length.
+    /// Bucket 0 counts pauses shorter than 1ms, bucket i counts pauses in
+    /// [2^(i-1), 2^i) ms, and the last bucket counts all longer pauses.
+    std::array<unsigned, kNumPauseBuckets> pauseHistogram{};
   };
 
   struct HeapInfo {
@@ -1342,6 +1351,12 @@ class GCBase {
       CumulativeHeapStats *stats,
       bool onMutator);
 
+  /// Print the pause histogram of \p stats as a dictionary from the range of
+  /// each bucket to its count.
+  static void printPauseHistogram(
+      JSONEmitter &json,
+      const CumulativeHeapStats &stats);
+
   /// Print detailed stats of the breakdown of the roots and heap in terms of
   /// the number of pointers, symbols, HermesValues, etc.
   void sizeDiagnosticCensus(size_t allocatedBytes);
@@ -14,9 +14,11 @@
 #include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/VTable.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #pragma GCC diagnostic push
 
 #ifdef HERMES_COMPILER_SUPPORTS_WSHORTEN_64_TO_32
@@ -217,6 +219,39 @@ class GCCell {
     return isMarked();
   }
 
+  /// The next two functions implement marked forwarding pointers that several
+  /// GC threads may race to install.
+
+  /// Atomically read the header of this cell.
+  /// \return the forwarding pointer if one has been set, or null after
+  ///   writing the KindAndSize of the cell to \p kindAndSize.
+  /// NOTE: this should only be used by the GC.
+  CompressedPointer getMarkedForwardingPointerAtomic(
+      KindAndSize &kindAndSize) const {
+    const RawType raw = headerAtomic().load(std::memory_order_acquire);
+    if (raw & 0x1)
+      return CompressedPointer::fromRaw(raw - 0x1);
+    std::memcpy(&kindAndSize, &raw, sizeof(kindAndSize));
+    return CompressedPointer(nullptr);
+  }
+
+  /// Atomically set a marked forwarding pointer to \p cell, if the header of
+  /// this cell is still \p expected.
+  /// \return null if the pointer was set. Otherwise, another thread forwarded
+  ///   this cell first, and its forwarding pointer is returned.
+  /// NOTE: this should only be used by the GC.
+  CompressedPointer trySetMarkedForwardingPointer(
+      KindAndSize expected,
+      CompressedPointer cell) {
+    RawType raw;
+    std::memcpy(&raw, &expected, sizeof(raw));
+    if (headerAtomic().compare_exchange_strong(
+            raw, cell.getRaw() | 0x1, std::memory_order_acq_rel))
+      return CompressedPointer(nullptr);
+    assert((raw & 0x1) && "Header changed without being forwarded");
+    return CompressedPointer::fromRaw(raw - 0x1);
+  }
+
   const GCCell *nextCell() const {
     return reinterpret_cast<const GCCell *>(
         reinterpret_cast<const char *>(this) + getAllocatedSize());
@@ -279,6 +314,20 @@ class GCCell {
   static constexpr uint32_t maxSize() {
     return KindAndSize::maxSize();
   }
+
+ private:
+  using RawType = CompressedPointer::RawType;
+  static_assert(
+      sizeof(KindAndSize) == sizeof(RawType) &&
+          sizeof(std::atomic<RawType>) == sizeof(RawType),
+      "The header must be accessible as an atomic RawType");
+
+  /// \return the header of this cell, as an atomic.
+  std::atomic<RawType> &headerAtomic() const {
+    void *header =
+        const_cast<AssignableCompressedPointer *>(&forwardingPointer_);
+    return *static_cast<std::atomic<RawType> *>(header);
+  }
 };
 
 /// A VariableSizeRuntimeCell is a GCCell with a variable size only known
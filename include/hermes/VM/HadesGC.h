@@ -343,6 +343,8 @@ class HadesGC final : public GCBase {
   class MarkWeakRootsAcceptor;
   class OldGen;
   class Executor;
+  class WorkerPool;
+  class WorkStealingStacks;
 
   struct CopyListCell final : public GCCell {
     // Linked list of cells pointing to the next cell that was copied.
@@ -404,6 +406,23 @@ class HadesGC final : public GCBase {
     /// \post This function either successfully allocates, or reports OOM.
     GCCell *alloc(uint32_t sz);
 
+    /// Allocate a block for one thread of a parallel YG collection to promote
+    /// cells into. The block is \p maxSize bytes if there is a free block that
+    /// large, and otherwise \p minSize bytes. It is marked and accounted for
+    /// as a single allocation.
+    /// Unlike alloc, this is called on helper threads while the thread that
+    /// started the collection holds gcMutex_, so the caller must make sure
+    /// that no two threads call it, or freePromotionBuffer, at the same time.
+    /// \param[out] size The size of the block.
+    /// \post This function either successfully allocates, or reports OOM.
+    GCCell *
+    allocPromotionBuffer(uint32_t minSize, uint32_t maxSize, uint32_t &size);
+
+    /// Return \p sz unused bytes at \p addr, the end of a block from
+    /// allocPromotionBuffer, to the free list. Has the same threading
+    /// requirements as allocPromotionBuffer.
+    void freePromotionBuffer(char *addr, uint32_t sz);
+
     /// \return the total number of bytes that are in use by the OG section of
     /// the JS heap, including any bytes allocated in a pending compactee, and
     /// excluding free list entries.
@@ -633,6 +652,10 @@ class HadesGC final : public GCBase {
 #endif
     } sweepIterator_;
 
+    /// The implementation of alloc, which does not check that gcMutex_ is
+    /// held.
+    GCCell *allocImpl(uint32_t sz);
+
     /// Searches the OG for a space to allocate memory into.
     /// \return A pointer to uninitialized memory that can be written into, null
     ///   if no such space exists.
@@ -680,6 +703,12 @@ class HadesGC final : public GCBase {
   static constexpr double kYGInitialSizeFactor = 0.5;
   double ygSizeFactor_{kYGInitialSizeFactor};
 
+  /// Bounds on ygSizeFactor_, derived from the min and max YG sizes in the
+  /// GCConfig. The upper bound also caps how much of the YG segment is ever
+  /// touched, and therefore its contribution to RSS.
+  const double ygMinSizeFactor_;
+  const double ygMaxSizeFactor_;
+
   /// oldGen_ is a free list space, so it needs a different segment
   /// representation.
   /// Protected by gcMutex_.
@@ -724,6 +753,15 @@ class HadesGC final : public GCBase {
   /// concurrently with the mutator.
   std::unique_ptr<Executor> backgroundExecutor_;
 
+  /// The number of threads that mark the OG, and that evacuate the YG.
+  const unsigned markingThreads_;
+  const unsigned evacuationThreads_;
+
+  /// Extra threads that help mark the OG and evacuate the YG, when more than
+  /// one thread is configured for either. Only used by the holder of
+  /// gcMutex_. Null if both are serial.
+  std::unique_ptr<WorkerPool> workerPool_;
+
   /// This tracks the current status of execution in the background thread. The
   /// future should be set every time work is enqueued onto the executor. After
   /// that, whenever we need to wait for execution in the background thread to
@@ -769,6 +807,10 @@ class HadesGC final : public GCBase {
   /// each YG collection.
   ExponentialMovingAverage ygAverageSurvivalBytes_;
 
+  /// The weighted average of the fraction of the YG that survives each YG
+  /// collection. Drives the size of the YG along with pause times.
+  ExponentialMovingAverage ygAverageSurvivalRatio_;
+
   /// The amount of bytes of external memory credited to objects in the YG.
   /// Only accessible to the mutator.
   uint64_t ygExternalBytes_{0};
@@ -882,8 +924,20 @@ class HadesGC final : public GCBase {
   ///   allocations.
   void youngGenCollection(std::string cause, bool forceOldGenCollection);
 
-  template <typename Acceptor>
-  void youngGenEvacuateImpl(Acceptor &acceptor, bool doCompaction);
+  template <bool CompactionEnabled>
+  void youngGenEvacuateImpl(
+      EvacAcceptor<CompactionEnabled> &acceptor,
+      bool doCompaction);
+
+  /// Evacuate the YG using evacuationThreads_ threads of workerPool_. Each
+  /// thread promotes cells into its own buffer in the OG, and threads that
+  /// run out of cells to scan steal from the others.
+  /// \param acceptor The acceptor used by the calling thread, which also
+  ///   receives the evacuated byte counts of the other threads.
+  template <bool CompactionEnabled>
+  void youngGenEvacuateInParallel(
+      EvacAcceptor<CompactionEnabled> &acceptor,
+      bool doCompaction);
 
   /// In the "no GC before TTI" mode, move the Young Gen heap segment to the
   /// Old Gen without scanning for garbage.
@@ -903,8 +957,11 @@ class HadesGC final : public GCBase {
   /// collection.
   void transferExternalMemoryToOldGen();
 
-  /// Update the scaling factor for the size of the young gen to meet our pause
-  /// time goals, based on the duration of the most recently completed YG.
+  /// Update the scaling factor for the size of the young gen based on the
+  /// duration of the most recently completed YG and the average survival
+  /// ratio. The YG grows while little of it survives, since a larger YG then
+  /// means fewer collections for the same amount of copying, and shrinks when
+  /// most of it survives or when collections exceed our pause time goals.
   void updateYoungGenSizeFactor();
 
   /// Perform an OG garbage collection. All live objects in OG will be left
@@ -968,9 +1025,9 @@ class HadesGC final : public GCBase {
 
   /// Search a single segment for pointers that may need to be updated as the
   /// YG/compactee are evacuated.
-  template <bool CompactionEnabled>
+  template <bool CompactionEnabled, typename Acceptor>
   void scanDirtyCardsForSegment(
-      SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
+      SlotVisitor<Acceptor> &visitor,
       HeapSegment &segment);
 
   /// Find all pointers from OG into the YG/compactee during a YG collection.
@@ -979,6 +1036,15 @@ class HadesGC final : public GCBase {
   template <bool CompactionEnabled>
   void scanDirtyCards(EvacAcceptor<CompactionEnabled> &acceptor);
 
+  /// Like scanDirtyCards, but split across the threads of workerPool_ by
+  /// segment. Instead of being evacuated right away, the pointers found are
+  /// recorded in the acceptor of the thread that found them, to be evacuated
+  /// later by that thread.
+  /// \param acceptors One acceptor per thread, indexed by worker index.
+  template <bool CompactionEnabled>
+  void scanDirtyCardsInParallel(
+      llvh::ArrayRef<EvacAcceptor<CompactionEnabled> *> acceptors);
+
   /// Common logic for doing the Snapshot At The Beginning (SATB) write barrier.
   void snapshotWriteBarrierInternal(GCCell *oldValue);
   void snapshotWriteBarrierInternal(CompressedPointer oldValue);
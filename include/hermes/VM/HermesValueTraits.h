@@ -36,10 +36,10 @@ HERMES_VM_GCOBJECT(Callable);
 HERMES_VM_GCOBJECT(DecoratedObject);
 HERMES_VM_GCOBJECT(DictPropertyMap);
 HERMES_VM_GCOBJECT(Domain);
+HERMES_VM_GCOBJECT(DoubleStorage);
 HERMES_VM_GCOBJECT(Environment);
 HERMES_VM_GCOBJECT(FinalizableNativeFunction);
 HERMES_VM_GCOBJECT(GeneratorInnerFunction);
-HERMES_VM_GCOBJECT(HashMapEntry);
 HERMES_VM_GCOBJECT(HiddenClass);
 HERMES_VM_GCOBJECT(HostObject);
 HERMES_VM_GCOBJECT(JSArray);
@@ -67,10 +67,12 @@ HERMES_VM_GCOBJECT(JSSymbol);
 HERMES_VM_GCOBJECT(JSTypedArrayBase);
 HERMES_VM_GCOBJECT(JSWeakMapImplBase);
 HERMES_VM_GCOBJECT(JSWeakRef);
+HERMES_VM_GCOBJECT(JSPromise);
 HERMES_VM_GCOBJECT(NativeConstructor);
 HERMES_VM_GCOBJECT(NativeFunction);
 HERMES_VM_GCOBJECT(NativeState);
 HERMES_VM_GCOBJECT(OrderedHashMap);
+HERMES_VM_GCOBJECT(OrderedHashTable);
 HERMES_VM_GCOBJECT(PropertyAccessor);
 HERMES_VM_GCOBJECT(RequireContext);
 HERMES_VM_GCOBJECT(StringPrimitive);
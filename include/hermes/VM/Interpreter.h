@@ -136,13 +136,24 @@ class Interpreter {
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param keyBufferIndex the first element of the key buffer to read.
   /// \param valBufferIndex the first element of the val buffer to read.
+  /// \param site the allocation site of the instruction.
   /// \return ExecutionStatus::EXCEPTION if the property definitions throw.
   static CallResult<PseudoHandle<>> createObjectFromBuffer(
       Runtime &runtime,
       CodeBlock *curCodeBlock,
       unsigned numLiterals,
       unsigned keyBufferIndex,
-      unsigned valBufferIndex);
+      unsigned valBufferIndex,
+      AllocationSite &site);
+
+  /// Give \p obj, a new object allocated by the instruction \p ip, room for
+  /// the properties that objects from the instruction's allocation site have
+  /// reached, and record it as the site's latest object.
+  static void applyAllocationSite(
+      Runtime &runtime,
+      CodeBlock *curCodeBlock,
+      const inst::Inst *ip,
+      Handle<JSObject> obj);
 
   /// Populates an array with literal values from the array buffer.
   /// \param numLiterals the amount of literals to read from the buffer.
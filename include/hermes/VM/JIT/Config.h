@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_CONFIG_H
+#define HERMES_VM_JIT_CONFIG_H
+
+/// HERMESVM_JIT is defined when the baseline JIT is compiled in. It is only
+/// available on x86-64 Linux for now, and can be turned off entirely with the
+/// HERMESVM_ALLOW_JIT build option. Even when it is compiled in, the JIT must
+/// be enabled at runtime via RuntimeConfig::EnableJIT.
+#if defined(HERMESVM_ALLOW_JIT) && defined(__x86_64__) && defined(__linux__)
+#define HERMESVM_JIT 1
+#endif
+
+#endif // HERMES_VM_JIT_CONFIG_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_JIT_H
+#define HERMES_VM_JIT_JIT_H
+
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/Config.h"
+
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+#ifdef HERMESVM_JIT
+
+/// Owns the state of the baseline JIT for a single Runtime: the executable
+/// memory holding compiled functions and the policy deciding when a function
+/// is worth compiling.
+///
+/// The JIT is a template compiler: every bytecode instruction is translated in
+/// isolation into machine code operating directly on the interpreter's
+/// register frame. This allows execution to move between compiled code and the
+/// interpreter at any instruction boundary, which is how calls, returns and
+/// exception handling are implemented: compiled code hands those instructions
+/// back to the interpreter, and the interpreter re-enters compiled code after
+/// a call returns.
+class JITContext {
+ public:
+  /// \param enable whether compilation is enabled.
+  /// \param threshold number of times a function has to be entered before it
+  ///   is compiled.
+  JITContext(bool enable, uint32_t threshold);
+  ~JITContext();
+
+  JITContext(const JITContext &) = delete;
+  void operator=(const JITContext &) = delete;
+
+  /// Note that \p codeBlock is being entered, and compile it if it has become
+  /// hot enough.
+  /// \return the compiled code for \p codeBlock, or nullptr if it should keep
+  ///   running in the interpreter.
+  inline JITCompiledFunctionPtr compile(
+      Runtime &runtime,
+      CodeBlock *codeBlock) {
+    if (LLVM_LIKELY(codeBlock->getJITCompiled()))
+      return codeBlock->getJITCompiled();
+    if (LLVM_LIKELY(!enabled_) || codeBlock->getDontJIT())
+      return nullptr;
+    if (codeBlock->incJITHotness() <= threshold_)
+      return nullptr;
+    return compileImpl(runtime, codeBlock);
+  }
+
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  void setEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  /// \return the number of functions that have been compiled.
+  unsigned getNumCompiled() const {
+    return numCompiled_;
+  }
+
+  /// \return the number of functions the JIT declined to compile because they
+  /// contained unsupported instructions.
+  unsigned getNumRejected() const {
+    return numRejected_;
+  }
+
+ private:
+  /// Compile \p codeBlock, or mark it as not compilable.
+  JITCompiledFunctionPtr compileImpl(Runtime &runtime, CodeBlock *codeBlock);
+
+  /// Copy \p size bytes of machine code from \p code into executable memory.
+  /// \return the address of the copy, or nullptr if memory could not be
+  ///   allocated.
+  void *installCode(const uint8_t *code, size_t size);
+
+  /// A block of executable memory, filled from the start.
+  struct CodeRegion {
+    void *base;
+    size_t size;
+    size_t used;
+  };
+
+  /// Whether compilation is enabled.
+  bool enabled_;
+
+  /// Number of entries after which a function is compiled.
+  uint32_t threshold_;
+
+  unsigned numCompiled_{0};
+  unsigned numRejected_{0};
+
+  /// Executable memory allocated so far. Compiled code is never freed before
+  /// the context itself.
+  std::vector<CodeRegion> codeRegions_{};
+};
+
+#else // HERMESVM_JIT
+
+/// Placeholder used when the JIT is not compiled in. Nothing is ever compiled.
+class JITContext {
+ public:
+  JITContext(bool enable, uint32_t threshold) {}
+
+  JITCompiledFunctionPtr compile(Runtime &runtime, CodeBlock *codeBlock) {
+    return nullptr;
+  }
+
+  bool isEnabled() const {
+    return false;
+  }
+
+  void setEnabled(bool enabled) {}
+
+  unsigned getNumCompiled() const {
+    return 0;
+  }
+
+  unsigned getNumRejected() const {
+    return 0;
+  }
+};
+
+#endif // HERMESVM_JIT
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_JIT_H
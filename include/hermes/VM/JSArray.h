@@ -8,6 +8,7 @@
 #ifndef HERMES_VM_JSARRAY_H
 #define HERMES_VM_JSARRAY_H
 
+#include "hermes/VM/DoubleStorage.h"
 #include "hermes/VM/IterationKind.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/SegmentedArray.h"
@@ -16,6 +17,12 @@ namespace hermes {
 namespace vm {
 
 /// A common implementation of "Array-like" objects.
+///
+/// The indexed elements live either in a StorageType of SmallHermesValue
+/// ("generic" elements), or, for arrays created with double elements, in a
+/// DoubleStorage of raw doubles. An array with double elements switches to
+/// generic elements the first time a value that is not a number is stored in
+/// it, and never switches back.
 class ArrayImpl : public JSObject {
   using Super = JSObject;
   friend void ArrayImplBuildMeta(const GCCell *cell, Metadata::Builder &mb);
@@ -35,6 +42,31 @@ class ArrayImpl : public JSObject {
   /// into.
   using StorageType = SegmentedArraySmall;
 
+  /// \return true if the elements are stored as raw doubles in a
+  /// DoubleStorage.
+  bool hasDoubleElements() const {
+    return flags_.doubleElements;
+  }
+
+  /// Store the elements of this array as raw doubles until a value that is
+  /// not a number is stored. The array must not have any indexed storage yet.
+  void initDoubleElements() {
+    assert(
+        !indexedStorage_ && beginIndex_ == endIndex_ &&
+        "array must not have indexed storage yet");
+    flags_.doubleElements = 1;
+  }
+
+  /// Switch the array to generic elements, converting its existing elements.
+  /// Does nothing if the array already has generic elements.
+  static ExecutionStatus ensureGenericElements(
+      Handle<ArrayImpl> selfHandle,
+      Runtime &runtime) {
+    if (LLVM_LIKELY(!selfHandle->flags_.doubleElements))
+      return ExecutionStatus::RETURNED;
+    return convertToGenericElements(selfHandle, runtime);
+  }
+
   /// Resize the internal storage. The ".length" property is not affected. It
   /// does \b NOT check for read-only properties.
   static ExecutionStatus setStorageEndIndex(
@@ -63,6 +95,7 @@ class ArrayImpl : public JSObject {
   /// "empty" are assumed to exist for the purpose of this definition. This is
   /// only safe to do for arrays that were created by the caller, can be
   /// extended, are not sealed or frozen, and were never passed to user JS code.
+  /// The array must have generic elements.
   static void unsafeSetExistingElementAt(
       ArrayImpl *self,
       Runtime &runtime,
@@ -75,6 +108,7 @@ class ArrayImpl : public JSObject {
     assert(
         index >= self->beginIndex_ && index < self->endIndex_ &&
         "array index out of range");
+    assert(!self->flags_.doubleElements && "array has double elements");
     self->getIndexedStorage(runtime)->set(
         runtime, index - self->beginIndex_, value);
   }
@@ -101,29 +135,39 @@ class ArrayImpl : public JSObject {
 
   /// Return the value at index \p index, or \c empty if the index is not
   /// contained in the storage.
-  const SmallHermesValue at(Runtime &runtime, size_type index) const {
+  HermesValue at(Runtime &runtime, size_type index) const {
     return index >= beginIndex_ && index < endIndex_
-        ? getIndexedStorage(runtime)->at(runtime, index - beginIndex_)
-        : SmallHermesValue::encodeEmptyValue();
+        ? unsafeAt(runtime, index)
+        : HermesValue::encodeEmptyValue();
   }
 
   /// Return the value at index \p index.
   Handle<> handleAt(Runtime &runtime, size_type index) const {
-    return runtime.makeHandle(at(runtime, index).unboxToHV(runtime));
+    return runtime.makeHandle(at(runtime, index));
   }
 
-  /// Get a pointer to the indexed storage for this array. The returned value
-  /// may be null if there is no indexed storage.
+  /// Get a pointer to the generic indexed storage for this array, which must
+  /// not have double elements. The returned value may be null if there is no
+  /// indexed storage.
   StorageType *getIndexedStorage(PointerBase &base) const {
-    return indexedStorage_.get(base);
+    assert(!flags_.doubleElements && "array has double elements");
+    return vmcast_or_null<StorageType>(indexedStorage_.get(base));
   }
 
   /// Set the indexed storage of this array to be \p p. The pointer is allowed
   /// to be null.
   void setIndexedStorage(PointerBase &base, StorageType *p, GC &gc) {
+    assert(!flags_.doubleElements && "array has double elements");
     indexedStorage_.set(base, p, gc);
   }
 
+  /// Get a pointer to the storage of an array with double elements. The
+  /// returned value may be null if there is no indexed storage.
+  DoubleStorage *getDoubleStorage(PointerBase &base) const {
+    assert(flags_.doubleElements && "array has generic elements");
+    return vmcast_or_null<DoubleStorage>(indexedStorage_.get(base));
+  }
+
   /// @}
 
  protected:
@@ -213,17 +257,57 @@ class ArrayImpl : public JSObject {
       ObjectVTable::CheckAllOwnIndexedMode mode);
 
   /// Return the value at index \p index, which must be valid.
-  const SmallHermesValue unsafeAt(Runtime &runtime, size_type index) const {
-    return getIndexedStorage(runtime)->at(runtime, index - beginIndex_);
+  HermesValue unsafeAt(Runtime &runtime, size_type index) const {
+    if (flags_.doubleElements)
+      return getDoubleStorage(runtime)->at(index - beginIndex_);
+    return getIndexedStorage(runtime)
+        ->at(runtime, index - beginIndex_)
+        .unboxToHV(runtime);
   }
 
  private:
+  /// The slow path of ensureGenericElements(): copy the doubles into a new
+  /// StorageType and clear the double elements flag.
+  static ExecutionStatus convertToGenericElements(
+      Handle<ArrayImpl> selfHandle,
+      Runtime &runtime);
+
+  /// The part of setStorageEndIndex() for an array with double elements,
+  /// where \p newLength fits in a DoubleStorage.
+  static ExecutionStatus setDoubleStorageEndIndex(
+      Handle<ArrayImpl> selfHandle,
+      Runtime &runtime,
+      uint32_t newLength);
+
+  /// \return true if the element at index \p index, which must be valid, is
+  /// empty.
+  bool unsafeIsHoleAt(Runtime &runtime, size_type index) const {
+    if (flags_.doubleElements)
+      return getDoubleStorage(runtime)->isHole(index - beginIndex_);
+    return getIndexedStorage(runtime)
+        ->at(runtime, index - beginIndex_)
+        .isEmpty();
+  }
+
+  /// Store \p value at \p index, which is outside the storage, of an array
+  /// with double elements, growing the storage as needed, or switch to
+  /// generic elements if \p value is not a number or the storage would get
+  /// too large.
+  /// \return true if the value was stored, false if the array now has generic
+  ///   elements and the caller must store the value itself.
+  static CallResult<bool> setDoubleElementAt(
+      Handle<ArrayImpl> selfHandle,
+      Runtime &runtime,
+      uint32_t index,
+      Handle<> value);
+
   /// The first index contained in the storage.
   uint32_t beginIndex_{0};
   /// One past the last index contained in the storage.
   uint32_t endIndex_{0};
-  /// The indexed storage for this array.
-  GCPointer<StorageType> indexedStorage_;
+  /// The indexed storage for this array: a StorageType, or a DoubleStorage if
+  /// flags_.doubleElements is set.
+  GCPointer<GCCell> indexedStorage_;
 };
 
 class Arguments final : public ArrayImpl {
@@ -342,6 +426,20 @@ class JSArray final : public ArrayImpl {
   static CallResult<Handle<JSArray>>
   create(Runtime &runtime, size_type capacity, size_type length);
 
+  /// Create an instance of Array, using the standard array prototype, with
+  /// actual size \p length and double elements. No storage is allocated
+  /// until the first element is stored, so arrays that turn out to hold other
+  /// values never allocate a DoubleStorage.
+  static CallResult<Handle<JSArray>> createWithDoubleElements(
+      Runtime &runtime,
+      size_type length) {
+    auto arrRes = create(runtime, 0, length);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    (*arrRes)->initDoubleElements();
+    return arrRes;
+  }
+
   /// A convenience method for setting the \c .length property of the array.
   /// It performs the necessary checks and updates the property. It could fail
   /// if the property is not writable or if there are read-only index-like
@@ -44,6 +44,10 @@ void createHermesBuiltins(
     Runtime &runtime,
     llvh::MutableArrayRef<Callable *> builtins);
 
+/// Create the native implementation of the spawnAsync builtin, which runs
+/// async functions on top of the native Promise.
+Callable *createAsyncFunctionSpawner(Runtime &runtime);
+
 std::shared_ptr<RuntimeCommonStorage> createRuntimeCommonStorage(
     bool shouldTrace);
 
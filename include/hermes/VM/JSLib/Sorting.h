@@ -38,9 +38,12 @@ class SortModel {
   virtual ~SortModel() = 0;
 };
 
-/// QuickSort to sort elements in the range [begin, end). Returns immediately
-/// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
+/// Stable TimSort of the elements in the range [begin, end), which takes
+/// advantage of runs that are already sorted. Returns immediately with
+/// ExecutionStatus::EXCEPTION if any compare or swap operations fail. The
+/// elements are only swapped once all comparisons are done, so they are left
+/// unchanged if a comparison fails.
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end);
 
 } // namespace vm
 } // namespace hermes
@@ -51,19 +51,19 @@ class JSMapImpl final : public JSObject {
     return ExecutionStatus::RETURNED;
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime &runtime, HashMapEntry *entry) {
-    return storage_.getNonNull(runtime)->iteratorNext(runtime, entry);
+  /// \return the table holding the entries, where an iteration starts.
+  OrderedHashTable *getTable(Runtime &runtime) {
+    return storage_.getNonNull(runtime)->getTable(runtime);
   }
 
   /// Add a value.
-  static void addValue(
+  static ExecutionStatus addValue(
       Handle<JSMapImpl> self,
       Runtime &runtime,
       Handle<> key,
       Handle<> value) {
     self->assertInitialized();
-    OrderedHashMap::insert(
+    return OrderedHashMap::insert(
         runtime.makeHandle<OrderedHashMap>(self->storage_),
         runtime,
         key,
@@ -99,9 +99,10 @@ class JSMapImpl final : public JSObject {
   }
 
   /// Clear all elements from the storage.
-  static void clear(Handle<JSMapImpl> self, Runtime &runtime) {
+  static ExecutionStatus clear(Handle<JSMapImpl> self, Runtime &runtime) {
     self->assertInitialized();
-    self->storage_.getNonNull(runtime)->clear(runtime);
+    return OrderedHashMap::clear(
+        runtime.makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -111,15 +112,16 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
+    MutableHandle<OrderedHashTable> table{runtime, self->getTable(runtime)};
     GCScopeMarkerRAII marker{runtime};
-    for (entry = self->storage_.getNonNull(runtime)->iteratorNext(runtime);
-         entry;
-         entry = self->storage_.getNonNull(runtime)->iteratorNext(
-             runtime, entry.get())) {
+    for (uint32_t index = 0;; ++index) {
       marker.flush();
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+      OrderedHashTable *t = *table;
+      if (!OrderedHashTable::advance(runtime, t, index))
+        break;
+      table = t;
+      HermesValue key = t->keyAt(runtime, index);
+      HermesValue value = t->valueAt(runtime, index);
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -213,18 +215,19 @@ class JSMapIteratorImpl final : public JSObject {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.getNonNull(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          runtime.getHeap());
-      if (self->itr_) {
+      OrderedHashTable *table = self->table_
+          ? self->table_.getNonNull(runtime)
+          : self->data_.getNonNull(runtime)->getTable(runtime);
+      uint32_t index = self->index_;
+      if (OrderedHashTable::advance(runtime, table, index)) {
+        self->table_.setNonNull(runtime, table, runtime.getHeap());
+        self->index_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.getNonNull(runtime)->key;
+            value = table->keyAt(runtime, index);
             break;
           case IterationKind::Value:
-            value = self->itr_.getNonNull(runtime)->value;
+            value = table->valueAt(runtime, index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
@@ -234,9 +237,9 @@ class JSMapIteratorImpl final : public JSObject {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = *arrRes;
-            value = self->itr_.getNonNull(runtime)->key;
+            value = self->table_.getNonNull(runtime)->keyAt(runtime, index);
             JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.getNonNull(runtime)->value;
+            value = self->table_.getNonNull(runtime)->valueAt(runtime, index);
             JSArray::setElementAt(arrHandle, runtime, 1, value);
             value = arrHandle.getHermesValue();
             break;
@@ -250,6 +253,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_.setNull(runtime.getHeap());
+        self->table_.setNull(runtime.getHeap());
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -272,8 +276,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The table of the Map that the iteration is in. nullptr until the first
+  /// entry is visited.
+  GCPointer<OrderedHashTable> table_{nullptr};
+
+  /// The index in table_ of the next entry to visit.
+  uint32_t index_{0};
 
   IterationKind iterationKind_;
 
@@ -8,6 +8,7 @@
 #ifndef HERMES_VM_JSOBJECT_H
 #define HERMES_VM_JSOBJECT_H
 
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/Handle.h"
 #include "hermes/VM/HermesValue-inline.h"
@@ -132,7 +133,16 @@ struct ObjectFlags {
   /// This flag indicates this is a proxy exotic Object
   uint32_t proxyObject : 1;
 
-  static constexpr unsigned kHashWidth = 24;
+  /// This object is part of a prototype chain recorded in a property cache.
+  /// Modifying its properties or its parent must invalidate such caches, see
+  /// Runtime::invalidateProtoChainCaches().
+  uint32_t cachedPrototype : 1;
+
+  /// This is an ArrayImpl whose indexed elements are raw doubles in a
+  /// DoubleStorage. Cleared, never set again, once a non-number is stored.
+  uint32_t doubleElements : 1;
+
+  static constexpr unsigned kHashWidth = 22;
   /// A non-zero object id value, assigned lazily. It is 0 before it is
   /// assigned. If an object started out as lazy, the objectID is the lazy
   /// object index used to identify when it gets initialized.
@@ -406,9 +416,12 @@ class JSObject : public GCCell {
   /// preallocated. If allocation fails, the GC declares an
   /// OOM.
   /// \param clazz the hidden class for the new object.
+  /// \param capacity number of properties to make room for, if more than
+  ///   \p clazz has.
   static PseudoHandle<JSObject> create(
       Runtime &runtime,
-      Handle<HiddenClass> clazz);
+      Handle<HiddenClass> clazz,
+      unsigned capacity = 0);
 
   /// Allocates a JSObject with the given hidden class and prototype.
   /// If allocation fails, the GC declares an OOM.
@@ -417,6 +430,25 @@ class JSObject : public GCCell {
       Handle<JSObject> parentHandle,
       Handle<HiddenClass> clazz);
 
+  /// Update \p site with the number of properties of the object it last
+  /// allocated. \return the number of properties that new objects from the
+  /// site should have room for.
+  static uint32_t sampleAllocationSite(Runtime &runtime, AllocationSite &site);
+
+  /// Make room for \p capacity properties in \p selfHandle, a new object with
+  /// no indirect property storage yet, so that adding them does not have to
+  /// grow the storage.
+  static void reservePropStorage(
+      Handle<JSObject> selfHandle,
+      Runtime &runtime,
+      PropStorage::size_type capacity) {
+    if (LLVM_LIKELY(capacity <= DIRECT_PROPERTY_SLOTS) ||
+        selfHandle->propStorage_)
+      return;
+    runtime.ignoreAllocationFailure(
+        allocatePropStorage(selfHandle, runtime, 0, capacity));
+  }
+
   ~JSObject() = default;
 
   /// Must be called immediately after the construction of any JSObject.
@@ -470,6 +502,16 @@ class JSObject : public GCCell {
     return clazz_;
   }
 
+  /// \return the `__proto__` internal property without decoding it. Unlike
+  /// getParent(), this may be used with proxy objects.
+  const GCPointer<JSObject> &getParentGCPtr() const {
+    return parent_;
+  }
+
+  /// Note that the properties or the parent of \p self are about to change,
+  /// invalidating cached prototype chains it is part of.
+  static void invalidateCachedPrototype(JSObject *self, Runtime &runtime);
+
   /// \return the object ID. Assign one if not yet exist. This ID can be used
   /// in Set or Map where hashing is required. We don't assign object an ID
   /// until we actually need it. An exception is lazily created objects where
@@ -1329,20 +1371,24 @@ class JSObject : public GCCell {
       Runtime &runtime,
       ObjectVTable::CheckAllOwnIndexedMode mode);
 
-  /// Allocate an instance of property storage with the specified size.
+  /// Allocate an instance of property storage with the specified size, and
+  /// room for at least \p capacity properties.
   static inline ExecutionStatus allocatePropStorage(
       Handle<JSObject> selfHandle,
       Runtime &runtime,
-      PropStorage::size_type size);
+      PropStorage::size_type size,
+      PropStorage::size_type capacity = 0);
 
-  /// Allocate an instance of property storage with the specified size.
+  /// Allocate an instance of property storage with the specified size, and
+  /// room for at least \p capacity properties.
   /// If an allocation is required, a handle is allocated internally and the
   /// updated self value is returned. This means that the return value MUST
   /// be used by the caller.
   static inline CallResult<PseudoHandle<JSObject>> allocatePropStorage(
       PseudoHandle<JSObject> self,
       Runtime &runtime,
-      PropStorage::size_type size);
+      PropStorage::size_type size,
+      PropStorage::size_type capacity = 0);
 
   /// @}
 
@@ -1470,6 +1516,16 @@ class JSObject : public GCCell {
       Handle<> value,
       PropOpFlags opFlags);
 
+  /// Record in \p cacheEntry that the property at \p slot of \p holder, an
+  /// object in the prototype chain of \p self, is what a lookup on \p self
+  /// finds. Does nothing if \p self cannot be used as a cache key.
+  static void cachePrototypeProperty(
+      JSObject *self,
+      Runtime &runtime,
+      JSObject *holder,
+      SlotIndex slot,
+      PropertyCacheEntry *cacheEntry);
+
  protected:
   /// Flags affecting the entire object.
   ObjectFlags flags_{};
@@ -1627,12 +1683,16 @@ bool JSObject::forEachOwnPropertyWhile(
 inline ExecutionStatus JSObject::allocatePropStorage(
     Handle<JSObject> selfHandle,
     Runtime &runtime,
-    PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+    PropStorage::size_type size,
+    PropStorage::size_type capacity) {
+  capacity = std::max(size, capacity);
+  if (LLVM_LIKELY(capacity <= DIRECT_PROPERTY_SLOTS))
     return ExecutionStatus::RETURNED;
 
   auto res = PropStorage::create(
-      runtime, size - DIRECT_PROPERTY_SLOTS, size - DIRECT_PROPERTY_SLOTS);
+      runtime,
+      capacity - DIRECT_PROPERTY_SLOTS,
+      size > DIRECT_PROPERTY_SLOTS ? size - DIRECT_PROPERTY_SLOTS : 0);
   if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
@@ -1644,13 +1704,14 @@ inline ExecutionStatus JSObject::allocatePropStorage(
 inline CallResult<PseudoHandle<JSObject>> JSObject::allocatePropStorage(
     PseudoHandle<JSObject> self,
     Runtime &runtime,
-    PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+    PropStorage::size_type size,
+    PropStorage::size_type capacity) {
+  if (LLVM_LIKELY(std::max(size, capacity) <= DIRECT_PROPERTY_SLOTS))
     return self;
 
   Handle<JSObject> selfHandle = runtime.makeHandle(std::move(self));
   if (LLVM_UNLIKELY(
-          allocatePropStorage(selfHandle, runtime, size) ==
+          allocatePropStorage(selfHandle, runtime, size, capacity) ==
           ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JSPROMISE_H
+#define HERMES_VM_JSPROMISE_H
+
+#include "hermes/VM/ArrayStorage.h"
+#include "hermes/VM/CallResult.h"
+#include "hermes/VM/CellKind.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+namespace hermes {
+namespace vm {
+
+/// A native ES2022 Promise (27.2). Only used when the runtime has a microtask
+/// queue, since its jobs are run by Runtime::drainJobs. Otherwise Promise is
+/// provided by the polyfill in the internal bytecode.
+///
+/// Reactions added by then() are stored as records of four values:
+/// [onFulfilled, onRejected, capabilityTarget, capabilityReject], where the
+/// capability describes what to settle with the result of the handler:
+/// - capabilityTarget is a JSPromise and capabilityReject is undefined: the
+///   promise is settled directly, without going through resolving functions.
+///   This is the case for promises created by then() with %Promise%.
+/// - capabilityTarget is undefined: there is nothing to settle, e.g. for the
+///   reactions that resume async functions.
+/// - Otherwise, capabilityTarget and capabilityReject are the resolve and
+///   reject functions of a PromiseCapability.
+class JSPromise final : public JSObject {
+  using Super = JSObject;
+
+ public:
+  /// [[PromiseState]].
+  enum class State : uint8_t { Pending, Fulfilled, Rejected };
+
+  /// Number of values in each reaction record.
+  static constexpr unsigned kReactionSize = 4;
+
+  static const ObjectVTable vt;
+
+  static constexpr CellKind getCellKind() {
+    return CellKind::JSPromiseKind;
+  }
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::JSPromiseKind;
+  }
+
+  /// Create a new pending promise with prototype \p parentHandle.
+  static PseudoHandle<JSPromise> create(
+      Runtime &runtime,
+      Handle<JSObject> parentHandle);
+
+  /// Create a new pending promise with %Promise.prototype% as its prototype.
+  static PseudoHandle<JSPromise> create(Runtime &runtime) {
+    return create(runtime, Handle<JSObject>::vmcast(&runtime.promisePrototype));
+  }
+
+  State getState() const {
+    return state_;
+  }
+
+  /// \return [[PromiseResult]], which is undefined while pending.
+  HermesValue getResult() const {
+    return result_;
+  }
+
+  /// ES2022 27.2.1.3 CreateResolvingFunctions. Fills in \p resolve and
+  /// \p reject with a fresh pair of functions sharing an alreadyResolved flag.
+  static void createResolvingFunctions(
+      Handle<JSPromise> self,
+      Runtime &runtime,
+      MutableHandle<Callable> &resolve,
+      MutableHandle<Callable> &reject);
+
+  /// The steps of a promise resolve function (27.2.1.3.2) from step 7 on,
+  /// i.e. after alreadyResolved has been checked and set. Resolves \p self
+  /// with \p resolution, which may adopt the state of a thenable.
+  static ExecutionStatus
+  resolve(Handle<JSPromise> self, Runtime &runtime, Handle<> resolution);
+
+  /// ES2022 27.2.1.4 FulfillPromise.
+  static ExecutionStatus
+  fulfill(Handle<JSPromise> self, Runtime &runtime, Handle<> value);
+
+  /// ES2022 27.2.1.7 RejectPromise.
+  static ExecutionStatus
+  reject(Handle<JSPromise> self, Runtime &runtime, Handle<> reason);
+
+  /// ES2022 27.2.5.4.1 PerformPromiseThen, with the capability encoded as
+  /// described in the class comment.
+  static ExecutionStatus performThen(
+      Handle<JSPromise> self,
+      Runtime &runtime,
+      Handle<> onFulfilled,
+      Handle<> onRejected,
+      Handle<> capabilityTarget,
+      Handle<> capabilityReject);
+
+  /// ES2022 27.2.4.7.1 PromiseResolve(%Promise%, \p value).
+  static CallResult<Handle<JSPromise>> promiseResolve(
+      Runtime &runtime,
+      Handle<> value);
+
+  /// Run a Promise Job taken from the job queue. The operands are:
+  /// - PromiseReaction: [handler, argument, capabilityTarget,
+  ///   capabilityReject], and \p isRejection tells whether the job was
+  ///   triggered by a rejection.
+  /// - PromiseResolveThenable: [promise, thenable, then].
+  static ExecutionStatus runJob(
+      Runtime &runtime,
+      Runtime::Job::Kind kind,
+      bool isRejection,
+      llvh::ArrayRef<Handle<>> operands);
+
+  friend void JSPromiseBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+
+  JSPromise(
+      Runtime &runtime,
+      Handle<JSObject> parent,
+      Handle<HiddenClass> clazz)
+      : JSObject(runtime, *parent, *clazz) {}
+
+ private:
+  /// Settle \p self with \p value and trigger its reactions.
+  static ExecutionStatus settle(
+      Handle<JSPromise> self,
+      Runtime &runtime,
+      State state,
+      Handle<> value);
+
+  /// ES2022 27.2.1.9 HostPromiseRejectionTracker. Calls the tracker installed
+  /// by HermesInternal.enablePromiseRejectionTracker, if any.
+  static ExecutionStatus trackRejection(
+      Handle<JSPromise> self,
+      Runtime &runtime,
+      bool handled);
+
+  /// [[PromiseResult]].
+  GCHermesValue result_;
+
+  /// The pending reactions, kReactionSize values each, or null if there are
+  /// none. Cleared once the promise is settled.
+  GCPointer<ArrayStorage> reactions_{nullptr};
+
+  /// [[PromiseState]].
+  State state_{State::Pending};
+
+  /// [[PromiseIsHandled]].
+  bool isHandled_{false};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JSPROMISE_H
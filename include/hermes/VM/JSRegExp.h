@@ -73,7 +73,8 @@ class JSRegExp final : public JSObject {
   /// error. If valid, set the source and flags to the given strings, and set
   /// the standard properties of the RegExp according to the flags. Note that
   /// RegExps are not mutable (with the exception of the lastIndex property).
-  /// Compiles the \p pattern and \p flags to RegExp bytecode.
+  /// Compiles the \p pattern and \p flags to RegExp bytecode, or reuses the
+  /// bytecode in the runtime's RegExpCache.
   static ExecutionStatus initialize(
       Handle<JSRegExp> selfHandle,
       Runtime &runtime,
@@ -139,11 +140,12 @@ class JSRegExp final : public JSObject {
   /// Store a copy of the \p bytecode array.
   void initializeBytecode(llvh::ArrayRef<uint8_t> bytecode);
 
+  /// Set the group name mappings of \p selfHandle to an object mapping each
+  /// of \p groupNames, in order, to its capture group number.
   static ExecutionStatus initializeGroupNameMappingObj(
       Runtime &runtime,
       Handle<JSRegExp> selfHandle,
-      std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
-      regex::ParsedGroupNamesMapping &parsedMappings);
+      llvh::ArrayRef<std::pair<regex::GroupName, uint32_t>> groupNames);
 
   /// The order of properties here is important to avoid wasting space. When
   /// compressed pointers are enabled, JSObject has an odd number of 4 byte
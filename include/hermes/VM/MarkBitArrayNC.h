@@ -55,6 +55,11 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Marks the bit for the given index atomically, so that several marking
+  /// threads may mark bits in the same array at the same time.
+  /// \return true if the bit was not marked before this call.
+  inline bool markAtomic(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -140,6 +145,11 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_.set(ind, true);
 }
 
+bool MarkBitArrayNC::markAtomic(size_t ind) {
+  assert(ind < kNumBits && "precondition: ind must be within the index range");
+  return bitArray_.atomicTestAndSet(ind);
+}
+
 void MarkBitArrayNC::clear() {
   bitArray_.reset();
 }
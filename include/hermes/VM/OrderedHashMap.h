@@ -9,74 +9,112 @@
 #define HERMES_VM_ORDERED_HASHMAP_H
 
 #include "hermes/Support/ErrorHandling.h"
-#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Runtime.h"
-
-#include <vector>
+#include "hermes/VM/SegmentedArray.h"
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
+/// OrderedHashTable is the gc-managed storage of the entries of an
+/// OrderedHashMap, in insertion order. Entry i occupies slots 2 * i (the key)
+/// and 2 * i + 1 (the value) of a SegmentedArray. An erased entry stays in
+/// place with both slots set to empty, so the index of an entry does not
+/// change for as long as the table is in use.
+/// When the map is rehashed or cleared, its live entries move to a new table
+/// and the old table records the new one. Iterators hold a table and an entry
+/// index, and follow these records to find their position in the table the
+/// map currently uses.
+class OrderedHashTable final : public GCCell {
+  friend void OrderedHashTableBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend class OrderedHashMap;
+
  public:
   static const VTable vt;
 
-  /// The key.
-  GCHermesValue key;
+  static constexpr CellKind getCellKind() {
+    return CellKind::OrderedHashTableKind;
+  }
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::OrderedHashTableKind;
+  }
+
+  /// Create an empty table with room for \p capacity entries.
+  static CallResult<PseudoHandle<OrderedHashTable>> create(
+      Runtime &runtime,
+      uint32_t capacity);
 
-  /// The value.
-  GCHermesValue value;
+  /// \return the key of the entry at \p index, or empty if it was erased.
+  HermesValue keyAt(PointerBase &base, uint32_t index) const {
+    assert(index < numEntries_ && "Invalid entry index");
+    return entries_.getNonNull(base)->at(base, 2 * index);
+  }
 
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
+  /// \return the value of the entry at \p index, or empty if it was erased.
+  HermesValue valueAt(PointerBase &base, uint32_t index) const {
+    assert(index < numEntries_ && "Invalid entry index");
+    return entries_.getNonNull(base)->at(base, 2 * index + 1);
+  }
 
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
+  /// Move the iteration position (\p table, \p index) to the first entry at
+  /// or after it that has not been erased, first following \p table to the
+  /// table that replaced it, if any.
+  /// \return true if such an entry exists, false if the iteration is done.
+  static bool
+  advance(PointerBase &base, OrderedHashTable *&table, uint32_t &index);
 
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
+  OrderedHashTable(
+      Runtime &runtime,
+      Handle<SegmentedArray> entries,
+      uint32_t capacity);
 
-  static constexpr CellKind getCellKind() {
-    return CellKind::HashMapEntryKind;
-  }
-  static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
-  }
+ private:
+  /// The keys and values of the entries, with size 2 * capacity_.
+  GCPointer<SegmentedArray> entries_;
+
+  /// The table the entries moved to when this one was rehashed or cleared.
+  /// nullptr while this table is in use.
+  GCPointer<OrderedHashTable> next_{nullptr};
+
+  /// The number of entries the table has room for.
+  uint32_t capacity_;
 
-  static CallResult<PseudoHandle<HashMapEntry>> create(Runtime &runtime);
+  /// The number of entries appended so far, including the erased ones.
+  uint32_t numEntries_{0};
 
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
+  /// Whether this table was replaced by clearing the map, rather than by a
+  /// rehash which preserves the live entries.
+  bool cleared_{false};
+
+  /// \return true if the entry at \p index was erased.
+  bool isErased(PointerBase &base, uint32_t index) const {
+    return keyAt(base, index).isEmpty();
   }
 
-  /// Mark this entry as deleted.
-  void markDeleted(Runtime &runtime) {
-    key.setNonPtr(HermesValue::encodeEmptyValue(), runtime.getHeap());
-    value.setNonPtr(HermesValue::encodeEmptyValue(), runtime.getHeap());
+  /// Append an entry. \pre numEntries_ < capacity_.
+  uint32_t append(Runtime &runtime, HermesValue key, HermesValue value);
+
+  /// Set the value of the entry at \p index.
+  void setValue(Runtime &runtime, uint32_t index, HermesValue value) {
+    assert(!isErased(runtime, index) && "Setting an erased entry");
+    entries_.getNonNull(runtime)->set(runtime, 2 * index + 1, value);
   }
-}; // HashMapEntry
+
+  /// Mark the entry at \p index as erased.
+  void erase(Runtime &runtime, uint32_t index);
+}; // OrderedHashTable
 
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// The entries live in insertion order in a dense OrderedHashTable, and are
+/// found through an open-addressed index of (entry, hash) pairs that is owned
+/// by the map and allocated with malloc. The index has twice as many buckets
+/// as the table has room for entries, so its load factor, including the
+/// buckets of erased entries, never exceeds 0.5.
+/// Appending to a full table rehashes the map into a new table, which
+/// compacts away the erased entries and doubles the capacity if at least
+/// half of the entries are live. Erasing shrinks the table when less than a
+/// quarter of it is live.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -102,12 +140,8 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
-
-  /// Insert a key/value pair into the map, if not already existing.
+  /// Insert a key/value pair into the map, or update the value if the key
+  /// already exists.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
       Runtime &runtime,
@@ -118,74 +152,88 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime &runtime);
+  /// Clear the map, moving it to a new empty table.
+  static ExecutionStatus clear(Handle<OrderedHashMap> self, Runtime &runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime &runtime, HashMapEntry *entry = nullptr)
-      const;
+  /// \return the table holding the entries. An iteration starts at its entry
+  /// 0, see OrderedHashTable::advance.
+  OrderedHashTable *getTable(PointerBase &base) const {
+    return table_.getNonNull(base);
+  }
 
-  OrderedHashMap(Runtime &runtime, Handle<ArrayStorageSmall> hashTableStorage);
+  OrderedHashMap(Runtime &runtime, Handle<OrderedHashTable> table);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorageSmall> hashTable_{nullptr};
-
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
-
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
-
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
-
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  static constexpr uint32_t MAX_CAPACITY =
-      std::min(ArrayStorageSmall::maxElements(), UINT32_MAX / 4);
-
-  /// Capacity of the hash table.
-  uint32_t capacity_{INITIAL_CAPACITY};
-
-  /// Number of alive entries in the storage.
+  /// A bucket of the index.
+  struct Bucket {
+    /// The index of the entry in the table, or EMPTY or ERASED.
+    uint32_t entry;
+    /// The hash of the key of the entry.
+    uint32_t hash;
+  };
+
+  /// The entry of a bucket that was never used.
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+  /// The entry of a bucket whose entry was erased.
+  static constexpr uint32_t ERASED = UINT32_MAX - 1;
+
+  /// Initial capacity of the table.
+  static constexpr uint32_t INITIAL_CAPACITY = 8;
+
+  /// Maximum capacity of the table, such that both the entries and the index
+  /// can be allocated.
+  static constexpr uint32_t MAX_CAPACITY = 1u << 26;
+  static_assert(
+      2 * MAX_CAPACITY <= SegmentedArray::maxElements(),
+      "The entries of the largest table cannot be allocated");
+
+  /// The table holding the entries.
+  GCPointer<OrderedHashTable> table_;
+
+  /// The index, with 2 * capacity buckets, where capacity is the capacity of
+  /// table_.
+  Bucket *buckets_;
+
+  /// Number of buckets in the index, a power of 2.
+  uint32_t numBuckets_;
+
+  /// Number of alive entries in the map.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key) {
-    auto hash = runtime.gcStableHashHermesValue(key);
-    assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
-  }
+  static void _finalizeImpl(GCCell *cell, GC &gc);
+  static size_t _mallocSizeImpl(GCCell *cell);
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime &runtime, HashMapEntry *entry, GC &gc);
+  /// Allocate an index of \p numBuckets empty buckets.
+  static Bucket *allocateBuckets(uint32_t numBuckets);
 
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime &runtime, uint32_t bucket, HermesValue key);
+  /// Hash \p key the way the index does.
+  static uint32_t hash(Runtime &runtime, Handle<> key) {
+    return (uint32_t)runtime.gcStableHashHermesValue(key);
+  }
 
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
+  /// Lookup the bucket of the entry with key \p key, whose hash is \p hash.
+  /// \return nullptr if there is no such entry.
+  Bucket *lookup(PointerBase &base, HermesValue key, uint32_t hash);
+
+  /// Add the entry at \p entry, whose key has hash \p hash, to the index
+  /// \p buckets of size \p numBuckets.
+  static void addToIndex(
+      Bucket *buckets,
+      uint32_t numBuckets,
+      uint32_t entry,
+      uint32_t hash);
+
+  /// Move the live entries to a new table of capacity \p newCapacity, and
+  /// rebuild the index for it.
+  static ExecutionStatus rehash(
       Handle<OrderedHashMap> self,
-      Runtime &runtime);
+      Runtime &runtime,
+      uint32_t newCapacity);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
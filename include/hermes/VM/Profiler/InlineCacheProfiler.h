@@ -45,13 +45,18 @@ class InlineCacheProfiler {
   /// is uniquely identified by code block and instruction offset.
   struct ICMiss {
     /// Increment the inline caching miss count for a pair of hidden classes.
-    void insertMiss(ICMissKey icRecord) {
+    /// \p megamorphic indicates that the cache entry was no longer being
+    /// updated.
+    void insertMiss(ICMissKey icRecord, bool megamorphic) {
       auto ret =
           hiddenClasses.insert(std::pair<ICMissKey, uint32_t>(icRecord, 1));
       if (!ret.second) {
         ++(ret.first->second);
       }
       ++missCount;
+      if (megamorphic) {
+        ++megamorphicMissCount;
+      }
     }
 
     /// Increment the inline caching hit count for a pair of hidden classes.
@@ -59,12 +64,25 @@ class InlineCacheProfiler {
       ++hitCount;
     }
 
+    /// Increment the count of hits on a class other than the primary cached
+    /// class of a polymorphic cache entry.
+    void incrementPolymorphicHit() {
+      ++polymorphicHitCount;
+    }
+
     /// Total number of inline caching misses at the source location.
     uint64_t missCount{0};
 
     /// Total number of inline caching hits at the source location.
     uint64_t hitCount{0};
 
+    /// Number of hits on a class other than the primary cached class.
+    uint64_t polymorphicHitCount{0};
+
+    /// Number of misses at the source location after its cache entry became
+    /// megamorphic.
+    uint64_t megamorphicMissCount{0};
+
     /// Internal map that keeps track of the mapping between
     /// <property, object hidden class, cached hidden class> and its frequency.
     llvh::DenseMap<ICMissKey, uint64_t> hiddenClasses;
@@ -82,16 +100,31 @@ class InlineCacheProfiler {
       uint32_t instOffset,
       SymbolID &propertyID,
       ClassId objectHiddenClassId,
-      ClassId cachedHiddenClassId);
+      ClassId cachedHiddenClassId,
+      bool megamorphic);
 
   /// Record an inline caching hit.
   bool insertICHit(CodeBlock *codeblock, uint32_t instOffset);
 
+  /// Record an inline caching hit on a class other than the primary cached
+  /// class of a polymorphic cache entry.
+  bool insertICPolymorphicHit(CodeBlock *codeblock, uint32_t instOffset);
+
   /// Get the total number of inline caching misses.
   uint32_t getTotalMisses() {
     return totalMisses_;
   }
 
+  /// Get the total number of polymorphic inline caching hits.
+  uint64_t getTotalPolymorphicHits() {
+    return totalPolymorphicHits_;
+  }
+
+  /// Get the total number of inline caching misses at megamorphic sites.
+  uint64_t getTotalMegamorphicMisses() {
+    return totalMegamorphicMisses_;
+  }
+
   /// Get a JS array containing all hidden classes that shouldn't be
   /// garbage collected.
   JSArray *&getHiddenClassArray();
@@ -163,6 +196,14 @@ class InlineCacheProfiler {
   /// Total number of inline caching hits during the program execution.
   uint64_t totalHits_{0};
 
+  /// Total number of polymorphic inline caching hits during the program
+  /// execution.
+  uint64_t totalPolymorphicHits_{0};
+
+  /// Total number of inline caching misses at megamorphic sites during the
+  /// program execution.
+  uint64_t totalMegamorphicMisses_{0};
+
   /// Store the data structure of all inline caching misses information.
   /// The map is keyed by pairs <instruction offset, CodeBlock> and maps
   /// to ICMiss objects, which keeps track of hidden classes and frequency.
@@ -17,17 +17,102 @@ namespace vm {
 using SlotIndex = uint32_t;
 
 class HiddenClass;
+class JSObject;
 
 /// A cache entry for a property lookup.
 /// If the class operation that we are performing
 /// matches the values in the cache entry, \c slot is the index of a
 /// non-accessor property.
+///
+/// An entry can hold up to kNumWays classes, so that sites which see a few
+/// different object shapes still hit. The most recently added class is kept
+/// in \c clazz and \c slot, which is what the fast paths check first; the
+/// others are kept in \c polyClazz and \c polySlot. Once a site has seen more
+/// classes than fit, it is marked megamorphic and the entry is no longer
+/// updated.
+///
+/// Separately, an entry can cache a property found in the prototype chain of
+/// the receiver. Hidden classes do not describe the prototype, so such an
+/// entry records the receiver's class and parent, and the object holding the
+/// property. Every object between the parent and the holder is flagged, and
+/// modifying a flagged object advances the runtime's prototype shape epoch,
+/// which invalidates all such entries at once.
 struct PropertyCacheEntry {
+  /// The maximum number of classes cached in a single entry.
+  static constexpr unsigned kNumWays = 4;
+
   /// Cached class.
   WeakRoot<HiddenClass> clazz{nullptr};
 
   /// Cached property index.
   SlotIndex slot{0};
+
+  /// Whether more than kNumWays classes have been seen by this entry.
+  bool megamorphic{false};
+
+  /// Additional cached classes. Unused ways are null.
+  WeakRoot<HiddenClass> polyClazz[kNumWays - 1];
+
+  /// Cached property indices corresponding to \c polyClazz.
+  SlotIndex polySlot[kNumWays - 1]{};
+
+  /// Class of the receivers for which the prototype chain entry is valid.
+  WeakRoot<HiddenClass> protoClazz;
+
+  /// Parent of the receivers for which the prototype chain entry is valid.
+  WeakRoot<JSObject> protoParent;
+
+  /// The object in the prototype chain holding the property.
+  WeakRoot<JSObject> protoHolder;
+
+  /// Property index of the property in \c protoHolder.
+  SlotIndex protoSlot{0};
+
+  /// Prototype shape epoch in which the prototype chain entry was filled.
+  uint32_t protoEpoch{0};
+
+  /// Look for \p cls among the additional cached classes.
+  /// \return true and set \p slotOut to its property index if it was found.
+  bool findPolymorphic(CompressedPointer cls, SlotIndex &slotOut) const {
+    for (unsigned i = 0; i < kNumWays - 1; ++i) {
+      if (polyClazz[i] == cls) {
+        slotOut = polySlot[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Add class \p cls with property index \p slotIdx to the entry, making it
+  /// the primary class. The previous primary class moves to a free way; if
+  /// there is none, the entry becomes megamorphic and is left unchanged.
+  void insert(CompressedPointer cls, SlotIndex slotIdx) {
+    if (megamorphic)
+      return;
+    if (!clazz || clazz == cls) {
+      clazz = cls;
+      slot = slotIdx;
+      return;
+    }
+    for (unsigned i = 0; i < kNumWays - 1; ++i) {
+      if (polyClazz[i] == cls) {
+        polySlot[i] = slotIdx;
+        return;
+      }
+    }
+    for (unsigned i = 0; i < kNumWays - 1; ++i) {
+      if (!polyClazz[i]) {
+        // Copying between weak roots needs no read barrier, since both are
+        // cleared together if the class dies.
+        polyClazz[i] = clazz.getNoBarrierUnsafe();
+        polySlot[i] = slot;
+        clazz = cls;
+        slot = slotIdx;
+        return;
+      }
+    }
+    megamorphic = true;
+  }
 };
 
 } // namespace vm
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "hermes/Regex/RegexSupport.h"
+#include "hermes/Regex/RegexTypes.h"
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// RegExpCache keeps the compiled form of the patterns most recently passed to
+/// the RegExp constructor, so that constructing a RegExp with the same pattern
+/// and flags again skips parsing and compiling it. Once the cache is full, the
+/// least recently used entry is evicted.
+class RegExpCache {
+ public:
+  /// A compiled RegExp.
+  struct Entry {
+    /// The regex bytecode, including its header.
+    std::vector<uint8_t> bytecode;
+
+    /// The named capture groups in the order they are defined, with their
+    /// capture group numbers.
+    std::vector<std::pair<regex::GroupName, uint32_t>> groupNames;
+  };
+
+  /// Create a cache holding at most \p capacity entries. A capacity of 0
+  /// disables the cache.
+  explicit RegExpCache(unsigned capacity) : capacity_(capacity) {}
+
+  RegExpCache(const RegExpCache &) = delete;
+  RegExpCache &operator=(const RegExpCache &) = delete;
+
+  /// \return the entry for \p pattern compiled with \p flags, or nullptr if
+  /// there is none. The entry remains valid until the next call to insert().
+  const Entry *lookup(
+      llvh::ArrayRef<char16_t> pattern,
+      regex::SyntaxFlags flags);
+
+  /// Add \p entry, the compiled form of \p pattern with \p flags, evicting the
+  /// least recently used entry if the cache is full.
+  void insert(
+      llvh::ArrayRef<char16_t> pattern,
+      regex::SyntaxFlags flags,
+      Entry entry);
+
+  /// \return the number of lookups that found an entry.
+  uint64_t getHits() const {
+    return hits_;
+  }
+
+  /// \return the number of lookups that did not find an entry.
+  uint64_t getMisses() const {
+    return misses_;
+  }
+
+  /// \return the number of entries.
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /// \return the number of bytes allocated for the entries.
+  size_t mallocSize() const {
+    return mallocSize_;
+  }
+
+ private:
+  /// The key of an entry: the flags followed by the pattern.
+  using Key = std::u16string;
+
+  /// The entries, most recently used first.
+  using EntryList = std::list<std::pair<Key, Entry>>;
+
+  static Key makeKey(
+      llvh::ArrayRef<char16_t> pattern,
+      regex::SyntaxFlags flags);
+
+  /// \return an estimate of the bytes allocated for \p entry under \p key.
+  static size_t entrySize(const Key &key, const Entry &entry);
+
+  /// The maximum number of entries.
+  const unsigned capacity_;
+
+  EntryList entries_;
+
+  /// Maps each key to its entry in entries_.
+  std::unordered_map<Key, EntryList::iterator> index_;
+
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  size_t mallocSize_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
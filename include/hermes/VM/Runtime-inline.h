@@ -22,6 +22,12 @@ inline Callable *Runtime::getBuiltinCallable(unsigned builtinMethodID) {
 }
 
 inline void Runtime::enqueueJob(Callable *job) {
+  jobQueue_.emplace_back();
+  jobQueue_.back().kind = Job::Kind::Call;
+  jobQueue_.back().operands[0] = HermesValue::encodeObjectValue(job);
+}
+
+inline void Runtime::enqueueJob(const Job &job) {
   jobQueue_.push_back(job);
 }
 
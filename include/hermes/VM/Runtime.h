@@ -26,11 +26,13 @@
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/InternalProperty.h"
 #include "hermes/VM/InterpreterState.h"
+#include "hermes/VM/JIT/JIT.h"
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/Predefined.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/Profiler/SamplingProfilerDefs.h"
 #include "hermes/VM/PropertyCache.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
@@ -51,6 +53,7 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -392,16 +395,51 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// the builtins header header.
   inline Callable *getBuiltinCallable(unsigned builtinMethodID);
 
+  /// A job in \c jobQueue_. Jobs are either callables invoked with no
+  /// arguments, or Promise Jobs created by the native Promise, which keep
+  /// their operands here instead of in a closure allocated per job.
+  struct Job {
+    enum class Kind : uint8_t {
+      /// Call \c operands[0] with no arguments.
+      Call,
+      /// ES2022 27.2.2.1 NewPromiseReactionJob. See JSPromise::runJob for the
+      /// operands.
+      PromiseReaction,
+      /// ES2022 27.2.2.2 NewPromiseResolveThenableJob. See JSPromise::runJob
+      /// for the operands.
+      PromiseResolveThenable,
+    };
+
+    static constexpr unsigned kNumOperands = 4;
+
+    Kind kind;
+    /// Whether a PromiseReaction job is triggered by a rejection.
+    bool isRejection{false};
+    PinnedHermesValue operands[kNumOperands]{};
+  };
+
   /// ES6-ES11 8.4.1 EnqueueJob ( queueName, job, arguments )
   /// See \c jobQueue_ for how the Jobs and Job Queues are set up in Hermes.
   inline void enqueueJob(Callable *job);
 
+  /// Enqueue a job that has already been filled in.
+  inline void enqueueJob(const Job &job);
+
+  /// \return true if there are jobs waiting in the job queue.
+  bool hasPendingJobs() const {
+    return !jobQueue_.empty();
+  }
+
   /// ES6-ES11 8.6 RunJobs ( )
   /// Draining the job queue by invoking the queued jobs in FIFO order.
   ///
-  /// \return ExecutionStatus::RETURNED if the job queue is emptied and no
-  /// exception was thrown from any job. Otherwise, ExecutionStatus::EXCEPTION
-  /// if an exception was thrown and the draining is stopped.
+  /// \param maxJobs the maximum number of jobs to run before returning, even
+  /// if the queue is not empty yet. Use \c hasPendingJobs to tell whether the
+  /// queue was emptied.
+  /// \return ExecutionStatus::RETURNED if the job queue is emptied (or
+  /// \p maxJobs were run) and no exception was thrown from any job.
+  /// Otherwise, ExecutionStatus::EXCEPTION if an exception was thrown and the
+  /// draining is stopped.
   /// It's the caller's responsibility to check the status and re-invoke this
   /// function to resume the draining to fulfill the microtask requirements.
   ///
@@ -409,7 +447,8 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// by returning a rejected Promise. However, the capability of propagating
   /// exception per job is required by `queueMicrotask` to properly "report the
   /// exception" (https://html.spec.whatwg.org/C#microtask-queuing).
-  ExecutionStatus drainJobs();
+  ExecutionStatus drainJobs(
+      size_t maxJobs = std::numeric_limits<size_t>::max());
 
   // ES2021 9.12 "When the abstract operation AddToKeptObjects is called with a
   // target object reference, it adds the target to a list that will point
@@ -745,6 +784,25 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// Like calling JSObject::getNamed, but uses this runtime's property cache.
   CallResult<PseudoHandle<>> getNamed(Handle<JSObject> obj, PropCacheID id);
 
+  /// Epoch value that is never current, see getProtoShapeEpoch().
+  static constexpr uint32_t kInvalidProtoShapeEpoch = UINT32_MAX;
+
+  /// \return the current prototype shape epoch. Property cache entries for
+  /// properties found in the prototype chain are only valid while the epoch
+  /// they were filled in is current.
+  uint32_t getProtoShapeEpoch() const {
+    return protoShapeEpoch_;
+  }
+
+  /// Invalidate all property cache entries for properties found in the
+  /// prototype chain. Called when an object on a cached prototype chain is
+  /// modified. Once the epoch reaches kInvalidProtoShapeEpoch it stops
+  /// advancing, and such entries are no longer filled.
+  void invalidateProtoChainCaches() {
+    if (LLVM_LIKELY(protoShapeEpoch_ != kInvalidProtoShapeEpoch))
+      ++protoShapeEpoch_;
+  }
+
   /// Like calling JSObject::putNamed with the ThrowOnError flag, but uses this
   /// runtime's property cache.
   ExecutionStatus putNamedThrowOnError(
@@ -752,6 +810,11 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
       PropCacheID id,
       SmallHermesValue hv);
 
+  /// \return the cache of compiled RegExp patterns.
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
   /// @}
 
 #define RUNTIME_HV_FIELD(name) PinnedHermesValue name{};
@@ -827,6 +890,10 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
     return *codeCoverageProfiler_;
   }
 
+  JITContext &getJITContext() {
+    return jitContext_;
+  }
+
 #if HERMESVM_SAMPLING_PROFILER_AVAILABLE
   /// Sampling profiler data for this runtime. The ctor/dtor of SamplingProfiler
   /// will automatically register/unregister this runtime from profiling.
@@ -871,6 +938,13 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
     return hasMicrotaskQueue_;
   }
 
+  /// \return true if Promise is implemented natively by JSPromise rather than
+  /// by the polyfill in the internal bytecode. The native Promise schedules
+  /// its jobs on the engine's job queue, so it needs the microtask queue.
+  bool hasNativePromise() const {
+    return hasES6Promise_ && hasMicrotaskQueue_;
+  }
+
   bool builtinsAreFrozen() const {
     return builtinsFrozen_;
   }
@@ -951,13 +1025,14 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// collected.
   void preventHCGC(HiddenClass *hc);
 
-  /// Inserts Hidden Classes into InlineCacheProfiler
+  /// Inserts Hidden Classes into InlineCacheProfiler, classifying the access
+  /// against the classes held by \p cacheEntry.
   void recordHiddenClass(
       CodeBlock *codeBlock,
       const Inst *cacheMissInst,
       SymbolID symbolID,
       HiddenClass *objectHiddenClass,
-      HiddenClass *cachedHiddenClass);
+      PropertyCacheEntry *cacheEntry);
 
   /// Resolve HiddenClass pointers from its hidden class Id.
   HiddenClass *resolveHiddenClassId(ClassId classId);
@@ -1239,6 +1314,13 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// Cache for property lookups in non-JS code.
   PropertyCacheEntry fixedPropCache_[(size_t)PropCacheID::_COUNT];
 
+  /// The current prototype shape epoch, see getProtoShapeEpoch(). Property
+  /// cache entries start out with epoch 0, so it starts at 1.
+  uint32_t protoShapeEpoch_{1};
+
+  /// Cache of compiled RegExp patterns, see getRegExpCache().
+  RegExpCache regExpCache_;
+
   /// StringPrimitive representation of the first 256 characters.
   /// These are allocated as "long-lived" objects, so they don't need
   /// to be scanned as roots in young-gen collections.
@@ -1267,6 +1349,8 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// - Promise Jobs enqueued from Promise internal bytecode are thunks (or, in
   /// the ES12 wording, Promise Jobs are Abstract Closure with no parameters).
   /// - `queueMicrotask` take a JSFunction but only invoke it with 0 arguments.
+  /// The native Promise instead enqueues its jobs with their operands (see
+  /// \c Job), which are run by JSPromise::runJob.
   ///
   /// Although ES12 (9.4 Jobs and Host Operations to Enqueue Jobs) changed the
   /// meta-language to ask hosts to schedule Promise Job to integrate with the
@@ -1274,7 +1358,7 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// approach, similar to other engines, e.g. V8/JSC, which is more efficient
   /// (being able to batch the job invocations) and sufficient to express the
   /// HTML spec specified "perform a microtask checkpoint" algorithm.
-  std::deque<Callable *> jobQueue_{};
+  std::deque<Job> jobQueue_{};
 
 #ifdef HERMESVM_PROFILER_BB
   BasicBlockExecutionInfo basicBlockExecInfo_;
@@ -1293,6 +1377,9 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// Pointer to the code coverage profiler.
   const std::unique_ptr<CodeCoverageProfiler> codeCoverageProfiler_;
 
+  /// State of the baseline JIT.
+  JITContext jitContext_;
+
   /// Bit flags for async break request reasons.
   enum class AsyncBreakReasonBits : uint8_t {
     DebuggerExplicit = 0x1,
@@ -96,6 +96,9 @@ class RuntimeModule final : public llvh::ilist_node<RuntimeModule> {
   /// The table maps from a function index to a CodeBlock.
   std::vector<CodeBlock *> functionMap_{};
 
+  /// The CodeBlocks owned by this module that have allocation sites.
+  std::vector<CodeBlock *> allocationSiteCodeBlocks_{};
+
   /// The byte-code provider for this RuntimeModule. The RuntimeModule is
   /// designed to own the provider exclusively, especially because in some
   /// cases the bytecode can be modified (e.g. for breakpoints). This however
@@ -362,6 +365,16 @@ class RuntimeModule final : public llvh::ilist_node<RuntimeModule> {
     acceptor.acceptWeak(domain_);
   }
 
+  /// Record that \p codeBlock, which this module owns, has allocation sites.
+  void addAllocationSiteCodeBlock(CodeBlock *codeBlock) {
+    allocationSiteCodeBlocks_.push_back(codeBlock);
+  }
+
+  /// Mark the weak roots in the allocation sites of this module's CodeBlocks.
+  /// They usually refer to young objects, so unlike the other weak roots of
+  /// the module, every collection must update them.
+  void markAllocationSites(WeakRootAcceptor &acceptor);
+
   /// \return an estimate of the size of additional memory used by this
   /// RuntimeModule.
   size_t additionalMemorySize() const;
@@ -115,6 +115,24 @@ class StringBuilder {
     }
   }
 
+  /// Append a copy of the \p length characters starting at \p start that have
+  /// already been appended. Repeating content by copying what is built, with
+  /// the length doubling each time, avoids a copy call per repetition.
+  void appendCopyOf(uint32_t start, uint32_t length) {
+    assert(start + length <= index_ && "Copied range not built yet");
+    assert(
+        index_ + length <= strPrim_->getStringLength() &&
+        "StringBuilder append out of bound");
+    if (strPrim_->isASCII()) {
+      char *ptr = strPrim_->castToASCIIPointerForWrite();
+      std::memcpy(ptr + index_, ptr + start, length);
+    } else {
+      char16_t *ptr = strPrim_->castToUTF16PointerForWrite();
+      std::memcpy(ptr + index_, ptr + start, length * sizeof(char16_t));
+    }
+    index_ += length;
+  }
+
   /// Append the first \p length characters from StringPrimitive \p other.
   void appendStringPrim(Handle<StringPrimitive> other, uint32_t length) {
     assert(
@@ -31,6 +31,9 @@ enum {
   // HadesTimedIncremental = 1 << 12,
   CrashTrace = 1 << 13,
   // JobQueue = 1 << 14,
+  /// Advise sequential access to the bytecode while its global code runs,
+  /// then random access.
+  MAdviseStartupSequential = 1 << 15,
 };
 
 /// Set of flags for active VM experiments.
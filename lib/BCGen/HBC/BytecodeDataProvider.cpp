@@ -13,6 +13,8 @@
 #include "llvh/Support/MathExtras.h"
 #include "llvh/Support/SHA1.h"
 
+#include <map>
+
 namespace hermes {
 namespace hbc {
 
@@ -399,6 +401,7 @@ void BCProviderFromBuffer::stopWarmup() {
 }
 
 void BCProviderFromBuffer::startWarmup(uint8_t percent) {
+  std::lock_guard<std::mutex> lk(mutex_);
   if (!warmupThread_) {
     uint32_t warmupSize = buffer_->size();
     assert(percent <= 100);
@@ -542,6 +545,7 @@ void BCProviderFromBuffer::willNeedStringTable() {
 #undef ASSERT_TOTAL_ARRAY_LEN
 
 void BCProviderFromBuffer::startPageAccessTracker() {
+  std::lock_guard<std::mutex> lk(mutex_);
   auto size = buffer_->size();
   if (!tracker_) {
     tracker_ =
@@ -549,6 +553,66 @@ void BCProviderFromBuffer::startPageAccessTracker() {
   }
 }
 
+namespace {
+
+/// The providers that runtimes may share, keyed by the hash in the footer of
+/// their bytecode. Entries are not owning, so a provider is released as soon
+/// as the last runtime using it is done with it.
+struct SharedProviders {
+  std::mutex mutex;
+  std::map<SHA1, std::weak_ptr<BCProviderFromBuffer>> providers;
+};
+
+SharedProviders &sharedProviders() {
+  // Leaked so that it can still be used while other statics are destroyed.
+  static SharedProviders *shared = new SharedProviders();
+  return *shared;
+}
+
+} // namespace
+
+std::pair<std::shared_ptr<BCProviderFromBuffer>, std::string>
+BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+    std::unique_ptr<const Buffer> buffer) {
+  llvh::ArrayRef<uint8_t> aref(buffer->data(), buffer->size());
+  std::string errstr;
+  if (!sanityCheck(aref, BytecodeForm::Execution, &errstr))
+    return {nullptr, errstr};
+  const auto *header =
+      reinterpret_cast<const hbc::BytecodeFileHeader *>(aref.data());
+  if (header->fileLength != aref.size())
+    return createBCProviderFromBuffer(std::move(buffer));
+
+  const auto *footer = reinterpret_cast<const hbc::BytecodeFileFooter *>(
+      aref.data() + header->fileLength - sizeof(BytecodeFileFooter));
+  SHA1 fileHash;
+  std::copy(
+      std::begin(footer->fileHash),
+      std::end(footer->fileHash),
+      fileHash.begin());
+
+  auto &shared = sharedProviders();
+  std::lock_guard<std::mutex> lk(shared.mutex);
+  if (auto existing = shared.providers[fileHash].lock())
+    return {std::move(existing), ""};
+
+  auto ret = createBCProviderFromBuffer(std::move(buffer));
+  if (!ret.first) {
+    shared.providers.erase(fileHash);
+    return {nullptr, ret.second};
+  }
+  std::shared_ptr<BCProviderFromBuffer> provider = std::move(ret.first);
+  shared.providers[fileHash] = provider;
+  // Forget the providers that are no longer used by any runtime.
+  for (auto it = shared.providers.begin(); it != shared.providers.end();) {
+    if (it->second.expired())
+      it = shared.providers.erase(it);
+    else
+      ++it;
+  }
+  return {std::move(provider), ""};
+}
+
 BCProviderFromBuffer::BCProviderFromBuffer(
     std::unique_ptr<const Buffer> buffer,
     BytecodeForm form)
@@ -617,6 +681,10 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
 }
 
 void BCProviderFromBuffer::createDebugInfo() {
+  std::lock_guard<std::mutex> lk(mutex_);
+  // Another thread may have created it while we were waiting for the lock.
+  if (debugInfo_.load(std::memory_order_relaxed))
+    return;
   const auto *buf = bufferPtr_ + debugInfoOffset_;
   const auto *header = castData<hbc::DebugInfoHeader>(buf);
 
@@ -630,7 +698,7 @@ void BCProviderFromBuffer::createDebugInfo() {
     const auto *region = castData<hbc::DebugFileRegion>(buf);
     files.push_back(*region);
   }
-  debugInfo_ = new hbc::DebugInfo(
+  auto *debugInfo = new hbc::DebugInfo(
       filenameTable,
       filenameStorage,
       std::move(files),
@@ -638,6 +706,7 @@ void BCProviderFromBuffer::createDebugInfo() {
       header->textifiedCalleeOffset,
       header->stringTableOffset,
       hbc::StreamVector<uint8_t>{buf, header->debugDataSize});
+  debugInfo_.store(debugInfo, std::memory_order_release);
 }
 
 std::pair<
@@ -194,6 +194,10 @@ void BytecodeFunctionGenerator::bytecodeGenerationComplete() {
 }
 
 unsigned BytecodeModuleGenerator::addFunction(Function *F) {
+  // Instruction selection looks up the IDs of functions that were already
+  // added, possibly on several threads, so that must not write anything.
+  if (auto id = functionIDMap_.find(F))
+    return *id;
   lazyFunctions_ |= F->isLazy();
   asyncFunctions_ |= llvh::isa<AsyncFunction>(F);
   return functionIDMap_.allocate(F);
@@ -29,6 +29,9 @@
 #include "hermes/Support/PerfSection.h"
 #include "hermes/Support/UTF8.h"
 
+#include <atomic>
+#include <thread>
+
 #define DEBUG_TYPE "hbc-backend"
 
 using namespace hermes;
@@ -105,6 +108,72 @@ void lowerIR(Module *M, const BytecodeGenerationOptions &options) {
   }
 }
 
+/// \return whether instruction selection for \p F only reads the state it
+/// shares with other functions, so that it can run concurrently with theirs
+/// (see HBCISel::generateCode()). This also fills \p scopeAnalysis with the
+/// scope depths that F needs, since the analysis computes them lazily.
+bool canSelectConcurrently(Function *F, FunctionScopeAnalysis &scopeAnalysis) {
+  // Declaring the global properties may create literals.
+  if (F->isGlobalScope())
+    return false;
+  llvh::Optional<int32_t> curDepth =
+      scopeAnalysis.getScopeDepth(F->getFunctionScopeDesc());
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      // Regular expressions and BigInts are numbered in the order they are
+      // added to the module, so they must be added in function order.
+      if (llvh::isa<CreateRegExpInst>(&I))
+        return false;
+      if (auto *LCI = llvh::dyn_cast<HBCLoadConstInst>(&I)) {
+        if (llvh::isa<LiteralBigInt>(LCI->getConst()))
+          return false;
+      }
+      if (auto *RE = llvh::dyn_cast<HBCResolveEnvironment>(&I)) {
+        llvh::Optional<int32_t> depth =
+            scopeAnalysis.getScopeDepth(RE->getCreatedScopeDesc());
+        // Environments out of reach are reported as errors.
+        if (depth && curDepth && *curDepth - *depth > UINT8_MAX)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// A function whose instruction selection was deferred, so that it can run
+/// on several threads once all functions have been register allocated.
+struct DeferredFunction {
+  Function *F;
+  std::unique_ptr<HVMRegisterAllocator> RA;
+  std::unique_ptr<BytecodeFunctionGenerator> funcGen;
+  std::unique_ptr<HBCISel> hbciSel;
+  /// Whether canSelectConcurrently(F).
+  bool concurrent;
+};
+
+/// Run HBCISel::generateCode() for the functions of \p deferred that allow
+/// it, on \p numThreads threads including the calling one.
+void selectConcurrently(
+    llvh::MutableArrayRef<DeferredFunction> deferred,
+    unsigned numThreads) {
+  std::atomic<size_t> next{0};
+  auto work = [&next, deferred]() {
+    for (;;) {
+      size_t i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= deferred.size())
+        return;
+      if (deferred[i].concurrent)
+        deferred[i].hbciSel->generateCode();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads; ++i)
+    threads.emplace_back(work);
+  work();
+  for (auto &thread : threads)
+    thread.join();
+}
+
 /// Used in delta optimizing mode.
 /// \return a UniquingStringLiteralAccumulator seeded with strings  from a
 /// bytecode provider \p bcProvider.
@@ -501,6 +570,13 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
   // Allow reusing the debug cache between functions
   HBCISelDebugCache debugCache;
 
+  // With several threads, register allocate all the functions first, since
+  // that mutates the IR, then select their instructions in parallel. Bundle
+  // splitting may add functions to BMGen while selecting instructions, so it
+  // always runs serially.
+  const bool parallel = options.numThreads > 1 && !segment;
+  std::vector<DeferredFunction> deferred;
+
   // Bytecode generation for each function.
   for (auto &F : *M) {
     if (!shouldGenerate(&F)) {
@@ -512,30 +588,30 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
     if (F.isLazy()) {
       funcGen = BytecodeFunctionGenerator::create(BMGen, 0);
     } else {
-      HVMRegisterAllocator RA(&F);
+      auto RA = std::make_unique<HVMRegisterAllocator>(&F);
       if (!options.optimizationEnabled) {
-        RA.setFastPassThreshold(kFastRegisterAllocationThreshold);
-        RA.setMemoryLimit(kRegisterAllocationMemoryLimit);
+        RA->setFastPassThreshold(kFastRegisterAllocationThreshold);
+        RA->setMemoryLimit(kRegisterAllocationMemoryLimit);
       }
       PostOrderAnalysis PO(&F);
       /// The order of the blocks is reverse-post-order, which is a simply
       /// topological sort.
       llvh::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
-      RA.allocate(order);
+      RA->allocate(order);
 
       if (options.format == DumpRA) {
-        RA.dump();
+        RA->dump();
       }
 
       PassManager PM;
-      PM.addPass(new LowerStoreInstrs(RA));
-      PM.addPass(new LowerCalls(RA));
+      PM.addPass(new LowerStoreInstrs(*RA));
+      PM.addPass(new LowerCalls(*RA));
       if (options.optimizationEnabled) {
-        PM.addPass(new MovElimination(RA));
-        PM.addPass(new RecreateCheapValues(RA));
-        PM.addPass(new LoadConstantValueNumbering(RA));
+        PM.addPass(new MovElimination(*RA));
+        PM.addPass(new RecreateCheapValues(*RA));
+        PM.addPass(new LoadConstantValueNumbering(*RA));
       }
-      PM.addPass(new SpillRegisters(RA));
+      PM.addPass(new SpillRegisters(*RA));
       if (options.basicBlockProfiling) {
         // Insert after all other passes so that it sees final basic block
         // list.
@@ -544,17 +620,28 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
       PM.run(&F);
 
       if (options.format == DumpLRA)
-        RA.dump();
+        RA->dump();
 
       if (options.format == DumpPostRA)
         F.dump();
 
       funcGen =
-          BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
-      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis, options);
-      hbciSel.populateDebugCache(debugCache);
-      hbciSel.generate(sourceMapGen);
-      debugCache = hbciSel.getDebugCache();
+          BytecodeFunctionGenerator::create(BMGen, RA->getMaxRegisterUsage());
+      auto hbciSel = std::make_unique<HBCISel>(
+          &F, funcGen.get(), *RA, scopeAnalysis, options);
+      if (parallel) {
+        bool concurrent = canSelectConcurrently(&F, scopeAnalysis);
+        deferred.push_back(
+            {&F,
+             std::move(RA),
+             std::move(funcGen),
+             std::move(hbciSel),
+             concurrent});
+        continue;
+      }
+      hbciSel->populateDebugCache(debugCache);
+      hbciSel->generate(sourceMapGen);
+      debugCache = hbciSel->getDebugCache();
     }
 
     if (funcGen->hasEncodingError()) {
@@ -565,6 +652,26 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
     BMGen.setFunctionGenerator(&F, std::move(funcGen));
   }
 
+  if (!deferred.empty()) {
+    selectConcurrently(deferred, options.numThreads);
+    // Finish in function order, which numbers regular expressions, BigInts
+    // and filenames the same way as generating serially does.
+    for (DeferredFunction &DF : deferred) {
+      if (!DF.concurrent)
+        DF.hbciSel->generateCode();
+      DF.hbciSel->populateDebugCache(debugCache);
+      DF.hbciSel->finishGeneration(sourceMapGen);
+      debugCache = DF.hbciSel->getDebugCache();
+
+      if (DF.funcGen->hasEncodingError()) {
+        M->getContext().getSourceErrorManager().error(
+            DF.F->getSourceRange().Start, "Error encoding bytecode");
+        return nullptr;
+      }
+      BMGen.setFunctionGenerator(DF.F, std::move(DF.funcGen));
+    }
+  }
+
   return BMGen.generate();
 }
 
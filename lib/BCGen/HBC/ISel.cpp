@@ -1765,7 +1765,7 @@ void HBCISel::generate(Instruction *ii, BasicBlock *next) {
   }
 }
 
-void HBCISel::generate(SourceMapGenerator *outSourceMap) {
+void HBCISel::generateCode() {
   PostOrderAnalysis PO(F_);
 
   /// The order of the blocks is reverse-post-order, which is a simply
@@ -1791,14 +1791,22 @@ void HBCISel::generate(SourceMapGenerator *outSourceMap) {
 
   resolveRelocations();
   resolveExceptionHandlers();
-  addDebugSourceLocationInfo(outSourceMap);
   addDebugTextifiedCalleeInfo();
   generateJumpTable();
-  addDebugLexicalInfo();
   populatePropertyCachingInfo();
+}
+
+void HBCISel::finishGeneration(SourceMapGenerator *outSourceMap) {
+  addDebugSourceLocationInfo(outSourceMap);
+  addDebugLexicalInfo();
   BCFGen_->bytecodeGenerationComplete();
 }
 
+void HBCISel::generate(SourceMapGenerator *outSourceMap) {
+  generateCode();
+  finishGeneration(outSourceMap);
+}
+
 uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
   const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
   // Zero is reserved for indicating no-cache, so cannot be a value in the map.
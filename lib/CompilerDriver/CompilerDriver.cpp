@@ -51,6 +51,7 @@
 #include "zip/src/zip.h"
 
 #include <sstream>
+#include <thread>
 
 #define DEBUG_TYPE "hermes"
 
@@ -524,6 +525,15 @@ static CLFlag StripFunctionNames(
     "Strip function names to reduce string table size",
     CompilerCategory);
 
+static opt<unsigned> Jobs(
+    "j",
+    desc(
+        "Number of threads generating bytecode for functions (0 means one per "
+        "core)"),
+    init(1),
+    llvh::cl::Prefix,
+    cat(CompilerCategory));
+
 static opt<bool> EnableTDZ(
     "Xenable-tdz",
     init(false),
@@ -1969,6 +1979,9 @@ CompileResult processSourceFiles(
       cl::OutputSourceMap || cl::DebugInfoLevel == cl::DebugLevel::g0;
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
+  genOptions.numThreads = cl::Jobs
+      ? cl::Jobs
+      : std::max(1u, std::thread::hardware_concurrency());
 
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == Execute) {
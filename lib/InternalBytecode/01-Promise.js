@@ -546,6 +546,7 @@
   return promise;
 
 });
-if (HermesInternal?.hasPromise?.()) {
+// With the microtask queue, Promise is implemented natively.
+if (HermesInternal?.hasPromise?.() && !HermesInternal?.useEngineQueue?.()) {
   initPromise();
 }
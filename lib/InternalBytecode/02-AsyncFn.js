@@ -59,9 +59,12 @@ function initAsyncFn() {
   internalBytecodeResult.spawnAsync = spawn;
 }
 
-// Async functions can only work with Promise enabled.
+// Async functions can only work with Promise enabled. With the microtask
+// queue, spawnAsync comes with the native Promise instead.
 if (HermesInternal?.hasPromise?.()) {
-  initAsyncFn();
+  if (!HermesInternal?.useEngineQueue?.()) {
+    initAsyncFn();
+  }
 } else {
   // Make sure we maintain the invariant that builtin is always
   // populated, and error out when Promise is disabled.
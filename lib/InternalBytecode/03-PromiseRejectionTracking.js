@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Promise rejection tracking for the native Promise. It behaves like the
+// rejection tracking of the `promise` polyfill in 01-Promise.js, except that
+// `enable` returns the function that the engine calls for
+// HostPromiseRejectionTracker(promise, operation).
+function initPromiseRejectionTracking() {
+  var DEFAULT_WHITELIST = [
+    ReferenceError,
+    TypeError,
+    RangeError
+  ];
+
+  function matchWhitelist(error, list) {
+    return list.some(function (cls) {
+      return error instanceof cls;
+    });
+  }
+
+  function logError(id, error) {
+    console.warn('Possible Unhandled Promise Rejection (id: ' + id + '):');
+    var errStr = (error && (error.stack || error)) + '';
+    errStr.split('\n').forEach(function (line) {
+      console.warn('  ' + line);
+    });
+  }
+
+  function enable(options) {
+    options = options || {};
+    var displayId = 0;
+    // The rejections that are not handled yet, by promise.
+    var rejections = new Map();
+
+    function onUnhandled(promise) {
+      var rejection = rejections.get(promise);
+      if (
+        options.allRejections ||
+        matchWhitelist(
+          rejection.error,
+          options.whitelist || DEFAULT_WHITELIST
+        )
+      ) {
+        rejection.displayId = displayId++;
+        rejection.logged = true;
+        if (options.onUnhandled) {
+          options.onUnhandled(rejection.displayId, rejection.error);
+        } else {
+          logError(rejection.displayId, rejection.error);
+        }
+      }
+    }
+
+    function onHandled(rejection) {
+      if (options.onHandled) {
+        options.onHandled(rejection.displayId, rejection.error);
+      } else {
+        console.warn(
+          'Promise Rejection Handled (id: ' + rejection.displayId + '):'
+        );
+        console.warn(
+          '  This means you can ignore any previous messages of the form "Possible Unhandled Promise Rejection" with id ' +
+          rejection.displayId + '.'
+        );
+      }
+    }
+
+    return function (promise, operation, reason) {
+      if (operation === 'reject') {
+        rejections.set(promise, {
+          displayId: null,
+          error: reason,
+          timeout: setTimeout(
+            onUnhandled.bind(null, promise),
+            // For reference errors and type errors, this almost always
+            // means the programmer made a mistake, so log them after just
+            // 100ms
+            // otherwise, wait 2 seconds to see if they get handled
+            matchWhitelist(reason, DEFAULT_WHITELIST)
+              ? 100
+              : 2000
+          ),
+          logged: false
+        });
+        return;
+      }
+      // operation === 'handle'
+      var rejection = rejections.get(promise);
+      if (rejection) {
+        if (rejection.logged) {
+          onHandled(rejection);
+        } else {
+          clearTimeout(rejection.timeout);
+        }
+        rejections.delete(promise);
+      }
+    };
+  }
+
+  // register the `enable` function into the Hermes' internal promise
+  // rejection tracker.
+  HermesInternal?.setPromiseRejectionTrackingHook?.(enable);
+}
+
+if (HermesInternal?.hasPromise?.() && HermesInternal?.useEngineQueue?.()) {
+  initPromiseRejectionTracking();
+}
@@ -7,6 +7,7 @@
 
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
+#include "hermes/Support/CharacterScan.h"
 #include "hermes/Support/OptValue.h"
 
 #include "llvh/ADT/SmallVector.h"
@@ -20,6 +21,9 @@ namespace regex {
 template <class Traits>
 struct State;
 
+template <class Traits>
+class PikeVM;
+
 /// Describes the exit status of a RegEx execution: it either returned
 /// normally or stack overflowed
 enum class ExecutionStatus : uint8_t { RETURNED, STACK_OVERFLOW };
@@ -246,6 +250,145 @@ class Cursor {
   bool forwards_;
 };
 
+/// FirstChars is a small set of code units, one of which begins every match of
+/// a regex. The executor scans the input for them instead of attempting a
+/// match at every position.
+class FirstChars {
+ public:
+  /// Compute the first characters of the regex \p bytecode, which includes the
+  /// header. The set is empty if the regex does not have few enough of them.
+  static FirstChars compute(llvh::ArrayRef<uint8_t> bytecode) {
+    auto header =
+        reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+    FirstChars result;
+    if (!result.collect(
+            &bytecode[sizeof(RegexBytecodeHeader)],
+            0,
+            SyntaxFlags::fromByte(header->syntaxFlags),
+            0))
+      result.count_ = 0;
+    return result;
+  }
+
+  /// \return the characters, or an empty list if every match may begin with
+  /// a different character.
+  llvh::ArrayRef<char16_t> chars() const {
+    return llvh::makeArrayRef(chars_, count_);
+  }
+
+  /// \return whether every character is ASCII, so that the set can be
+  /// scanned for in an ASCII string.
+  bool allASCII() const {
+    return llvh::all_of(chars(), [](char16_t c) { return c < 128; });
+  }
+
+ private:
+  /// Alternations nested deeper than this are not analyzed.
+  static constexpr unsigned kMaxAlternationDepth = 8;
+
+  char16_t chars_[kMaxScanChars];
+  uint8_t count_ = 0;
+
+  /// Add \p c to the set. \return false if the set is full.
+  bool add(char16_t c) {
+    // A surrogate may begin in the middle of a surrogate pair, at which a
+    // unicode regex never starts a match attempt.
+    if (isHighSurrogate(c) || isLowSurrogate(c))
+      return false;
+    if (llvh::is_contained(chars(), c))
+      return true;
+    if (count_ == kMaxScanChars)
+      return false;
+    chars_[count_++] = c;
+    return true;
+  }
+
+  /// Add the characters that begin the matches of the instructions of \p
+  /// bytecode (without the header) starting at \p ip.
+  /// \return false if they are not known or too many.
+  bool collect(
+      const uint8_t *bytecode,
+      uint32_t ip,
+      SyntaxFlags flags,
+      unsigned depth);
+};
+
+bool FirstChars::collect(
+    const uint8_t *bytecode,
+    uint32_t ip,
+    SyntaxFlags flags,
+    unsigned depth) {
+  for (;;) {
+    const Insn *base = reinterpret_cast<const Insn *>(&bytecode[ip]);
+    switch (base->opcode) {
+      // Skip the instructions that match the empty string unconditionally.
+      case Opcode::BeginMarkedSubexpression:
+        ip += sizeof(BeginMarkedSubexpressionInsn);
+        break;
+      case Opcode::EndMarkedSubexpression:
+        ip += sizeof(EndMarkedSubexpressionInsn);
+        break;
+      case Opcode::Jump32:
+        ip = llvh::cast<Jump32Insn>(base)->target;
+        break;
+
+      case Opcode::MatchChar8: {
+        char c = llvh::cast<MatchChar8Insn>(base)->c;
+        return (unsigned char)c < 128 && add(c);
+      }
+      case Opcode::MatchChar16:
+        return add(llvh::cast<MatchChar16Insn>(base)->c);
+      case Opcode::MatchNChar8: {
+        char c = *reinterpret_cast<const char *>(
+            llvh::cast<MatchNChar8Insn>(base) + 1);
+        return (unsigned char)c < 128 && add(c);
+      }
+
+      case Opcode::Bracket: {
+        // Case insensitive brackets hold canonicalized ranges, which match
+        // more characters than they contain.
+        const auto *insn = llvh::cast<BracketInsn>(base);
+        if (flags.ignoreCase || insn->negate || insn->positiveCharClasses ||
+            insn->negativeCharClasses)
+          return false;
+        const auto *ranges = reinterpret_cast<const BracketRange32 *>(insn + 1);
+        for (uint32_t i = 0; i < insn->rangeCount; ++i) {
+          if (ranges[i].end - ranges[i].start >= kMaxScanChars ||
+              ranges[i].end > 0xFFFF)
+            return false;
+          for (uint32_t c = ranges[i].start; c <= ranges[i].end; ++c) {
+            if (!add(c))
+              return false;
+          }
+        }
+        return count_ != 0;
+      }
+
+      case Opcode::Alternation: {
+        const auto *insn = llvh::cast<AlternationInsn>(base);
+        return depth < kMaxAlternationDepth &&
+            collect(bytecode, ip + sizeof(AlternationInsn), flags, depth + 1) &&
+            collect(bytecode, insn->secondaryBranch, flags, depth + 1);
+      }
+
+      // A loop that must be entered begins with its body.
+      case Opcode::BeginLoop:
+        if (llvh::cast<BeginLoopInsn>(base)->min == 0)
+          return false;
+        ip += sizeof(BeginLoopInsn);
+        break;
+      case Opcode::Width1Loop:
+        if (llvh::cast<Width1LoopInsn>(base)->min == 0)
+          return false;
+        ip += sizeof(Width1LoopInsn);
+        break;
+
+      default:
+        return false;
+    }
+  }
+}
+
 /// A Context records global information about a match attempt.
 template <class Traits>
 struct Context {
@@ -400,6 +543,11 @@ struct Context {
   /// This is effectively a timeout on the regexp execution.
   uint32_t backtracksRemaining_ = kBacktrackLimit;
 
+  /// The code units that may begin a match, if they are known. A search only
+  /// attempts a match where the input has one of them.
+  CodeUnit firstChars_[kMaxScanChars];
+  uint8_t firstCharCount_ = 0;
+
   Context(
       llvh::ArrayRef<uint8_t> bytecodeStream,
       constants::MatchFlagType flags,
@@ -416,6 +564,23 @@ struct Context {
         markedCount_(markedCount),
         loopCount_(loopCount) {}
 
+  /// Search only at the code units of \p firstChars, if they can occur in the
+  /// input.
+  void setFirstChars(const FirstChars &firstChars) {
+    if (sizeof(CodeUnit) == 1 && !firstChars.allASCII())
+      return;
+    for (char16_t c : firstChars.chars())
+      firstChars_[firstCharCount_++] = (CodeUnit)c;
+  }
+
+  /// \return a pointer to the first position in [\p pos, last_) where a match
+  /// may begin, or last_ if there is none. \pre firstCharCount_ > 0.
+  const CodeUnit *findFirstChar(const CodeUnit *pos) const {
+    assert(firstCharCount_ && "First characters are not known");
+    return findFirstOf(
+        pos, last_, llvh::makeArrayRef(firstChars_, firstCharCount_));
+  }
+
   /// Run the given State \p state, by starting at its cursor and acting on its
   /// ip_ until the match succeeds or fails. If \p onlyAtStart is set, only
   /// test the match at \pos; otherwise test all successive input positions from
@@ -467,6 +632,9 @@ struct Context {
       BacktrackStack &bts);
 
  private:
+  /// The PikeVM shares the character matching of the backtracking matcher.
+  friend class PikeVM<Traits>;
+
   /// Do initialization of the given state before it enters the loop body
   /// described by the LoopInsn \p loop, including setting up any backtracking
   /// state.
@@ -567,9 +735,8 @@ bool isLineTerminator(CharT c) {
 }
 
 template <class Traits>
-bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesLeftAnchor(const Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atLeft()) {
     // Beginning of text.
     matchesAnchor = true;
@@ -583,9 +750,8 @@ bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
 }
 
 template <class Traits>
-bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesRightAnchor(const Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atRight() && !(ctx.flags_ & constants::matchNotEndOfLine)) {
     matchesAnchor = true;
   } else if (
@@ -596,6 +762,25 @@ bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
   return matchesAnchor;
 }
 
+/// \return whether the cursor \p c is at a word boundary, that is between a
+/// word character and a non-word character.
+template <class Traits>
+bool isWordBoundary(const Context<Traits> &ctx, const Cursor<Traits> &c) {
+  const auto *charPointer = c.currentPointer();
+
+  bool prevIsWordchar = false;
+  if (!c.atLeft())
+    prevIsWordchar =
+        ctx.traits_.characterHasType(charPointer[-1], CharacterClass::Words);
+
+  bool currentIsWordchar = false;
+  if (!c.atRight())
+    currentIsWordchar =
+        ctx.traits_.characterHasType(charPointer[0], CharacterClass::Words);
+
+  return prevIsWordchar != currentIsWordchar;
+}
+
 /// \return true if all chars, stored in contiguous memory after \p insn,
 /// match the chars in state \p s in the same order. Note the count of chars
 /// is given in \p insn.
@@ -990,6 +1175,9 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
       (c.forwards() || locsToCheckCount == 1) &&
       "Can only check one location when cursor is backwards");
 
+  // Skip the locations that cannot begin a match, if we know which can.
+  const bool scanFirstChars = !onlyAtStart && firstCharCount_ != 0;
+
   // Macro used when a state fails to match.
 #define BACKTRACK()                            \
   do {                                         \
@@ -1003,6 +1191,14 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
   for (size_t locIndex = 0; locIndex < locsToCheckCount;
        locIndex = advanceStringIndex(startLoc, locIndex, charsToRight)) {
+    if (scanFirstChars) {
+      // No surrogate begins a match, so the scan never stops in the middle
+      // of a surrogate pair, which advanceStringIndex would have skipped.
+      const CodeUnit *next = findFirstChar(startLoc + locIndex);
+      if (next == last_)
+        break;
+      locIndex = next - startLoc;
+    }
     const CodeUnit *potentialMatchLocation = startLoc + locIndex;
     c.setCurrentPointer(potentialMatchLocation);
     s->ip_ = startIp;
@@ -1014,13 +1210,13 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
           return potentialMatchLocation;
 
         case Opcode::LeftAnchor:
-          if (!matchesLeftAnchor(*this, *s))
+          if (!matchesLeftAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(LeftAnchorInsn);
           break;
 
         case Opcode::RightAnchor:
-          if (!matchesRightAnchor(*this, *s))
+          if (!matchesRightAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(RightAnchorInsn);
           break;
@@ -1179,20 +1375,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::WordBoundary: {
           const WordBoundaryInsn *insn = llvh::cast<WordBoundaryInsn>(base);
-          const auto *charPointer = c.currentPointer();
-
-          bool prevIsWordchar = false;
-          if (!c.atLeft())
-            prevIsWordchar = traits_.characterHasType(
-                charPointer[-1], CharacterClass::Words);
-
-          bool currentIsWordchar = false;
-          if (!c.atRight())
-            currentIsWordchar =
-                traits_.characterHasType(charPointer[0], CharacterClass::Words);
-
-          bool isWordBoundary = (prevIsWordchar != currentIsWordchar);
-          if (isWordBoundary ^ insn->invert)
+          if (isWordBoundary(*this, c) ^ insn->invert)
             s->ip_ += sizeof(WordBoundaryInsn);
           else
             BACKTRACK();
@@ -1501,6 +1684,663 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
   return nullptr;
 }
 
+//===----------------------------------------------------------------------===//
+// PikeVM
+//
+// The backtracking matcher above can take time exponential in the length of
+// the input, e.g. for /(a+)+b/ on a long run of 'a'. Regexes without
+// backreferences or lookarounds can instead be run by simulating all the paths
+// through the regex in lockstep, one input position at a time, as in Pike's
+// VM. Two paths that reach the same instruction at the same position have the
+// same future, so only the one with the higher priority is kept, and a search
+// takes time proportional to the length of the input times the size of the
+// regex. Keeping the paths in priority order yields the same match and capture
+// groups as the backtracking matcher.
+
+/// The number of backtracks per character of input the backtracking matcher
+/// may make on a regex that the PikeVM can run, before the search is handed
+/// over to the PikeVM. Most searches stay well below this, and are faster in
+/// the backtracking matcher.
+constexpr uint32_t kBacktracksPerCharBeforePikeVM = 64;
+
+/// The maximum number of instructions in a PikeVM program. Counted loops are
+/// unrolled into the program, so a regex like /a{1,100000}/ exceeds this and
+/// stays with the backtracking matcher.
+constexpr uint32_t kMaxPikeProgramSize = 1u << 14;
+
+/// \return the width of the instruction \p insn, including any data following
+/// it in the bytecode stream.
+static uint32_t instructionWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::Bracket:
+      return llvh::cast<BracketInsn>(insn)->totalWidth();
+    case Opcode::U16Bracket:
+      return llvh::cast<U16BracketInsn>(insn)->totalWidth();
+    case Opcode::MatchNChar8:
+      return llvh::cast<MatchNChar8Insn>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return llvh::cast<MatchNCharICase8Insn>(insn)->totalWidth();
+    default:
+      break;
+  }
+  switch (insn->opcode) {
+#define REOP(code)   \
+  case Opcode::code: \
+    return sizeof(code##Insn);
+#include "hermes/Regex/RegexOpcodes.def"
+  }
+  llvm_unreachable("Invalid opcode");
+}
+
+/// \return whether the PikeVM can run the regex \p bytecode. This requires
+/// that the regex has no backreferences or lookarounds, and that no loop body
+/// can match the empty string, since the PikeVM does not track where an
+/// iteration started.
+static bool pikeVMCanRun(llvh::ArrayRef<uint8_t> bytecode) {
+  for (uint32_t ip = sizeof(RegexBytecodeHeader); ip < bytecode.size();) {
+    const Insn *insn = reinterpret_cast<const Insn *>(&bytecode[ip]);
+    switch (insn->opcode) {
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+        return false;
+      case Opcode::BeginLoop:
+        if (!(llvh::cast<BeginLoopInsn>(insn)->loopeeConstraints &
+              MatchConstraintNonEmpty))
+          return false;
+        break;
+      default:
+        break;
+    }
+    ip += instructionWidth(insn);
+  }
+  return true;
+}
+
+/// \return whether the input [\p first, \p last) contains a surrogate pair.
+/// The PikeVM steps through the input one code unit at a time, so it cannot
+/// run a unicode regex on such input.
+template <typename CharT>
+static bool containsSurrogatePair(const CharT *first, const CharT *last) {
+  if (sizeof(CharT) == 1)
+    return false;
+  for (const CharT *p = first; p + 1 < last; ++p) {
+    if (isHighSurrogate(p[0]) && isLowSurrogate(p[1]))
+      return true;
+  }
+  return false;
+}
+
+/// An instruction of a PikeVM program. The program is built from the regex
+/// bytecode, with loops expanded into splits and jumps.
+struct PikeInsn {
+  enum class Op : uint8_t {
+    /// The regex matched.
+    Goal,
+    /// Consume a code unit that matches the regex instruction insn.
+    Consume,
+    /// Consume the code unit arg.
+    Char8,
+    /// Consume a code unit that is the code unit arg, ignoring case.
+    CharICase8,
+    /// Check the zero-width regex instruction insn: an anchor or a word
+    /// boundary.
+    Assert,
+    /// Continue at arg, and with lower priority at arg2.
+    Split,
+    /// Continue at arg.
+    Jump,
+    /// Store the current position in capture slot arg.
+    Save,
+    /// Clear the capture slots in [arg, arg2).
+    ResetCaptures,
+  };
+
+  Op op;
+  const Insn *insn;
+  uint32_t arg;
+  uint32_t arg2;
+};
+
+/// \return the capture slot of the start of capture group \p mexp. Slots 0 and
+/// 1 hold the start and end of the entire match.
+static uint32_t captureSlot(uint16_t mexp) {
+  return 2 + 2 * (uint32_t)mexp;
+}
+
+/// Builds a PikeVM program from regex bytecode.
+class PikeProgramBuilder {
+ public:
+  /// Build the program for \p bytecode, which must satisfy pikeVMCanRun, into
+  /// \p program. \return false if the program would be too large.
+  static bool build(
+      llvh::ArrayRef<uint8_t> bytecode,
+      std::vector<PikeInsn> &program) {
+    PikeProgramBuilder builder{bytecode, program};
+    return builder.translate(
+        0, bytecode.size() - sizeof(RegexBytecodeHeader));
+  }
+
+ private:
+  /// The instructions, following the header.
+  const uint8_t *const bytecode_;
+
+  /// The program being built.
+  std::vector<PikeInsn> &program_;
+
+  PikeProgramBuilder(
+      llvh::ArrayRef<uint8_t> bytecode,
+      std::vector<PikeInsn> &program)
+      : bytecode_(&bytecode[sizeof(RegexBytecodeHeader)]), program_(program) {}
+
+  /// Append \p insn to the program. \return its index.
+  uint32_t emit(PikeInsn insn) {
+    program_.push_back(insn);
+    return program_.size() - 1;
+  }
+
+  /// Translate the instructions of the bytecode in [begin, end). A range may
+  /// be translated several times, to unroll the body of a counted loop.
+  /// \return false if the program became too large.
+  bool translate(uint32_t begin, uint32_t end);
+
+  /// Translate a loop whose body is the bytecode in [bodyBegin, bodyEnd).
+  /// Each iteration clears the capture groups in [mexpBegin, mexpEnd).
+  bool translateLoop(
+      uint32_t bodyBegin,
+      uint32_t bodyEnd,
+      uint32_t min,
+      uint32_t max,
+      bool greedy,
+      uint16_t mexpBegin,
+      uint16_t mexpEnd);
+};
+
+bool PikeProgramBuilder::translate(uint32_t begin, uint32_t end) {
+  // Jumps within the range are forward and resolved once their target is
+  // reached. Each fixup is the field to set and the bytecode target.
+  llvh::SmallVector<std::pair<uint32_t *, uint32_t>, 4> fixups;
+  // Fields are referred to by index, since program_ may reallocate.
+  llvh::SmallVector<std::pair<uint32_t, bool>, 4> fixupFields;
+  auto addFixup = [&](uint32_t index, bool secondary, uint32_t target) {
+    fixups.push_back({nullptr, target});
+    fixupFields.push_back({index, secondary});
+  };
+  auto resolveFixups = [&](uint32_t ip) {
+    for (size_t i = 0; i < fixups.size();) {
+      if (fixups[i].second != ip) {
+        ++i;
+        continue;
+      }
+      PikeInsn &insn = program_[fixupFields[i].first];
+      (fixupFields[i].second ? insn.arg2 : insn.arg) = program_.size();
+      fixups.erase(fixups.begin() + i);
+      fixupFields.erase(fixupFields.begin() + i);
+    }
+  };
+
+  for (uint32_t ip = begin; ip < end;) {
+    resolveFixups(ip);
+    if (program_.size() > kMaxPikeProgramSize)
+      return false;
+    const Insn *base = reinterpret_cast<const Insn *>(&bytecode_[ip]);
+    switch (base->opcode) {
+      case Opcode::Goal:
+        emit({PikeInsn::Op::Goal, base, 0, 0});
+        break;
+
+      case Opcode::LeftAnchor:
+      case Opcode::RightAnchor:
+      case Opcode::WordBoundary:
+        emit({PikeInsn::Op::Assert, base, 0, 0});
+        break;
+
+      case Opcode::MatchAny:
+      case Opcode::U16MatchAny:
+      case Opcode::MatchAnyButNewline:
+      case Opcode::U16MatchAnyButNewline:
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::U16MatchChar32:
+      case Opcode::MatchCharICase8:
+      case Opcode::MatchCharICase16:
+      case Opcode::U16MatchCharICase32:
+      case Opcode::Bracket:
+      case Opcode::U16Bracket:
+        emit({PikeInsn::Op::Consume, base, 0, 0});
+        break;
+
+      case Opcode::MatchNChar8: {
+        const auto *insn = llvh::cast<MatchNChar8Insn>(base);
+        const char *chars = reinterpret_cast<const char *>(insn + 1);
+        for (uint32_t i = 0; i < insn->charCount; ++i)
+          emit({PikeInsn::Op::Char8, base, (uint32_t)chars[i], 0});
+        break;
+      }
+
+      case Opcode::MatchNCharICase8: {
+        const auto *insn = llvh::cast<MatchNCharICase8Insn>(base);
+        const char *chars = reinterpret_cast<const char *>(insn + 1);
+        for (uint32_t i = 0; i < insn->charCount; ++i)
+          emit({PikeInsn::Op::CharICase8, base, (uint32_t)chars[i], 0});
+        break;
+      }
+
+      case Opcode::Alternation: {
+        // The constraints of the branches only prune the search, so they can
+        // be ignored here.
+        const auto *insn = llvh::cast<AlternationInsn>(base);
+        uint32_t split = emit({PikeInsn::Op::Split, base, 0, 0});
+        program_[split].arg = split + 1;
+        addFixup(split, true, insn->secondaryBranch);
+        break;
+      }
+
+      case Opcode::Jump32:
+        addFixup(
+            emit({PikeInsn::Op::Jump, base, 0, 0}),
+            false,
+            llvh::cast<Jump32Insn>(base)->target);
+        break;
+
+      case Opcode::BeginMarkedSubexpression: {
+        const auto *insn = llvh::cast<BeginMarkedSubexpressionInsn>(base);
+        emit({PikeInsn::Op::Save, base, captureSlot(insn->mexp), 0});
+        break;
+      }
+
+      case Opcode::EndMarkedSubexpression: {
+        const auto *insn = llvh::cast<EndMarkedSubexpressionInsn>(base);
+        emit({PikeInsn::Op::Save, base, captureSlot(insn->mexp) + 1, 0});
+        break;
+      }
+
+      case Opcode::BeginLoop: {
+        const auto *loop = llvh::cast<BeginLoopInsn>(base);
+        if (!translateLoop(
+                ip + sizeof(BeginLoopInsn),
+                loop->notTakenTarget - sizeof(EndLoopInsn),
+                loop->min,
+                loop->max,
+                loop->greedy,
+                loop->mexpBegin,
+                loop->mexpEnd))
+          return false;
+        ip = loop->notTakenTarget;
+        continue;
+      }
+
+      case Opcode::BeginSimpleLoop: {
+        const auto *loop = llvh::cast<BeginSimpleLoopInsn>(base);
+        if (!translateLoop(
+                ip + sizeof(BeginSimpleLoopInsn),
+                loop->notTakenTarget - sizeof(EndSimpleLoopInsn),
+                0,
+                UINT32_MAX,
+                true,
+                0,
+                0))
+          return false;
+        ip = loop->notTakenTarget;
+        continue;
+      }
+
+      case Opcode::Width1Loop: {
+        const auto *loop = llvh::cast<Width1LoopInsn>(base);
+        if (!translateLoop(
+                ip + sizeof(Width1LoopInsn),
+                loop->notTakenTarget,
+                loop->min,
+                loop->max,
+                loop->greedy,
+                0,
+                0))
+          return false;
+        ip = loop->notTakenTarget;
+        continue;
+      }
+
+      case Opcode::EndLoop:
+      case Opcode::EndSimpleLoop:
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+        llvm_unreachable("Instruction not supported by the PikeVM");
+    }
+    ip += instructionWidth(base);
+  }
+  resolveFixups(end);
+  assert(fixups.empty() && "Jump out of the translated range");
+  return program_.size() <= kMaxPikeProgramSize;
+}
+
+bool PikeProgramBuilder::translateLoop(
+    uint32_t bodyBegin,
+    uint32_t bodyEnd,
+    uint32_t min,
+    uint32_t max,
+    bool greedy,
+    uint16_t mexpBegin,
+    uint16_t mexpEnd) {
+  auto translateBody = [&]() {
+    if (mexpBegin != mexpEnd) {
+      emit(
+          {PikeInsn::Op::ResetCaptures,
+           nullptr,
+           captureSlot(mexpBegin),
+           captureSlot(mexpEnd)});
+    }
+    return translate(bodyBegin, bodyEnd);
+  };
+  // Point a split before an optional iteration at the iteration and at \p
+  // exit, in the order given by greediness.
+  auto setSplit = [&](uint32_t split, uint32_t exit) {
+    program_[split].arg = greedy ? split + 1 : exit;
+    program_[split].arg2 = greedy ? exit : split + 1;
+  };
+
+  for (uint32_t i = 0; i < min; ++i) {
+    if (!translateBody())
+      return false;
+  }
+  if (max == UINT32_MAX) {
+    uint32_t split = emit({PikeInsn::Op::Split, nullptr, 0, 0});
+    if (!translateBody())
+      return false;
+    emit({PikeInsn::Op::Jump, nullptr, split, 0});
+    setSplit(split, program_.size());
+    return true;
+  }
+  // Nest the optional iterations, so that each is tried only after the
+  // previous one.
+  llvh::SmallVector<uint32_t, 4> splits;
+  for (uint32_t i = min; i < max; ++i) {
+    splits.push_back(emit({PikeInsn::Op::Split, nullptr, 0, 0}));
+    if (!translateBody())
+      return false;
+  }
+  for (uint32_t split : splits)
+    setSplit(split, program_.size());
+  return true;
+}
+
+/// Runs a PikeVM program over the input of a Context.
+template <class Traits>
+class PikeVM {
+  using CodeUnit = typename Traits::CodeUnit;
+  using CodePoint = typename Traits::CodePoint;
+
+ public:
+  PikeVM(
+      const Context<Traits> &ctx,
+      llvh::ArrayRef<PikeInsn> program,
+      uint32_t markedCount)
+      : ctx_(ctx),
+        program_(program),
+        numSlots_(captureSlot(markedCount)),
+        addedAt_(program.size(), 0),
+        slots_(numSlots_, kNotMatched) {}
+
+  /// Search for a match starting at \p start, or at or after it unless \p
+  /// onlyAtStart is set. \return whether a match was found, in which case
+  /// \p captures holds the match followed by the capture groups.
+  bool search(
+      const CodeUnit *start,
+      bool onlyAtStart,
+      std::vector<CapturedRange> &captures);
+
+ private:
+  /// The threads at an input position, in priority order.
+  struct ThreadList {
+    /// The instruction each thread is at.
+    std::vector<uint32_t> pcs;
+    /// The capture slots of each thread, numSlots_ per thread.
+    std::vector<uint32_t> slots;
+
+    bool empty() const {
+      return pcs.empty();
+    }
+    void clear() {
+      pcs.clear();
+      slots.clear();
+    }
+  };
+
+  /// The marker for work items that restore a capture slot.
+  static constexpr uint32_t kRestoreSlot = UINT32_MAX;
+
+  /// A work item of addThread: either an instruction to follow, or a capture
+  /// slot to restore once the instructions following its change are done.
+  struct Work {
+    uint32_t pc;
+    uint32_t slot;
+    uint32_t value;
+  };
+
+  const Context<Traits> &ctx_;
+  llvh::ArrayRef<PikeInsn> program_;
+
+  /// Number of capture slots of a thread.
+  const uint32_t numSlots_;
+
+  /// The generation in which each instruction was last added to a list. Each
+  /// instruction is added at most once per input position.
+  std::vector<uint32_t> addedAt_;
+  uint32_t generation_ = 0;
+
+  /// The capture slots of the thread being added.
+  std::vector<uint32_t> slots_;
+
+  /// The work list of addThread.
+  std::vector<Work> work_;
+
+  /// Add the thread at \p pc with capture slots slots_ to \p list, following
+  /// the instructions that do not consume input at position \p pos, in
+  /// priority order.
+  void addThread(ThreadList &list, uint32_t pc, const CodeUnit *pos);
+
+  /// \return whether the zero-width instruction \p insn holds at \p pos.
+  bool assertionHolds(const Insn *insn, const CodeUnit *pos) const;
+
+  /// \return whether the consuming instruction \p insn matches \p c.
+  bool consumes(const PikeInsn &insn, CodeUnit c) const;
+};
+
+template <class Traits>
+void PikeVM<Traits>::addThread(
+    ThreadList &list,
+    uint32_t pc,
+    const CodeUnit *pos) {
+  const uint32_t offset = pos - ctx_.first_;
+  work_.push_back({pc, 0, 0});
+  while (!work_.empty()) {
+    Work item = work_.back();
+    work_.pop_back();
+    if (item.pc == kRestoreSlot) {
+      slots_[item.slot] = item.value;
+      continue;
+    }
+    if (addedAt_[item.pc] == generation_)
+      continue;
+    addedAt_[item.pc] = generation_;
+
+    const PikeInsn &insn = program_[item.pc];
+    switch (insn.op) {
+      case PikeInsn::Op::Goal:
+      case PikeInsn::Op::Consume:
+      case PikeInsn::Op::Char8:
+      case PikeInsn::Op::CharICase8:
+        list.pcs.push_back(item.pc);
+        list.slots.insert(list.slots.end(), slots_.begin(), slots_.end());
+        break;
+
+      case PikeInsn::Op::Assert:
+        if (assertionHolds(insn.insn, pos))
+          work_.push_back({item.pc + 1, 0, 0});
+        break;
+
+      case PikeInsn::Op::Split:
+        // Follow arg first, so push it last.
+        work_.push_back({insn.arg2, 0, 0});
+        work_.push_back({insn.arg, 0, 0});
+        break;
+
+      case PikeInsn::Op::Jump:
+        work_.push_back({insn.arg, 0, 0});
+        break;
+
+      case PikeInsn::Op::Save:
+        work_.push_back({kRestoreSlot, insn.arg, slots_[insn.arg]});
+        slots_[insn.arg] = offset;
+        work_.push_back({item.pc + 1, 0, 0});
+        break;
+
+      case PikeInsn::Op::ResetCaptures:
+        for (uint32_t slot = insn.arg; slot < insn.arg2; ++slot) {
+          work_.push_back({kRestoreSlot, slot, slots_[slot]});
+          slots_[slot] = kNotMatched;
+        }
+        work_.push_back({item.pc + 1, 0, 0});
+        break;
+    }
+  }
+}
+
+template <class Traits>
+bool PikeVM<Traits>::assertionHolds(const Insn *insn, const CodeUnit *pos)
+    const {
+  Cursor<Traits> c{ctx_.first_, pos, ctx_.last_, true /* forwards */};
+  switch (insn->opcode) {
+    case Opcode::LeftAnchor:
+      return matchesLeftAnchor(ctx_, c);
+    case Opcode::RightAnchor:
+      return matchesRightAnchor(ctx_, c);
+    case Opcode::WordBoundary:
+      return isWordBoundary(ctx_, c) ^
+          llvh::cast<WordBoundaryInsn>(insn)->invert;
+    default:
+      llvm_unreachable("Not an assertion");
+  }
+}
+
+template <class Traits>
+bool PikeVM<Traits>::consumes(const PikeInsn &insn, CodeUnit c) const {
+  using W1 = Width1Opcode;
+  const Insn *base = insn.insn;
+  // The PikeVM does not run unicode regexes on input with surrogate pairs,
+  // so every code unit is a code point.
+  CodePoint cp = c;
+  switch (insn.op) {
+    case PikeInsn::Op::Char8:
+      return c == (char)insn.arg;
+    case PikeInsn::Op::CharICase8:
+      return c == (char)insn.arg ||
+          (char32_t)ctx_.traits_.canonicalize(c, ctx_.syntaxFlags_.unicode) ==
+          (char32_t)(char)insn.arg;
+    case PikeInsn::Op::Consume:
+      break;
+    default:
+      llvm_unreachable("Not a consuming instruction");
+  }
+  switch (base->opcode) {
+    case Opcode::MatchChar8:
+      return ctx_.template matchWidth1<W1::MatchChar8>(base, c);
+    case Opcode::MatchChar16:
+      return ctx_.template matchWidth1<W1::MatchChar16>(base, c);
+    case Opcode::MatchCharICase8:
+      return ctx_.template matchWidth1<W1::MatchCharICase8>(base, c);
+    case Opcode::MatchCharICase16:
+      return ctx_.template matchWidth1<W1::MatchCharICase16>(base, c);
+    case Opcode::MatchAny:
+      return ctx_.template matchWidth1<W1::MatchAny>(base, c);
+    case Opcode::MatchAnyButNewline:
+      return ctx_.template matchWidth1<W1::MatchAnyButNewline>(base, c);
+    case Opcode::Bracket:
+      return ctx_.template matchWidth1<W1::Bracket>(base, c);
+    case Opcode::U16MatchAny:
+      return true;
+    case Opcode::U16MatchAnyButNewline:
+      return !isLineTerminator(cp);
+    case Opcode::U16MatchChar32:
+      return cp == (CodePoint)llvh::cast<U16MatchChar32Insn>(base)->c;
+    case Opcode::U16MatchCharICase32: {
+      CodePoint target = llvh::cast<U16MatchCharICase32Insn>(base)->c;
+      return cp == target || ctx_.traits_.canonicalize(cp, true) == target;
+    }
+    case Opcode::U16Bracket: {
+      const auto *bracket = llvh::cast<U16BracketInsn>(base);
+      const auto *ranges =
+          reinterpret_cast<const BracketRange32 *>(bracket + 1);
+      return bracketMatchesChar<Traits>(ctx_, bracket, ranges, cp);
+    }
+    default:
+      llvm_unreachable("Not a consuming instruction");
+  }
+}
+
+template <class Traits>
+bool PikeVM<Traits>::search(
+    const CodeUnit *start,
+    bool onlyAtStart,
+    std::vector<CapturedRange> &captures) {
+  const CodeUnit *const first = ctx_.first_;
+  const CodeUnit *const last = ctx_.last_;
+  ThreadList clist, nlist;
+  std::vector<uint32_t> matchSlots;
+
+  // The next position at which to start a match attempt, or nullptr if there
+  // is none. Attempts start at lower priority than the attempts before them.
+  const CodeUnit *nextStart = start;
+  ++generation_;
+  for (const CodeUnit *pos = start;; ++pos) {
+    if (clist.empty() && matchSlots.empty() && nextStart && !onlyAtStart &&
+        ctx_.firstCharCount_) {
+      // No attempt is in progress; skip to the next position where one can
+      // succeed.
+      nextStart = ctx_.findFirstChar(nextStart);
+      if (nextStart == last)
+        break;
+      pos = nextStart;
+    }
+    if (matchSlots.empty() && pos == nextStart) {
+      std::fill(slots_.begin(), slots_.end(), kNotMatched);
+      slots_[0] = pos - first;
+      addThread(clist, 0, pos);
+      nextStart = onlyAtStart || pos == last ? nullptr
+                                             : first +
+              ctx_.advanceStringIndex(first, pos - first, last - first);
+    }
+    if (clist.empty() && (!matchSlots.empty() || !nextStart))
+      break;
+
+    ++generation_;
+    nlist.clear();
+    for (size_t i = 0, e = clist.pcs.size(); i < e; ++i) {
+      const PikeInsn &insn = program_[clist.pcs[i]];
+      const uint32_t *threadSlots = &clist.slots[i * numSlots_];
+      if (insn.op == PikeInsn::Op::Goal) {
+        // This thread matched. The threads after it have lower priority, drop
+        // them; the threads before it may still find a match they prefer.
+        matchSlots.assign(threadSlots, threadSlots + numSlots_);
+        matchSlots[1] = pos - first;
+        break;
+      }
+      if (pos != last && consumes(insn, *pos)) {
+        std::copy_n(threadSlots, numSlots_, slots_.begin());
+        addThread(nlist, clist.pcs[i] + 1, pos + 1);
+      }
+    }
+    std::swap(clist, nlist);
+    if (pos == last)
+      break;
+  }
+
+  if (matchSlots.empty())
+    return false;
+  captures.clear();
+  for (uint32_t slot = 0; slot < numSlots_; slot += 2)
+    captures.push_back(CapturedRange{matchSlots[slot], matchSlots[slot + 1]});
+  return true;
+}
+
 /// Entry point for searching a string via regex compiled bytecode.
 /// Given the bytecode \p bytecode, search the range starting at \p first up to
 /// (not including) \p last with the flags \p matchFlags. If the search
@@ -1536,6 +2376,7 @@ MatchRuntimeResult searchWithBytecodeImpl(
       first + length,
       header->markedCount,
       header->loopCount);
+  ctx.setFirstChars(FirstChars::compute(bytecode));
   State<Traits> state{cursor, markedCount, loopCount};
 
   // We check only one location if either the regex pattern constrains us to, or
@@ -1543,7 +2384,36 @@ MatchRuntimeResult searchWithBytecodeImpl(
   bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
       (matchFlags & constants::matchOnlyAtStart);
 
+  // If the PikeVM can run this regex, give the backtracking matcher a budget
+  // proportional to the input, and hand the search over to the PikeVM once the
+  // budget is exhausted.
+  const bool pikeVMFallback = pikeVMCanRun(bytecode);
+  if (pikeVMFallback) {
+    ctx.backtracksRemaining_ = (uint32_t)std::min<uint64_t>(
+        kBacktrackLimit,
+        (uint64_t)kBacktracksPerCharBeforePikeVM * (length - start + 1));
+  }
+
   auto res = ctx.match(&state, onlyAtStart);
+  if (!res && pikeVMFallback) {
+    std::vector<PikeInsn> program;
+    if (!(ctx.syntaxFlags_.unicode &&
+          containsSurrogatePair(first + start, first + length)) &&
+        PikeProgramBuilder::build(bytecode, program)) {
+      PikeVM<Traits> pikeVM{ctx, program, markedCount};
+      std::vector<CapturedRange> captures;
+      if (!pikeVM.search(first + start, onlyAtStart, captures))
+        return MatchRuntimeResult::NoMatch;
+      if (m != nullptr)
+        *m = std::move(captures);
+      return MatchRuntimeResult::Match;
+    }
+    // The PikeVM cannot run this search; retry with the full backtracking
+    // budget.
+    ctx.backtracksRemaining_ = kBacktrackLimit;
+    state = State<Traits>{cursor, markedCount, loopCount};
+    res = ctx.match(&state, onlyAtStart);
+  }
   if (!res) {
     assert(res.getStatus() == ExecutionStatus::STACK_OVERFLOW);
     return MatchRuntimeResult::StackOverflow;
@@ -183,6 +183,8 @@ bool vm_protect(void *p, size_t sz, ProtectMode mode) {
   auto prot = PROT_NONE;
   if (mode == ProtectMode::ReadWrite) {
     prot = PROT_WRITE | PROT_READ;
+  } else if (mode == ProtectMode::ReadExecute) {
+    prot = PROT_READ | PROT_EXEC;
   }
   int err = mprotect(p, sz, prot);
   return err != -1;
@@ -198,6 +200,15 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return true;
 }
 
+llvh::ErrorOr<void *> vm_map_file(const char *path, size_t &sz) {
+  // Not implemented.
+  return std::error_code(ENOSYS, std::generic_category());
+}
+
+void vm_unmap_file(void *p, size_t sz) {
+  // Nothing is ever mapped by vm_map_file.
+}
+
 llvh::ErrorOr<size_t> vm_footprint(char *start, char *end) {
   return std::error_code(errno, std::generic_category());
 }
@@ -15,9 +15,11 @@
 #include <fstream>
 #include <vector>
 
+#include <fcntl.h>
 #include <signal.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 
 #if defined(__linux__)
 #if !defined(RUSAGE_THREAD)
@@ -305,6 +307,8 @@ bool vm_protect(void *p, size_t sz, ProtectMode mode) {
   auto prot = PROT_NONE;
   if (mode == ProtectMode::ReadWrite) {
     prot = PROT_WRITE | PROT_READ;
+  } else if (mode == ProtectMode::ReadExecute) {
+    prot = PROT_READ | PROT_EXEC;
   }
   int err = mprotect(p, sz, prot);
   return err != -1;
@@ -330,6 +334,39 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return madvise(p, sz, param) == 0;
 }
 
+llvh::ErrorOr<void *> vm_map_file(const char *path, size_t &sz) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return std::error_code(errno, std::generic_category());
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int err = errno;
+    close(fd);
+    return std::error_code(err, std::generic_category());
+  }
+  // Empty files and pipes cannot be mapped.
+  if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return std::error_code(EINVAL, std::generic_category());
+  }
+
+  void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int err = errno;
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  if (p == MAP_FAILED)
+    return std::error_code(err, std::generic_category());
+  sz = st.st_size;
+  return p;
+}
+
+void vm_unmap_file(void *p, size_t sz) {
+  auto ret = munmap(p, sz);
+  assert(!ret && "Failed to unmap file");
+  (void)ret;
+}
+
 llvh::ErrorOr<size_t> vm_footprint(char *start, char *end) {
 #ifdef __MACH__
   const task_t self = mach_task_self();
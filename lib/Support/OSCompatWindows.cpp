@@ -332,6 +332,8 @@ bool vm_protect(void *p, size_t sz, ProtectMode mode) {
   DWORD newProtect = PAGE_NOACCESS;
   if (mode == ProtectMode::ReadWrite) {
     newProtect = PAGE_READWRITE;
+  } else if (mode == ProtectMode::ReadExecute) {
+    newProtect = PAGE_EXECUTE_READ;
   }
   BOOL err = VirtualProtect(p, sz, newProtect, &oldProtect);
   return err != 0;
@@ -342,6 +344,15 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return false;
 }
 
+llvh::ErrorOr<void *> vm_map_file(const char *path, size_t &sz) {
+  // Not implemented.
+  return std::error_code(ENOSYS, std::generic_category());
+}
+
+void vm_unmap_file(void *p, size_t sz) {
+  // Nothing is ever mapped by vm_map_file.
+}
+
 llvh::ErrorOr<size_t> vm_footprint(char *start, char *end) {
   return std::error_code(errno, std::generic_category());
 }
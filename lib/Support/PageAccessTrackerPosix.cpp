@@ -168,6 +168,8 @@ void PageAccessTracker::printStats(llvh::raw_ostream &OS) {
      << "\n";
   OS << "number of pages accessed during execution: " << accessedPageCount_
      << "\n";
+  OS << "number of pages accessed during startup: "
+     << startupPageCount_.getValueOr(accessedPageCount_) << "\n";
   printPageAccessedOrder(OS);
 }
 
@@ -181,6 +183,9 @@ void PageAccessTracker::getJSONStats(JSONEmitter &json) {
   json.emitKeyValue("page_size", pageSize_);
   json.emitKeyValue("total_pages", totalPages_);
   json.emitKeyValue("accessed_pages", accessedPageCount_);
+  json.emitKeyValue(
+      "startup_accessed_pages",
+      startupPageCount_.getValueOr(accessedPageCount_));
   json.emitKey("page_ids");
   json.openArray();
   for (unsigned i = 0; i < accessedPageCount_; ++i) {
@@ -250,6 +255,13 @@ void PageAccessTracker::getJSONStats(JSONEmitter &json) volatile {
   tracker->install();
 }
 
+void PageAccessTracker::markStartupComplete() volatile {
+  auto tracker = uninstall();
+  if (!tracker->startupPageCount_)
+    tracker->startupPageCount_ = tracker->accessedPageCount_;
+  tracker->install();
+}
+
 bool PageAccessTracker::printPageAccessedOrder(
     llvh::raw_ostream &OS,
     bool json) volatile {
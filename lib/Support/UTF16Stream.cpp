@@ -9,6 +9,10 @@
 
 #include <cstdlib>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "llvh/ADT/ArrayRef.h"
 #include "llvh/Support/ConvertUTF.h"
 #include "llvh/Support/MathExtras.h"
@@ -96,6 +100,22 @@ bool UTF16Stream::refill() {
   {
     int len = std::min(end_ - cur_, utf8End_ - utf8Begin_);
     int index = 0;
+#ifdef __SSE2__
+    // Widen 16 bytes at a time while none of them has the top bit set.
+    for (; index + 16 <= len; index += 16) {
+      __m128i bytes = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(utf8Begin_ + index));
+      if (_mm_movemask_epi8(bytes))
+        break;
+      __m128i zero = _mm_setzero_si128();
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(out + index),
+          _mm_unpacklo_epi8(bytes, zero));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(out + index + 8),
+          _mm_unpackhi_epi8(bytes, zero));
+    }
+#endif
     while (index < len && utf8Begin_[index] < 128) {
       out[index] = utf8Begin_[index];
       ++index;
@@ -381,6 +381,35 @@ void CodeBlock::markCachedHiddenClasses(
     if (prop.clazz) {
       acceptor.acceptWeak(prop.clazz);
     }
+    for (auto &polyClazz : prop.polyClazz) {
+      if (polyClazz) {
+        acceptor.acceptWeak(polyClazz);
+      }
+    }
+    if (prop.protoClazz) {
+      acceptor.acceptWeak(prop.protoClazz);
+      acceptor.acceptWeak(prop.protoParent);
+      acceptor.acceptWeak(prop.protoHolder);
+      // The prototype chain entry is only usable if all of it survived.
+      if (!prop.protoClazz || !prop.protoParent || !prop.protoHolder) {
+        prop.protoClazz = CompressedPointer(nullptr);
+        prop.protoParent = CompressedPointer(nullptr);
+        prop.protoHolder = CompressedPointer(nullptr);
+      }
+    }
+  }
+}
+
+AllocationSite &CodeBlock::addAllocationSite(uint32_t offset) {
+  if (allocationSites_.empty())
+    runtimeModule_->addAllocationSiteCodeBlock(this);
+  return allocationSites_[offset];
+}
+
+void CodeBlock::markAllocationSites(WeakRootAcceptor &acceptor) {
+  for (auto &entry : allocationSites_) {
+    if (entry.second.lastObject)
+      acceptor.acceptWeak(entry.second.lastObject);
   }
 }
 
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/DoubleStorage.h"
+
+#include "hermes/VM/BuildMetadata.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+const VTable DoubleStorage::vt(
+    CellKind::DoubleStorageKind,
+    0,
+    nullptr,
+    nullptr,
+    nullptr,
+    _trimSizeCallback
+#ifdef HERMES_MEMORY_INSTRUMENTATION
+    ,
+    VTable::HeapSnapshotMetadata {
+      HeapSnapshot::NodeType::Array, nullptr, nullptr, nullptr, nullptr
+    }
+#endif
+);
+
+void DoubleStorageBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  mb.setVTable(&DoubleStorage::vt);
+}
+
+CallResult<PseudoHandle<DoubleStorage>>
+DoubleStorage::create(Runtime &runtime, size_type capacity, size_type size) {
+  assert(size <= capacity && "size must not exceed the capacity");
+  if (LLVM_UNLIKELY(capacity > maxElements())) {
+    return runtime.raiseRangeError(
+        TwineChar16("Requested an array size larger than the max allowable: ") +
+        "Requested elements = " + capacity +
+        ", max elements = " + maxElements());
+  }
+  auto *self = runtime.makeAVariable<DoubleStorage>(allocationSize(capacity));
+  resizeWithinCapacity(self, size);
+  return createPseudoHandle(self);
+}
+
+void DoubleStorage::resizeWithinCapacity(
+    DoubleStorage *self,
+    size_type newSize) {
+  assert(
+      newSize <= self->capacity() &&
+      "newSize must be <= capacity in resizeWithinCapacity()");
+  if (newSize > self->size_)
+    std::fill(self->data() + self->size_, self->data() + newSize, hole());
+  self->size_ = newSize;
+}
+
+ExecutionStatus DoubleStorage::shift(
+    MutableHandle<DoubleStorage> &selfHandle,
+    Runtime &runtime,
+    size_type fromFirst,
+    size_type toFirst,
+    size_type toLast) {
+  assert(toFirst <= toLast && "First must be before last");
+  assert(fromFirst <= selfHandle->size() && "fromFirst must be before size");
+
+  size_type copySize =
+      std::min(selfHandle->size() - fromFirst, toLast - toFirst);
+
+  DoubleStorage *dest = selfHandle.get();
+  if (toLast > selfHandle->capacity()) {
+    // Grow geometrically, like ArrayStorage.
+    size_type capacity = selfHandle->capacity();
+    if (LLVM_UNLIKELY(toLast > maxElements())) {
+      capacity = toLast;
+    } else if (capacity < maxElements() / 2) {
+      capacity = std::max(capacity * 2, toLast);
+    } else {
+      capacity = maxElements();
+    }
+    auto newRes = create(runtime, capacity);
+    if (LLVM_UNLIKELY(newRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    dest = newRes->get();
+  }
+
+  // The elements are plain doubles, so they can be moved with memmove, and
+  // holes need no write barriers.
+  const double *src = selfHandle->data() + fromFirst;
+  std::memmove(dest->data() + toFirst, src, copySize * sizeof(double));
+  std::fill(dest->data(), dest->data() + toFirst, hole());
+  std::fill(dest->data() + toFirst + copySize, dest->data() + toLast, hole());
+  dest->size_ = toLast;
+  selfHandle = dest;
+  return ExecutionStatus::RETURNED;
+}
+
+gcheapsize_t DoubleStorage::_trimSizeCallback(const GCCell *cell) {
+  const auto *self = reinterpret_cast<const DoubleStorage *>(cell);
+  return allocationSize(self->size());
+}
+
+} // namespace vm
+} // namespace hermes
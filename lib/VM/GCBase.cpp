@@ -22,6 +22,7 @@
 #include "llvh/Support/Debug.h"
 #include "llvh/Support/FileSystem.h"
 #include "llvh/Support/Format.h"
+#include "llvh/Support/MathExtras.h"
 #include "llvh/Support/raw_os_ostream.h"
 #include "llvh/Support/raw_ostream.h"
 
@@ -816,6 +817,8 @@ void GCBase::printStats(JSONEmitter &json) {
   json.emitKeyValue("peakLiveAfterGC", formatSize(getPeakLiveAfterGC()).bytes);
   json.emitKeyValue(
       "totalAllocatedBytes", formatSize(info.totalAllocatedBytes).bytes);
+  json.emitKey("gcPauseHistogram");
+  printPauseHistogram(json, cumStats_);
   json.closeDict();
 
   json.emitKey("collections");
@@ -841,20 +844,53 @@ void GCBase::printStats(JSONEmitter &json) {
       json.emitValue(tag);
     }
     json.closeArray();
+    if (!event.markedBytesPerWorker.empty()) {
+      json.emitKey("markedBytesPerWorker");
+      json.openArray();
+      json.emitValues(llvh::makeArrayRef(event.markedBytesPerWorker));
+      json.closeArray();
+      json.emitKey("stealsPerWorker");
+      json.openArray();
+      json.emitValues(llvh::makeArrayRef(event.stealsPerWorker));
+      json.closeArray();
+    }
     json.closeDict();
   }
   json.closeArray();
 }
 
+/* static */
+void GCBase::printPauseHistogram(
+    JSONEmitter &json,
+    const CumulativeHeapStats &stats) {
+  json.openDict();
+  for (size_t i = 0; i < CumulativeHeapStats::kNumPauseBuckets; ++i) {
+    const unsigned lo = i ? 1u << (i - 1) : 0;
+    std::string key = i + 1 < CumulativeHeapStats::kNumPauseBuckets
+        ? std::to_string(lo) + "-" + std::to_string(1u << i) + "ms"
+        : std::to_string(lo) + "ms+";
+    json.emitKeyValue(key, stats.pauseHistogram[i]);
+  }
+  json.closeDict();
+}
+
 void GCBase::recordGCStats(
     const GCAnalyticsEvent &event,
     CumulativeHeapStats *stats,
     bool onMutator) {
   // Hades OG collections do not block the mutator, and so do not contribute to
   // the max pause time or the total execution time.
-  if (onMutator)
+  if (onMutator) {
     stats->gcWallTime.record(
         std::chrono::duration<double>(event.duration).count());
+    const auto pauseMs = event.duration.count();
+    const size_t bucket = pauseMs < 1
+        ? 0
+        : std::min<size_t>(
+              llvh::Log2_64(pauseMs) + 1,
+              CumulativeHeapStats::kNumPauseBuckets - 1);
+    stats->pauseHistogram[bucket]++;
+  }
   stats->gcCPUTime.record(
       std::chrono::duration<double>(event.cpuDuration).count());
   stats->finalHeapSize = event.size.after;
@@ -57,8 +57,11 @@ HERMES_SLOW_STATISTIC(
     NumGetByIdProtoHits,
     "NumGetByIdProtoHits: Number of property 'read by id' cache hits for the prototype");
 HERMES_SLOW_STATISTIC(
-    NumGetByIdCacheEvicts,
-    "NumGetByIdCacheEvicts: Number of property 'read by id' cache evictions");
+    NumGetByIdPolyHits,
+    "NumGetByIdPolyHits: Number of property 'read by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdMegamorphic,
+    "NumGetByIdMegamorphic: Number of property 'read by id' cache fills skipped at megamorphic sites");
 HERMES_SLOW_STATISTIC(
     NumGetByIdFastPaths,
     "NumGetByIdFastPaths: Number of property 'read by id' fast paths");
@@ -88,8 +91,11 @@ HERMES_SLOW_STATISTIC(
     NumPutByIdCacheHits,
     "NumPutByIdCacheHits: Number of property 'write by id' cache hits");
 HERMES_SLOW_STATISTIC(
-    NumPutByIdCacheEvicts,
-    "NumPutByIdCacheEvicts: Number of property 'write by id' cache evictions");
+    NumPutByIdPolyHits,
+    "NumPutByIdPolyHits: Number of property 'write by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdMegamorphic,
+    "NumPutByIdMegamorphic: Number of property 'write by id' cache fills skipped at megamorphic sites");
 HERMES_SLOW_STATISTIC(
     NumPutByIdFastPaths,
     "NumPutByIdFastPaths: Number of property 'write by id' fast paths");
@@ -555,13 +561,16 @@ CallResult<PseudoHandle<>> Interpreter::createObjectFromBuffer(
     CodeBlock *curCodeBlock,
     unsigned numLiterals,
     unsigned keyBufferIndex,
-    unsigned valBufferIndex) {
+    unsigned valBufferIndex,
+    AllocationSite &site) {
   // Create a new object using the built-in constructor or cached hidden class.
   // Note that the built-in constructor is empty, so we don't actually need to
   // call it.
   auto clazz = getHiddenClassForBuffer(
       runtime, curCodeBlock, numLiterals, keyBufferIndex);
-  auto obj = runtime.makeHandle(JSObject::create(runtime, clazz));
+  auto obj = runtime.makeHandle(JSObject::create(
+      runtime, clazz, JSObject::sampleAllocationSite(runtime, site)));
+  site.lastObject.set(runtime, *obj);
 
   auto valGen =
       curCodeBlock->getObjectBufferValueIter(valBufferIndex, numLiterals);
@@ -621,24 +630,56 @@ CallResult<PseudoHandle<>> Interpreter::createObjectFromBuffer(
   return createPseudoHandle(HermesValue::encodeObjectValue(*obj));
 }
 
+void Interpreter::applyAllocationSite(
+    Runtime &runtime,
+    CodeBlock *curCodeBlock,
+    const inst::Inst *ip,
+    Handle<JSObject> obj) {
+  AllocationSite &site =
+      curCodeBlock->getAllocationSite(curCodeBlock->getOffsetOf(ip));
+  JSObject::reservePropStorage(
+      obj, runtime, JSObject::sampleAllocationSite(runtime, site));
+  site.lastObject.set(runtime, *obj);
+}
+
 CallResult<PseudoHandle<>> Interpreter::createArrayFromBuffer(
     Runtime &runtime,
     CodeBlock *curCodeBlock,
     unsigned numElements,
     unsigned numLiterals,
     unsigned bufferIndex) {
+  // Arrays of number literals get double elements. The scan stops at the
+  // first literal that is not a number.
+  bool allNumbers = true;
+  for (auto scan = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
+       allNumbers && scan.hasNext();) {
+    allNumbers = scan.get(runtime).isNumber();
+  }
+
   // Create a new array using the built-in constructor, and initialize
   // the elements from a literal array buffer.
-  auto arrRes = JSArray::create(runtime, numElements, numElements);
+  auto arrRes = allNumbers
+      ? JSArray::createWithDoubleElements(runtime, numElements)
+      : JSArray::create(runtime, numElements, numElements);
   if (arrRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
   // Resize the array storage in advance.
   auto arr = *arrRes;
-  JSArray::setStorageEndIndex(arr, runtime, numElements);
+  if (LLVM_UNLIKELY(
+          JSArray::setStorageEndIndex(arr, runtime, numElements) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
 
   auto iter = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
   JSArray::size_type i = 0;
+  if (arr->hasDoubleElements()) {
+    DoubleStorage *storage = arr->getDoubleStorage(runtime);
+    while (iter.hasNext())
+      storage->set(i++, iter.get(runtime).getNumber());
+    return createPseudoHandle(HermesValue::encodeObjectValue(*arr));
+  }
   while (iter.hasNext()) {
     // NOTE: we must get the value in a separate step to guarantee ordering.
     const auto value =
@@ -1047,6 +1088,11 @@ tailCall:
 
   INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
 
+#ifdef HERMESVM_JIT
+  if (!SingleStep && runtime.jitContext_.compile(runtime, curCodeBlock))
+    goto runJIT;
+#endif
+
 #define BEFORE_OP_CODE                                                       \
   {                                                                          \
     UPDATE_OPCODE_TIME_SPENT;                                                \
@@ -1604,6 +1650,10 @@ tailCall:
                  << DumpHermesValue(O1REG(Call)) << "\n");
       gcScope.flushToSmallCount(KEEP_HANDLES);
       ip = nextIP;
+#ifdef HERMESVM_JIT
+      if (curCodeBlock->getJITCompiled())
+        goto runJIT;
+#endif
       DISPATCH;
     }
 
@@ -1771,6 +1821,11 @@ tailCall:
         INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
         O1REG(Call) = res.getValue();
         ip = nextInstCall(ip);
+#ifdef HERMESVM_JIT
+        // Resume in compiled code if the caller has been compiled.
+        if (curCodeBlock->getJITCompiled())
+          goto runJIT;
+#endif
         DISPATCH;
       }
 
@@ -2214,10 +2269,8 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime.makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              cacheEntry->clazz.get(runtime, runtime.getHeap())));
           CAPTURE_IP(runtime.recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheEntry));
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2243,6 +2296,39 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        // The site may be polymorphic, so check the other cached classes.
+        SlotIndex polySlot;
+        if (cacheEntry->findPolymorphic(clazzPtr, polySlot)) {
+          ++NumGetByIdPolyHits;
+          CAPTURE_IP(
+              O1REG(GetById) =
+                  JSObject::getNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                      obj, runtime, polySlot)
+                      .unboxToHV(runtime));
+          ip = nextIP;
+          DISPATCH;
+        }
+        // The property may have been found in the prototype chain of an
+        // object with the same class and parent. Objects whose own properties
+        // are not described by their class are excluded.
+        if (cacheEntry->protoClazz == clazzPtr &&
+            cacheEntry->protoEpoch == runtime.getProtoShapeEpoch() &&
+            cacheEntry->protoParent == obj->getParentGCPtr() &&
+            LLVM_LIKELY(
+                !obj->isLazy() && !obj->isHostObject() &&
+                !obj->isProxyObject())) {
+          ++NumGetByIdProtoHits;
+          CAPTURE_IP(
+              O1REG(GetById) =
+                  JSObject::getNamedSlotValueUnsafe(
+                      cacheEntry->protoHolder.getNonNull(
+                          runtime, runtime.getHeap()),
+                      runtime,
+                      cacheEntry->protoSlot)
+                      .unboxToHV(runtime));
+          ip = nextIP;
+          DISPATCH;
+        }
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
@@ -2260,14 +2346,13 @@ tailCall:
           if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazzPtr)
-              ++NumGetByIdCacheEvicts;
+            if (cacheEntry->megamorphic)
+              ++NumGetByIdMegamorphic;
 #else
-            (void)NumGetByIdCacheEvicts;
+            (void)NumGetByIdMegamorphic;
 #endif
             // Cache the class, id and property slot.
-            cacheEntry->clazz = clazzPtr;
-            cacheEntry->slot = desc.slot;
+            cacheEntry->insert(clazzPtr, desc.slot);
           }
 
           assert(
@@ -2281,29 +2366,6 @@ tailCall:
           DISPATCH;
         }
 
-        // The cache may also be populated via the prototype of the object.
-        // This value is only reliable if the fast path was a definite
-        // not-found.
-        if (fastPathResult.hasValue() && !fastPathResult.getValue() &&
-            LLVM_LIKELY(!obj->isProxyObject())) {
-          CAPTURE_IP_ASSIGN(JSObject * parent, obj->getParent(runtime));
-          // TODO: This isLazy check is because a lazy object is reported as
-          // having no properties and therefore cannot contain the property.
-          // This check does not belong here, it should be merged into
-          // tryGetOwnNamedDescriptorFast().
-          if (parent && cacheEntry->clazz == parent->getClassGCPtr() &&
-              LLVM_LIKELY(!obj->isLazy())) {
-            ++NumGetByIdProtoHits;
-            // We've already checked that this isn't a Proxy.
-            CAPTURE_IP(
-                O1REG(GetById) = JSObject::getNamedSlotValueUnsafe(
-                                     parent, runtime, cacheEntry->slot)
-                                     .unboxToHV(runtime));
-            ip = nextIP;
-            DISPATCH;
-          }
-        }
-
 #ifdef HERMES_SLOW_DEBUG
         // Call to getNamedDescriptorUnsafe is safe because `id` is kept alive
         // by the IdentifierTable.
@@ -2325,9 +2387,9 @@ tailCall:
         (void)NumGetByIdNotFound;
 #endif
 #ifdef HERMES_SLOW_DEBUG
-        auto *savedClass = cacheIdx != hbc::PROPERTY_CACHING_DISABLED
-            ? cacheEntry->clazz.get(runtime, runtime.getHeap())
-            : nullptr;
+        if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED &&
+            cacheEntry->megamorphic)
+          ++NumGetByIdMegamorphic;
 #endif
         ++NumGetByIdSlow;
         CAPTURE_IP(
@@ -2342,12 +2404,6 @@ tailCall:
         if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
-#ifdef HERMES_SLOW_DEBUG
-        if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED && savedClass &&
-            cacheEntry->clazz.get(runtime, runtime.getHeap()) != savedClass) {
-          ++NumGetByIdCacheEvicts;
-        }
-#endif
       } else {
         ++NumGetByIdTransient;
         assert(!tryProp && "TryGetById can only be used on the global object");
@@ -2405,10 +2461,8 @@ tailCall:
               "unaccounted handles were created");
           auto shvHandle = runtime.makeHandle(shv.toHV(runtime));
           auto objHandle = runtime.makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              cacheEntry->clazz.get(runtime, runtime.getHeap())));
           CAPTURE_IP(runtime.recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheEntry));
           // shv/obj may be invalidated by recordHiddenClass
           if (shv.isPointer())
             shv.unsafeUpdatePointer(
@@ -2428,6 +2482,16 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        // The site may be polymorphic, so check the other cached classes.
+        SlotIndex polySlot;
+        if (cacheEntry->findPolymorphic(clazzPtr, polySlot)) {
+          ++NumPutByIdPolyHits;
+          CAPTURE_IP(
+              JSObject::setNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                  obj, runtime, polySlot, shv));
+          ip = nextIP;
+          DISPATCH;
+        }
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
@@ -2445,14 +2509,13 @@ tailCall:
           if (LLVM_LIKELY(!clazz->isDictionary()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazzPtr)
-              ++NumPutByIdCacheEvicts;
+            if (cacheEntry->megamorphic)
+              ++NumPutByIdMegamorphic;
 #else
-            (void)NumPutByIdCacheEvicts;
+            (void)NumPutByIdMegamorphic;
 #endif
             // Cache the class and property slot.
-            cacheEntry->clazz = clazzPtr;
-            cacheEntry->slot = desc.slot;
+            cacheEntry->insert(clazzPtr, desc.slot);
           }
 
           // This must be valid because an own property was already found.
@@ -2869,9 +2932,14 @@ tailCall:
       CASE(NewObject) {
         // Create a new object using the built-in constructor. Note that the
         // built-in constructor is empty, so we don't actually need to call
-        // it.
+        // it. The property storage is sized by the allocation site.
         CAPTURE_IP(
             O1REG(NewObject) = JSObject::create(runtime).getHermesValue());
+        CAPTURE_IP(applyAllocationSite(
+            runtime,
+            curCodeBlock,
+            ip,
+            Handle<JSObject>::vmcast(&O1REG(NewObject))));
         assert(
             gcScope.getHandleCountDbg() == KEEP_HANDLES &&
             "Should not create handles.");
@@ -2889,6 +2957,11 @@ tailCall:
                         ? Runtime::makeNullHandle<JSObject>()
                         : Handle<JSObject>::vmcast(&runtime.objectPrototype))
                     .getHermesValue());
+        CAPTURE_IP(applyAllocationSite(
+            runtime,
+            curCodeBlock,
+            ip,
+            Handle<JSObject>::vmcast(&O1REG(NewObjectWithParent))));
         assert(
             gcScope.getHandleCountDbg() == KEEP_HANDLES &&
             "Should not create handles.");
@@ -2903,7 +2976,9 @@ tailCall:
                 curCodeBlock,
                 ip->iNewObjectWithBuffer.op3,
                 ip->iNewObjectWithBuffer.op4,
-                ip->iNewObjectWithBuffer.op5));
+                ip->iNewObjectWithBuffer.op5,
+                curCodeBlock->getAllocationSite(
+                    curCodeBlock->getOffsetOf(ip))));
         if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2920,7 +2995,9 @@ tailCall:
                 curCodeBlock,
                 ip->iNewObjectWithBufferLong.op3,
                 ip->iNewObjectWithBufferLong.op4,
-                ip->iNewObjectWithBufferLong.op5));
+                ip->iNewObjectWithBufferLong.op5,
+                curCodeBlock->getAllocationSite(
+                    curCodeBlock->getOffsetOf(ip))));
         if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2933,11 +3010,12 @@ tailCall:
       CASE(NewArray) {
         // Create a new array using the built-in constructor. Note that the
         // built-in constructor is empty, so we don't actually need to call
-        // it.
+        // it. The elements start out as doubles, and the storage is sized
+        // from the length when the first element is stored.
         {
           CAPTURE_IP_ASSIGN(
               auto createRes,
-              JSArray::create(runtime, ip->iNewArray.op2, ip->iNewArray.op2));
+              JSArray::createWithDoubleElements(runtime, ip->iNewArray.op2));
           if (createRes == ExecutionStatus::EXCEPTION) {
             goto exception;
           }
@@ -3001,8 +3079,13 @@ tailCall:
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
-        gcScope.flushToSmallCount(KEEP_HANDLES);
         O1REG(CreateThis) = res->getHermesValue();
+        CAPTURE_IP(applyAllocationSite(
+            runtime,
+            curCodeBlock,
+            ip,
+            Handle<JSObject>::vmcast(&O1REG(CreateThis))));
+        gcScope.flushToSmallCount(KEEP_HANDLES);
         ip = NEXTINST(CreateThis);
         DISPATCH;
       }
@@ -3566,6 +3649,21 @@ tailCall:
         "All opcodes should dispatch to the next and not fallthrough "
         "to here");
 
+#ifdef HERMESVM_JIT
+  // Run compiled code for the current function, starting at ip. It returns
+  // when it reaches an instruction it leaves to the interpreter, or when it
+  // raises an exception, with the runtime's IP pointing at that instruction.
+  runJIT : {
+    CAPTURE_IP_ASSIGN(
+        ExecutionStatus jitStatus,
+        curCodeBlock->getJITCompiled()(runtime, frameRegs, ip));
+    gcScope.flushToSmallCount(KEEP_HANDLES);
+    if (LLVM_UNLIKELY(jitStatus == ExecutionStatus::EXCEPTION))
+      goto exception;
+    DISPATCH;
+  }
+#endif
+
   // We arrive here if we couldn't allocate the registers for the current frame.
   stackOverflow:
     CAPTURE_IP(runtime.raiseStackOverflow(
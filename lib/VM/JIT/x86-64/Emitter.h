@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_X86_64_EMITTER_H
+#define HERMES_VM_JIT_X86_64_EMITTER_H
+
+#include "llvh/ADT/SmallVector.h"
+#include "llvh/Support/Compiler.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+/// The general purpose registers used by the JIT. Only the low eight
+/// registers are listed, r12 is encoded explicitly where it is used as the
+/// frame base.
+enum class Reg : uint8_t {
+  rax = 0,
+  rcx = 1,
+  rdx = 2,
+  rbx = 3,
+  rsp = 4,
+  rbp = 5,
+  rsi = 6,
+  rdi = 7,
+};
+
+/// Condition codes, as encoded in the low nibble of Jcc.
+enum class Cond : uint8_t {
+  B = 0x2,
+  AE = 0x3,
+  E = 0x4,
+  NE = 0x5,
+  BE = 0x6,
+  A = 0x7,
+};
+
+/// A minimal x86-64 assembler emitting into a byte buffer. Only the handful
+/// of instruction forms needed by the baseline JIT are supported. The code
+/// is position independent except for absolute 64-bit immediates, so the
+/// buffer can be copied to its final location once emission is complete.
+///
+/// Register conventions of the generated code:
+///   rbx - Runtime *
+///   r12 - PinnedHermesValue *frameRegs
+///   rax, rcx, rdx, rsi, rdi, xmm0, xmm1 - scratch
+class Emitter {
+ public:
+  /// A position in the buffer holding a rel32 that must be patched once the
+  /// jump destination is known.
+  using Fixup = uint32_t;
+
+  uint32_t size() const {
+    return buf_.size();
+  }
+
+  const uint8_t *data() const {
+    return buf_.data();
+  }
+
+  /// push rbp; mov rbp, rsp; push rbx; push r12; mov rbx, rdi; mov r12, rsi.
+  /// Leaves the stack 16-byte aligned for calls.
+  void prologue() {
+    bytes({0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54});
+    bytes({0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4});
+  }
+
+  /// pop r12; pop rbx; pop rbp; ret.
+  void epilogue() {
+    bytes({0x41, 0x5C, 0x5B, 0x5D, 0xC3});
+  }
+
+  /// mov \p dst, [r12 + 8 * \p index].
+  void loadFrameReg(Reg dst, uint32_t index) {
+    bytes({0x49, 0x8B});
+    frameRegOperand(dst, index);
+  }
+
+  /// mov [r12 + 8 * \p index], \p src.
+  void storeFrameReg(uint32_t index, Reg src) {
+    bytes({0x49, 0x89});
+    frameRegOperand(src, index);
+  }
+
+  /// movabs \p dst, \p imm.
+  void movImm64(Reg dst, uint64_t imm) {
+    bytes({0x48, (uint8_t)(0xB8 + (uint8_t)dst)});
+    u64(imm);
+  }
+
+  /// mov r32, \p imm, zero extending into the full register.
+  void movImm32(Reg dst, uint32_t imm) {
+    byte(0xB8 + (uint8_t)dst);
+    u32(imm);
+  }
+
+  /// Set up the arguments of a call to a JIT stub:
+  ///   rdi = runtime, rsi = frameRegs, rdx = \p arg2, rcx = \p arg3.
+  void stubArgs(uint64_t arg2, uint64_t arg3) {
+    bytes({0x48, 0x89, 0xDF, 0x4C, 0x89, 0xE6});
+    movImm64(Reg::rdx, arg2);
+    movImm64(Reg::rcx, arg3);
+  }
+
+  /// Call the absolute address \p target through rax.
+  void call(const void *target) {
+    movImm64(Reg::rax, reinterpret_cast<uint64_t>(target));
+    bytes({0xFF, 0xD0});
+  }
+
+  /// cmp \p a, \p b (64-bit).
+  void cmp(Reg a, Reg b) {
+    bytes({0x48, 0x39, modRM(3, (uint8_t)b, (uint8_t)a)});
+  }
+
+  /// test eax, eax.
+  void testEAX() {
+    bytes({0x85, 0xC0});
+  }
+
+  /// cmp eax, \p imm.
+  void cmpEAX(int8_t imm) {
+    bytes({0x83, 0xF8, (uint8_t)imm});
+  }
+
+  /// movq xmm\p xmm, \p src.
+  void movqToXMM(unsigned xmm, Reg src) {
+    bytes({0x66, 0x48, 0x0F, 0x6E, modRM(3, xmm, (uint8_t)src)});
+  }
+
+  /// movq \p dst, xmm\p xmm.
+  void movqFromXMM(Reg dst, unsigned xmm) {
+    bytes({0x66, 0x48, 0x0F, 0x7E, modRM(3, xmm, (uint8_t)dst)});
+  }
+
+  /// Scalar double arithmetic: xmm\p dst = xmm\p dst <op> xmm\p src, where
+  /// \p opcode is 0x58 (add), 0x59 (mul), 0x5C (sub) or 0x5E (div).
+  void arithSD(uint8_t opcode, unsigned dst, unsigned src) {
+    bytes({0xF2, 0x0F, opcode, modRM(3, dst, src)});
+  }
+
+  /// ucomisd xmm\p a, xmm\p b.
+  void ucomisd(unsigned a, unsigned b) {
+    bytes({0x66, 0x0F, 0x2E, modRM(3, a, b)});
+  }
+
+  /// ud2, used to mark unreachable code.
+  void ud2() {
+    bytes({0x0F, 0x0B});
+  }
+
+  /// Emit a jump with an unresolved destination. \return its fixup.
+  Fixup jmp() {
+    byte(0xE9);
+    return rel32();
+  }
+
+  /// Emit a conditional jump with an unresolved destination. \return its
+  /// fixup.
+  Fixup jcc(Cond cond) {
+    bytes({0x0F, (uint8_t)(0x80 | (uint8_t)cond)});
+    return rel32();
+  }
+
+  /// Resolve \p fixup to jump to the buffer offset \p target.
+  void patch(Fixup fixup, uint32_t target) {
+    int32_t rel = (int32_t)target - (int32_t)(fixup + 4);
+    std::memcpy(&buf_[fixup], &rel, sizeof(rel));
+  }
+
+ private:
+  static uint8_t modRM(unsigned mod, unsigned reg, unsigned rm) {
+    assert(reg < 8 && rm < 8 && "register out of range");
+    return (uint8_t)((mod << 6) | (reg << 3) | rm);
+  }
+
+  /// Emit the ModRM, SIB and disp32 addressing [r12 + 8 * index].
+  void frameRegOperand(Reg reg, uint32_t index) {
+    assert(index < (1u << 28) && "frame register index out of range");
+    bytes({modRM(2, (uint8_t)reg, 4), 0x24});
+    u32(index * 8);
+  }
+
+  Fixup rel32() {
+    Fixup pos = size();
+    u32(0);
+    return pos;
+  }
+
+  void byte(uint8_t b) {
+    buf_.push_back(b);
+  }
+
+  void bytes(std::initializer_list<uint8_t> bs) {
+    buf_.append(bs.begin(), bs.end());
+  }
+
+  void u32(uint32_t v) {
+    uint8_t tmp[sizeof(v)];
+    std::memcpy(tmp, &v, sizeof(v));
+    buf_.append(tmp, tmp + sizeof(v));
+  }
+
+  void u64(uint64_t v) {
+    uint8_t tmp[sizeof(v)];
+    std::memcpy(tmp, &v, sizeof(v));
+    buf_.append(tmp, tmp + sizeof(v));
+  }
+
+  llvh::SmallVector<uint8_t, 1024> buf_{};
+};
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_X86_64_EMITTER_H
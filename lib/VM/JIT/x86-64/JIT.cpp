@@ -0,0 +1,1155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/JIT.h"
+
+#ifdef HERMESVM_JIT
+
+#include "Emitter.h"
+
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/Interpreter.h"
+#include "hermes/VM/JSArray.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule-inline.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/Support/Debug.h"
+
+#include "../../Interpreter-internal.h"
+
+#define DEBUG_TYPE "jit"
+
+using namespace hermes::inst;
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+using x86_64::Cond;
+using x86_64::Emitter;
+using x86_64::Reg;
+
+/// Result of a call to executeInstruction(), tested by the generated code.
+enum StubResult : uint32_t {
+  /// Continue with the next instruction.
+  StubNext = 0,
+  /// The instruction is a conditional jump and the jump is taken.
+  StubJump = 1,
+  /// An exception was raised. The runtime's current IP is already set.
+  StubException = 2,
+};
+
+/// Implement the instruction at \p ip on behalf of compiled code. This covers
+/// the slow paths of the instructions that are compiled inline, as well as
+/// instructions that are always implemented out of line. It mirrors the
+/// corresponding code in the interpreter, and must be kept in sync with it.
+uint32_t executeInstruction(
+    Runtime &runtime,
+    PinnedHermesValue *frameRegs,
+    const Inst *ip,
+    CodeBlock *curCodeBlock) {
+  runtime.setCurrentIP(ip);
+  GCScopeMarkerRAII marker{runtime};
+  const PropOpFlags defaultPropOpFlags =
+      DEFAULT_PROP_OP_FLAGS(curCodeBlock->isStrictMode());
+
+/// Store the value of a CallResult<HermesValue> \p expr to the output
+/// register of \p name.
+#define STORE_RESULT(name, expr)                \
+  {                                             \
+    CallResult<HermesValue> res = (expr);       \
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) \
+      return StubException;                     \
+    O1REG(name) = *res;                         \
+    return StubNext;                            \
+  }
+
+#define BINOP_SLOW(name, expr) \
+  case OpCode::name:           \
+    STORE_RESULT(              \
+        name, expr(runtime, Handle<>(&O2REG(name)), Handle<>(&O3REG(name))))
+
+#define UNOP_SLOW(name, expr) \
+  case OpCode::name:          \
+    STORE_RESULT(name, expr(runtime, Handle<>(&O2REG(name))))
+
+#define CONDOP_SLOW(name, operFuncName)                                  \
+  case OpCode::name: {                                                   \
+    CallResult<bool> boolRes = operFuncName(                             \
+        runtime, Handle<>(&O2REG(name)), Handle<>(&O3REG(name)));        \
+    if (LLVM_UNLIKELY(boolRes == ExecutionStatus::EXCEPTION))            \
+      return StubException;                                              \
+    O1REG(name) = HermesValue::encodeBoolValue(*boolRes);                \
+    return StubNext;                                                     \
+  }
+
+/// Slow path of a comparison conditional jump \p name. \p jumpIf is the
+/// comparison result for which the jump is taken.
+#define JCOND_SLOW_IMPL(name, operFuncName, jumpIf)                      \
+  case OpCode::name: {                                                   \
+    CallResult<bool> boolRes = operFuncName(                             \
+        runtime, Handle<>(&O2REG(name)), Handle<>(&O3REG(name)));        \
+    if (LLVM_UNLIKELY(boolRes == ExecutionStatus::EXCEPTION))            \
+      return StubException;                                              \
+    return *boolRes == jumpIf ? StubJump : StubNext;                     \
+  }
+
+/// The short and long forms of a jump have different layouts, since the jump
+/// offset comes first, so they are implemented separately.
+#define JCOND_SLOW(name, operFuncName, jumpIf)   \
+  JCOND_SLOW_IMPL(name, operFuncName, jumpIf)    \
+  JCOND_SLOW_IMPL(name##Long, operFuncName, jumpIf)
+
+#define JSTRICT_SLOW(name, jumpIf)                                        \
+  case OpCode::name:                                                      \
+    return strictEqualityTest(O2REG(name), O3REG(name)) == jumpIf         \
+        ? StubJump                                                        \
+        : StubNext;                                                       \
+  case OpCode::name##Long:                                                \
+    return strictEqualityTest(O2REG(name##Long), O3REG(name##Long)) ==    \
+            jumpIf                                                        \
+        ? StubJump                                                        \
+        : StubNext;
+
+#define JBOOL_SLOW(name, jumpIf)                                          \
+  case OpCode::name:                                                      \
+    return toBoolean(O2REG(name)) == jumpIf ? StubJump : StubNext;        \
+  case OpCode::name##Long:                                                \
+    return toBoolean(O2REG(name##Long)) == jumpIf ? StubJump : StubNext;
+
+  switch (ip->opCode) {
+    case OpCode::Add:
+      STORE_RESULT(
+          Add,
+          addOp_RJS(runtime, Handle<>(&O2REG(Add)), Handle<>(&O3REG(Add))));
+      BINOP_SLOW(Sub, doOperSlowPath<doSub>);
+      BINOP_SLOW(Mul, doOperSlowPath<doMul>);
+      BINOP_SLOW(Div, doOperSlowPath<doDiv>);
+      BINOP_SLOW(Mod, doOperSlowPath<doMod>);
+      BINOP_SLOW(BitAnd, doBitOperSlowPath<doBitAnd>);
+      BINOP_SLOW(BitOr, doBitOperSlowPath<doBitOr>);
+      BINOP_SLOW(BitXor, doBitOperSlowPath<doBitXor>);
+      BINOP_SLOW(LShift, doShiftOperSlowPath<doLShift>);
+      BINOP_SLOW(RShift, doShiftOperSlowPath<doRShift>);
+      BINOP_SLOW(URshift, doShiftOperSlowPath<doURshift>);
+      UNOP_SLOW(Inc, doIncDecOperSlowPath<doInc>);
+      UNOP_SLOW(Dec, doIncDecOperSlowPath<doDec>);
+      UNOP_SLOW(Negate, doNegateSlowPath);
+      UNOP_SLOW(BitNot, doBitNotSlowPath);
+
+      CONDOP_SLOW(Less, lessOp_RJS);
+      CONDOP_SLOW(LessEq, lessEqualOp_RJS);
+      CONDOP_SLOW(Greater, greaterOp_RJS);
+      CONDOP_SLOW(GreaterEq, greaterEqualOp_RJS);
+
+      JCOND_SLOW(JLess, lessOp_RJS, true);
+      JCOND_SLOW(JNotLess, lessOp_RJS, false);
+      JCOND_SLOW(JLessEqual, lessEqualOp_RJS, true);
+      JCOND_SLOW(JNotLessEqual, lessEqualOp_RJS, false);
+      JCOND_SLOW(JGreater, greaterOp_RJS, true);
+      JCOND_SLOW(JNotGreater, greaterOp_RJS, false);
+      JCOND_SLOW(JGreaterEqual, greaterEqualOp_RJS, true);
+      JCOND_SLOW(JNotGreaterEqual, greaterEqualOp_RJS, false);
+      JCOND_SLOW(JEqual, abstractEqualityTest_RJS, true);
+      JCOND_SLOW(JNotEqual, abstractEqualityTest_RJS, false);
+
+    case OpCode::Eq:
+    case OpCode::Neq: {
+      CallResult<bool> eqRes = abstractEqualityTest_RJS(
+          runtime, Handle<>(&O2REG(Eq)), Handle<>(&O3REG(Eq)));
+      if (LLVM_UNLIKELY(eqRes == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(Eq) = HermesValue::encodeBoolValue(
+          ip->opCode == OpCode::Eq ? *eqRes : !*eqRes);
+      return StubNext;
+    }
+    case OpCode::StrictEq:
+    case OpCode::StrictNeq:
+      O1REG(StrictEq) = HermesValue::encodeBoolValue(
+          strictEqualityTest(O2REG(StrictEq), O3REG(StrictEq)) ==
+          (ip->opCode == OpCode::StrictEq));
+      return StubNext;
+      JSTRICT_SLOW(JStrictEqual, true);
+      JSTRICT_SLOW(JStrictNotEqual, false);
+      JBOOL_SLOW(JmpTrue, true);
+      JBOOL_SLOW(JmpFalse, false);
+    case OpCode::Not:
+      O1REG(Not) = HermesValue::encodeBoolValue(!toBoolean(O2REG(Not)));
+      return StubNext;
+    case OpCode::TypeOf:
+      O1REG(TypeOf) = typeOf(runtime, Handle<>(&O2REG(TypeOf)));
+      return StubNext;
+
+    case OpCode::LoadParam:
+    case OpCode::LoadParamLong: {
+      uint32_t index = ip->opCode == OpCode::LoadParam
+          ? ip->iLoadParam.op2
+          : ip->iLoadParamLong.op2;
+      // index 0 must load 'this'. Index 1 the first argument, etc.
+      O1REG(LoadParam) = index <= FRAME.getArgCount()
+          ? FRAME.getArgRef((int32_t)index - 1)
+          : HermesValue::encodeUndefinedValue();
+      return StubNext;
+    }
+    case OpCode::LoadThisNS:
+    case OpCode::CoerceThisNS: {
+      Handle<> thisArg = ip->opCode == OpCode::LoadThisNS
+          ? Handle<>(&FRAME.getThisArgRef())
+          : Handle<>(&O2REG(CoerceThisNS));
+      if (LLVM_LIKELY(thisArg->isObject())) {
+        O1REG(LoadThisNS) = *thisArg;
+      } else if (thisArg->isNull() || thisArg->isUndefined()) {
+        O1REG(LoadThisNS) = runtime.getGlobal().getHermesValue();
+      } else {
+        STORE_RESULT(LoadThisNS, toObject(runtime, thisArg));
+      }
+      return StubNext;
+    }
+    case OpCode::GetGlobalObject:
+      O1REG(GetGlobalObject) = runtime.getGlobal().getHermesValue();
+      return StubNext;
+    case OpCode::ThrowIfEmpty:
+      if (LLVM_UNLIKELY(O2REG(ThrowIfEmpty).isEmpty())) {
+        (void)runtime.raiseReferenceError(
+            "accessing an uninitialized variable");
+        return StubException;
+      }
+      O1REG(ThrowIfEmpty) = O2REG(ThrowIfEmpty);
+      return StubNext;
+    case OpCode::AddEmptyString: {
+      if (LLVM_LIKELY(O2REG(AddEmptyString).isString())) {
+        O1REG(AddEmptyString) = O2REG(AddEmptyString);
+        return StubNext;
+      }
+      auto primRes = toPrimitive_RJS(
+          runtime, Handle<>(&O2REG(AddEmptyString)), PreferredType::NONE);
+      if (LLVM_UNLIKELY(primRes == ExecutionStatus::EXCEPTION))
+        return StubException;
+      auto strRes = toString_RJS(runtime, runtime.makeHandle(*primRes));
+      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(AddEmptyString) = strRes->getHermesValue();
+      return StubNext;
+    }
+    case OpCode::LoadConstString:
+      O1REG(LoadConstString) = HermesValue::encodeStringValue(
+          curCodeBlock->getRuntimeModule()->getStringPrimFromStringIDMayAllocate(
+              ip->iLoadConstString.op2));
+      return StubNext;
+    case OpCode::LoadConstStringLongIndex:
+      O1REG(LoadConstStringLongIndex) = HermesValue::encodeStringValue(
+          curCodeBlock->getRuntimeModule()->getStringPrimFromStringIDMayAllocate(
+              ip->iLoadConstStringLongIndex.op2));
+      return StubNext;
+
+    case OpCode::GetEnvironment: {
+      // The currently executing function must exist, so get the environment.
+      Environment *curEnv =
+          FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime);
+      for (unsigned level = ip->iGetEnvironment.op2; level; --level) {
+        assert(curEnv && "invalid environment relative level");
+        curEnv = curEnv->getParentEnvironment(runtime);
+      }
+      O1REG(GetEnvironment) = HermesValue::encodeObjectValue(curEnv);
+      return StubNext;
+    }
+    case OpCode::CreateEnvironment: {
+      auto parentEnv = runtime.makeHandle(
+          FRAME.getCalleeClosureUnsafe()->getEnvironment(runtime));
+      CallResult<HermesValue> res = Environment::create(
+          runtime, parentEnv, curCodeBlock->getEnvironmentSize());
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(CreateEnvironment) = *res;
+#ifdef HERMES_ENABLE_DEBUGGER
+      FRAME.getDebugEnvironmentRef() = *res;
+#endif
+      return StubNext;
+    }
+    case OpCode::LoadFromEnvironment:
+      O1REG(LoadFromEnvironment) =
+          vmcast<Environment>(O2REG(LoadFromEnvironment))
+              ->slot(ip->iLoadFromEnvironment.op3);
+      return StubNext;
+    case OpCode::LoadFromEnvironmentL:
+      O1REG(LoadFromEnvironmentL) =
+          vmcast<Environment>(O2REG(LoadFromEnvironmentL))
+              ->slot(ip->iLoadFromEnvironmentL.op3);
+      return StubNext;
+    case OpCode::StoreToEnvironment:
+      vmcast<Environment>(O1REG(StoreToEnvironment))
+          ->slot(ip->iStoreToEnvironment.op2)
+          .set(O3REG(StoreToEnvironment), runtime.getHeap());
+      return StubNext;
+    case OpCode::StoreToEnvironmentL:
+      vmcast<Environment>(O1REG(StoreToEnvironmentL))
+          ->slot(ip->iStoreToEnvironmentL.op2)
+          .set(O3REG(StoreToEnvironmentL), runtime.getHeap());
+      return StubNext;
+    case OpCode::StoreNPToEnvironment:
+      vmcast<Environment>(O1REG(StoreNPToEnvironment))
+          ->slot(ip->iStoreNPToEnvironment.op2)
+          .setNonPtr(O3REG(StoreNPToEnvironment), runtime.getHeap());
+      return StubNext;
+    case OpCode::StoreNPToEnvironmentL:
+      vmcast<Environment>(O1REG(StoreNPToEnvironmentL))
+          ->slot(ip->iStoreNPToEnvironmentL.op2)
+          .setNonPtr(O3REG(StoreNPToEnvironmentL), runtime.getHeap());
+      return StubNext;
+    case OpCode::CreateClosure:
+    case OpCode::CreateClosureLongIndex: {
+      uint32_t funcIndex = ip->opCode == OpCode::CreateClosure
+          ? ip->iCreateClosure.op3
+          : ip->iCreateClosureLongIndex.op3;
+      auto *runtimeModule = curCodeBlock->getRuntimeModule();
+      O1REG(CreateClosure) =
+          JSFunction::create(
+              runtime,
+              runtimeModule->getDomain(runtime),
+              Handle<JSObject>::vmcast(&runtime.functionPrototype),
+              Handle<Environment>::vmcast(&O2REG(CreateClosure)),
+              runtimeModule->getCodeBlockMayAllocate(funcIndex))
+              .getHermesValue();
+      return StubNext;
+    }
+    case OpCode::NewObject:
+      O1REG(NewObject) = JSObject::create(runtime).getHermesValue();
+      Interpreter::applyAllocationSite(
+          runtime,
+          curCodeBlock,
+          ip,
+          Handle<JSObject>::vmcast(&O1REG(NewObject)));
+      return StubNext;
+    case OpCode::NewArray: {
+      auto createRes =
+          JSArray::createWithDoubleElements(runtime, ip->iNewArray.op2);
+      if (LLVM_UNLIKELY(createRes == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(NewArray) = createRes->getHermesValue();
+      return StubNext;
+    }
+    case OpCode::CallBuiltin:
+    case OpCode::CallBuiltinLong: {
+      uint32_t op3 = ip->opCode == OpCode::CallBuiltin
+          ? ip->iCallBuiltin.op3
+          : ip->iCallBuiltinLong.op3;
+      return Interpreter::implCallBuiltin(
+                 runtime, frameRegs, curCodeBlock, op3) ==
+              ExecutionStatus::EXCEPTION
+          ? StubException
+          : StubNext;
+    }
+
+    case OpCode::GetById:
+    case OpCode::GetByIdShort:
+    case OpCode::GetByIdLong:
+    case OpCode::TryGetById:
+    case OpCode::TryGetByIdLong: {
+      // All of these share the layout of GetById, except for the width of the
+      // identifier.
+      uint32_t idVal;
+      bool tryProp = false;
+      switch (ip->opCode) {
+        case OpCode::GetByIdShort:
+          idVal = ip->iGetByIdShort.op4;
+          break;
+        case OpCode::GetByIdLong:
+          idVal = ip->iGetByIdLong.op4;
+          break;
+        case OpCode::TryGetById:
+          tryProp = true;
+          idVal = ip->iTryGetById.op4;
+          break;
+        case OpCode::TryGetByIdLong:
+          tryProp = true;
+          idVal = ip->iTryGetByIdLong.op4;
+          break;
+        default:
+          idVal = ip->iGetById.op4;
+          break;
+      }
+      CallResult<PseudoHandle<>> resPH{ExecutionStatus::EXCEPTION};
+      if (LLVM_LIKELY(O2REG(GetById).isObject())) {
+        auto *obj = vmcast<JSObject>(O2REG(GetById));
+        auto cacheIdx = ip->iGetById.op3;
+        auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
+        CompressedPointer clazzPtr{obj->getClassGCPtr()};
+        SlotIndex slot = cacheEntry->slot;
+        if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr) ||
+            cacheEntry->findPolymorphic(clazzPtr, slot)) {
+          O1REG(GetById) =
+              JSObject::getNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                  obj, runtime, slot)
+                  .unboxToHV(runtime);
+          return StubNext;
+        }
+        if (cacheEntry->protoClazz == clazzPtr &&
+            cacheEntry->protoEpoch == runtime.getProtoShapeEpoch() &&
+            cacheEntry->protoParent == obj->getParentGCPtr() &&
+            LLVM_LIKELY(
+                !obj->isLazy() && !obj->isHostObject() &&
+                !obj->isProxyObject())) {
+          O1REG(GetById) =
+              JSObject::getNamedSlotValueUnsafe(
+                  cacheEntry->protoHolder.getNonNull(
+                      runtime, runtime.getHeap()),
+                  runtime,
+                  cacheEntry->protoSlot)
+                  .unboxToHV(runtime);
+          return StubNext;
+        }
+        // getNamed_RJS() populates the cache on the way.
+        resPH = JSObject::getNamed_RJS(
+            Handle<JSObject>::vmcast(&O2REG(GetById)),
+            runtime,
+            ID(idVal),
+            !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist(),
+            cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry : nullptr);
+      } else {
+        resPH = Interpreter::getByIdTransient_RJS(
+            runtime, Handle<>(&O2REG(GetById)), ID(idVal));
+      }
+      if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(GetById) = resPH->get();
+      return StubNext;
+    }
+
+    case OpCode::PutById:
+    case OpCode::PutByIdLong:
+    case OpCode::TryPutById:
+    case OpCode::TryPutByIdLong: {
+      uint32_t idVal;
+      bool tryProp = false;
+      switch (ip->opCode) {
+        case OpCode::PutByIdLong:
+          idVal = ip->iPutByIdLong.op4;
+          break;
+        case OpCode::TryPutById:
+          tryProp = true;
+          idVal = ip->iTryPutById.op4;
+          break;
+        case OpCode::TryPutByIdLong:
+          tryProp = true;
+          idVal = ip->iTryPutByIdLong.op4;
+          break;
+        default:
+          idVal = ip->iPutById.op4;
+          break;
+      }
+      if (LLVM_UNLIKELY(!O1REG(PutById).isObject())) {
+        return Interpreter::putByIdTransient_RJS(
+                   runtime,
+                   Handle<>(&O1REG(PutById)),
+                   ID(idVal),
+                   Handle<>(&O2REG(PutById)),
+                   curCodeBlock->isStrictMode()) == ExecutionStatus::EXCEPTION
+            ? StubException
+            : StubNext;
+      }
+      SmallHermesValue shv =
+          SmallHermesValue::encodeHermesValue(O2REG(PutById), runtime);
+      auto *obj = vmcast<JSObject>(O1REG(PutById));
+      auto cacheIdx = ip->iPutById.op3;
+      auto *cacheEntry = curCodeBlock->getWriteCacheEntry(cacheIdx);
+      CompressedPointer clazzPtr{obj->getClassGCPtr()};
+      SlotIndex slot = cacheEntry->slot;
+      if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr) ||
+          cacheEntry->findPolymorphic(clazzPtr, slot)) {
+        JSObject::setNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+            obj, runtime, slot, shv);
+        return StubNext;
+      }
+      auto id = ID(idVal);
+      NamedPropertyDescriptor desc;
+      OptValue<bool> hasOwnProp =
+          JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
+      if (LLVM_LIKELY(hasOwnProp.hasValue() && hasOwnProp.getValue()) &&
+          !desc.flags.accessor && desc.flags.writable &&
+          !desc.flags.internalSetter) {
+        HiddenClass *clazz = vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
+        if (LLVM_LIKELY(!clazz->isDictionary()) &&
+            LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+          cacheEntry->insert(clazzPtr, desc.slot);
+        }
+        JSObject::setNamedSlotValueUnsafe(obj, runtime, desc.slot, shv);
+        return StubNext;
+      }
+      return JSObject::putNamed_RJS(
+                 Handle<JSObject>::vmcast(&O1REG(PutById)),
+                 runtime,
+                 id,
+                 Handle<>(&O2REG(PutById)),
+                 !tryProp ? defaultPropOpFlags
+                          : defaultPropOpFlags.plusMustExist()) ==
+              ExecutionStatus::EXCEPTION
+          ? StubException
+          : StubNext;
+    }
+
+    case OpCode::GetByVal: {
+      CallResult<PseudoHandle<>> resPH = O2REG(GetByVal).isObject()
+          ? JSObject::getComputed_RJS(
+                Handle<JSObject>::vmcast(&O2REG(GetByVal)),
+                runtime,
+                Handle<>(&O3REG(GetByVal)))
+          : Interpreter::getByValTransient_RJS(
+                runtime,
+                Handle<>(&O2REG(GetByVal)),
+                Handle<>(&O3REG(GetByVal)));
+      if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION))
+        return StubException;
+      O1REG(GetByVal) = resPH->get();
+      return StubNext;
+    }
+    case OpCode::PutByVal: {
+      ExecutionStatus status;
+      if (LLVM_LIKELY(O1REG(PutByVal).isObject())) {
+        status = JSObject::putComputed_RJS(
+                     Handle<JSObject>::vmcast(&O1REG(PutByVal)),
+                     runtime,
+                     Handle<>(&O2REG(PutByVal)),
+                     Handle<>(&O3REG(PutByVal)),
+                     defaultPropOpFlags)
+                     .getStatus();
+      } else {
+        status = Interpreter::putByValTransient_RJS(
+            runtime,
+            Handle<>(&O1REG(PutByVal)),
+            Handle<>(&O2REG(PutByVal)),
+            Handle<>(&O3REG(PutByVal)),
+            curCodeBlock->isStrictMode());
+      }
+      return status == ExecutionStatus::EXCEPTION ? StubException : StubNext;
+    }
+
+    default:
+      llvm_unreachable("instruction is not implemented by the JIT");
+  }
+
+#undef STORE_RESULT
+#undef BINOP_SLOW
+#undef UNOP_SLOW
+#undef CONDOP_SLOW
+#undef JCOND_SLOW_IMPL
+#undef JCOND_SLOW
+#undef JSTRICT_SLOW
+#undef JBOOL_SLOW
+}
+
+/// Called by compiled code when it reaches an instruction that it leaves to
+/// the interpreter.
+ExecutionStatus exitToInterpreter(
+    Runtime &runtime,
+    PinnedHermesValue *,
+    const Inst *ip,
+    CodeBlock *) {
+  runtime.setCurrentIP(ip);
+  return ExecutionStatus::RETURNED;
+}
+
+/// \return true if \p op is a call-type instruction, i.e. one that a callee
+/// returns to.
+bool isCallType(OpCode op) {
+  switch (op) {
+#define DEFINE_RET_TARGET(name) \
+  case OpCode::name:            \
+    return true;
+#include "hermes/BCGen/HBC/BytecodeList.def"
+    default:
+      return false;
+  }
+}
+
+/// \return true if \p op is a jump instruction.
+bool isJump(OpCode op) {
+  switch (op) {
+#define DEFINE_JUMP_LONG_VARIANT(shortName, longName) \
+  case OpCode::shortName:                             \
+  case OpCode::longName:                              \
+    return true;
+#include "hermes/BCGen/HBC/BytecodeList.def"
+    default:
+      return false;
+  }
+}
+
+/// How an instruction is handled by the compiler.
+enum class InstKind {
+  /// Compiled into inline code, possibly with an out of line slow path.
+  Inline,
+  /// Always implemented by executeInstruction().
+  Stub,
+  /// Handed back to the interpreter.
+  Exit,
+  /// Not supported; functions containing it are not compiled.
+  Unsupported,
+};
+
+InstKind classify(OpCode op) {
+  if (isCallType(op))
+    return InstKind::Exit;
+  switch (op) {
+    case OpCode::Ret:
+    case OpCode::Throw:
+    case OpCode::Catch:
+      return InstKind::Exit;
+
+    case OpCode::Mov:
+    case OpCode::MovLong:
+    case OpCode::LoadConstEmpty:
+    case OpCode::LoadConstUndefined:
+    case OpCode::LoadConstNull:
+    case OpCode::LoadConstTrue:
+    case OpCode::LoadConstFalse:
+    case OpCode::LoadConstZero:
+    case OpCode::LoadConstUInt8:
+    case OpCode::LoadConstInt:
+    case OpCode::LoadConstDouble:
+    case OpCode::Jmp:
+    case OpCode::JmpLong:
+    case OpCode::JmpUndefined:
+    case OpCode::JmpUndefinedLong:
+    case OpCode::JmpTrue:
+    case OpCode::JmpTrueLong:
+    case OpCode::JmpFalse:
+    case OpCode::JmpFalseLong:
+    case OpCode::Add:
+    case OpCode::AddN:
+    case OpCode::Sub:
+    case OpCode::SubN:
+    case OpCode::Mul:
+    case OpCode::MulN:
+    case OpCode::Div:
+    case OpCode::DivN:
+    case OpCode::Inc:
+    case OpCode::Dec:
+#define JCOND_OPS(name)             \
+  case OpCode::J##name:             \
+  case OpCode::J##name##Long:       \
+  case OpCode::JNot##name:          \
+  case OpCode::JNot##name##Long:    \
+  case OpCode::J##name##N:          \
+  case OpCode::J##name##NLong:      \
+  case OpCode::JNot##name##N:       \
+  case OpCode::JNot##name##NLong:
+      JCOND_OPS(Less)
+      JCOND_OPS(LessEqual)
+      JCOND_OPS(Greater)
+      JCOND_OPS(GreaterEqual)
+#undef JCOND_OPS
+      return InstKind::Inline;
+
+    case OpCode::Mod:
+    case OpCode::BitAnd:
+    case OpCode::BitOr:
+    case OpCode::BitXor:
+    case OpCode::LShift:
+    case OpCode::RShift:
+    case OpCode::URshift:
+    case OpCode::Negate:
+    case OpCode::BitNot:
+    case OpCode::Not:
+    case OpCode::Less:
+    case OpCode::LessEq:
+    case OpCode::Greater:
+    case OpCode::GreaterEq:
+    case OpCode::Eq:
+    case OpCode::Neq:
+    case OpCode::StrictEq:
+    case OpCode::StrictNeq:
+    case OpCode::JEqual:
+    case OpCode::JEqualLong:
+    case OpCode::JNotEqual:
+    case OpCode::JNotEqualLong:
+    case OpCode::JStrictEqual:
+    case OpCode::JStrictEqualLong:
+    case OpCode::JStrictNotEqual:
+    case OpCode::JStrictNotEqualLong:
+    case OpCode::TypeOf:
+    case OpCode::LoadParam:
+    case OpCode::LoadParamLong:
+    case OpCode::LoadThisNS:
+    case OpCode::CoerceThisNS:
+    case OpCode::GetGlobalObject:
+    case OpCode::ThrowIfEmpty:
+    case OpCode::AddEmptyString:
+    case OpCode::LoadConstString:
+    case OpCode::LoadConstStringLongIndex:
+    case OpCode::GetEnvironment:
+    case OpCode::CreateEnvironment:
+    case OpCode::LoadFromEnvironment:
+    case OpCode::LoadFromEnvironmentL:
+    case OpCode::StoreToEnvironment:
+    case OpCode::StoreToEnvironmentL:
+    case OpCode::StoreNPToEnvironment:
+    case OpCode::StoreNPToEnvironmentL:
+    case OpCode::CreateClosure:
+    case OpCode::CreateClosureLongIndex:
+    case OpCode::NewObject:
+    case OpCode::NewArray:
+    case OpCode::CallBuiltin:
+    case OpCode::CallBuiltinLong:
+    case OpCode::GetById:
+    case OpCode::GetByIdShort:
+    case OpCode::GetByIdLong:
+    case OpCode::TryGetById:
+    case OpCode::TryGetByIdLong:
+    case OpCode::PutById:
+    case OpCode::PutByIdLong:
+    case OpCode::TryPutById:
+    case OpCode::TryPutByIdLong:
+    case OpCode::GetByVal:
+    case OpCode::PutByVal:
+      return InstKind::Stub;
+
+    default:
+      return InstKind::Unsupported;
+  }
+}
+
+/// Raw encodings at or above this value are not doubles.
+constexpr uint64_t kFirstNonDouble = (uint64_t)HermesValue::Tag::First
+    << HermesValue::kNumDataBits;
+
+/// Translates the bytecode of a single function into machine code.
+class FunctionCompiler {
+ public:
+  explicit FunctionCompiler(CodeBlock *codeBlock) : codeBlock_(codeBlock) {}
+
+  /// Emit code for the whole function. \return false if it contains
+  /// instructions that are not supported.
+  bool compile();
+
+  const Emitter &emitter() const {
+    return em_;
+  }
+
+ private:
+  const Inst *instAt(uint32_t offset) const {
+    return reinterpret_cast<const Inst *>(codeBlock_->begin() + offset);
+  }
+
+  /// Emit a call to \p stub for the instruction at \p ip. The result is left
+  /// in eax.
+  void emitStubCall(const void *stub, const Inst *ip) {
+    em_.stubArgs(
+        reinterpret_cast<uint64_t>(ip), reinterpret_cast<uint64_t>(codeBlock_));
+    em_.call(stub);
+  }
+
+  /// Implement the instruction at \p ip out of line, and propagate exceptions.
+  /// If it is a jump, jump to \p target if the stub says so.
+  void emitSlowPath(const Inst *ip, uint32_t target) {
+    emitStubCall(reinterpret_cast<const void *>(executeInstruction), ip);
+    if (isJump(ip->opCode)) {
+      em_.cmpEAX(StubJump);
+      jumpTo(em_.jcc(Cond::E), target);
+      exceptionFixups_.push_back(em_.jcc(Cond::A));
+    } else {
+      em_.testEAX();
+      exceptionFixups_.push_back(em_.jcc(Cond::NE));
+    }
+  }
+
+  /// Record that \p fixup must jump to the code for bytecode \p target.
+  void jumpTo(Emitter::Fixup fixup, uint32_t target) {
+    jumpFixups_.push_back({fixup, target});
+  }
+
+  /// Jump to \p notNumber unless both \p a and \p b hold doubles. Clobbers
+  /// rdx.
+  void emitNumberCheck(
+      Reg a,
+      Reg b,
+      llvh::SmallVectorImpl<Emitter::Fixup> &notNumber) {
+    em_.movImm64(Reg::rdx, kFirstNonDouble);
+    em_.cmp(a, Reg::rdx);
+    notNumber.push_back(em_.jcc(Cond::AE));
+    em_.cmp(b, Reg::rdx);
+    notNumber.push_back(em_.jcc(Cond::AE));
+  }
+
+  /// Load the operands of a binary instruction into xmm0 and xmm1, jumping to
+  /// \p notNumber if either is not a number, unless \p known is true.
+  void emitLoadDoubles(
+      uint32_t a,
+      uint32_t b,
+      bool known,
+      llvh::SmallVectorImpl<Emitter::Fixup> &notNumber) {
+    em_.loadFrameReg(Reg::rax, a);
+    em_.loadFrameReg(Reg::rcx, b);
+    if (!known)
+      emitNumberCheck(Reg::rax, Reg::rcx, notNumber);
+    em_.movqToXMM(0, Reg::rax);
+    em_.movqToXMM(1, Reg::rcx);
+  }
+
+  void emitArith(const Inst *ip, uint8_t sseOp, bool known);
+  void emitIncDec(const Inst *ip, uint8_t sseOp);
+  void emitCompareJump(const Inst *ip, uint32_t target);
+  void emitBoolJump(const Inst *ip, uint32_t target, bool jumpIfTrue);
+
+  CodeBlock *const codeBlock_;
+  Emitter em_{};
+
+  /// Native offset of the code for each bytecode offset.
+  llvh::DenseMap<uint32_t, uint32_t> nativeOffsets_{};
+
+  /// Jumps to be resolved once all code has been emitted, with the bytecode
+  /// offset they target.
+  llvh::SmallVector<std::pair<Emitter::Fixup, uint32_t>, 16> jumpFixups_{};
+
+  /// Jumps to the exception exit.
+  llvh::SmallVector<Emitter::Fixup, 16> exceptionFixups_{};
+
+  /// Jumps to the common epilogue.
+  llvh::SmallVector<Emitter::Fixup, 16> returnFixups_{};
+};
+
+void FunctionCompiler::emitArith(const Inst *ip, uint8_t sseOp, bool known) {
+  // All the arithmetic instructions share the layout of Add.
+  llvh::SmallVector<Emitter::Fixup, 2> notNumber;
+  emitLoadDoubles(ip->iAdd.op2, ip->iAdd.op3, known, notNumber);
+  em_.arithSD(sseOp, 0, 1);
+  em_.movqFromXMM(Reg::rax, 0);
+  em_.storeFrameReg(ip->iAdd.op1, Reg::rax);
+  if (known)
+    return;
+  Emitter::Fixup done = em_.jmp();
+  for (auto fixup : notNumber)
+    em_.patch(fixup, em_.size());
+  emitSlowPath(ip, 0);
+  em_.patch(done, em_.size());
+}
+
+void FunctionCompiler::emitIncDec(const Inst *ip, uint8_t sseOp) {
+  // Inc and Dec share a layout.
+  em_.loadFrameReg(Reg::rax, ip->iInc.op2);
+  em_.movImm64(Reg::rdx, kFirstNonDouble);
+  em_.cmp(Reg::rax, Reg::rdx);
+  Emitter::Fixup notNumber = em_.jcc(Cond::AE);
+  em_.movqToXMM(0, Reg::rax);
+  em_.movImm64(Reg::rcx, HermesValue::encodeDoubleValue(1).getRaw());
+  em_.movqToXMM(1, Reg::rcx);
+  em_.arithSD(sseOp, 0, 1);
+  em_.movqFromXMM(Reg::rax, 0);
+  em_.storeFrameReg(ip->iInc.op1, Reg::rax);
+  Emitter::Fixup done = em_.jmp();
+  em_.patch(notNumber, em_.size());
+  emitSlowPath(ip, 0);
+  em_.patch(done, em_.size());
+}
+
+void FunctionCompiler::emitCompareJump(const Inst *ip, uint32_t target) {
+  // The fast path of JLess and friends, where both operands are numbers.
+  // ucomisd sets CF and ZF for unordered operands, so only the "above" family
+  // of conditions is false when either operand is NaN.
+  bool swap, orEqual, negate, known;
+  switch (ip->opCode) {
+#define CASES(name, sw, eq)                              \
+  case OpCode::J##name:                                  \
+  case OpCode::J##name##Long:                            \
+    swap = sw, orEqual = eq, negate = false, known = false; \
+    break;                                               \
+  case OpCode::JNot##name:                               \
+  case OpCode::JNot##name##Long:                         \
+    swap = sw, orEqual = eq, negate = true, known = false;  \
+    break;                                               \
+  case OpCode::J##name##N:                               \
+  case OpCode::J##name##NLong:                           \
+    swap = sw, orEqual = eq, negate = false, known = true;  \
+    break;                                               \
+  case OpCode::JNot##name##N:                            \
+  case OpCode::JNot##name##NLong:                        \
+    swap = sw, orEqual = eq, negate = true, known = true;   \
+    break;
+    CASES(Less, true, false)
+    CASES(LessEqual, true, true)
+    CASES(Greater, false, false)
+    CASES(GreaterEqual, false, true)
+#undef CASES
+    default:
+      llvm_unreachable("not a comparison jump");
+  }
+
+  // The operand registers follow a jump offset of varying width, so read them
+  // from the decoded instruction.
+  DecodedInstruction decoded = decodeInstruction(ip);
+  llvh::SmallVector<Emitter::Fixup, 2> notNumber;
+  emitLoadDoubles(
+      decoded.operandValue[1].integer,
+      decoded.operandValue[2].integer,
+      known,
+      notNumber);
+  // "a < b" is computed as "b > a".
+  if (swap)
+    em_.ucomisd(1, 0);
+  else
+    em_.ucomisd(0, 1);
+  Cond cond = orEqual ? (negate ? Cond::B : Cond::AE)
+                      : (negate ? Cond::BE : Cond::A);
+  jumpTo(em_.jcc(cond), target);
+  if (known)
+    return;
+  Emitter::Fixup done = em_.jmp();
+  for (auto fixup : notNumber)
+    em_.patch(fixup, em_.size());
+  emitSlowPath(ip, target);
+  em_.patch(done, em_.size());
+}
+
+void FunctionCompiler::emitBoolJump(
+    const Inst *ip,
+    uint32_t target,
+    bool jumpIfTrue) {
+  // Booleans are handled inline, everything else calls out.
+  em_.loadFrameReg(Reg::rax, decodeInstruction(ip).operandValue[1].integer);
+  em_.movImm64(Reg::rdx, HermesValue::encodeBoolValue(jumpIfTrue).getRaw());
+  em_.cmp(Reg::rax, Reg::rdx);
+  jumpTo(em_.jcc(Cond::E), target);
+  em_.movImm64(Reg::rdx, HermesValue::encodeBoolValue(!jumpIfTrue).getRaw());
+  em_.cmp(Reg::rax, Reg::rdx);
+  Emitter::Fixup done = em_.jcc(Cond::E);
+  emitSlowPath(ip, target);
+  em_.patch(done, em_.size());
+}
+
+bool FunctionCompiler::compile() {
+  const uint32_t codeSize = codeBlock_->end() - codeBlock_->begin();
+
+  // First pass: check that every instruction is supported, and collect the
+  // offsets where the interpreter may enter compiled code.
+  llvh::SmallVector<uint32_t, 8> entryPoints{0};
+  for (uint32_t offset = 0; offset < codeSize;) {
+    OpCode op = instAt(offset)->opCode;
+    InstKind kind = classify(op);
+    if (kind == InstKind::Unsupported) {
+      LLVM_DEBUG(
+          llvh::dbgs() << "JIT: function " << codeBlock_->getFunctionID()
+                       << " not compiled, unsupported " << getOpCodeString(op)
+                       << "\n");
+      return false;
+    }
+    offset += getInstSize(op);
+    if (isCallType(op) && offset < codeSize)
+      entryPoints.push_back(offset);
+  }
+
+  em_.prologue();
+
+  // Dispatch on the entry ip, passed in rdx.
+  for (uint32_t entry : entryPoints) {
+    em_.movImm64(Reg::rax, reinterpret_cast<uint64_t>(instAt(entry)));
+    em_.cmp(Reg::rdx, Reg::rax);
+    jumpTo(em_.jcc(Cond::E), entry);
+  }
+  em_.ud2();
+
+  // Second pass: emit code for every instruction.
+  for (uint32_t offset = 0; offset < codeSize;) {
+    const Inst *ip = instAt(offset);
+    OpCode op = ip->opCode;
+    uint32_t next = offset + getInstSize(op);
+    uint32_t target = 0;
+    if (isJump(op))
+      target = offset + (int32_t)decodeInstruction(ip).operandValue[0].integer;
+
+    nativeOffsets_[offset] = em_.size();
+
+    switch (classify(op)) {
+      case InstKind::Exit:
+        emitStubCall(reinterpret_cast<const void *>(exitToInterpreter), ip);
+        returnFixups_.push_back(em_.jmp());
+        break;
+      case InstKind::Stub:
+        emitSlowPath(ip, target);
+        break;
+      case InstKind::Unsupported:
+        llvm_unreachable("unsupported instructions were rejected");
+      case InstKind::Inline:
+        switch (op) {
+          case OpCode::Mov:
+            em_.loadFrameReg(Reg::rax, ip->iMov.op2);
+            em_.storeFrameReg(ip->iMov.op1, Reg::rax);
+            break;
+          case OpCode::MovLong:
+            em_.loadFrameReg(Reg::rax, ip->iMovLong.op2);
+            em_.storeFrameReg(ip->iMovLong.op1, Reg::rax);
+            break;
+#define LOAD_CONST(name, value)                                   \
+  case OpCode::name:                                              \
+    em_.movImm64(Reg::rax, (value).getRaw());                     \
+    em_.storeFrameReg(ip->i##name.op1, Reg::rax);                 \
+    break;
+            LOAD_CONST(LoadConstEmpty, HermesValue::encodeEmptyValue())
+            LOAD_CONST(LoadConstUndefined, HermesValue::encodeUndefinedValue())
+            LOAD_CONST(LoadConstNull, HermesValue::encodeNullValue())
+            LOAD_CONST(LoadConstTrue, HermesValue::encodeBoolValue(true))
+            LOAD_CONST(LoadConstFalse, HermesValue::encodeBoolValue(false))
+            LOAD_CONST(LoadConstZero, HermesValue::encodeDoubleValue(0))
+            LOAD_CONST(
+                LoadConstUInt8,
+                HermesValue::encodeDoubleValue(ip->iLoadConstUInt8.op2))
+            LOAD_CONST(
+                LoadConstInt,
+                HermesValue::encodeDoubleValue(ip->iLoadConstInt.op2))
+            LOAD_CONST(
+                LoadConstDouble,
+                HermesValue::encodeDoubleValue(ip->iLoadConstDouble.op2))
+#undef LOAD_CONST
+          case OpCode::Jmp:
+          case OpCode::JmpLong:
+            jumpTo(em_.jmp(), target);
+            break;
+          case OpCode::JmpUndefined:
+          case OpCode::JmpUndefinedLong:
+            em_.loadFrameReg(
+                Reg::rax, decodeInstruction(ip).operandValue[1].integer);
+            em_.movImm64(
+                Reg::rdx, HermesValue::encodeUndefinedValue().getRaw());
+            em_.cmp(Reg::rax, Reg::rdx);
+            jumpTo(em_.jcc(Cond::E), target);
+            break;
+          case OpCode::JmpTrue:
+          case OpCode::JmpTrueLong:
+            emitBoolJump(ip, target, true);
+            break;
+          case OpCode::JmpFalse:
+          case OpCode::JmpFalseLong:
+            emitBoolJump(ip, target, false);
+            break;
+          case OpCode::Add:
+          case OpCode::AddN:
+            emitArith(ip, 0x58, op == OpCode::AddN);
+            break;
+          case OpCode::Sub:
+          case OpCode::SubN:
+            emitArith(ip, 0x5C, op == OpCode::SubN);
+            break;
+          case OpCode::Mul:
+          case OpCode::MulN:
+            emitArith(ip, 0x59, op == OpCode::MulN);
+            break;
+          case OpCode::Div:
+          case OpCode::DivN:
+            emitArith(ip, 0x5E, op == OpCode::DivN);
+            break;
+          case OpCode::Inc:
+            emitIncDec(ip, 0x58);
+            break;
+          case OpCode::Dec:
+            emitIncDec(ip, 0x5C);
+            break;
+          default:
+            emitCompareJump(ip, target);
+            break;
+        }
+        break;
+    }
+    offset = next;
+  }
+  // Every function ends in Ret or Throw, so nothing falls off the end.
+  em_.ud2();
+
+  // Exception exit: return ExecutionStatus::EXCEPTION.
+  for (auto fixup : exceptionFixups_)
+    em_.patch(fixup, em_.size());
+  em_.movImm32(Reg::rax, (uint32_t)ExecutionStatus::EXCEPTION);
+  for (auto fixup : returnFixups_)
+    em_.patch(fixup, em_.size());
+  em_.epilogue();
+
+  for (auto &fixup : jumpFixups_) {
+    auto it = nativeOffsets_.find(fixup.second);
+    assert(it != nativeOffsets_.end() && "jump into the middle of an inst");
+    em_.patch(fixup.first, it->second);
+  }
+  return true;
+}
+
+} // namespace
+
+JITContext::JITContext(bool enable, uint32_t threshold)
+    : enabled_(enable), threshold_(threshold) {}
+
+JITContext::~JITContext() {
+  for (auto &region : codeRegions_)
+    oscompat::vm_free(region.base, region.size);
+}
+
+void *JITContext::installCode(const uint8_t *code, size_t size) {
+  /// Code is allocated in regions of at least this many bytes.
+  constexpr size_t kMinRegionSize = 64 * 1024;
+  /// Alignment of the start of each function.
+  constexpr size_t kFunctionAlignment = 16;
+
+  if (codeRegions_.empty() ||
+      codeRegions_.back().size - codeRegions_.back().used < size) {
+    size_t regionSize = llvh::alignTo(
+        std::max(size, kMinRegionSize), oscompat::page_size());
+    auto memOr = oscompat::vm_allocate(regionSize);
+    if (!memOr)
+      return nullptr;
+    oscompat::vm_name(*memOr, regionSize, "hermes-jit");
+    codeRegions_.push_back({*memOr, regionSize, 0});
+  }
+
+  // The region is only writable while code is copied into it.
+  CodeRegion &region = codeRegions_.back();
+  if (!oscompat::vm_protect(
+          region.base, region.size, oscompat::ProtectMode::ReadWrite))
+    return nullptr;
+  void *dest = static_cast<char *>(region.base) + region.used;
+  std::memcpy(dest, code, size);
+  region.used = std::min(
+      region.size, llvh::alignTo(region.used + size, kFunctionAlignment));
+  if (!oscompat::vm_protect(
+          region.base, region.size, oscompat::ProtectMode::ReadExecute))
+    hermes_fatal("JIT: unable to make code executable");
+  return dest;
+}
+
+JITCompiledFunctionPtr JITContext::compileImpl(
+    Runtime &runtime,
+    CodeBlock *codeBlock) {
+  // Don't try again, whatever happens.
+  codeBlock->setDontJIT(true);
+
+  FunctionCompiler compiler{codeBlock};
+  if (!compiler.compile()) {
+    ++numRejected_;
+    return nullptr;
+  }
+
+  const Emitter &em = compiler.emitter();
+  void *code = installCode(em.data(), em.size());
+  if (!code) {
+    ++numRejected_;
+    return nullptr;
+  }
+
+  LLVM_DEBUG(
+      llvh::dbgs() << "JIT: compiled function " << codeBlock->getFunctionID()
+                   << " into " << em.size() << " bytes\n");
+
+  auto fn = reinterpret_cast<JITCompiledFunctionPtr>(code);
+  codeBlock->setJITCompiled(fn);
+  ++numCompiled_;
+  return fn;
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_JIT
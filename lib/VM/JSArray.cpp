@@ -36,16 +36,19 @@ void ArrayImpl::_snapshotAddEdgesImpl(
   auto *const self = vmcast<ArrayImpl>(cell);
   // Add the super type's edges too.
   JSObject::_snapshotAddEdgesImpl(self, gc, snap);
-  if (!self->getIndexedStorage(gc.getPointerBase())) {
+  GCCell *storage = self->indexedStorage_.get(gc.getPointerBase());
+  if (!storage) {
     return;
   }
 
   // This edge has to be called "elements" in order for Chrome to attribute
   // the size of the indexed storage as part of total usage of "JS Arrays".
   snap.addNamedEdge(
-      HeapSnapshot::EdgeType::Internal,
-      "elements",
-      gc.getObjectID(self->getIndexedStorage(gc.getPointerBase())));
+      HeapSnapshot::EdgeType::Internal, "elements", gc.getObjectID(storage));
+  // Raw doubles don't reference anything.
+  if (self->flags_.doubleElements) {
+    return;
+  }
   auto *const indexedStorage = self->getIndexedStorage(gc.getPointerBase());
   const auto beginIndex = self->beginIndex_;
   const auto endIndex = self->endIndex_;
@@ -69,9 +72,7 @@ bool ArrayImpl::_haveOwnIndexedImpl(
 
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_)
-    return !self->getIndexedStorage(runtime)
-                ->at(runtime, index - self->beginIndex_)
-                .isEmpty();
+    return !self->unsafeIsHoleAt(runtime, index);
 
   return false;
 }
@@ -84,9 +85,7 @@ OptValue<PropertyFlags> ArrayImpl::_getOwnIndexedPropertyFlagsImpl(
 
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_ &&
-      !self->getIndexedStorage(runtime)
-           ->at(runtime, index - self->beginIndex_)
-           .isEmpty()) {
+      !self->unsafeIsHoleAt(runtime, index)) {
     PropertyFlags indexedElementFlags{};
     indexedElementFlags.enumerable = 1;
     indexedElementFlags.writable = 1;
@@ -117,15 +116,116 @@ HermesValue ArrayImpl::_getOwnIndexedImpl(
     uint32_t index) {
   NoAllocScope noAllocs{runtime};
 
-  return vmcast<ArrayImpl>(selfObj.get())
-      ->at(runtime, index)
-      .unboxToHV(runtime);
+  return vmcast<ArrayImpl>(selfObj.get())->at(runtime, index);
+}
+
+/// \return the capacity of the storage allocated for the first element,
+/// stored at \p index, of \p self. For a JSArray that is the rest of its
+/// length (up to a limit), so that arrays created with a known length, such as
+/// array literals and new Array(n), are filled without growing the storage.
+static uint32_t
+firstStorageCapacity(ArrayImpl *self, Runtime &runtime, uint32_t index) {
+  constexpr uint32_t kMinCapacity = 4;
+  constexpr uint32_t kMaxLengthCapacity = 1 << 16;
+  auto *arr = dyn_vmcast<JSArray>(self);
+  if (!arr)
+    return kMinCapacity;
+  uint32_t length = JSArray::getLength(arr, runtime);
+  if (index >= length)
+    return kMinCapacity;
+  return std::max(kMinCapacity, std::min(length - index, kMaxLengthCapacity));
+}
+
+ExecutionStatus ArrayImpl::convertToGenericElements(
+    Handle<ArrayImpl> selfHandle,
+    Runtime &runtime) {
+  assert(selfHandle->flags_.doubleElements && "array has generic elements");
+  auto doubles = runtime.makeHandle(selfHandle->getDoubleStorage(runtime));
+  if (!doubles) {
+    selfHandle->flags_.doubleElements = 0;
+    return ExecutionStatus::RETURNED;
+  }
+
+  const uint32_t size = doubles->size();
+  auto arrRes = StorageType::create(runtime, doubles->capacity(), size);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto storage = runtime.makeHandle<StorageType>(std::move(*arrRes));
+  for (uint32_t i = 0; i < size; ++i) {
+    // Holes are already empty in the new storage.
+    if (doubles->isHole(i))
+      continue;
+    // This may allocate a BoxedDouble.
+    const auto shv =
+        SmallHermesValue::encodeNumberValue(doubles->data()[i], runtime);
+    storage->set(runtime, i, shv);
+  }
+
+  selfHandle->flags_.doubleElements = 0;
+  selfHandle->setIndexedStorage(runtime, storage.get(), runtime.getHeap());
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus ArrayImpl::setDoubleStorageEndIndex(
+    Handle<ArrayImpl> selfHandle,
+    Runtime &runtime,
+    uint32_t newLength) {
+  auto *self = selfHandle.get();
+  const auto beginIndex = self->beginIndex_;
+
+  // If the storage hasn't even been allocated.
+  if (!self->getDoubleStorage(runtime)) {
+    if (newLength == 0) {
+      return ExecutionStatus::RETURNED;
+    }
+    auto arrRes = DoubleStorage::create(runtime, newLength, newLength);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->indexedStorage_.set(runtime, arrRes->get(), runtime.getHeap());
+    self->beginIndex_ = 0;
+    self->endIndex_ = newLength;
+    return ExecutionStatus::RETURNED;
+  }
+
+  if (newLength <= beginIndex) {
+    // Remove the storage. If this array grows again it can be re-allocated.
+    self->endIndex_ = beginIndex;
+    self->indexedStorage_.setNull(runtime.getHeap());
+    return ExecutionStatus::RETURNED;
+  }
+
+  auto storage = runtime.makeMutableHandle(self->getDoubleStorage(runtime));
+  if (LLVM_UNLIKELY(
+          DoubleStorage::resize(storage, runtime, newLength - beginIndex) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  self = selfHandle.get();
+  self->endIndex_ = newLength;
+  self->indexedStorage_.set(runtime, storage.get(), runtime.getHeap());
+  return ExecutionStatus::RETURNED;
 }
 
 ExecutionStatus ArrayImpl::setStorageEndIndex(
     Handle<ArrayImpl> selfHandle,
     Runtime &runtime,
     uint32_t newLength) {
+  if (LLVM_UNLIKELY(selfHandle->flags_.doubleElements)) {
+    // Use the doubles unless they would need too large an allocation.
+    if (newLength <= selfHandle->beginIndex_ ||
+        newLength - selfHandle->beginIndex_ <= DoubleStorage::maxElements()) {
+      return setDoubleStorageEndIndex(selfHandle, runtime, newLength);
+    }
+    if (LLVM_UNLIKELY(
+            convertToGenericElements(selfHandle, runtime) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
   auto *self = selfHandle.get();
 
   if (LLVM_UNLIKELY(
@@ -195,6 +295,26 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
   if (LLVM_UNLIKELY(self->flags_.frozen))
     return false;
 
+  if (self->flags_.doubleElements) {
+    // Fast path: store a number within the storage.
+    if (LLVM_LIKELY(
+            value->isNumber() && index >= beginIndex && index < endIndex)) {
+      self->getDoubleStorage(runtime)->set(
+          index - beginIndex, value->getNumber());
+      return true;
+    }
+    auto res = setDoubleElementAt(
+        Handle<ArrayImpl>::vmcast(selfHandle), runtime, index, value);
+    if (res != ExecutionStatus::EXCEPTION && !*res) {
+      // The array now has generic elements; store the value below.
+      self = vmcast<ArrayImpl>(selfHandle.get());
+      beginIndex = self->beginIndex_;
+      endIndex = self->endIndex_;
+    } else {
+      return res;
+    }
+  }
+
   // Check whether the index is within the storage.
   if (LLVM_LIKELY(index >= beginIndex && index < endIndex)) {
     const auto shv = SmallHermesValue::encodeHermesValue(*value, runtime);
@@ -206,8 +326,9 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
 
   // If indexedStorage hasn't even been allocated.
   if (LLVM_UNLIKELY(!self->getIndexedStorage(runtime))) {
-    // Allocate storage with capacity for 4 elements and length 1.
-    auto arrRes = StorageType::create(runtime, 4, 1);
+    // Allocate storage with length 1.
+    auto arrRes = StorageType::create(
+        runtime, firstStorageCapacity(self, runtime, index), 1);
     if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -314,6 +435,105 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
   return true;
 }
 
+CallResult<bool> ArrayImpl::setDoubleElementAt(
+    Handle<ArrayImpl> selfHandle,
+    Runtime &runtime,
+    uint32_t index,
+    Handle<> value) {
+  auto *self = selfHandle.get();
+  assert(self->flags_.doubleElements && "array has generic elements");
+  const auto beginIndex = self->beginIndex_;
+  const auto endIndex = self->endIndex_;
+
+  if (LLVM_UNLIKELY(!value->isNumber())) {
+    if (LLVM_UNLIKELY(
+            convertToGenericElements(selfHandle, runtime) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return false;
+  }
+  const double num = value->getNumber();
+  assert(
+      (index < beginIndex || index >= endIndex) &&
+      "stores within the storage are done by the caller");
+
+  DoubleStorage *storage = self->getDoubleStorage(runtime);
+  // If the storage hasn't even been allocated.
+  if (!storage) {
+    auto arrRes = DoubleStorage::create(
+        runtime, firstStorageCapacity(self, runtime, index), 1);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->indexedStorage_.set(runtime, arrRes->get(), runtime.getHeap());
+    self->beginIndex_ = index;
+    self->endIndex_ = index + 1;
+    (*arrRes)->set(0, num);
+    return true;
+  }
+
+  // Can we do it without reallocation?
+  if (index >= endIndex && index - beginIndex < storage->capacity()) {
+    DoubleStorage::resizeWithinCapacity(storage, index - beginIndex + 1);
+    self->endIndex_ = index + 1;
+    storage->set(index - beginIndex, num);
+    return true;
+  }
+
+  // Leave indexes far away from the current range, and storage larger than a
+  // DoubleStorage can hold, to the generic elements.
+  constexpr uint32_t shiftLimit = (1 << 20);
+  if (LLVM_UNLIKELY(
+          endIndex != beginIndex &&
+          ((index > endIndex && index - endIndex > shiftLimit) ||
+           (index < beginIndex && beginIndex - index > shiftLimit) ||
+           std::max(index + 1, endIndex) - std::min(index, beginIndex) >
+               DoubleStorage::maxElements()))) {
+    if (LLVM_UNLIKELY(
+            convertToGenericElements(selfHandle, runtime) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return false;
+  }
+
+  auto storageHandle = runtime.makeMutableHandle(storage);
+  if (LLVM_UNLIKELY(endIndex == beginIndex)) {
+    // The array is empty.
+    if (DoubleStorage::resize(storageHandle, runtime, 1) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->beginIndex_ = index;
+    self->endIndex_ = index + 1;
+  } else if (index >= endIndex) {
+    // Extending to the right.
+    if (DoubleStorage::resize(
+            storageHandle, runtime, index - beginIndex + 1) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->endIndex_ = index + 1;
+  } else {
+    // Extending to the left. 'index' will become the new 'beginIndex'.
+    assert(index < beginIndex);
+    if (DoubleStorage::resizeLeft(
+            storageHandle, runtime, endIndex - index) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self = selfHandle.get();
+    self->beginIndex_ = index;
+  }
+  storageHandle->set(index - self->beginIndex_, num);
+  self->indexedStorage_.set(runtime, storageHandle.get(), runtime.getHeap());
+  return true;
+}
+
 bool ArrayImpl::_deleteOwnIndexedImpl(
     Handle<JSObject> selfHandle,
     Runtime &runtime,
@@ -321,6 +541,14 @@ bool ArrayImpl::_deleteOwnIndexedImpl(
   auto *self = vmcast<ArrayImpl>(selfHandle.get());
   NoAllocScope noAlloc{runtime};
   if (index >= self->beginIndex_ && index < self->endIndex_) {
+    if (self->flags_.doubleElements) {
+      // Cannot delete indexed elements if we are sealed.
+      if (LLVM_UNLIKELY(self->flags_.sealed) &&
+          !self->unsafeIsHoleAt(runtime, index))
+        return false;
+      self->getDoubleStorage(runtime)->setHole(index - self->beginIndex_);
+      return true;
+    }
     auto *indexedStorage = self->getIndexedStorage(runtime);
     // Cannot delete indexed elements if we are sealed.
     if (LLVM_UNLIKELY(self->flags_.sealed)) {
@@ -348,8 +576,8 @@ bool ArrayImpl::_checkAllOwnIndexedImpl(
 
   // If we have any indexed properties at all, they don't satisfy the
   // requirements.
-  for (uint32_t i = 0, e = self->endIndex_ - self->beginIndex_; i != e; ++i) {
-    if (!self->getIndexedStorage(runtime)->at(runtime, i).isEmpty())
+  for (uint32_t i = self->beginIndex_, e = self->endIndex_; i != e; ++i) {
+    if (!self->unsafeIsHoleAt(runtime, i))
       return false;
   }
   return true;
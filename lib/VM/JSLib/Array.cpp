@@ -13,6 +13,7 @@
 #include "JSLibInternal.h"
 
 #include "hermes/ADT/SafeInt.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/VM/HandleRootOwner-inline.h"
 #include "hermes/VM/JSLib/Sorting.h"
 #include "hermes/VM/Operations.h"
@@ -21,6 +22,8 @@
 #include "hermes/VM/StringView.h"
 
 #include "llvh/ADT/ScopeExit.h"
+
+#include <numeric>
 #pragma GCC diagnostic push
 
 #ifdef HERMES_COMPILER_SUPPORTS_WSHORTEN_64_TO_32
@@ -341,6 +344,8 @@ arrayConstructor(void *, Runtime &runtime, NativeArgs args) {
     }
     selfHandle = arrRes->get();
   }
+  // Keep the elements as doubles while they are numbers.
+  selfHandle->initDoubleElements();
 
   // Possibility 1: new Array(number)
   if (args.getArgCount() == 1 && args.getArg(0).isNumber()) {
@@ -535,12 +540,12 @@ arrayPrototypeToLocaleString(void *, Runtime &runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   MutableHandle<StringPrimitive> element{runtime};
-  element = strings->at(runtime, 0).getString(runtime);
+  element = strings->at(runtime, 0).getString();
   builder->appendStringPrim(element);
   for (uint32_t j = 1; j < len; ++j) {
     // Every element after the first needs a separator before it.
     builder->appendCharacter(separator);
-    element = strings->at(runtime, j).getString(runtime);
+    element = strings->at(runtime, j).getString();
     builder->appendStringPrim(element);
   }
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
@@ -603,11 +608,11 @@ arrayPrototypeAt(void *, Runtime &runtime, NativeArgs args) {
 
   // 7. Return ? Get(O, ! ToString(𝔽(k))).
   if (LLVM_LIKELY(jsArr)) {
-    const SmallHermesValue elm = jsArr->at(runtime, k);
+    const HermesValue elm = jsArr->at(runtime, k);
     if (elm.isEmpty()) {
       return HermesValue::encodeUndefinedValue();
     } else {
-      return elm.unboxToHV(runtime);
+      return elm;
     }
   }
   CallResult<PseudoHandle<>> propRes = JSObject::getComputed_RJS(
@@ -731,15 +736,17 @@ arrayPrototypeConcat(void *, Runtime &runtime, NativeArgs args) {
       // appended to the result array.
       // 5.c.iv. Repeat, while k < len
       for (uint64_t k = 0; k < len; ++k, ++n) {
-        SmallHermesValue subElement = LLVM_LIKELY(arrHandle)
+        HermesValue subElement = LLVM_LIKELY(arrHandle)
             ? arrHandle->at(runtime, k)
-            : SmallHermesValue::encodeEmptyValue();
+            : HermesValue::encodeEmptyValue();
         if (LLVM_LIKELY(!subElement.isEmpty()) &&
             LLVM_LIKELY(n < A->getEndIndex())) {
           // Fast path: quickly set element without making any extra calls.
           // Cast is safe because A->getEndIndex must be in uint32_t range.
+          const auto shv =
+              SmallHermesValue::encodeHermesValue(subElement, runtime);
           JSArray::unsafeSetExistingElementAt(
-              A.get(), runtime, static_cast<uint32_t>(n), subElement);
+              A.get(), runtime, static_cast<uint32_t>(n), shv);
         } else {
           // Slow path fallback if there's an empty slot in arr.
           // We have to use getComputedPrimitiveDescriptor because the property
@@ -865,6 +872,8 @@ arrayPrototypeJoin(void *, Runtime &runtime, NativeArgs args) {
   // Track the size of the resultant string. Use a 64-bit value to detect
   // overflow.
   SafeUInt32 size;
+  // Track whether the result is ASCII, so that it can be built as such.
+  bool isASCII = len == 1 || sep->isASCII();
 
   // Storage for the strings for each element.
   if (LLVM_UNLIKELY(len > JSArray::StorageType::maxElements())) {
@@ -885,14 +894,23 @@ arrayPrototypeJoin(void *, Runtime &runtime, NativeArgs args) {
       size.add(sep->getStringLength());
 
     GCScope gcScope2(runtime);
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getComputed_RJS(O, runtime, i)) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+    // Elements of arrays with fast indexed properties are read from their
+    // storage. Holes are looked up normally, since they may come from the
+    // prototype chain.
+    auto *arr = dyn_vmcast<JSArray>(*O);
+    HermesValue fastElem = arr && arr->hasFastIndexProperties()
+        ? arr->at(runtime, i->getNumberAs<uint32_t>())
+        : HermesValue::encodeEmptyValue();
+    MutableHandle<> elem{runtime, fastElem};
+    if (fastElem.isEmpty()) {
+      if (LLVM_UNLIKELY(
+              (propRes = JSObject::getComputed_RJS(O, runtime, i)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      elem = std::move(*propRes);
     }
 
-    auto elem = runtime.makeHandle(std::move(*propRes));
-
     if (elem->isUndefined() || elem->isNull()) {
       JSArray::setElementAt(strings, runtime, i->getNumber(), emptyString);
     } else {
@@ -903,6 +921,7 @@ arrayPrototypeJoin(void *, Runtime &runtime, NativeArgs args) {
       }
       auto S = runtime.makeHandle(std::move(*strRes));
       size.add(S->getStringLength());
+      isASCII = isASCII && S->isASCII();
       JSArray::setElementAt(strings, runtime, i->getNumber(), S);
     }
 
@@ -914,16 +933,16 @@ arrayPrototypeJoin(void *, Runtime &runtime, NativeArgs args) {
   }
 
   // Allocate the complete result.
-  auto builder = StringBuilder::createStringBuilder(runtime, size);
+  auto builder = StringBuilder::createStringBuilder(runtime, size, isASCII);
   if (builder == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
   MutableHandle<StringPrimitive> element{runtime};
-  element = strings->at(runtime, 0).getString(runtime);
+  element = strings->at(runtime, 0).getString();
   builder->appendStringPrim(element);
   for (size_t i = 1; i < len; ++i) {
     builder->appendStringPrim(sep);
-    element = strings->at(runtime, i).getString(runtime);
+    element = strings->at(runtime, i).getString();
     builder->appendStringPrim(element);
   }
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
@@ -1022,7 +1041,7 @@ namespace {
 /// handles every time we want to compare different elements.
 /// Usage example:
 ///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
+///   timSort(sm, 0, length);
 /// Note that this is generic and does nothing different if passed a JSArray.
 class StandardSortModel : public SortModel {
  private:
@@ -1395,7 +1414,7 @@ CallResult<HermesValue> sortSparse(
   {
     StandardSortModel sm(runtime, array, compareFn);
     if (LLVM_UNLIKELY(
-            quickSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
+            timSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
   }
 
@@ -1403,7 +1422,7 @@ CallResult<HermesValue> sortSparse(
   for (decltype(numProps) i = 0; i != numProps; ++i) {
     gcMarker.flush();
 
-    auto hv = array->at(runtime, i).unboxToHV(runtime);
+    auto hv = array->at(runtime, i);
     assert(
         !hv.isEmpty() &&
         "empty values cannot appear in the array out of nowhere");
@@ -1420,6 +1439,100 @@ CallResult<HermesValue> sortSparse(
 
   return O.getHermesValue();
 }
+
+/// Rearrange elements so that the element at index order[i] moves to index i,
+/// one permutation cycle at a time, using \p get(i) and \p set(i, value) to
+/// access them. Marks the indices that are done by setting order[i] to i.
+template <typename Get, typename Set>
+void applyOrder(std::vector<uint32_t> &order, Get get, Set set) {
+  for (uint32_t i = 0, n = order.size(); i < n; ++i) {
+    if (order[i] == i)
+      continue;
+    auto first = get(i);
+    uint32_t j = i;
+    while (order[j] != i) {
+      uint32_t from = order[j];
+      set(j, get(from));
+      order[j] = j;
+      j = from;
+    }
+    set(j, first);
+    order[j] = j;
+  }
+}
+
+/// Sort a dense array whose elements are all numbers or all strings with the
+/// default comparison, which orders both by their string values. Numbers are
+/// converted to strings once each rather than once per comparison, strings
+/// are compared directly, and the elements are then permuted in the storage.
+/// \return false, without changing \p arr, if the array does not qualify.
+bool sortDenseByDefault(Runtime &runtime, Handle<JSArray> arr, uint64_t len) {
+  if (len < 2 || !arr->hasFastIndexProperties() || !arr->isExtensible() ||
+      arr->getBeginIndex() != 0 || arr->getEndIndex() != len) {
+    return false;
+  }
+
+  NoAllocScope noAllocs{runtime};
+  uint32_t n = len;
+  bool allNumbers = true;
+  bool allStrings = true;
+  for (uint32_t i = 0; i < n && (allNumbers || allStrings); ++i) {
+    HermesValue elem = arr->at(runtime, i);
+    allNumbers = allNumbers && elem.isNumber();
+    allStrings = allStrings && elem.isString();
+  }
+  if (!allNumbers && !allStrings)
+    return false;
+
+  // order[i] is the index of the element that belongs at index i.
+  std::vector<uint32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  if (allStrings) {
+    std::vector<const StringPrimitive *> strs(n);
+    for (uint32_t i = 0; i < n; ++i)
+      strs[i] = arr->at(runtime, i).getString();
+    std::stable_sort(
+        order.begin(), order.end(), [&strs](uint32_t a, uint32_t b) {
+          return strs[a]->compare(strs[b]) < 0;
+        });
+  } else {
+    // The strings of numbers are ASCII, so comparing their bytes orders them
+    // like their UTF-16 code units.
+    std::vector<char> keys(n * NUMBER_TO_STRING_BUF_SIZE);
+    std::vector<uint8_t> keyLens(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      keyLens[i] = numberToString(
+          arr->at(runtime, i).getNumber(),
+          &keys[i * NUMBER_TO_STRING_BUF_SIZE],
+          NUMBER_TO_STRING_BUF_SIZE);
+    }
+    auto key = [&keys, &keyLens](uint32_t i) {
+      return llvh::StringRef(
+          &keys[i * NUMBER_TO_STRING_BUF_SIZE], keyLens[i]);
+    };
+    std::stable_sort(
+        order.begin(), order.end(), [&key](uint32_t a, uint32_t b) {
+          return key(a) < key(b);
+        });
+  }
+
+  if (arr->hasDoubleElements()) {
+    double *doubles = arr->getDoubleStorage(runtime)->data();
+    applyOrder(
+        order,
+        [doubles](uint32_t i) { return doubles[i]; },
+        [doubles](uint32_t i, double d) { doubles[i] = d; });
+  } else {
+    JSArray::StorageType *storage = arr->getIndexedStorage(runtime);
+    applyOrder(
+        order,
+        [&runtime, storage](uint32_t i) { return storage->at(runtime, i); },
+        [&runtime, storage](uint32_t i, SmallHermesValue v) {
+          storage->set(runtime, i, v);
+        });
+  }
+  return true;
+}
 } // anonymous namespace
 
 /// ES5.1 15.4.4.11.
@@ -1448,6 +1561,14 @@ arrayPrototypeSort(void *, Runtime &runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
+  // Arrays of numbers or strings are sorted directly by default.
+  if (!compareFn) {
+    if (auto arr = Handle<JSArray>::dyn_vmcast(O)) {
+      if (sortDenseByDefault(runtime, arr, len))
+        return O.getHermesValue();
+    }
+  }
+
   // If we are not sorting a regular dense array, use a special routine which
   // first copies all properties into an array.
   // Proxies  and host objects however are excluded because they are weird.
@@ -1460,7 +1581,7 @@ arrayPrototypeSort(void *, Runtime &runtime, NativeArgs args) {
   // Use our custom sort routine. We can't use std::sort because it performs
   // optimizations that allow it to bypass calls to std::swap, but our swap
   // function is special, since it needs to use the internal Object functions.
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
+  if (LLVM_UNLIKELY(timSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
   return O.getHermesValue();
@@ -2879,7 +3000,7 @@ arrayPrototypeMap(void *, Runtime &runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(len > JSArray::StorageType::maxElements())) {
     return runtime.raiseRangeError("Out of memory for array elements.");
   }
-  auto arrRes = JSArray::create(runtime, len, len);
+  auto arrRes = JSArray::createWithDoubleElements(runtime, len);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
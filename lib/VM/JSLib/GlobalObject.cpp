@@ -528,6 +528,12 @@ void initGlobalObject(Runtime &runtime, const JSLibFlags &jsLibFlags) {
     runtime.weakRefPrototype = JSObject::create(runtime).getHermesValue();
   }
 
+  // Only define Promise natively if its jobs can go to the microtask queue.
+  if (LLVM_UNLIKELY(runtime.hasNativePromise())) {
+    // "Forward declaration" of Promise.prototype.
+    runtime.promisePrototype = JSObject::create(runtime).getHermesValue();
+  }
+
   // "Forward declaration" of %ArrayIteratorPrototype%.
   runtime.arrayIteratorPrototype =
       JSObject::create(
@@ -644,6 +650,12 @@ void initGlobalObject(Runtime &runtime, const JSLibFlags &jsLibFlags) {
     createWeakRefConstructor(runtime);
   }
 
+  // Otherwise Promise is defined by the internal bytecode.
+  if (LLVM_UNLIKELY(runtime.hasNativePromise())) {
+    // Promise constructor.
+    createPromiseConstructor(runtime);
+  }
+
   // Symbol constructor.
   createSymbolConstructor(runtime);
 
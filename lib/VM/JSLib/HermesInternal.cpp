@@ -173,6 +173,8 @@ ExecutionStatus populateInstrumentedStats(Runtime &runtime, AP addProp) {
   ADD_PROP("js_mallocSizeEstimate", info.mallocSizeEstimate);
   ADD_PROP("js_vaSize", info.va);
   ADD_PROP("js_markStackOverflows", info.numMarkStackOverflows);
+  ADD_PROP("js_regExpCacheHits", runtime.getRegExpCache().getHits());
+  ADD_PROP("js_regExpCacheMisses", runtime.getRegExpCache().getMisses());
   PASSTHROUGH_PROP("js_hermesVolCtxSwitches");
   PASSTHROUGH_PROP("js_hermesInvolCtxSwitches");
   PASSTHROUGH_PROP("js_pageSize");
@@ -725,9 +727,18 @@ CallResult<HermesValue> hermesInternalEnablePromiseRejectionTracker(
     return runtime.raiseTypeError(
         "Promise rejection tracking hook was not registered");
   }
-  return Callable::executeCall1(
-             func, runtime, Runtime::getUndefinedValue(), opts.getHermesValue())
-      .toCallResultHermesValue();
+  auto res = Callable::executeCall1(
+      func, runtime, Runtime::getUndefinedValue(), opts.getHermesValue());
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // With the native Promise, the hook returns the function to call for
+  // HostPromiseRejectionTracker.
+  if (runtime.hasNativePromise() && vmisa<Callable>(res->get())) {
+    runtime.promiseRejectionTracker_ = res->get();
+    return HermesValue::encodeUndefinedValue();
+  }
+  return res->get();
 }
 
 #ifdef HERMES_ENABLE_FUZZILLI
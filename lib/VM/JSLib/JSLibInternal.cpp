@@ -432,7 +432,7 @@ CallResult<HermesValue> createDynamicFunction(
   MutableHandle<StringPrimitive> element{runtime};
   for (uint32_t i = 0; i < paramCount; ++i) {
     // Copy params into str.
-    element = params->at(runtime, i).getString(runtime);
+    element = params->at(runtime, i).getString();
     builder->appendStringPrim(element);
     if (i < paramCount - 1) {
       // If there's more params left to put, need to add a comma.
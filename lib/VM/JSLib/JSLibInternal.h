@@ -405,6 +405,9 @@ Handle<JSObject> createWeakSetConstructor(Runtime &runtime);
 /// Create the WeakRef constructor and populate methods.
 Handle<JSObject> createWeakRefConstructor(Runtime &runtime);
 
+/// Create the Promise constructor and populate methods.
+Handle<JSObject> createPromiseConstructor(Runtime &runtime);
+
 /// Create the Symbol constructor and populate methods.
 Handle<JSObject> createSymbolConstructor(Runtime &runtime);
 
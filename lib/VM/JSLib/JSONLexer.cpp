@@ -7,6 +7,7 @@
 
 #include "JSONLexer.h"
 
+#include "hermes/Support/CharacterScan.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "llvh/ADT/ScopeExit.h"
 
@@ -19,15 +20,31 @@ static const char *TrueString = "true";
 static const char *FalseString = "false";
 static const char *NullString = "null";
 
+/// JSONWhiteSpace includes <TAB>, <CR>, <LF>, <SP>.
+static const char16_t kWhiteSpaceChars[] = {u'\t', u'\r', u'\n', u' '};
+
+/// The characters that end a run of plain characters in a string, other than
+/// the control characters below U+0020.
+static const char16_t kStringSpecialChars[] = {u'"', u'\\'};
+
 static bool isJSONWhiteSpace(char16_t ch) {
-  // JSONWhiteSpace includes <TAB>, <CR>, <LF>, <SP>.
   return (ch == u'\t' || ch == u'\r' || ch == u'\n' || ch == u' ');
 }
 
+/// \return whether \p ch may continue a number, as accepted by scanNumber.
+static bool isNumberChar(char16_t ch) {
+  return ch == u'-' || ch == u'+' || ch == u'.' || (ch | 32) == u'e' ||
+      (ch >= u'0' && ch <= u'9');
+}
+
 ExecutionStatus JSONLexer::advance() {
-  // Skip whitespaces.
+  // Skip whitespaces. Compact JSON has none between tokens, so check the
+  // first character before scanning for the end of a longer run.
   while (curCharPtr_.hasChar() && isJSONWhiteSpace(*curCharPtr_)) {
-    ++curCharPtr_;
+    llvh::ArrayRef<char16_t> avail = curCharPtr_.available();
+    const char16_t *nonSpace = findFirstNotOf(
+        avail.begin(), avail.end(), llvh::makeArrayRef(kWhiteSpaceChars));
+    curCharPtr_ += nonSpace - avail.begin();
   }
 
   // End of buffer.
@@ -96,11 +113,51 @@ CallResult<char16_t> JSONLexer::consumeUnicode() {
 }
 
 ExecutionStatus JSONLexer::scanNumber() {
+  // Fast path for numbers without an exponent and with at most 15 digits,
+  // which end within the available input. The digits form an integer that is
+  // exactly representable as a double, as is the power of ten it is divided
+  // by, so the division is correctly rounded.
+  {
+    static const double kPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    constexpr unsigned kMaxDigits = 15;
+
+    llvh::ArrayRef<char16_t> avail = curCharPtr_.available();
+    const char16_t *p = avail.begin();
+    const char16_t *end = avail.end();
+    const bool negative = *p == u'-';
+    if (negative)
+      ++p;
+    const char16_t *intBegin = p;
+    uint64_t digits = 0;
+    unsigned numDigits = 0;
+    for (; p != end && *p >= u'0' && *p <= u'9' && numDigits < kMaxDigits;
+         ++p, ++numDigits)
+      digits = digits * 10 + (*p - u'0');
+    const unsigned intDigits = numDigits;
+    if (p != end && *p == u'.' && intDigits) {
+      ++p;
+      for (; p != end && *p >= u'0' && *p <= u'9' && numDigits < kMaxDigits;
+           ++p, ++numDigits)
+        digits = digits * 10 + (*p - u'0');
+    }
+    const unsigned fracDigits = numDigits - intDigits;
+    // The integer part cannot start with 0 unless it is 0, and a fraction
+    // needs at least one digit. Anything else the slow path handles.
+    if (intDigits && (*intBegin != u'0' || intDigits == 1) &&
+        (fracDigits || p[-1] != u'.') && p != end && !isNumberChar(*p)) {
+      double value = (double)digits / kPowersOfTen[fracDigits];
+      curCharPtr_ += p - avail.begin();
+      token_.setNumber(negative ? -value : value);
+      return ExecutionStatus::RETURNED;
+    }
+  }
+
   llvh::SmallVector<char, 32> str8;
   while (curCharPtr_.hasChar()) {
     auto ch = *curCharPtr_;
-    if (!(ch == u'-' || ch == u'+' || ch == u'.' || (ch | 32) == u'e' ||
-          (ch >= u'0' && ch <= u'9'))) {
+    if (!isNumberChar(ch)) {
       break;
     }
     str8.push_back(ch);
@@ -139,6 +196,22 @@ ExecutionStatus JSONLexer::scanString() {
       llvh::make_scope_exit([this] { curCharPtr_.cancelCapture(); });
 
   while (curCharPtr_.hasChar()) {
+    // Skip the run of plain characters up to the next quote, backslash or
+    // control character.
+    llvh::ArrayRef<char16_t> avail = curCharPtr_.available();
+    const char16_t *special = findFirstOfOrBelow(
+        avail.begin(),
+        avail.end(),
+        llvh::makeArrayRef(kStringSpecialChars),
+        u'\u0020');
+    if (hasEscape)
+      tmpStorage.append(avail.begin(), special);
+    curCharPtr_ += special - avail.begin();
+    if (special == avail.end()) {
+      // Convert more input, if there is any.
+      continue;
+    }
+
     if (*curCharPtr_ == '"') {
       // End of string.
       llvh::ArrayRef<char16_t> strRef =
@@ -160,63 +233,58 @@ ExecutionStatus JSONLexer::scanString() {
     } else if (*curCharPtr_ <= '\u001F') {
       return error(u"U+0000 thru U+001F is not allowed in string");
     }
-    if (*curCharPtr_ == u'\\') {
-      if (!hasEscape) {
-        // This is the first escape character encountered, so append everything
-        // we've seen so far to tmpStorage.
-        tmpStorage.append(curCharPtr_.endCapture());
-      }
-      hasEscape = true;
-      ++curCharPtr_;
-      if (!curCharPtr_.hasChar()) {
-        return error("Unexpected end of input");
-      }
-      switch (*curCharPtr_) {
-        case u'"':
-        case u'/':
-        case u'\\':
-          tmpStorage.push_back(*curCharPtr_);
-          ++curCharPtr_;
-          break;
-
-        case 'b':
-          ++curCharPtr_;
-          tmpStorage.push_back(8);
-          break;
-        case 'f':
-          ++curCharPtr_;
-          tmpStorage.push_back(12);
-          break;
-        case 'n':
-          ++curCharPtr_;
-          tmpStorage.push_back(10);
-          break;
-        case 'r':
-          ++curCharPtr_;
-          tmpStorage.push_back(13);
-          break;
-        case 't':
-          ++curCharPtr_;
-          tmpStorage.push_back(9);
-          break;
-
-        case 'u': {
-          ++curCharPtr_;
-          CallResult<char16_t> cr = consumeUnicode();
-          if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          tmpStorage.push_back(*cr);
-          break;
-        }
+    assert(*curCharPtr_ == u'\\' && "Unexpected special character");
+    if (!hasEscape) {
+      // This is the first escape character encountered, so append everything
+      // we've seen so far to tmpStorage.
+      tmpStorage.append(curCharPtr_.endCapture());
+    }
+    hasEscape = true;
+    ++curCharPtr_;
+    if (!curCharPtr_.hasChar()) {
+      return error("Unexpected end of input");
+    }
+    switch (*curCharPtr_) {
+      case u'"':
+      case u'/':
+      case u'\\':
+        tmpStorage.push_back(*curCharPtr_);
+        ++curCharPtr_;
+        break;
+
+      case 'b':
+        ++curCharPtr_;
+        tmpStorage.push_back(8);
+        break;
+      case 'f':
+        ++curCharPtr_;
+        tmpStorage.push_back(12);
+        break;
+      case 'n':
+        ++curCharPtr_;
+        tmpStorage.push_back(10);
+        break;
+      case 'r':
+        ++curCharPtr_;
+        tmpStorage.push_back(13);
+        break;
+      case 't':
+        ++curCharPtr_;
+        tmpStorage.push_back(9);
+        break;
 
-        default:
-          return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
+      case 'u': {
+        ++curCharPtr_;
+        CallResult<char16_t> cr = consumeUnicode();
+        if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        tmpStorage.push_back(*cr);
+        break;
       }
-    } else {
-      if (hasEscape)
-        tmpStorage.push_back(*curCharPtr_);
-      ++curCharPtr_;
+
+      default:
+        return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
     }
   }
   return error("Unexpected end of input");
@@ -0,0 +1,1119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// ES2022 27.2 Promise Objects, and the spawnAsync builtin that drives async
+/// functions with them. Only installed when the runtime has a microtask queue;
+/// otherwise Promise comes from the polyfill in the internal bytecode.
+//===----------------------------------------------------------------------===//
+
+#include "JSLibInternal.h"
+
+#include "hermes/VM/JSGenerator.h"
+#include "hermes/VM/JSLib.h"
+#include "hermes/VM/JSPromise.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// ES2022 27.2.1.1 PromiseCapability Records.
+struct PromiseCapability {
+  Handle<JSObject> promise;
+  Handle<Callable> resolve;
+  Handle<Callable> reject;
+};
+
+/// Slots of GetCapabilitiesExecutor functions.
+enum CapabilityExecutorSlotIndexes { resolve, reject, COUNT };
+
+/// Slots of the functions created by Promise.prototype.finally.
+enum FinallySlotIndexes { onFinally, constructor, FINALLY_COUNT };
+
+/// Slots of the value thunks created by Promise.prototype.finally.
+enum FinallyThunkSlotIndexes { value, FINALLY_THUNK_COUNT };
+
+/// The combinators that take an iterable of promises.
+enum class Combinator : uintptr_t { All, AllSettled, Any, Race };
+
+/// What a combinator element function does with its argument. Passed as the
+/// context of promiseCombinatorElementFunction.
+enum class ElementKind : uintptr_t {
+  /// Promise.all Resolve Element Functions.
+  All,
+  /// Promise.allSettled Resolve Element Functions.
+  AllSettledFulfilled,
+  /// Promise.allSettled Reject Element Functions.
+  AllSettledRejected,
+  /// Promise.any Reject Element Functions.
+  AnyRejected,
+};
+
+// A NativeFunction has room for two additional slots only, so the functions
+// below keep any further state elsewhere.
+
+/// Slots of combinator element functions.
+enum ElementSlotIndexes {
+  /// The CombinatorRecord shared by all the element functions of a call, or
+  /// undefined once this function was called.
+  record,
+  /// The index of the element in the values list.
+  index,
+  ELEMENT_COUNT
+};
+
+/// The fields of the ArrayStorage shared by all the element functions of a
+/// combinator call.
+enum CombinatorRecordIndexes {
+  /// The JSArray with the values (or errors for Promise.any).
+  values,
+  /// [[RemainingElements]], as a number.
+  remaining,
+  /// The capability function to call with the values once all are settled.
+  settle,
+  /// For allSettled, an ArrayStorage with the [[AlreadyCalled]] flag shared
+  /// by the two element functions of each element. Undefined otherwise.
+  alreadyCalled,
+  RECORD_COUNT
+};
+
+/// Slots of the functions resuming async functions. The state of an async
+/// function call is split between its two step functions.
+enum AsyncStepSlotIndexes {
+  /// The GeneratorInnerFunction in onNext, the JSPromise in onThrow.
+  state,
+  /// The other step function.
+  otherStep,
+  ASYNC_STEP_COUNT
+};
+
+/// \return the NativeFunction being executed.
+Handle<NativeFunction> getCallee(Runtime &runtime) {
+  return Handle<NativeFunction>::vmcast(
+      runtime.getCurrentFrame()->getCalleeClosureHandleUnsafe());
+}
+
+/// \return the value of the additional slot \p index of \p fn.
+HermesValue
+getSlot(Handle<NativeFunction> fn, Runtime &runtime, unsigned index) {
+  return NativeFunction::getAdditionalSlotValue(*fn, runtime, index)
+      .unboxToHV(runtime);
+}
+
+/// Set the additional slot \p index of \p fn to \p value.
+void setSlot(
+    Handle<NativeFunction> fn,
+    Runtime &runtime,
+    unsigned index,
+    HermesValue value) {
+  // Encode first: boxing may allocate and move fn.
+  auto encoded = SmallHermesValue::encodeHermesValue(value, runtime);
+  NativeFunction::setAdditionalSlotValue(*fn, runtime, index, encoded);
+}
+
+/// ES2022 27.2.1.5 NewPromiseCapability(C). The executor is only created for
+/// constructors other than %Promise%.
+CallResult<PromiseCapability> newPromiseCapability(
+    Runtime &runtime,
+    Handle<> C) {
+  if (C.getHermesValue().getRaw() == runtime.promiseConstructor.getRaw()) {
+    auto promise = runtime.makeHandle(JSPromise::create(runtime));
+    MutableHandle<Callable> resolveFn{runtime};
+    MutableHandle<Callable> rejectFn{runtime};
+    JSPromise::createResolvingFunctions(promise, runtime, resolveFn, rejectFn);
+    return PromiseCapability{promise, resolveFn, rejectFn};
+  }
+
+  // 1. If IsConstructor(C) is false, throw a TypeError exception.
+  auto isConstructorRes = isConstructor(runtime, *C);
+  if (LLVM_UNLIKELY(isConstructorRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  if (!*isConstructorRes)
+    return runtime.raiseTypeError("Promise capability needs a constructor");
+
+  // 3-5. Let executor be a new GetCapabilitiesExecutor function.
+  auto executor = NativeFunction::createWithoutPrototype(
+      runtime,
+      nullptr,
+      promiseCapabilityExecutor,
+      Predefined::getSymbolID(Predefined::emptyString),
+      2,
+      CapabilityExecutorSlotIndexes::COUNT);
+  setSlot(
+      executor,
+      runtime,
+      CapabilityExecutorSlotIndexes::resolve,
+      HermesValue::encodeUndefinedValue());
+  setSlot(
+      executor,
+      runtime,
+      CapabilityExecutorSlotIndexes::reject,
+      HermesValue::encodeUndefinedValue());
+
+  // 6. Let promise be ? Construct(C, « executor »).
+  auto promiseRes = Callable::executeConstruct1(
+      Handle<Callable>::vmcast(C), runtime, executor);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto promise =
+      runtime.makeHandle<JSObject>(vmcast<JSObject>(promiseRes->get()));
+
+  // 7-8. The functions must have been set to callables.
+  auto resolveFn = Handle<Callable>::dyn_vmcast(runtime.makeHandle(
+      getSlot(executor, runtime, CapabilityExecutorSlotIndexes::resolve)));
+  auto rejectFn = Handle<Callable>::dyn_vmcast(runtime.makeHandle(
+      getSlot(executor, runtime, CapabilityExecutorSlotIndexes::reject)));
+  if (!resolveFn || !rejectFn)
+    return runtime.raiseTypeError("Promise resolve or reject is not callable");
+  return PromiseCapability{promise, resolveFn, rejectFn};
+}
+
+/// IfAbruptRejectPromise: reject the promise of \p capability with the
+/// pending exception, unless it is uncatchable.
+/// \return the promise of \p capability.
+CallResult<HermesValue> rejectWithThrownValue(
+    Runtime &runtime,
+    const PromiseCapability &capability) {
+  if (isUncatchableError(runtime.getThrownValue()))
+    return ExecutionStatus::EXCEPTION;
+  auto thrown = runtime.makeHandle(runtime.getThrownValue());
+  runtime.clearThrownValue();
+  if (LLVM_UNLIKELY(
+          Callable::executeCall1(
+              capability.reject,
+              runtime,
+              Runtime::getUndefinedValue(),
+              *thrown) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return capability.promise.getHermesValue();
+}
+
+/// Invoke(\p target, "then", « \p onFulfilled, \p onRejected »).
+CallResult<HermesValue> invokeThen(
+    Runtime &runtime,
+    Handle<> target,
+    Handle<> onFulfilled,
+    Handle<> onRejected) {
+  auto objRes = toObject(runtime, target);
+  if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto thenRes = JSObject::getNamed_RJS(
+      runtime.makeHandle<JSObject>(*objRes),
+      runtime,
+      Predefined::getSymbolID(Predefined::then));
+  if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto then =
+      Handle<Callable>::dyn_vmcast(runtime.makeHandle(std::move(*thenRes)));
+  if (!then)
+    return runtime.raiseTypeError("then is not callable");
+  return Callable::executeCall2(
+             then, runtime, target, *onFulfilled, *onRejected)
+      .toCallResultHermesValue();
+}
+
+/// ES2022 27.2.4.7.1 PromiseResolve(\p C, \p x).
+CallResult<HermesValue>
+promiseResolve(Runtime &runtime, Handle<JSObject> C, Handle<> x) {
+  if (C.getHermesValue().getRaw() == runtime.promiseConstructor.getRaw()) {
+    auto res = JSPromise::promiseResolve(runtime, x);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    return res->getHermesValue();
+  }
+
+  // 1. If IsPromise(x) is true, return x if it was created by C.
+  if (auto promise = Handle<JSPromise>::dyn_vmcast(x)) {
+    auto ctorRes = JSObject::getNamed_RJS(
+        promise, runtime, Predefined::getSymbolID(Predefined::constructor));
+    if (LLVM_UNLIKELY(ctorRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    if (ctorRes->get().getRaw() == C.getHermesValue().getRaw())
+      return x.getHermesValue();
+  }
+
+  // 2-4. Resolve a new promise of C with x.
+  auto capRes = newPromiseCapability(runtime, C);
+  if (LLVM_UNLIKELY(capRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  if (LLVM_UNLIKELY(
+          Callable::executeCall1(
+              capRes->resolve, runtime, Runtime::getUndefinedValue(), *x) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return capRes->promise.getHermesValue();
+}
+
+/// Create an Error like the AggregateError of Promise.any, with \p errors as
+/// its errors property. There is no AggregateError constructor yet, so this
+/// does what the polyfill does.
+CallResult<HermesValue> createAggregateError(
+    Runtime &runtime,
+    Handle<> errors) {
+  auto errRes = Callable::executeConstruct1(
+      Handle<Callable>::vmcast(&runtime.errorConstructor),
+      runtime,
+      runtime.getPredefinedStringHandle(Predefined::allPromisesRejected));
+  if (LLVM_UNLIKELY(errRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto error = runtime.makeHandle<JSObject>(vmcast<JSObject>(errRes->get()));
+  defineProperty(
+      runtime,
+      error,
+      Predefined::getSymbolID(Predefined::name),
+      runtime.getPredefinedStringHandle(Predefined::AggregateError));
+  defineProperty(
+      runtime, error, Predefined::getSymbolID(Predefined::errors), errors);
+  return error.getHermesValue();
+}
+
+/// Called when the remaining element count of a combinator record drops to
+/// zero: pass the values to the capability function.
+CallResult<HermesValue> settleCombinator(
+    Runtime &runtime,
+    Handle<ArrayStorage> record,
+    bool isAny) {
+  auto values = runtime.makeHandle(record->at(CombinatorRecordIndexes::values));
+  auto settleFn = runtime.makeHandle(
+      vmcast<Callable>(record->at(CombinatorRecordIndexes::settle)));
+  MutableHandle<> arg{runtime, *values};
+  if (isAny) {
+    auto errRes = createAggregateError(runtime, values);
+    if (LLVM_UNLIKELY(errRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    arg = *errRes;
+  }
+  return Callable::executeCall1(
+             settleFn, runtime, Runtime::getUndefinedValue(), *arg)
+      .toCallResultHermesValue();
+}
+
+/// Create a combinator element function of \p kind for element \p idx.
+Handle<NativeFunction> createElementFunction(
+    Runtime &runtime,
+    ElementKind kind,
+    Handle<ArrayStorage> record,
+    uint32_t idx) {
+  auto fn = NativeFunction::createWithoutPrototype(
+      runtime,
+      (void *)kind,
+      promiseCombinatorElementFunction,
+      Predefined::getSymbolID(Predefined::emptyString),
+      1,
+      ElementSlotIndexes::ELEMENT_COUNT);
+  setSlot(fn, runtime, ElementSlotIndexes::record, record.getHermesValue());
+  setSlot(
+      fn,
+      runtime,
+      ElementSlotIndexes::index,
+      HermesValue::encodeNumberValue(idx));
+  return fn;
+}
+
+/// The body shared by Promise.all, Promise.allSettled, Promise.any and
+/// Promise.race (ES2022 27.2.4.1-5).
+CallResult<HermesValue>
+performCombinator(Runtime &runtime, NativeArgs args, Combinator combinator) {
+  // 1. Let C be the this value.
+  // 2. Let promiseCapability be ? NewPromiseCapability(C).
+  auto capRes = newPromiseCapability(runtime, args.getThisHandle());
+  if (LLVM_UNLIKELY(capRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  const PromiseCapability capability = *capRes;
+  auto C = Handle<JSObject>::vmcast(args.getThisHandle());
+
+  // 3-4. Let promiseResolve be GetPromiseResolve(C).
+  auto resolveRes = JSObject::getNamed_RJS(
+      C, runtime, Predefined::getSymbolID(Predefined::resolve));
+  if (LLVM_UNLIKELY(resolveRes == ExecutionStatus::EXCEPTION))
+    return rejectWithThrownValue(runtime, capability);
+  auto promiseResolveFn =
+      Handle<Callable>::dyn_vmcast(runtime.makeHandle(std::move(*resolveRes)));
+  if (!promiseResolveFn) {
+    (void)runtime.raiseTypeError("Promise resolve is not callable");
+    return rejectWithThrownValue(runtime, capability);
+  }
+
+  // 5-6. Let iteratorRecord be GetIterator(iterable).
+  auto iterRes = getIterator(runtime, args.getArgHandle(0));
+  if (LLVM_UNLIKELY(iterRes == ExecutionStatus::EXCEPTION))
+    return rejectWithThrownValue(runtime, capability);
+  const IteratorRecord iteratorRecord = *iterRes;
+
+  // The values list and remaining elements count shared by all the element
+  // functions. Promise.race needs neither.
+  MutableHandle<JSArray> values{runtime};
+  MutableHandle<ArrayStorage> record{runtime};
+  if (combinator != Combinator::Race) {
+    auto valuesRes = JSArray::create(runtime, 0, 0);
+    if (LLVM_UNLIKELY(valuesRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    values = valuesRes->get();
+    auto recordRes = ArrayStorage::create(
+        runtime,
+        CombinatorRecordIndexes::RECORD_COUNT,
+        CombinatorRecordIndexes::RECORD_COUNT);
+    if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    record = vmcast<ArrayStorage>(*recordRes);
+    record->set(
+        CombinatorRecordIndexes::values,
+        values.getHermesValue(),
+        runtime.getHeap());
+    record->set(
+        CombinatorRecordIndexes::remaining,
+        HermesValue::encodeNumberValue(1),
+        runtime.getHeap());
+    record->set(
+        CombinatorRecordIndexes::settle,
+        combinator == Combinator::Any ? capability.reject.getHermesValue()
+                                      : capability.resolve.getHermesValue(),
+        runtime.getHeap());
+    record->set(
+        CombinatorRecordIndexes::alreadyCalled,
+        HermesValue::encodeUndefinedValue(),
+        runtime.getHeap());
+  }
+  MutableHandle<ArrayStorage> alreadyCalled{runtime};
+  if (combinator == Combinator::AllSettled) {
+    auto calledRes = ArrayStorage::create(runtime, 0);
+    if (LLVM_UNLIKELY(calledRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    alreadyCalled = vmcast<ArrayStorage>(*calledRes);
+  }
+
+  MutableHandle<> onFulfilled{runtime};
+  MutableHandle<> onRejected{runtime};
+  MutableHandle<> nextPromise{runtime};
+  GCScopeMarkerRAII marker{runtime};
+  for (uint32_t idx = 0;; ++idx) {
+    marker.flush();
+    auto nextRes = iteratorStep(runtime, iteratorRecord);
+    if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION))
+      return rejectWithThrownValue(runtime, capability);
+
+    if (!*nextRes) {
+      // The iterator is done: drop the initial count of 1.
+      if (combinator == Combinator::Race)
+        return capability.promise.getHermesValue();
+      double remaining =
+          record->at(CombinatorRecordIndexes::remaining).getNumber() - 1;
+      record->set(
+          CombinatorRecordIndexes::remaining,
+          HermesValue::encodeNumberValue(remaining),
+          runtime.getHeap());
+      if (remaining == 0) {
+        auto settleRes = settleCombinator(
+            runtime, record, combinator == Combinator::Any);
+        if (LLVM_UNLIKELY(settleRes == ExecutionStatus::EXCEPTION))
+          return rejectWithThrownValue(runtime, capability);
+      }
+      return capability.promise.getHermesValue();
+    }
+
+    auto nextValueRes = JSObject::getNamed_RJS(
+        *nextRes, runtime, Predefined::getSymbolID(Predefined::value));
+    if (LLVM_UNLIKELY(nextValueRes == ExecutionStatus::EXCEPTION))
+      return rejectWithThrownValue(runtime, capability);
+    auto nextValue = runtime.makeHandle(std::move(*nextValueRes));
+
+    // From here on, abrupt completions close the iterator before rejecting.
+    if (combinator != Combinator::Race) {
+      // Append undefined to values.
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(values, runtime, idx + 1) ==
+              ExecutionStatus::EXCEPTION)) {
+        (void)iteratorCloseAndRethrow(runtime, iteratorRecord.iterator);
+        return rejectWithThrownValue(runtime, capability);
+      }
+    }
+
+    // Let nextPromise be ? Call(promiseResolve, constructor, « nextValue »).
+    auto callRes = Callable::executeCall1(
+        promiseResolveFn, runtime, C, nextValue.getHermesValue());
+    if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+      (void)iteratorCloseAndRethrow(runtime, iteratorRecord.iterator);
+      return rejectWithThrownValue(runtime, capability);
+    }
+    nextPromise = callRes->get();
+
+    switch (combinator) {
+      case Combinator::All:
+        onFulfilled = createElementFunction(
+                          runtime, ElementKind::All, record, idx)
+                          .getHermesValue();
+        onRejected = capability.reject.getHermesValue();
+        break;
+      case Combinator::AllSettled: {
+        auto fulfilledFn = createElementFunction(
+            runtime, ElementKind::AllSettledFulfilled, record, idx);
+        auto rejectedFn = createElementFunction(
+            runtime, ElementKind::AllSettledRejected, record, idx);
+        if (LLVM_UNLIKELY(
+                ArrayStorage::push_back(
+                    alreadyCalled, runtime, Runtime::getBoolValue(false)) ==
+                ExecutionStatus::EXCEPTION)) {
+          (void)iteratorCloseAndRethrow(runtime, iteratorRecord.iterator);
+          return rejectWithThrownValue(runtime, capability);
+        }
+        record->set(
+            CombinatorRecordIndexes::alreadyCalled,
+            alreadyCalled.getHermesValue(),
+            runtime.getHeap());
+        onFulfilled = fulfilledFn.getHermesValue();
+        onRejected = rejectedFn.getHermesValue();
+        break;
+      }
+      case Combinator::Any:
+        onFulfilled = capability.resolve.getHermesValue();
+        onRejected = createElementFunction(
+                         runtime, ElementKind::AnyRejected, record, idx)
+                         .getHermesValue();
+        break;
+      case Combinator::Race:
+        onFulfilled = capability.resolve.getHermesValue();
+        onRejected = capability.reject.getHermesValue();
+        break;
+    }
+
+    if (combinator != Combinator::Race) {
+      record->set(
+          CombinatorRecordIndexes::remaining,
+          HermesValue::encodeNumberValue(
+              record->at(CombinatorRecordIndexes::remaining).getNumber() + 1),
+          runtime.getHeap());
+    }
+
+    // Perform ? Invoke(nextPromise, "then", « onFulfilled, onRejected »).
+    auto thenRes = invokeThen(runtime, nextPromise, onFulfilled, onRejected);
+    if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION)) {
+      (void)iteratorCloseAndRethrow(runtime, iteratorRecord.iterator);
+      return rejectWithThrownValue(runtime, capability);
+    }
+  }
+}
+
+/// Resume the generator \p gen of an async function with \p action and
+/// \p value, then await the value it yields or settle \p promise once it
+/// returns or throws. This is Await (ES2022 6.2.3.1) for async functions
+/// compiled to generators.
+ExecutionStatus asyncFunctionResume(
+    Runtime &runtime,
+    Handle<GeneratorInnerFunction> gen,
+    Handle<JSPromise> promise,
+    Handle<Callable> onNext,
+    Handle<Callable> onThrow,
+    Handle<> arg,
+    GeneratorInnerFunction::Action action) {
+  MutableHandle<> value{runtime, *arg};
+  for (;;) {
+    auto valueRes =
+        GeneratorInnerFunction::callInnerFunction(gen, runtime, value, action);
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      // The async function threw: reject its promise.
+      gen->setState(GeneratorInnerFunction::State::Completed);
+      if (isUncatchableError(runtime.getThrownValue()))
+        return ExecutionStatus::EXCEPTION;
+      value = runtime.getThrownValue();
+      runtime.clearThrownValue();
+      return JSPromise::reject(promise, runtime, value);
+    }
+    value = valueRes->get();
+
+    // The async function returned: resolve its promise.
+    if (gen->getState() == GeneratorInnerFunction::State::Completed)
+      return JSPromise::resolve(promise, runtime, value);
+
+    // Awaiting a primitive: there is nothing to adopt, so skip the promise
+    // that PromiseResolve would create and schedule the continuation.
+    if (!value->isObject()) {
+      Runtime::Job job;
+      job.kind = Runtime::Job::Kind::PromiseReaction;
+      job.operands[0] = onNext.getHermesValue();
+      job.operands[1] = *value;
+      runtime.enqueueJob(job);
+      return ExecutionStatus::RETURNED;
+    }
+
+    // 2. Let promise be ? PromiseResolve(%Promise%, value).
+    auto awaitedRes = JSPromise::promiseResolve(runtime, value);
+    if (LLVM_LIKELY(awaitedRes != ExecutionStatus::EXCEPTION)) {
+      // 3-9. Perform PerformPromiseThen(promise, onFulfilled, onRejected).
+      return JSPromise::performThen(
+          *awaitedRes,
+          runtime,
+          onNext,
+          onThrow,
+          Runtime::getUndefinedValue(),
+          Runtime::getUndefinedValue());
+    }
+
+    // The abrupt completion of PromiseResolve is thrown at the await.
+    if (isUncatchableError(runtime.getThrownValue()))
+      return ExecutionStatus::EXCEPTION;
+    value = runtime.getThrownValue();
+    runtime.clearThrownValue();
+    action = GeneratorInnerFunction::Action::Throw;
+  }
+}
+
+} // namespace
+
+Handle<JSObject> createPromiseConstructor(Runtime &runtime) {
+  auto promisePrototype = Handle<JSObject>::vmcast(&runtime.promisePrototype);
+
+  auto cons = defineSystemConstructor<JSPromise>(
+      runtime,
+      Predefined::getSymbolID(Predefined::Promise),
+      promiseConstructor,
+      promisePrototype,
+      1,
+      CellKind::JSPromiseKind);
+  runtime.promiseConstructor = cons.getHermesValue();
+
+  // Promise.prototype.xxx() methods.
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::then),
+      nullptr,
+      promisePrototypeThen,
+      2);
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::catchStr),
+      nullptr,
+      promisePrototypeCatch,
+      1);
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::finallyStr),
+      nullptr,
+      promisePrototypeFinally,
+      1);
+
+  DefinePropertyFlags dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
+  dpf.writable = 0;
+  dpf.enumerable = 0;
+  dpf.configurable = 1;
+
+  // ES2022 27.2.5.5 Promise.prototype [ @@toStringTag ]
+  defineProperty(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::SymbolToStringTag),
+      runtime.getPredefinedStringHandle(Predefined::Promise),
+      dpf);
+
+  // Promise.xxx() static methods.
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::resolve),
+      nullptr,
+      promiseResolveStatic,
+      1);
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::reject),
+      nullptr,
+      promiseRejectStatic,
+      1);
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::all),
+      (void *)Combinator::All,
+      promiseCombinator,
+      1);
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::allSettled),
+      (void *)Combinator::AllSettled,
+      promiseCombinator,
+      1);
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::any),
+      (void *)Combinator::Any,
+      promiseCombinator,
+      1);
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::race),
+      (void *)Combinator::Race,
+      promiseCombinator,
+      1);
+
+  return cons;
+}
+
+// ES2022 27.2.3.1
+CallResult<HermesValue>
+promiseConstructor(void *, Runtime &runtime, NativeArgs args) {
+  // 1. If NewTarget is undefined, throw a TypeError exception.
+  if (!args.isConstructorCall()) {
+    return runtime.raiseTypeError(
+        "Promise() called in function context instead of constructor");
+  }
+  // 2. If IsCallable(executor) is false, throw a TypeError exception.
+  auto executor = args.dyncastArg<Callable>(0);
+  if (!executor) {
+    return runtime.raiseTypeError("Promise executor is not callable");
+  }
+
+  // 3-8. The promise was created by NativeConstructor with the prototype of
+  // NewTarget.
+  auto self = args.vmcastThis<JSPromise>();
+
+  // 9. Let resolvingFunctions be CreateResolvingFunctions(promise).
+  MutableHandle<Callable> resolveFn{runtime};
+  MutableHandle<Callable> rejectFn{runtime};
+  JSPromise::createResolvingFunctions(self, runtime, resolveFn, rejectFn);
+
+  // 10. Let completion be Call(executor, undefined,
+  //       « resolvingFunctions.[[Resolve]], resolvingFunctions.[[Reject]] »).
+  auto callRes = Callable::executeCall2(
+      executor,
+      runtime,
+      Runtime::getUndefinedValue(),
+      resolveFn.getHermesValue(),
+      rejectFn.getHermesValue());
+  // 11. If completion is an abrupt completion, then
+  if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    if (isUncatchableError(runtime.getThrownValue()))
+      return ExecutionStatus::EXCEPTION;
+    auto thrown = runtime.makeHandle(runtime.getThrownValue());
+    runtime.clearThrownValue();
+    // a. Perform ? Call(resolvingFunctions.[[Reject]], undefined,
+    //      « completion.[[Value]] »).
+    if (LLVM_UNLIKELY(
+            Callable::executeCall1(
+                rejectFn, runtime, Runtime::getUndefinedValue(), *thrown) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  }
+  // 12. Return promise.
+  return self.getHermesValue();
+}
+
+// ES2022 27.2.1.5.1 GetCapabilitiesExecutor Functions
+CallResult<HermesValue>
+promiseCapabilityExecutor(void *, Runtime &runtime, NativeArgs args) {
+  auto callee = getCallee(runtime);
+  // 3-4. If promiseCapability.[[Resolve]] or [[Reject]] is not undefined,
+  // throw a TypeError exception.
+  if (!getSlot(callee, runtime, CapabilityExecutorSlotIndexes::resolve)
+           .isUndefined() ||
+      !getSlot(callee, runtime, CapabilityExecutorSlotIndexes::reject)
+           .isUndefined()) {
+    return runtime.raiseTypeError("Promise executor was already called");
+  }
+  // 5-6. Set promiseCapability.[[Resolve]] and [[Reject]].
+  setSlot(
+      callee,
+      runtime,
+      CapabilityExecutorSlotIndexes::resolve,
+      args.getArg(0));
+  setSlot(
+      callee,
+      runtime,
+      CapabilityExecutorSlotIndexes::reject,
+      args.getArg(1));
+  return HermesValue::encodeUndefinedValue();
+}
+
+// ES2022 27.2.5.4
+CallResult<HermesValue>
+promisePrototypeThen(void *, Runtime &runtime, NativeArgs args) {
+  // 1-2. If IsPromise(promise) is false, throw a TypeError exception.
+  auto self = args.dyncastThis<JSPromise>();
+  if (!self) {
+    return runtime.raiseTypeError(
+        "Promise.prototype.then() called on a non-promise");
+  }
+
+  // 3. Let C be ? SpeciesConstructor(promise, %Promise%).
+  auto ctorRes = speciesConstructor(
+      self, runtime, Handle<Callable>::vmcast(&runtime.promiseConstructor));
+  if (LLVM_UNLIKELY(ctorRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  // Promises derived with %Promise% need no resolving functions: the reaction
+  // settles them directly.
+  if (ctorRes->getHermesValue().getRaw() ==
+      runtime.promiseConstructor.getRaw()) {
+    auto derived = runtime.makeHandle(JSPromise::create(runtime));
+    if (LLVM_UNLIKELY(
+            JSPromise::performThen(
+                self,
+                runtime,
+                args.getArgHandle(0),
+                args.getArgHandle(1),
+                derived,
+                Runtime::getUndefinedValue()) == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    return derived.getHermesValue();
+  }
+
+  // 4. Let resultCapability be ? NewPromiseCapability(C).
+  auto capRes = newPromiseCapability(runtime, *ctorRes);
+  if (LLVM_UNLIKELY(capRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  // 5. Return PerformPromiseThen(promise, onFulfilled, onRejected,
+  //      resultCapability).
+  if (LLVM_UNLIKELY(
+          JSPromise::performThen(
+              self,
+              runtime,
+              args.getArgHandle(0),
+              args.getArgHandle(1),
+              capRes->resolve,
+              capRes->reject) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return capRes->promise.getHermesValue();
+}
+
+// ES2022 27.2.5.1
+CallResult<HermesValue>
+promisePrototypeCatch(void *, Runtime &runtime, NativeArgs args) {
+  // 2. Return ? Invoke(promise, "then", « undefined, onRejected »).
+  return invokeThen(
+      runtime,
+      args.getThisHandle(),
+      Runtime::getUndefinedValue(),
+      args.getArgHandle(0));
+}
+
+// ES2022 27.2.5.3
+CallResult<HermesValue>
+promisePrototypeFinally(void *, Runtime &runtime, NativeArgs args) {
+  // 2. If Type(promise) is not Object, throw a TypeError exception.
+  auto self = args.dyncastThis<JSObject>();
+  if (!self) {
+    return runtime.raiseTypeError(
+        "Promise.prototype.finally() called on a non-object");
+  }
+  // 3. Let C be ? SpeciesConstructor(promise, %Promise%).
+  auto ctorRes = speciesConstructor(
+      self, runtime, Handle<Callable>::vmcast(&runtime.promiseConstructor));
+  if (LLVM_UNLIKELY(ctorRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  // 5. If IsCallable(onFinally) is false, pass it on as both handlers.
+  auto onFinally = args.getArgHandle(0);
+  if (!vmisa<Callable>(*onFinally))
+    return invokeThen(runtime, self, onFinally, onFinally);
+
+  // 6. Else, create thenFinally and catchFinally.
+  auto makeFinally = [&](bool isCatch) {
+    auto fn = NativeFunction::createWithoutPrototype(
+        runtime,
+        /* isCatch */ (void *)isCatch,
+        promiseFinallyFunction,
+        Predefined::getSymbolID(Predefined::emptyString),
+        1,
+        FinallySlotIndexes::FINALLY_COUNT);
+    setSlot(fn, runtime, FinallySlotIndexes::onFinally, *onFinally);
+    setSlot(
+        fn,
+        runtime,
+        FinallySlotIndexes::constructor,
+        ctorRes->getHermesValue());
+    return fn;
+  };
+  auto thenFinally = makeFinally(false);
+  auto catchFinally = makeFinally(true);
+  // 7. Return ? Invoke(promise, "then", « thenFinally, catchFinally »).
+  return invokeThen(runtime, self, thenFinally, catchFinally);
+}
+
+/// The Then Finally and Catch Finally Functions of ES2022 27.2.5.3. The
+/// context tells which one the callee is.
+CallResult<HermesValue>
+promiseFinallyFunction(void *ctx, Runtime &runtime, NativeArgs args) {
+  const bool isCatch = (bool)ctx;
+  auto callee = getCallee(runtime);
+  auto onFinally = Handle<Callable>::vmcast(runtime.makeHandle(
+      getSlot(callee, runtime, FinallySlotIndexes::onFinally)));
+  auto C = Handle<JSObject>::vmcast(runtime.makeHandle(
+      getSlot(callee, runtime, FinallySlotIndexes::constructor)));
+
+  // i. Let result be ? Call(onFinally, undefined).
+  auto callRes =
+      Callable::executeCall0(onFinally, runtime, Runtime::getUndefinedValue());
+  if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  // ii. Let promise be ? PromiseResolve(C, result).
+  auto promiseRes =
+      promiseResolve(runtime, C, runtime.makeHandle(std::move(*callRes)));
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto promise = runtime.makeHandle(*promiseRes);
+
+  // iii-iv. Let valueThunk (or thrower) be a function that returns value (or
+  // throws reason).
+  auto thunk = NativeFunction::createWithoutPrototype(
+      runtime,
+      /* isThrow */ (void *)isCatch,
+      promiseFinallyThunk,
+      Predefined::getSymbolID(Predefined::emptyString),
+      0,
+      FinallyThunkSlotIndexes::FINALLY_THUNK_COUNT);
+  setSlot(thunk, runtime, FinallyThunkSlotIndexes::value, args.getArg(0));
+  // v. Return ? Invoke(promise, "then", « valueThunk »).
+  return invokeThen(runtime, promise, thunk, Runtime::getUndefinedValue());
+}
+
+/// The value thunk and thrower functions of ES2022 27.2.5.3.
+CallResult<HermesValue>
+promiseFinallyThunk(void *ctx, Runtime &runtime, NativeArgs) {
+  const bool isThrow = (bool)ctx;
+  HermesValue value = getSlot(
+      getCallee(runtime), runtime, FinallyThunkSlotIndexes::value);
+  if (isThrow)
+    return runtime.setThrownValue(value);
+  return value;
+}
+
+// ES2022 27.2.4.7
+CallResult<HermesValue>
+promiseResolveStatic(void *, Runtime &runtime, NativeArgs args) {
+  // 1-2. If Type(C) is not Object, throw a TypeError exception.
+  auto C = args.dyncastThis<JSObject>();
+  if (!C) {
+    return runtime.raiseTypeError("Promise.resolve() called on a non-object");
+  }
+  // 3. Return ? PromiseResolve(C, x).
+  return promiseResolve(runtime, C, args.getArgHandle(0));
+}
+
+// ES2022 27.2.4.6
+CallResult<HermesValue>
+promiseRejectStatic(void *, Runtime &runtime, NativeArgs args) {
+  // 2. Let promiseCapability be ? NewPromiseCapability(C).
+  auto capRes = newPromiseCapability(runtime, args.getThisHandle());
+  if (LLVM_UNLIKELY(capRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  // 3. Perform ? Call(promiseCapability.[[Reject]], undefined, « r »).
+  if (LLVM_UNLIKELY(
+          Callable::executeCall1(
+              capRes->reject,
+              runtime,
+              Runtime::getUndefinedValue(),
+              args.getArg(0)) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  // 4. Return promiseCapability.[[Promise]].
+  return capRes->promise.getHermesValue();
+}
+
+// ES2022 27.2.4.1-5: Promise.all, Promise.allSettled, Promise.any and
+// Promise.race, told apart by the context.
+CallResult<HermesValue>
+promiseCombinator(void *ctx, Runtime &runtime, NativeArgs args) {
+  return performCombinator(
+      runtime, args, static_cast<Combinator>((uintptr_t)ctx));
+}
+
+// ES2022 27.2.4.1.3, 27.2.4.2.2, 27.2.4.2.3 and 27.2.4.3.2: the element
+// functions of the combinators, told apart by the context.
+CallResult<HermesValue>
+promiseCombinatorElementFunction(void *ctx, Runtime &runtime, NativeArgs args) {
+  const auto kind = static_cast<ElementKind>((uintptr_t)ctx);
+  auto callee = getCallee(runtime);
+
+  // 1-3. If F.[[AlreadyCalled]] is true, return undefined.
+  HermesValue recordVal = getSlot(callee, runtime, ElementSlotIndexes::record);
+  if (recordVal.isUndefined())
+    return HermesValue::encodeUndefinedValue();
+  auto record = runtime.makeHandle(vmcast<ArrayStorage>(recordVal));
+  setSlot(
+      callee,
+      runtime,
+      ElementSlotIndexes::record,
+      HermesValue::encodeUndefinedValue());
+  auto idx = static_cast<uint32_t>(
+      NativeFunction::getAdditionalSlotValue(
+          *callee, runtime, ElementSlotIndexes::index)
+          .getNumber(runtime));
+  // The two element functions of allSettled share [[AlreadyCalled]].
+  if (kind == ElementKind::AllSettledFulfilled ||
+      kind == ElementKind::AllSettledRejected) {
+    auto *alreadyCalled = vmcast<ArrayStorage>(
+        record->at(CombinatorRecordIndexes::alreadyCalled));
+    if (alreadyCalled->at(idx).getBool())
+      return HermesValue::encodeUndefinedValue();
+    alreadyCalled->set(
+        idx, HermesValue::encodeBoolValue(true), runtime.getHeap());
+  }
+
+  // Set values[index] to x, or to a settlement record for allSettled.
+  MutableHandle<> element{runtime, args.getArg(0)};
+  if (kind == ElementKind::AllSettledFulfilled ||
+      kind == ElementKind::AllSettledRejected) {
+    const bool isFulfilled = kind == ElementKind::AllSettledFulfilled;
+    auto obj = runtime.makeHandle(JSObject::create(runtime));
+    auto status = JSObject::defineOwnProperty(
+        obj,
+        runtime,
+        Predefined::getSymbolID(Predefined::status),
+        DefinePropertyFlags::getDefaultNewPropertyFlags(),
+        runtime.getPredefinedStringHandle(
+            isFulfilled ? Predefined::fulfilled : Predefined::rejected));
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    status = JSObject::defineOwnProperty(
+        obj,
+        runtime,
+        Predefined::getSymbolID(
+            isFulfilled ? Predefined::value : Predefined::reason),
+        DefinePropertyFlags::getDefaultNewPropertyFlags(),
+        args.getArgHandle(0));
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    element = obj.getHermesValue();
+  }
+  JSArray::setElementAt(
+      runtime.makeHandle(
+          vmcast<JSArray>(record->at(CombinatorRecordIndexes::values))),
+      runtime,
+      idx,
+      element);
+
+  // Decrement remainingElementsCount, and settle once it reaches 0.
+  double remaining =
+      record->at(CombinatorRecordIndexes::remaining).getNumber() - 1;
+  record->set(
+      CombinatorRecordIndexes::remaining,
+      HermesValue::encodeNumberValue(remaining),
+      runtime.getHeap());
+  if (remaining != 0)
+    return HermesValue::encodeUndefinedValue();
+  return settleCombinator(runtime, record, kind == ElementKind::AnyRejected);
+}
+
+Callable *createAsyncFunctionSpawner(Runtime &runtime) {
+  return *NativeFunction::createWithoutPrototype(
+      runtime,
+      nullptr,
+      asyncFunctionSpawn,
+      Predefined::getSymbolID(Predefined::spawnAsync),
+      3);
+}
+
+/// spawnAsync(genF, self, args): run the generator function an async function
+/// was compiled to, and return the promise for its completion.
+CallResult<HermesValue>
+asyncFunctionSpawn(void *, Runtime &runtime, NativeArgs args) {
+  auto promise = runtime.makeHandle(JSPromise::create(runtime));
+
+  // Create the generator, as genF.apply(self, args) would.
+  auto genF = args.dyncastArg<Callable>(0);
+  auto argList = args.dyncastArg<JSObject>(2);
+  if (!genF || !argList) {
+    return runtime.raiseTypeError("spawnAsync() called with invalid arguments");
+  }
+  auto genRes = Callable::executeCall(
+      genF,
+      runtime,
+      Runtime::getUndefinedValue(),
+      args.getArgHandle(1),
+      argList);
+  if (LLVM_UNLIKELY(genRes == ExecutionStatus::EXCEPTION)) {
+    if (isUncatchableError(runtime.getThrownValue()))
+      return ExecutionStatus::EXCEPTION;
+    auto thrown = runtime.makeHandle(runtime.getThrownValue());
+    runtime.clearThrownValue();
+    if (LLVM_UNLIKELY(
+            JSPromise::reject(promise, runtime, thrown) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    return promise.getHermesValue();
+  }
+  auto gen = runtime.makeHandle(JSGenerator::getInnerFunction(
+      runtime, vmcast<JSGenerator>(genRes->get())));
+
+  // The continuations of every await in this call.
+  auto makeStep = [&](bool isThrow, Handle<> state) {
+    auto fn = NativeFunction::createWithoutPrototype(
+        runtime,
+        /* isThrow */ (void *)isThrow,
+        asyncFunctionStep,
+        Predefined::getSymbolID(Predefined::emptyString),
+        1,
+        AsyncStepSlotIndexes::ASYNC_STEP_COUNT);
+    setSlot(fn, runtime, AsyncStepSlotIndexes::state, *state);
+    return fn;
+  };
+  auto onNext = makeStep(false, gen);
+  auto onThrow = makeStep(true, promise);
+  setSlot(
+      onNext,
+      runtime,
+      AsyncStepSlotIndexes::otherStep,
+      onThrow.getHermesValue());
+  setSlot(
+      onThrow,
+      runtime,
+      AsyncStepSlotIndexes::otherStep,
+      onNext.getHermesValue());
+
+  if (LLVM_UNLIKELY(
+          asyncFunctionResume(
+              runtime,
+              gen,
+              promise,
+              onNext,
+              onThrow,
+              Runtime::getUndefinedValue(),
+              GeneratorInnerFunction::Action::Next) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return promise.getHermesValue();
+}
+
+/// The onFulfilled and onRejected functions of the awaits of an async
+/// function, told apart by the context. They resume the generator with the
+/// awaited value or reason.
+CallResult<HermesValue>
+asyncFunctionStep(void *ctx, Runtime &runtime, NativeArgs args) {
+  const bool isThrow = (bool)ctx;
+  auto callee = getCallee(runtime);
+  auto other = Handle<NativeFunction>::vmcast(runtime.makeHandle(
+      getSlot(callee, runtime, AsyncStepSlotIndexes::otherStep)));
+  auto onNext = isThrow ? other : callee;
+  auto onThrow = isThrow ? callee : other;
+  auto gen = Handle<GeneratorInnerFunction>::vmcast(runtime.makeHandle(
+      getSlot(onNext, runtime, AsyncStepSlotIndexes::state)));
+  auto promise = Handle<JSPromise>::vmcast(runtime.makeHandle(
+      getSlot(onThrow, runtime, AsyncStepSlotIndexes::state)));
+  if (LLVM_UNLIKELY(
+          asyncFunctionResume(
+              runtime,
+              gen,
+              promise,
+              onNext,
+              onThrow,
+              args.getArgHandle(0),
+              isThrow ? GeneratorInnerFunction::Action::Throw
+                      : GeneratorInnerFunction::Action::Next) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return HermesValue::encodeUndefinedValue();
+}
+
+} // namespace vm
+} // namespace hermes
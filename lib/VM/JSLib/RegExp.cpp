@@ -452,8 +452,9 @@ static void createGroupsObject(
         auto groupIdx =
             JSObject::getNamedSlotValueUnsafe(*mappingObj, runtime, desc.slot)
                 .getNumber(runtime);
-        JSObject::setNamedSlotValueUnsafe(
-            *groupsObj, runtime, desc.slot, matchObj->at(runtime, groupIdx));
+        auto shv = SmallHermesValue::encodeHermesValue(
+            matchObj->at(runtime, groupIdx), runtime);
+        JSObject::setNamedSlotValueUnsafe(*groupsObj, runtime, desc.slot, shv);
       });
 
   auto shv = SmallHermesValue::encodeObjectValue(*groupsObj, runtime);
@@ -9,21 +9,28 @@
 
 #include "Object.h"
 
+#include "hermes/Support/CharacterScan.h"
 #include "hermes/Support/Compiler.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSON.h"
 #include "hermes/Support/UTF16Stream.h"
 #include "hermes/VM/ArrayLike.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
+#include "hermes/VM/HiddenClass.h"
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSProxy.h"
+#include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
 
 #include "JSONLexer.h"
 
+#include "llvh/ADT/DenseSet.h"
 #include "llvh/ADT/SmallString.h"
 #include "llvh/Support/SaveAndRestore.h"
 
+#include <memory>
+
 namespace hermes {
 namespace vm {
 
@@ -63,6 +70,29 @@ class RuntimeJSONParser {
   /// If it drops below 0 while parsing, raise a stack overflow.
   int32_t remainingDepth_{MAX_RECURSION_DEPTH};
 
+  /// The most properties an object can have and still be created from a
+  /// cached hidden class. Larger objects would be in dictionary mode anyway.
+  static constexpr uint32_t kMaxShapeProperties =
+      HiddenClass::kDictionaryThreshold;
+
+  /// Number of entries in the shape cache, a power of 2.
+  static constexpr uint32_t kShapeCacheSize = 32;
+
+  /// The keys and values of the objects being parsed, in alternating slots.
+  /// The properties of an object are buffered here until its closing brace,
+  /// so that it can be created directly with the hidden class of its keys.
+  /// Nested objects buffer their properties above those of the enclosing
+  /// object. Created on the first object.
+  MutableHandle<PropStorage> props_;
+
+  /// The hidden classes of the objects parsed so far, by the hash of their
+  /// key sequences. An entry is empty until it is first filled.
+  MutableHandle<PropStorage> shapeClasses_;
+
+  /// The key sequence of each hidden class in shapeClasses_. The symbols are
+  /// kept alive by the hidden classes.
+  llvh::SmallVector<SymbolID, 8> shapeKeys_[kShapeCacheSize];
+
  public:
   explicit RuntimeJSONParser(
       Runtime &runtime,
@@ -71,7 +101,9 @@ class RuntimeJSONParser {
       : runtime_(runtime),
         lexer_(runtime, std::move(jsonString)),
         reviver_(reviver),
-        tmpHandle_(runtime) {}
+        tmpHandle_(runtime),
+        props_(runtime),
+        shapeClasses_(runtime) {}
 
   /// Parse JSON string through lexer_, create objects using runtime_.
   /// If errors occur, this function will return undefined, and the error
@@ -92,6 +124,16 @@ class RuntimeJSONParser {
   /// When this function is finished, the current token must be "}".
   CallResult<HermesValue> parseObject();
 
+  /// Create the object whose keys and values are buffered in props_ from
+  /// \p base onwards, and pop them. If \p named is true, none of the keys is
+  /// index-like and they are all symbols.
+  CallResult<HermesValue> createObject(uint32_t base, bool named);
+
+  /// \return the cached hidden class for the keys buffered in props_ from
+  /// \p base onwards, creating and caching it if needed, or nullptr if the
+  /// object must be created property by property.
+  HiddenClass *getShapeClass(uint32_t base);
+
   /// Use reviver to filter the result.
   CallResult<HermesValue> revive(Handle<> value);
 
@@ -167,6 +209,47 @@ class JSONStringifyer {
   /// The output buffer. The serialization process will append into it.
   llvh::SmallVector<char16_t, 32> output_{};
 
+  /// The properties that operationJO serializes for objects of a hidden
+  /// class, read straight from their slots.
+  struct PlainClassInfo {
+    /// A property with a plain data value.
+    struct Property {
+      /// The name of the property.
+      SymbolID name;
+      /// The slot holding the value.
+      SlotIndex slot;
+      /// The range of the quoted name in quotedNames.
+      uint32_t quotedBegin;
+      uint32_t quotedEnd;
+    };
+
+    /// Whether objects of the class can be serialized from the properties
+    /// below. False if an enumerable property is an accessor.
+    bool plain = true;
+
+    /// The enumerable properties with string names, in enumeration order.
+    std::vector<Property> props;
+
+    /// The quoted names of the properties, concatenated.
+    llvh::SmallVector<char16_t, 64> quotedNames;
+  };
+
+  /// Number of hidden classes whose PlainClassInfo is cached.
+  static constexpr uint32_t kClassCacheSize = 16;
+
+  /// The hidden classes whose PlainClassInfo is in classInfos_, at the same
+  /// index. An entry is empty until it is first filled, and entries are
+  /// replaced in turn.
+  MutableHandle<PropStorage> classCache_;
+
+  /// The PlainClassInfo of each class in classCache_. These are shared so
+  /// that an entry replaced while an object of its class is being serialized
+  /// stays alive until that is done.
+  std::shared_ptr<const PlainClassInfo> classInfos_[kClassCacheSize];
+
+  /// The entry of the cache to fill next.
+  uint32_t nextClassEntry_{0};
+
  public:
   explicit JSONStringifyer(Runtime &runtime)
       : runtime_(runtime),
@@ -179,7 +262,8 @@ class JSONStringifyer {
         tmpHandle2_(runtime),
         operationStrValue_(runtime),
         operationJOK_(runtime),
-        operationStrHolder_(runtime) {}
+        operationStrHolder_(runtime),
+        classCache_(runtime) {}
 
   LLVM_NODISCARD ExecutionStatus init(Handle<> replacer, Handle<> space) {
     auto arrRes = PropStorage::create(runtime_, 4);
@@ -193,6 +277,14 @@ class JSONStringifyer {
       return ExecutionStatus::EXCEPTION;
     }
     stackJO_ = vmcast<PropStorage>(*arrRes);
+    if (LLVM_UNLIKELY(
+            (arrRes = PropStorage::create(runtime_, kClassCacheSize)) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    classCache_ = vmcast<PropStorage>(*arrRes);
+    PropStorage::resizeWithinCapacity(
+        classCache_.get(), runtime_, kClassCacheSize);
     auto cr = initializeReplacer(replacer);
     if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -222,6 +314,10 @@ class JSONStringifyer {
   /// \return whether the result is not undefined.
   CallResult<bool> operationStr(HermesValue key);
 
+  /// The part of operationStr after holder[key] was read as \p value. The key
+  /// is in tmpHandle_ and the holder in operationStrHolder_.
+  CallResult<bool> operationStrWithValue(HermesValue value);
+
   /// Implement the abstract operation Quote(value).
   /// It wraps a String value in double quotes and escapes characters within it.
   void operationQuote(StringView value);
@@ -236,6 +332,27 @@ class JSONStringifyer {
   /// It serializes an object.
   ExecutionStatus operationJO();
 
+  /// The part of operationJO that collects the keys of the object with
+  /// enumerableOwnProperties, or takes them from the property list, and
+  /// serializes their values. Sets \p hasElement if anything was output.
+  ExecutionStatus operationJOKeys(bool &hasElement);
+
+  /// The part of operationJO for objects whose class is described by \p info,
+  /// which reads the values from their slots. Sets \p hasElement if anything
+  /// was output.
+  ExecutionStatus operationJOPlain(
+      const PlainClassInfo &info,
+      bool &hasElement);
+
+  /// \return the PlainClassInfo for the class of \p obj if \p obj is an
+  /// ordinary object whose properties can be read from their slots, or
+  /// nullptr.
+  std::shared_ptr<const PlainClassInfo> getPlainClassInfo(
+      Handle<JSObject> obj);
+
+  /// Append the finite number \p num to output_.
+  void appendNumber(double num);
+
   /// Append '\n' and indent to output_.
   /// The indent is constructed according to depthCount_.
   void indent();
@@ -395,13 +512,35 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
   assert(
       lexer_.getCurToken()->getKind() == JSONTokenKind::LBrace &&
       "Wrong entrance to parseObject");
-  auto object = runtime_.makeHandle(JSObject::create(runtime_));
+  if (LLVM_UNLIKELY(!props_)) {
+    auto arrRes = PropStorage::create(runtime_, 2 * kMaxShapeProperties);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    props_ = vmcast<PropStorage>(*arrRes);
+    if (LLVM_UNLIKELY(
+            (arrRes = PropStorage::create(runtime_, kShapeCacheSize)) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    shapeClasses_ = vmcast<PropStorage>(*arrRes);
+    PropStorage::resizeWithinCapacity(
+        shapeClasses_.get(), runtime_, kShapeCacheSize);
+  }
+  const uint32_t base = props_->size();
+
+  // Whether all the keys so far are symbols, rather than index-like strings.
+  bool named = true;
+  // Set once the object has too many properties to be created from a cached
+  // hidden class, after which the remaining properties are defined directly.
+  MutableHandle<JSObject> object{runtime_};
 
   if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RBrace) {
-    MutableHandle<StringPrimitive> key{runtime_};
+    MutableHandle<> key{runtime_};
+    MutableHandle<> value{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
     for (;;) {
@@ -411,7 +550,23 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
               lexer_.getCurToken()->getKind() != JSONTokenKind::String)) {
         return lexer_.error("Expect a string key in JSON object");
       }
-      key = lexer_.getCurToken()->getString().get();
+      // Index-like keys do not become part of the hidden class, so they are
+      // kept as strings and the object is created property by property.
+      Handle<StringPrimitive> keyStr = lexer_.getCurToken()->getString();
+      if (LLVM_UNLIKELY(
+              toArrayIndex(StringPrimitive::createStringView(runtime_, keyStr))
+                  .hasValue())) {
+        named = false;
+        key = keyStr.getHermesValue();
+      } else {
+        auto symRes =
+            runtime_.getIdentifierTable().getSymbolHandleFromPrimitive(
+                runtime_, createPseudoHandle(keyStr.get()));
+        if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        key = HermesValue::encodeSymbolValue(**symRes);
+      }
 
       if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -429,13 +584,35 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
       if (LLVM_UNLIKELY(parRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-
-      (void)JSObject::defineOwnComputedPrimitive(
-          object,
-          runtime_,
-          key,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_.makeHandle(*parRes));
+      value = *parRes;
+
+      if (LLVM_UNLIKELY(object)) {
+        (void)JSObject::defineOwnComputedPrimitive(
+            object,
+            runtime_,
+            key,
+            DefinePropertyFlags::getDefaultNewPropertyFlags(),
+            value);
+      } else {
+        if (LLVM_UNLIKELY(
+                PropStorage::push_back(props_, runtime_, key) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (LLVM_UNLIKELY(
+                PropStorage::push_back(props_, runtime_, value) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (LLVM_UNLIKELY(
+                props_->size() - base > 2 * kMaxShapeProperties)) {
+          auto objRes = createObject(base, false);
+          if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION)) {
+            return ExecutionStatus::EXCEPTION;
+          }
+          object = vmcast<JSObject>(*objRes);
+        }
+      }
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
         if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
@@ -453,9 +630,97 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         "Unexpected stop for object parse");
   }
 
+  if (object)
+    return object.getHermesValue();
+  return createObject(base, named);
+}
+
+CallResult<HermesValue> RuntimeJSONParser::createObject(
+    uint32_t base,
+    bool named) {
+  GCScopeMarkerRAII marker{runtime_};
+  const uint32_t numProps = (props_->size() - base) / 2;
+  if (named && numProps) {
+    if (HiddenClass *clazz = getShapeClass(base)) {
+      PseudoHandle<JSObject> object =
+          JSObject::create(runtime_, runtime_.makeHandle(clazz));
+      // The class was built by adding the keys in order to an empty class, so
+      // the properties occupy consecutive slots.
+      for (uint32_t i = 0; i < numProps; ++i) {
+        JSObject::setNamedSlotValueUnsafe(
+            object.get(), runtime_, i, props_->at(base + 2 * i + 1));
+      }
+      PropStorage::resizeWithinCapacity(props_.get(), runtime_, base);
+      return HermesValue::encodeObjectValue(object.get());
+    }
+  }
+
+  auto object = runtime_.makeHandle(JSObject::create(runtime_, numProps));
+  MutableHandle<> key{runtime_};
+  MutableHandle<> value{runtime_};
+  for (uint32_t i = 0; i < numProps; ++i) {
+    key = props_->at(base + 2 * i).unboxToHV(runtime_);
+    value = props_->at(base + 2 * i + 1).unboxToHV(runtime_);
+    (void)JSObject::defineOwnComputedPrimitive(
+        object,
+        runtime_,
+        key,
+        DefinePropertyFlags::getDefaultNewPropertyFlags(),
+        value);
+  }
+  PropStorage::resizeWithinCapacity(props_.get(), runtime_, base);
   return object.getHermesValue();
 }
 
+HiddenClass *RuntimeJSONParser::getShapeClass(uint32_t base) {
+  const uint32_t numProps = (props_->size() - base) / 2;
+  assert(
+      numProps <= kMaxShapeProperties && "Too many properties for a shape");
+  llvh::SmallVector<SymbolID, 8> keys;
+  uint32_t hash = 0;
+  for (uint32_t i = 0; i < numProps; ++i) {
+    SymbolID id = props_->at(base + 2 * i).getSymbol();
+    keys.push_back(id);
+    hash = (hash ^ id.unsafeGetRaw()) * 0x9e3779b1u;
+  }
+  const uint32_t index = hash >> (32 - llvh::Log2_32(kShapeCacheSize));
+  SmallHermesValue cached = shapeClasses_->at(index);
+  if (LLVM_LIKELY(!cached.isEmpty() && shapeKeys_[index] == keys))
+    return vmcast<HiddenClass>(cached.getObject(runtime_));
+
+  // Duplicate keys leave a single property holding the last value, which is
+  // what defining them one by one does.
+  llvh::SmallDenseSet<uint32_t, 16> seen;
+  for (SymbolID id : keys) {
+    if (!seen.insert(id.unsafeGetRaw()).second)
+      return nullptr;
+  }
+
+  GCScopeMarkerRAII marker{runtime_};
+  MutableHandle<HiddenClass> clazz{
+      runtime_,
+      *runtime_.getHiddenClassForPrototype(
+          vmcast<JSObject>(runtime_.objectPrototype),
+          JSObject::numOverlapSlots<JSObject>())};
+  for (SymbolID id : keys) {
+    auto addRes = HiddenClass::addProperty(
+        clazz, runtime_, id, PropertyFlags::defaultNewNamedPropertyFlags());
+    if (LLVM_UNLIKELY(addRes == ExecutionStatus::EXCEPTION)) {
+      runtime_.clearThrownValue();
+      return nullptr;
+    }
+    clazz = addRes->first;
+  }
+  assert(!clazz->isDictionary() && "Shape class must not be a dictionary");
+
+  shapeClasses_->set(
+      index,
+      SmallHermesValue::encodeObjectValue(*clazz, runtime_),
+      runtime_.getHeap());
+  shapeKeys_[index] = std::move(keys);
+  return *clazz;
+}
+
 CallResult<HermesValue> RuntimeJSONParser::revive(Handle<> value) {
   auto root = runtime_.makeHandle(JSObject::create(runtime_));
   auto status = JSObject::defineOwnProperty(
@@ -520,7 +785,7 @@ CallResult<HermesValue> RuntimeJSONParser::operationWalk(
     auto keys = *cr;
     GCScopeMarkerRAII marker(runtime_);
     for (uint32_t index = 0, e = keys->getEndIndex(); index < e; ++index) {
-      tmpHandle = keys->at(runtime_, index).unboxToHV(runtime_);
+      tmpHandle = keys->at(runtime_, index);
       if (LLVM_UNLIKELY(
               filter(scopedObject, tmpHandle) == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -665,9 +930,8 @@ ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
     bool exists = false;
     auto len = propertyList_->getEndIndex();
     for (uint32_t i = 0; i < len; ++i) {
-      if (propertyList_->at(runtime_, i)
-              .getString(runtime_)
-              ->equals(tmpHandle_->getString())) {
+      if (propertyList_->at(runtime_, i).getString()->equals(
+              tmpHandle_->getString())) {
         exists = true;
         break;
       }
@@ -739,7 +1003,12 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  operationStrValue_.set(propRes->get());
+  return operationStrWithValue(propRes->get());
+}
+
+CallResult<bool> JSONStringifyer::operationStrWithValue(HermesValue value) {
+  GCScopeMarkerRAII marker{runtime_};
+  operationStrValue_.set(value);
 
   // Str.2. If Type(value) is Object or BigInt, then
   MutableHandle<> hValueHV{runtime_, *operationStrValue_};
@@ -756,12 +1025,12 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   if (auto valueObj = Handle<JSObject>::dyn_vmcast(hValueHV)) {
     // Str.2.
     // Str.2.a: check if toJSON exists in value.
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getNamedWithReceiver_RJS(
-                 valueObj,
-                 runtime_,
-                 Predefined::getSymbolID(Predefined::toJSON),
-                 operationStrValue_)) == ExecutionStatus::EXCEPTION)) {
+    auto propRes = JSObject::getNamedWithReceiver_RJS(
+        valueObj,
+        runtime_,
+        Predefined::getSymbolID(Predefined::toJSON),
+        operationStrValue_);
+    if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
     // Str.2.b: check if toJSON is a Callable.
@@ -868,11 +1137,7 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   // Str.9.
   if (operationStrValue_->isNumber()) {
     if (std::isfinite(operationStrValue_->getNumber())) {
-      auto status = toString_RJS(runtime_, operationStrValue_);
-      assert(
-          status != ExecutionStatus::EXCEPTION &&
-          "toString on a number cannot fail");
-      appendToOutput(status->get());
+      appendNumber(operationStrValue_->getNumber());
     } else {
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
@@ -916,6 +1181,19 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
 }
 
 void JSONStringifyer::operationQuote(StringView value) {
+  // Most strings are ASCII with nothing to escape, and are copied in bulk.
+  if (value.isASCII()) {
+    const char *begin = value.castToCharPtr();
+    const char *end = begin + value.length();
+    static const char kEscapedChars[] = {'"', '\\'};
+    if (findFirstOfOrBelow(
+            begin, end, llvh::makeArrayRef(kEscapedChars), ' ') == end) {
+      output_.push_back(u'"');
+      output_.append(begin, end);
+      output_.push_back(u'"');
+      return;
+    }
+  }
   quoteStringForJSON(output_, value);
 }
 
@@ -954,7 +1232,21 @@ ExecutionStatus JSONStringifyer::operationJA() {
         stackValue_->at(stackValue_->size() - 1).getObject(runtime_));
     // Flush just before the recursion in case any handles were created.
     marker.flush();
-    auto status = operationStr(HermesValue::encodeDoubleValue(index));
+    // Elements of arrays with fast indexed properties are read from their
+    // storage. Holes, and elements removed by toJSON or the replacer, are
+    // looked up normally since they may come from the prototype chain.
+    auto *arr = dyn_vmcast<JSArray>(*operationStrHolder_);
+    HermesValue elem =
+        arr && arr->hasFastIndexProperties() && index < arr->getEndIndex()
+        ? arr->at(runtime_, index)
+        : HermesValue::encodeEmptyValue();
+    CallResult<bool> status{false};
+    if (LLVM_LIKELY(!elem.isEmpty())) {
+      tmpHandle_ = HermesValue::encodeDoubleValue(index);
+      status = operationStrWithValue(elem);
+    } else {
+      status = operationStr(HermesValue::encodeDoubleValue(index));
+    }
     if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -987,6 +1279,37 @@ ExecutionStatus JSONStringifyer::operationJO() {
   auto beginningLoc = output_.size();
   indent();
 
+  // JO.8.
+  bool hasElement = false;
+  std::shared_ptr<const PlainClassInfo> info;
+  if (!propertyList_) {
+    info = getPlainClassInfo(runtime_.makeHandle(vmcast<JSObject>(
+        stackValue_->at(stackValue_->size() - 1).getObject(runtime_))));
+  }
+  marker.flush();
+  ExecutionStatus status =
+      info ? operationJOPlain(*info, hasElement) : operationJOKeys(hasElement);
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  // It's important to reset depthCount_ first, because the last
+  // indent before } should be the old indent.
+  depthCount_ = stepBack;
+
+  if (hasElement) {
+    indent();
+  } else {
+    // If the object is empty, we need to roll back the first indent.
+    output_.resize(beginningLoc);
+  }
+  output_.push_back(u'}');
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSONStringifyer::operationJOKeys(bool &hasElement) {
+  GCScopeMarkerRAII marker{runtime_};
+
   if (propertyList_) {
     // JO.5.
     operationJOK_ = propertyList_.get();
@@ -1019,8 +1342,6 @@ ExecutionStatus JSONStringifyer::operationJO() {
 
   marker.flush();
 
-  // JO.8.
-  bool hasElement = false;
   for (uint32_t index = 0, len = operationJOK_->getEndIndex(); index < len;
        ++index) {
     // JO.8.a.
@@ -1036,7 +1357,7 @@ ExecutionStatus JSONStringifyer::operationJO() {
       indent();
     }
 
-    tmpHandle_ = operationJOK_->at(runtime_, index).unboxToHV(runtime_);
+    tmpHandle_ = operationJOK_->at(runtime_, index);
     if (LLVM_UNLIKELY(!tmpHandle_->isString())) {
       // property may come from getOwnPropertyNames, which may contain numbers.
       // getOwnPropertyNames and propertyList_ are both only populated
@@ -1088,20 +1409,116 @@ ExecutionStatus JSONStringifyer::operationJO() {
       hasElement = true;
     }
   }
-  // It's important to reset depthCount_ first, because the last
-  // indent before } should be the old indent.
-  depthCount_ = stepBack;
+  return ExecutionStatus::RETURNED;
+}
 
-  if (hasElement) {
-    indent();
-  } else {
-    // If the object is empty, we need to roll back the first indent.
-    output_.resize(beginningLoc);
+ExecutionStatus JSONStringifyer::operationJOPlain(
+    const PlainClassInfo &info,
+    bool &hasElement) {
+  // JO.6, 8: the keys are the enumerable properties of the class, and their
+  // values are read from their slots as long as the object keeps the class.
+  // A toJSON or replacer call may change it, in which case the remaining
+  // values are looked up normally.
+  auto obj = runtime_.makeHandle(vmcast<JSObject>(
+      stackValue_->at(stackValue_->size() - 1).getObject(runtime_)));
+  auto clazz = runtime_.makeHandle(obj->getClass(runtime_));
+  GCScopeMarkerRAII marker{runtime_};
+  for (const PlainClassInfo::Property &prop : info.props) {
+    auto savedLocation = output_.size();
+    if (hasElement) {
+      // JO.10.
+      output_.push_back(u',');
+      indent();
+    }
+    // JO.8.b.i-iii
+    output_.append(
+        info.quotedNames.begin() + prop.quotedBegin,
+        info.quotedNames.begin() + prop.quotedEnd);
+    output_.push_back(u':');
+    if (gap_.get()) {
+      output_.push_back(u' ');
+    }
+
+    // JO.9.a.
+    operationStrHolder_ = obj.get();
+    tmpHandle_ = HermesValue::encodeStringValue(
+        runtime_.getStringPrimFromSymbolID(prop.name));
+    CallResult<bool> result{false};
+    if (LLVM_LIKELY(obj->getClass(runtime_) == clazz.get())) {
+      result = operationStrWithValue(
+          JSObject::getNamedSlotValueUnsafe(obj.get(), runtime_, prop.slot)
+              .unboxToHV(runtime_));
+    } else {
+      result = operationStr(*tmpHandle_);
+    }
+    marker.flush();
+    if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(!result.getValue())) {
+      // Str returns undefined, we need to roll back.
+      output_.resize(savedLocation);
+    } else {
+      hasElement = true;
+    }
   }
-  output_.push_back(u'}');
   return ExecutionStatus::RETURNED;
 }
 
+std::shared_ptr<const JSONStringifyer::PlainClassInfo>
+JSONStringifyer::getPlainClassInfo(Handle<JSObject> obj) {
+  if (obj->getKind() != CellKind::JSObjectKind)
+    return nullptr;
+  HiddenClass *clazz = obj->getClass(runtime_);
+  // Dictionaries change in place, and index-like names are enumerated in
+  // numeric order rather than in the order of the class.
+  if (clazz->isDictionary() || clazz->getHasIndexLikeProperties())
+    return nullptr;
+
+  for (uint32_t i = 0; i < kClassCacheSize; ++i) {
+    SmallHermesValue entry = classCache_->at(i);
+    if (!entry.isEmpty() && entry.getObject(runtime_) == clazz)
+      return classInfos_[i]->plain ? classInfos_[i] : nullptr;
+  }
+
+  auto info = std::make_shared<PlainClassInfo>();
+  HiddenClass::forEachProperty(
+      runtime_.makeHandle(clazz),
+      runtime_,
+      [this, &info](SymbolID id, NamedPropertyDescriptor desc) {
+        if (!isPropertyNamePrimitive(id) || !desc.flags.enumerable)
+          return;
+        if (desc.flags.accessor || desc.flags.internalSetter ||
+            desc.flags.hostObject || desc.flags.proxyObject) {
+          info->plain = false;
+          return;
+        }
+        uint32_t quotedBegin = info->quotedNames.size();
+        quoteStringForJSON(
+            info->quotedNames,
+            runtime_.getIdentifierTable().getStringView(runtime_, id));
+        info->props.push_back(
+            {id, desc.slot, quotedBegin, (uint32_t)info->quotedNames.size()});
+      });
+
+  uint32_t idx = nextClassEntry_;
+  nextClassEntry_ = (nextClassEntry_ + 1) % kClassCacheSize;
+  classCache_->set(
+      idx,
+      SmallHermesValue::encodeObjectValue(
+          obj->getClass(runtime_), runtime_),
+      runtime_.getHeap());
+  classInfos_[idx] = std::move(info);
+  return classInfos_[idx]->plain ? classInfos_[idx] : nullptr;
+}
+
+void JSONStringifyer::appendNumber(double num) {
+  assert(std::isfinite(num) && "Only finite numbers are appended");
+  char buf[NUMBER_TO_STRING_BUF_SIZE];
+  size_t len = hermes::numberToString(num, buf, sizeof(buf));
+  output_.append(buf, buf + len);
+}
+
 void JSONStringifyer::indent() {
   if (gap_.get()) {
     output_.push_back(u'\n');
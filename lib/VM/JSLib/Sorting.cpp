@@ -9,7 +9,7 @@
 
 #include "hermes/Support/Compiler.h"
 
-#include "llvh/Support/MathExtras.h"
+#include "llvh/ADT/SmallVector.h"
 
 #include <algorithm>
 #include <vector>
@@ -21,324 +21,416 @@ SortModel::~SortModel() = default;
 
 namespace {
 
-/// Helper function to make sort algorithm stable
-/// If [i] < [j], return true
-/// If [j] < [i], return false
-/// If [i] == [j], compare their original index
-CallResult<bool> _less(
-    SortModel *sm,
-    const std::vector<uint32_t> &index,
-    uint32_t i,
-    uint32_t j) {
-  auto res = sm->compare(i, j);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+/// Runs shorter than this are extended with binary insertion sort. The
+/// minimum run length of a sort is between MIN_MERGE / 2 and MIN_MERGE.
+const uint32_t MIN_MERGE = 32;
+
+/// Once one run of a merge supplies this many elements in a row, the merge
+/// looks for the end of the stretch with a search instead of one comparison
+/// per element.
+const uint32_t MIN_GALLOP = 7;
+
+/// TimSort of the elements [begin, end) of a SortModel.
+/// The elements are not moved while sorting. Instead, the sort orders a
+/// permutation of their positions, comparing the elements at those positions,
+/// and the permutation is applied with swaps at the end. This keeps the number
+/// of swaps, which can call property accessors, below the number of elements,
+/// and leaves the elements untouched if a comparison throws.
+/// The sort always completes, and produces a permutation of the elements, even
+/// with an inconsistent comparison, since every search is bounded by the runs
+/// it searches.
+class TimSort {
+  /// A run of perm_ that is already sorted.
+  struct Run {
+    uint32_t base;
+    uint32_t len;
+  };
+
+  SortModel *sm_;
+
+  /// The first position of the range being sorted.
+  uint32_t begin_;
+
+  /// perm_[i] is the position of the element that belongs at begin_ + i.
+  std::vector<uint32_t> perm_;
+
+  /// Scratch space for merges.
+  std::vector<uint32_t> tmp_;
+
+  /// The stack of runs waiting to be merged. Their lengths grow at least as
+  /// fast as the Fibonacci numbers from the top, so the stack stays small.
+  llvh::SmallVector<Run, 40> runs_;
+
+  /// \return true if the element at position \p a is strictly less than the
+  /// element at position \p b.
+  CallResult<bool> less(uint32_t a, uint32_t b) {
+    auto res = sm_->compare(a, b);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return *res < 0;
   }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  return (*res != 0) ? (*res < 0) : (index[i] < index[j]);
-}
 
-/// Helper function to swap both items and their indices
-ExecutionStatus
-_swap(SortModel *sm, std::vector<uint32_t> &index, uint32_t i, uint32_t j) {
-  if (sm->swap(i, j) == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+  /// \return the length of the run starting at \p lo and ending before \p hi.
+  /// A strictly descending run is reversed in place, which keeps the sort
+  /// stable since it has no equal elements.
+  CallResult<uint32_t> countRunAndMakeAscending(uint32_t lo, uint32_t hi);
+
+  /// Sort [lo, hi) with binary insertion, knowing that [lo, start) is sorted.
+  ExecutionStatus
+  binaryInsertionSort(uint32_t lo, uint32_t hi, uint32_t start);
+
+  /// \return the number of elements of the sorted \p range of length \p len
+  /// that are less than (if \p after is false) or not greater than (if
+  /// \p after is true) the element at position \p key. The search starts at
+  /// the end of the range if \p fromEnd is true, and at its start otherwise,
+  /// and takes a number of comparisons logarithmic in the distance of the
+  /// result from there.
+  CallResult<uint32_t> search(
+      uint32_t key,
+      const uint32_t *range,
+      uint32_t len,
+      bool after,
+      bool fromEnd);
+
+  /// Merge runs until the lengths of the runs on the stack satisfy the
+  /// invariants: for every three consecutive runs A, B, C from the bottom,
+  /// A.len > B.len + C.len and B.len > C.len.
+  ExecutionStatus mergeCollapse();
+
+  /// Merge all the runs on the stack.
+  ExecutionStatus mergeForceCollapse();
+
+  /// Merge the runs at \p i and \p i + 1 of the stack.
+  ExecutionStatus mergeAt(size_t i);
+
+  /// Merge the run of \p len1 elements at \p base1 with the run of \p len2
+  /// elements that follows it, where the first element of the second run is
+  /// less than the first of the first run, and the last element of the first
+  /// run is greater than the last of the second.
+  ExecutionStatus merge(uint32_t base1, uint32_t len1, uint32_t len2);
+
+  /// \return the minimum run length for a sort of \p n elements.
+  static uint32_t minRunLength(uint32_t n) {
+    uint32_t r = 0;
+    while (n >= MIN_MERGE) {
+      r |= n & 1;
+      n >>= 1;
+    }
+    return n + r;
   }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  std::swap(index[i], index[j]);
-  return ExecutionStatus::RETURNED;
-}
 
-/**
- * @param base the beginning of the logical array
- */
-LLVM_NODISCARD ExecutionStatus heapFixDown(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t base,
-    uint32_t begin,
-    uint32_t end) {
-  CallResult<bool> res{false};
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
-    return ExecutionStatus::RETURNED;
+  /// Move the elements to the positions recorded in perm_.
+  ExecutionStatus applyPermutation();
+
+ public:
+  TimSort(SortModel *sm, uint32_t begin, uint32_t end)
+      : sm_(sm), begin_(begin), perm_(end - begin) {
+    for (uint32_t i = 0, e = perm_.size(); i < e; ++i) {
+      perm_[i] = begin + i;
+    }
   }
 
-  uint32_t lastGood = base + (end - base - 2) / 2;
-  uint32_t i = begin;
+  ExecutionStatus sort();
+};
 
-  while (i <= lastGood) {
-    uint32_t j = (i - base) * 2 + 1 + base;
-    // Find the greater of the two children
-    if (j + 1 < end) {
-      res = _less(sm, index, j, j + 1);
-      if (res == ExecutionStatus::EXCEPTION) {
+CallResult<uint32_t> TimSort::countRunAndMakeAscending(
+    uint32_t lo,
+    uint32_t hi) {
+  uint32_t runHi = lo + 1;
+  if (runHi == hi) {
+    return 1;
+  }
+
+  auto res = less(perm_[runHi], perm_[lo]);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  ++runHi;
+  if (*res) {
+    // Strictly descending.
+    for (; runHi < hi; ++runHi) {
+      res = less(perm_[runHi], perm_[runHi - 1]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      if (*res) {
-        ++j;
-      }
-    }
-    // If the child is greater than us, exchange places
-    res = _less(sm, index, i, j);
-    if (res == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+      if (!*res)
+        break;
     }
-    if (!*res) {
-      break;
+    std::reverse(perm_.begin() + lo, perm_.begin() + runHi);
+  } else {
+    // Ascending.
+    for (; runHi < hi; ++runHi) {
+      res = less(perm_[runHi], perm_[runHi - 1]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res)
+        break;
     }
+  }
+  return runHi - lo;
+}
 
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION) {
+ExecutionStatus
+TimSort::binaryInsertionSort(uint32_t lo, uint32_t hi, uint32_t start) {
+  for (; start < hi; ++start) {
+    uint32_t pivot = perm_[start];
+    // Insert the pivot after the elements of [lo, start) it is not less than.
+    auto posRes = search(pivot, &perm_[lo], start - lo, true, true);
+    if (LLVM_UNLIKELY(posRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    i = j;
+    uint32_t pos = lo + *posRes;
+    std::move_backward(
+        perm_.begin() + pos, perm_.begin() + start, perm_.begin() + start + 1);
+    perm_[pos] = pivot;
   }
-
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus heapSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
-    return ExecutionStatus::RETURNED;
-  }
-
-  // "heapify"
-  uint32_t start = (end - begin - 2) / 2 + begin;
-  do {
-    if (heapFixDown(sm, index, begin, start, end) ==
-        ExecutionStatus::EXCEPTION) {
+CallResult<uint32_t> TimSort::search(
+    uint32_t key,
+    const uint32_t *range,
+    uint32_t len,
+    bool after,
+    bool fromEnd) {
+  // The result is the first index at which the elements stop being before
+  // key, meaning not greater than it if after is true and less than it
+  // otherwise.
+  auto isPast = [this, key, range, after](uint32_t idx) -> CallResult<bool> {
+    if (after)
+      return less(key, range[idx]);
+    auto res = less(range[idx], key);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-  } while (start-- != begin);
-
-  while (end - begin > 1) {
-    --end;
-    if (_swap(sm, index, begin, end) == ExecutionStatus::EXCEPTION) {
+    return !*res;
+  };
+
+  // Probe in steps that double, to bound the result to [lo, hi].
+  uint32_t lo = 0, hi = len;
+  for (uint32_t step = 1; step <= hi - lo; step *= 2) {
+    uint32_t idx = fromEnd ? hi - step : lo + step - 1;
+    auto res = isPast(idx);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    if (heapFixDown(sm, index, begin, begin, end) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-  }
-
-  return ExecutionStatus::RETURNED;
-}
-
-ExecutionStatus insertionSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  CallResult<bool> res{false};
-  if (begin == end) {
-    return ExecutionStatus::RETURNED;
-  }
-
-  for (uint32_t i = begin + 1; i != end; ++i) {
-    for (uint32_t j = i; j != begin; --j) {
-      res = _less(sm, index, j, j - 1);
-      if (res == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      if (!*res) {
+    if (*res) {
+      hi = idx;
+      if (!fromEnd)
+        break;
+    } else {
+      lo = idx + 1;
+      if (fromEnd)
         break;
-      }
-      if (_swap(sm, index, j, j - 1) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
     }
   }
-  return ExecutionStatus::RETURNED;
-}
 
-// Must be at lest 3, for "median of three" to work
-const uint32_t INSERTION_THRESHOLD = 6;
-
-/// Performs the partition for quickSort between elements [l,r].
-/// Pre-condition: [l] <= [l+1] <= [r] and [l+1] is the pivot.
-/// This routine is guaranteed to complete even with an inconsistent comparison
-/// routine because it always makes forward progress and doesn't rely on
-/// sentinels.
-/// \return the new index of the pivot.
-CallResult<uint32_t> quickSortPartition(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot.
-  uint32_t pivot = l + 1;
-
-  uint32_t i = pivot + 1, j = r;
-  for (;;) {
-    for (; i <= j; ++i) {
-      res = _less(sm, index, i, pivot);
-      if (res == ExecutionStatus::EXCEPTION)
-        return ExecutionStatus::EXCEPTION;
-      if (!*res)
-        break;
+  // Then binary search within the bounds.
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    auto res = isPast(mid);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
-    assert(i <= r + 1 && "i is out of range");
-
-    for (; i <= j; --j) {
-      res = _less(sm, index, pivot, j);
-      if (res == ExecutionStatus::EXCEPTION)
-        return ExecutionStatus::EXCEPTION;
-      if (!*res)
-        break;
+    if (*res) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
     }
-    assert(j > l && "j is out of range");
+  }
+  return lo;
+}
 
-    if (i >= j)
+ExecutionStatus TimSort::mergeCollapse() {
+  while (runs_.size() > 1) {
+    size_t n = runs_.size() - 2;
+    if ((n > 0 && runs_[n - 1].len <= runs_[n].len + runs_[n + 1].len) ||
+        (n > 1 && runs_[n - 2].len <= runs_[n - 1].len + runs_[n].len)) {
+      if (runs_[n - 1].len < runs_[n + 1].len)
+        --n;
+    } else if (runs_[n].len > runs_[n + 1].len) {
       break;
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION)
+    }
+    if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
-    ++i;
-    --j;
+    }
   }
+  return ExecutionStatus::RETURNED;
+}
 
-  // [j] <= [pivot], we can put the pivot in its final position
-  if (j != pivot) {
-    if (_swap(sm, index, pivot, j) == ExecutionStatus::EXCEPTION)
+ExecutionStatus TimSort::mergeForceCollapse() {
+  while (runs_.size() > 1) {
+    size_t n = runs_.size() - 2;
+    if (n > 0 && runs_[n - 1].len < runs_[n + 1].len)
+      --n;
+    if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
+    }
   }
-
-  return j;
+  return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus doQuickSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    int limit,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-quicksort_top:
-  if (limit <= 0) {
-    // Bail to heap sort
-    return heapSort(sm, index, l, r + 1);
-  }
+ExecutionStatus TimSort::mergeAt(size_t i) {
+  uint32_t base1 = runs_[i].base;
+  uint32_t len1 = runs_[i].len;
+  uint32_t base2 = runs_[i + 1].base;
+  uint32_t len2 = runs_[i + 1].len;
+  assert(base1 + len1 == base2 && "Merging runs that are not consecutive");
 
-  // Median-of-three
-  // Place the middle element at [l+1]
-  if (_swap(sm, index, l + 1, l + ((r - l) >> 1)) ==
-      ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  // Sort, [l], [l+1], [r]
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-  }
-  res = _less(sm, index, l + 1, l);
-  if (res == ExecutionStatus::EXCEPTION) {
+  runs_[i].len = len1 + len2;
+  runs_.erase(runs_.begin() + i + 1);
+
+  // The elements of the first run that the first element of the second run is
+  // not less than are already in place.
+  auto skipRes = search(perm_[base2], &perm_[base1], len1, true, false);
+  if (LLVM_UNLIKELY(skipRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  if (*res) {
-    if (_swap(sm, index, l + 1, l) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
+  base1 += *skipRes;
+  len1 -= *skipRes;
+  if (len1 == 0) {
+    return ExecutionStatus::RETURNED;
   }
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
+
+  // So are the elements of the second run that are not less than the last
+  // element of the first run.
+  auto keepRes =
+      search(perm_[base1 + len1 - 1], &perm_[base2], len2, false, true);
+  if (LLVM_UNLIKELY(keepRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
+  len2 = *keepRes;
+  if (len2 == 0) {
+    return ExecutionStatus::RETURNED;
   }
 
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot and [r] is a sentinel
-  CallResult<uint32_t> partitionResult{quickSortPartition(sm, index, l, r)};
-  if (partitionResult == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  uint32_t j = *partitionResult;
-
-  // To limit the stack size, recurse for the smaller partition and do
-  // tail-recursion for the bigger one
-  uint32_t lSize = j - l;
-  uint32_t rSize = r - j;
-  if (lSize <= rSize) {
-    if (lSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, l, j - 1) ==
-          ExecutionStatus::EXCEPTION) {
+  return merge(base1, len1, len2);
+}
+
+ExecutionStatus TimSort::merge(uint32_t base1, uint32_t len1, uint32_t len2) {
+  // Move the first run out of the way, and merge into its place, taking from
+  // the first run on ties. The destination never passes the next element of
+  // the second run. An exception abandons the sort, so perm_ need not be kept
+  // consistent then.
+  tmp_.assign(perm_.begin() + base1, perm_.begin() + base1 + len1);
+  uint32_t a = 0, b = base1 + len1, dest = base1;
+  const uint32_t end2 = b + len2;
+  while (a < len1 && b < end2) {
+    // Take one element at a time until one run supplies MIN_GALLOP in a row.
+    uint32_t winsA = 0, winsB = 0;
+    while (winsA < MIN_GALLOP && winsB < MIN_GALLOP) {
+      auto res = less(perm_[b], tmp_[a]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-    } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+      if (*res) {
+        perm_[dest++] = perm_[b++];
+        ++winsB;
+        winsA = 0;
+        if (b == end2)
+          break;
+      } else {
+        perm_[dest++] = tmp_[a++];
+        ++winsA;
+        winsB = 0;
+        if (a == len1)
+          break;
       }
     }
 
-    if (rSize > INSERTION_THRESHOLD) {
-      l = j + 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
-          ExecutionStatus::EXCEPTION) {
+    // Then copy whole stretches of each run while they stay long.
+    while (a < len1 && b < end2) {
+      auto countA = search(perm_[b], &tmp_[a], len1 - a, true, false);
+      if (LLVM_UNLIKELY(countA == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-    }
+      std::copy(
+          tmp_.begin() + a, tmp_.begin() + a + *countA, perm_.begin() + dest);
+      a += *countA;
+      dest += *countA;
+      if (a == len1)
+        break;
 
-  } else {
-    if (rSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, j + 1, r) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
-          ExecutionStatus::EXCEPTION) {
+      auto countB = search(tmp_[a], &perm_[b], end2 - b, false, false);
+      if (LLVM_UNLIKELY(countB == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
+      std::copy(
+          perm_.begin() + b, perm_.begin() + b + *countB, perm_.begin() + dest);
+      b += *countB;
+      dest += *countB;
+      if (*countA < MIN_GALLOP && *countB < MIN_GALLOP)
+        break;
     }
+  }
+  std::copy(tmp_.begin() + a, tmp_.begin() + len1, perm_.begin() + dest);
+  return ExecutionStatus::RETURNED;
+}
 
-    if (lSize > INSERTION_THRESHOLD) {
-      r = j - 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
+ExecutionStatus TimSort::applyPermutation() {
+  uint32_t n = perm_.size();
+  // at[i] is the original position of the element currently at begin_ + i,
+  // and where[p] is the current offset of the element originally at
+  // begin_ + p.
+  std::vector<uint32_t> at(n), where(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    at[i] = i;
+    where[i] = i;
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    uint32_t j = where[perm_[i] - begin_];
+    if (j == i)
+      continue;
+    if (LLVM_UNLIKELY(
+            sm_->swap(begin_ + i, begin_ + j) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    std::swap(at[i], at[j]);
+    where[at[i]] = i;
+    where[at[j]] = j;
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus TimSort::sort() {
+  uint32_t n = perm_.size();
+  uint32_t minRun = minRunLength(n);
+  for (uint32_t lo = 0; lo < n;) {
+    auto runRes = countRunAndMakeAscending(lo, n);
+    if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    uint32_t runLen = *runRes;
+    if (runLen < minRun) {
+      // Extend short runs to minRun elements.
+      uint32_t forced = std::min(minRun, n - lo);
+      if (LLVM_UNLIKELY(
+              binaryInsertionSort(lo, lo + forced, lo + runLen) ==
+              ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
+      runLen = forced;
+    }
+    runs_.push_back({lo, runLen});
+    if (LLVM_UNLIKELY(mergeCollapse() == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    lo += runLen;
   }
-
-  return ExecutionStatus::RETURNED;
+  if (LLVM_UNLIKELY(mergeForceCollapse() == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return applyPermutation();
 }
 
 } // namespace
 
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end) {
-  if (begin >= end)
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end) {
+  if (begin >= end || end - begin == 1)
     return ExecutionStatus::RETURNED;
-  uint32_t len = end - begin;
-  std::vector<uint32_t> index(len); // Array of original indices of items
-  for (uint32_t i = 0; i < len; ++i) {
-    index[i] = i;
-  }
-
-  if (len > INSERTION_THRESHOLD) {
-    return doQuickSort(sm, index, llvh::Log2_32(len) * 2, begin, end - 1);
-  } else {
-    return insertionSort(sm, index, begin, end);
-  }
+  return TimSort(sm, begin, end).sort();
 }
 
 } // namespace vm
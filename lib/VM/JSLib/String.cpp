@@ -13,6 +13,7 @@
 #include "JSLibInternal.h"
 
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
+#include "hermes/Support/CharacterScan.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
@@ -744,8 +745,9 @@ stringPrototypeConcat(void *, Runtime &runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto S = runtime.makeHandle(std::move(*strRes));
-  // Track the total characters in the result.
+  // Track the total characters in the result, and whether they are ASCII.
   SafeUInt32 size(S->getStringLength());
+  bool isASCII = S->isASCII();
   uint32_t argCount = args.getArgCount();
 
   // Store the results of toStrings and concat them at the end.
@@ -770,6 +772,7 @@ stringPrototypeConcat(void *, Runtime &runtime, NativeArgs args) {
         SmallHermesValue::encodeStringValue(strRes->get(), runtime),
         runtime.getHeap());
     uint32_t strLength = strRes->get()->getStringLength();
+    isASCII = isASCII && strRes->get()->isASCII();
 
     size.add(strLength);
     if (LLVM_UNLIKELY(size.isOverflowed())) {
@@ -780,7 +783,7 @@ stringPrototypeConcat(void *, Runtime &runtime, NativeArgs args) {
   }
 
   // Allocate the complete result.
-  auto builder = StringBuilder::createStringBuilder(runtime, size);
+  auto builder = StringBuilder::createStringBuilder(runtime, size, isASCII);
   if (builder == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -837,11 +840,46 @@ stringPrototypeSubstring(void *, Runtime &runtime, NativeArgs args) {
   return StringPrimitive::slice(runtime, S, from, to > from ? to - from : 0);
 }
 
+/// Convert the case of the ASCII string \p S without going through UTF-16.
+/// \return \p S itself if it has no letters to convert.
+static CallResult<HermesValue> convertASCIIStringCase(
+    Runtime &runtime,
+    Handle<StringPrimitive> S,
+    const bool upperCase) {
+  ASCIIRef str = S->getStringRef<char>();
+  const char *firstLetter = upperCase
+      ? findFirstInRange(str.begin(), str.end(), 'a', 'z')
+      : findFirstInRange(str.begin(), str.end(), 'A', 'Z');
+  if (firstLetter == str.end()) {
+    // We don't have to allocate anything.
+    return S.getHermesValue();
+  }
+  if (str.size() == 1) {
+    // Use the Runtime stored representations of single-character strings.
+    return runtime.getCharacterString(str[0] ^ 0x20).getHermesValue();
+  }
+
+  // Everything before the first letter is copied unchanged.
+  size_t prefix = firstLetter - str.begin();
+  llvh::SmallVector<char, 64> buff(str.size());
+  std::memcpy(buff.data(), str.data(), prefix);
+  convertASCIICase(
+      str.data() + prefix,
+      str.size() - prefix,
+      buff.data() + prefix,
+      upperCase);
+  return StringPrimitive::create(runtime, ASCIIRef(buff));
+}
+
 static CallResult<HermesValue> convertCase(
     Runtime &runtime,
     Handle<StringPrimitive> S,
     const bool upperCase,
     const bool useCurrentLocale) {
+  if (!useCurrentLocale && S->isASCII()) {
+    return convertASCIIStringCase(runtime, S, upperCase);
+  }
+
   // Copying is unavoidable in this function, do it early on.
   SmallU16String<32> buff;
   // Must copy instead of just getting the reference, because later operations
@@ -889,7 +927,8 @@ static CallResult<HermesValue> convertCase(
       }
 
       SafeUInt32 len(S->getStringLength());
-      auto builder = StringBuilder::createStringBuilder(runtime, len);
+      auto builder =
+          StringBuilder::createStringBuilder(runtime, len, /*isASCII*/ true);
       if (builder == ExecutionStatus::EXCEPTION) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -1033,30 +1072,49 @@ stringPrototypeSubstr(void *, Runtime &runtime, NativeArgs args) {
   }
 }
 
-/// \return the number of characters to trim from the begin iterator.
-static size_t trimStart(
-    StringView::const_iterator begin,
-    StringView::const_iterator end) {
+/// \return whether the ASCII character \p c is a white space or line
+/// terminator character.
+static inline bool isASCIIWhiteSpaceOrLineTerminator(char c) {
+  return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+/// \return the number of characters to trim from the start of \p str.
+static size_t trimStart(StringView str) {
   size_t toTrim = 0;
-  while (begin != end &&
-         (isWhiteSpaceChar(*begin) || isLineTerminatorChar(*begin))) {
-    ++begin;
+  if (str.isASCII()) {
+    const char *chars = str.castToCharPtr();
+    while (toTrim != str.length() &&
+           isASCIIWhiteSpaceOrLineTerminator(chars[toTrim])) {
+      ++toTrim;
+    }
+    return toTrim;
+  }
+  const char16_t *chars = str.castToChar16Ptr();
+  while (toTrim != str.length() &&
+         (isWhiteSpaceChar(chars[toTrim]) ||
+          isLineTerminatorChar(chars[toTrim]))) {
     ++toTrim;
   }
   return toTrim;
 }
 
-/// \return the number of characters to trim from the end iterator.
-static size_t trimEnd(
-    StringView::const_iterator begin,
-    StringView::const_iterator end) {
-  size_t toTrim = 0;
-  while (begin != end &&
-         (isWhiteSpaceChar(*(end - 1)) || isLineTerminatorChar(*(end - 1)))) {
+/// \return the number of characters to trim from the end of \p str.
+static size_t trimEnd(StringView str) {
+  size_t end = str.length();
+  if (str.isASCII()) {
+    const char *chars = str.castToCharPtr();
+    while (end != 0 && isASCIIWhiteSpaceOrLineTerminator(chars[end - 1])) {
+      --end;
+    }
+    return str.length() - end;
+  }
+  const char16_t *chars = str.castToChar16Ptr();
+  while (end != 0 &&
+         (isWhiteSpaceChar(chars[end - 1]) ||
+          isLineTerminatorChar(chars[end - 1]))) {
     --end;
-    ++toTrim;
   }
-  return toTrim;
+  return str.length() - end;
 }
 
 CallResult<HermesValue>
@@ -1076,11 +1134,8 @@ stringPrototypeTrim(void *, Runtime &runtime, NativeArgs args) {
   size_t beginIdx = 0, endIdx = S->getStringLength();
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    beginIdx = trimStart(begin, end);
-    begin += beginIdx;
-    endIdx -= trimEnd(begin, end);
+    beginIdx = trimStart(str);
+    endIdx -= trimEnd(str.slice(beginIdx));
   }
 
   return StringPrimitive::slice(runtime, S, beginIdx, endIdx - beginIdx);
@@ -1103,9 +1158,7 @@ stringPrototypeTrimStart(void *, Runtime &runtime, NativeArgs args) {
   size_t beginIdx = 0;
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    beginIdx = trimStart(begin, end);
+    beginIdx = trimStart(str);
   }
 
   return StringPrimitive::slice(
@@ -1129,9 +1182,7 @@ stringPrototypeTrimEnd(void *, Runtime &runtime, NativeArgs args) {
   size_t endIdx = S->getStringLength();
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    endIdx -= trimEnd(begin, end);
+    endIdx -= trimEnd(str);
   }
 
   return StringPrimitive::slice(runtime, S, 0, endIdx);
@@ -1280,14 +1331,19 @@ stringPrototypeRepeat(void *, Runtime &runtime, NativeArgs args) {
   // It's safe to multiply as the overflow check is done above.
   SafeUInt32 finalLen(strLen * n);
 
-  auto builderRes = StringBuilder::createStringBuilder(runtime, finalLen);
+  auto builderRes =
+      StringBuilder::createStringBuilder(runtime, finalLen, S->isASCII());
   if (LLVM_UNLIKELY(builderRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
 
-  // Using uint32_t for i is valid because we have bounds-checked n.
-  for (uint32_t i = 0; i < n; ++i) {
-    builderRes->appendStringPrim(S);
+  // Append S once, then copies of what is built so far, doubling its length
+  // each time.
+  builderRes->appendStringPrim(S);
+  for (uint32_t built = strLen; built != finalLen.get();) {
+    uint32_t length = std::min(built, finalLen.get() - built);
+    builderRes->appendCopyOf(0, length);
+    built += length;
   }
 
   // 9. Return T.
@@ -1415,6 +1471,70 @@ stringPrototypeMatchAll(void *, Runtime &runtime, NativeArgs args) {
       .toCallResultHermesValue();
 }
 
+/// Call \p fn with the characters of \p haystack and \p needle as ArrayRefs of
+/// the same character type, so that a search picks its kernel once rather than
+/// branching on the width of each character.
+/// \return None without calling \p fn if \p needle contains characters that
+///   cannot occur in the ASCII \p haystack, otherwise the result of \p fn.
+template <typename Fn>
+static OptValue<uint32_t>
+withSameWidth(StringView haystack, StringView needle, Fn fn) {
+  if (haystack.isASCII()) {
+    ASCIIRef hay(haystack.castToCharPtr(), haystack.length());
+    if (needle.isASCII())
+      return fn(hay, ASCIIRef(needle.castToCharPtr(), needle.length()));
+    llvh::SmallVector<char, 32> narrow;
+    for (char16_t c : UTF16Ref(needle.castToChar16Ptr(), needle.length())) {
+      if (c > 127)
+        return llvh::None;
+      narrow.push_back((char)c);
+    }
+    return fn(hay, ASCIIRef(narrow));
+  }
+  UTF16Ref hay(haystack.castToChar16Ptr(), haystack.length());
+  if (!needle.isASCII())
+    return fn(hay, UTF16Ref(needle.castToChar16Ptr(), needle.length()));
+  const char *needleChars = needle.castToCharPtr();
+  llvh::SmallVector<char16_t, 32> wide(
+      needleChars, needleChars + needle.length());
+  return fn(hay, UTF16Ref(wide));
+}
+
+/// \return the index of the first occurrence of \p needle in \p haystack that
+/// starts at or after \p start, or None if there is none.
+/// \pre start <= haystack.length().
+static OptValue<uint32_t>
+stringViewFind(StringView haystack, uint32_t start, StringView needle) {
+  assert(start <= haystack.length() && "search starts past the end");
+  return withSameWidth(
+      haystack, needle, [start](auto hay, auto ndl) -> OptValue<uint32_t> {
+        auto *found = findSubstring(
+            hay.begin() + start, hay.end(), ndl.data(), ndl.size());
+        if (found == hay.end() && !ndl.empty())
+          return llvh::None;
+        return found - hay.begin();
+      });
+}
+
+/// \return the index of the last occurrence of \p needle in \p haystack that
+/// starts at or before \p start, or None if there is none.
+static OptValue<uint32_t>
+stringViewFindLast(StringView haystack, uint32_t start, StringView needle) {
+  return withSameWidth(
+      haystack, needle, [start](auto hay, auto ndl) -> OptValue<uint32_t> {
+        if (ndl.size() > hay.size())
+          return llvh::None;
+        // Only matches that start at or before start can end before this.
+        auto *end =
+            hay.begin() + std::min<size_t>(hay.size(), start + ndl.size());
+        auto *found =
+            findLastSubstring(hay.begin(), end, ndl.data(), ndl.size());
+        if (found == end && !ndl.empty())
+          return llvh::None;
+        return found - hay.begin();
+      });
+}
+
 /// This provides a shared implementation of three operations in ES2021:
 /// 6.1.4.1 Runtime Semantics: StringIndexOf ( string, searchValue, fromIndex )
 ///   when clampPostion=false,
@@ -1515,35 +1635,12 @@ static CallResult<HermesValue> stringDirectedIndexOf(
   // Let start be min(max(pos, 0), len).
   uint32_t start = static_cast<uint32_t>(std::min(std::max(pos, 0.), len));
 
-  // TODO: good candidate for Boyer-Moore on large needles/haystacks
-  // TODO: good candidate for memchr on length-1 needles
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  double ret = -1;
-  if (reverse) {
-    // lastIndexOf
-    uint32_t lastPossibleMatchEnd =
-        std::min(SView.length(), start + searchStrView.length());
-    auto foundIter = std::search(
-        SView.rbegin() + (SView.length() - lastPossibleMatchEnd),
-        SView.rend(),
-        searchStrView.rbegin(),
-        searchStrView.rend());
-    if (foundIter != SView.rend() || searchStrView.empty()) {
-      ret = SView.rend() - foundIter - searchStrView.length();
-    }
-  } else {
-    // indexOf
-    auto foundIter = std::search(
-        SView.begin() + start,
-        SView.end(),
-        searchStrView.begin(),
-        searchStrView.end());
-    if (foundIter != SView.end() || searchStrView.empty()) {
-      ret = foundIter - SView.begin();
-    }
-  }
-  return HermesValue::encodeDoubleValue(ret);
+  OptValue<uint32_t> found = reverse
+      ? stringViewFindLast(SView, start, searchStrView)
+      : stringViewFind(SView, start, searchStrView);
+  return HermesValue::encodeDoubleValue(found ? (double)*found : -1);
 }
 
 /// ES12 6.1.4.1 Runtime Semantics: StringIndexOf ( string, searchValue,
@@ -1911,22 +2008,26 @@ stringPrototypePad(void *ctx, Runtime &runtime, NativeArgs args) {
         runtime.getPredefinedString(Predefined::emptyString));
   }
 
-  auto builderRes = StringBuilder::createStringBuilder(runtime, size);
+  auto builderRes = StringBuilder::createStringBuilder(
+      runtime, size, S->isASCII() && filler->isASCII());
   if (LLVM_UNLIKELY(builderRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
 
   uint32_t resultLen = size.get();
 
-  // Repeatedly add filler to builder, taking up resultLen - stringLength
-  // characters.
-  auto addFiller = [&filler, resultLen, stringLength](StringBuilder &builder) {
-    uint32_t remaining = resultLen - stringLength;
-    const uint32_t fillerLen = filler->getStringLength();
-    while (remaining != 0) {
-      uint32_t length = std::min(remaining, fillerLen);
-      builder.appendStringPrim(filler, length);
-      remaining -= length;
+  // Repeatedly add filler to builder at index fillStart, taking up
+  // resultLen - stringLength characters. After the first filler, copy what is
+  // already filled, doubling its length each time.
+  auto addFiller = [&filler, resultLen, stringLength](
+                       StringBuilder &builder, uint32_t fillStart) {
+    const uint32_t toFill = resultLen - stringLength;
+    uint32_t filled = std::min(toFill, filler->getStringLength());
+    builder.appendStringPrim(filler, filled);
+    while (filled != toFill) {
+      uint32_t length = std::min(filled, toFill - filled);
+      builder.appendCopyOf(fillStart, length);
+      filled += length;
     }
   };
 
@@ -1935,7 +2036,7 @@ stringPrototypePad(void *ctx, Runtime &runtime, NativeArgs args) {
     // repeated concatenations of filler truncated to length fillLen.
     // 11. Return a new String value computed by the concatenation of
     // truncatedStringFiller and S.
-    addFiller(*builderRes);
+    addFiller(*builderRes, 0);
     builderRes->appendStringPrim(S);
   } else {
     // 10. Let truncatedStringFiller be a new String value consisting of
@@ -1943,7 +2044,7 @@ stringPrototypePad(void *ctx, Runtime &runtime, NativeArgs args) {
     // 11. Return a new String value computed by the concatenation of S and
     // truncatedStringFiller.
     builderRes->appendStringPrim(S);
-    addFiller(*builderRes);
+    addFiller(*builderRes, stringLength);
   }
 
   return builderRes->getStringPrimitive().getHermesValue();
@@ -2023,11 +2124,10 @@ stringPrototypeReplace(void *, Runtime &runtime, NativeArgs args) {
   auto strView = StringPrimitive::createStringView(runtime, string);
   if (!strView.empty()) {
     auto searchView = StringPrimitive::createStringView(runtime, searchString);
-    auto searchResult = std::search(
-        strView.begin(), strView.end(), searchView.begin(), searchView.end());
+    auto searchResult = stringViewFind(strView, 0, searchView);
 
-    if (searchResult != strView.end()) {
-      pos = searchResult - strView.begin();
+    if (searchResult) {
+      pos = *searchResult;
     } else {
       return string.getHermesValue();
     }
@@ -2084,13 +2184,24 @@ stringPrototypeReplace(void *, Runtime &runtime, NativeArgs args) {
   // units of string, replStr, and the trailing substring of string starting at
   // index tailPos. If pos is 0, the first element of the concatenation will be
   // the empty String.
-  SmallU16String<32> newString{};
-  strView.slice(0, pos).appendUTF16String(newString);
-  StringPrimitive::createStringView(runtime, replStr)
-      .appendUTF16String(newString);
-  strView.slice(tailPos).appendUTF16String(newString);
+  uint32_t tailLen = string->getStringLength() - tailPos;
+  SafeUInt32 size{pos};
+  size.add(replStr->getStringLength());
+  size.add(tailLen);
+  auto builder = StringBuilder::createStringBuilder(
+      runtime, size, string->isASCII() && replStr->isASCII());
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  builder->appendStringPrim(string, pos);
+  builder->appendStringPrim(replStr);
+  if (string->isASCII()) {
+    builder->appendASCIIRef(string->getStringRef<char>().slice(tailPos));
+  } else {
+    builder->appendUTF16Ref(string->getStringRef<char16_t>().slice(tailPos));
+  }
   // 15. Return newString.
-  return StringPrimitive::create(runtime, newString);
+  return HermesValue::encodeStringValue(*builder->getStringPrimitive());
 }
 
 CallResult<HermesValue>
@@ -2331,12 +2442,9 @@ static OptValue<uint32_t> splitMatch(
   auto SStr = StringPrimitive::createStringView(runtime, S);
   auto RStr = StringPrimitive::createStringView(runtime, R);
 
-  auto sliced = SStr.slice(q);
-  auto searchResult =
-      std::search(sliced.begin(), sliced.end(), RStr.begin(), RStr.end());
-
-  if (searchResult != sliced.end()) {
-    return q + (searchResult - sliced.begin()) + r;
+  auto searchResult = stringViewFind(SStr, q, RStr);
+  if (searchResult) {
+    return *searchResult + r;
   }
   return llvh::None;
 }
@@ -2642,15 +2750,8 @@ CallResult<HermesValue> stringPrototypeIncludesOrStartsWith(
   // k, return false.
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  auto foundIter = std::search(
-      SView.begin() + start,
-      SView.end(),
-      searchStrView.begin(),
-      searchStrView.end());
-  // Note: searchStrView.empty check is needed in the special case that S is
-  // empty, searchStr is empty, and start = 0
   return HermesValue::encodeBoolValue(
-      foundIter != SView.end() || searchStrView.empty());
+      stringViewFind(SView, (uint32_t)start, searchStrView).hasValue());
 }
 
 CallResult<HermesValue>
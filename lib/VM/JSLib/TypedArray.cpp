@@ -458,6 +458,27 @@ class TypedArraySortModel : public SortModel {
   }
 };
 
+/// \return whether \p a comes before \p b in the default order of
+/// TypedArray.prototype.sort, which for floating point also puts -0 before +0
+/// and NaN last.
+template <typename T>
+bool typedArrayDefaultLess(T a, T b) {
+  if (std::is_floating_point<T>::value) {
+    if (LLVM_UNLIKELY(std::isnan(b)))
+      return !std::isnan(a);
+    if (LLVM_UNLIKELY(a == 0 && b == 0))
+      return std::signbit(a) && !std::signbit(b);
+  }
+  return a < b;
+}
+
+/// Sort \p arr in place in the default order. Elements that compare equal are
+/// indistinguishable, so the sort need not be stable.
+template <typename T, CellKind C>
+void typedArraySortByDefault(Runtime &runtime, JSTypedArray<T, C> *arr) {
+  std::sort(arr->begin(runtime), arr->end(runtime), typedArrayDefaultLess<T>);
+}
+
 // ES7 22.2.3.23.1
 CallResult<HermesValue> typedArrayPrototypeSetObject(
     Runtime &runtime,
@@ -1283,7 +1304,7 @@ typedArrayPrototypeMapFilter(void *ctx, Runtime &runtime, NativeArgs args) {
   MutableHandle<> storage(runtime);
   auto marker = gcScope.createMarker();
   for (JSTypedArrayBase::size_type i = 0; i < insert; ++i) {
-    storage = values->at(runtime, i).unboxToHV(runtime);
+    storage = values->at(runtime, i);
     if (JSObject::setOwnIndexed(TA, runtime, i, storage) ==
         ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
@@ -1376,12 +1397,12 @@ typedArrayPrototypeJoin(void *, Runtime &runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   MutableHandle<StringPrimitive> element{runtime};
-  element = strings->at(runtime, 0).getString(runtime);
+  element = strings->at(runtime, 0).getString();
   builder->appendStringPrim(element);
   // Copy the strings.
   for (decltype(len) i = 1; i < len; ++i) {
     builder->appendStringPrim(sep);
-    element = strings->at(runtime, i).getString(runtime);
+    element = strings->at(runtime, i).getString();
     builder->appendStringPrim(element);
   }
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
@@ -1499,17 +1520,27 @@ typedArrayPrototypeSort(void *, Runtime &runtime, NativeArgs args) {
     return runtime.raiseTypeError("TypedArray sort argument must be callable");
   }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
+  // With a compare function, use our custom sort routine, since the compare
+  // function can observe the array and detach its buffer.
   if (compareFn) {
     TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+    if (LLVM_UNLIKELY(timSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
+    return self.getHermesValue();
+  }
+
+  // Without a compare function, no JavaScript runs during the sort, and the
+  // elements are sorted directly in their buffer.
+  switch (self->getKind()) {
+#define TYPED_ARRAY(name, type)                                              \
+  case CellKind::name##ArrayKind:                                            \
+    typedArraySortByDefault(                                                 \
+        runtime,                                                             \
+        vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(self.get())); \
+    break;
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
   }
   return self.getHermesValue();
 }
@@ -1729,13 +1760,13 @@ typedArrayPrototypeToLocaleString(void *, Runtime &runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   MutableHandle<StringPrimitive> element{runtime};
-  element = strings->at(runtime, 0).getString(runtime);
+  element = strings->at(runtime, 0).getString();
   builder->appendStringPrim(element);
 
   for (uint32_t i = 1; i < len; ++i) {
     // Every element after the first needs a separator before it.
     builder->appendASCIIRef(separator);
-    element = strings->at(runtime, i).getString(runtime);
+    element = strings->at(runtime, i).getString();
     builder->appendStringPrim(element);
   }
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
@@ -103,8 +103,10 @@ PseudoHandle<JSObject> JSObject::create(
 
 PseudoHandle<JSObject> JSObject::create(
     Runtime &runtime,
-    Handle<HiddenClass> clazz) {
-  auto obj = JSObject::create(runtime, clazz->getNumProperties());
+    Handle<HiddenClass> clazz,
+    unsigned capacity) {
+  auto obj = runtime.ignoreAllocationFailure(JSObject::allocatePropStorage(
+      create(runtime), runtime, clazz->getNumProperties(), capacity));
   obj->clazz_.setNonNull(runtime, *clazz, runtime.getHeap());
   // If the hidden class has index like property, we need to clear the fast path
   // flag.
@@ -123,6 +125,22 @@ PseudoHandle<JSObject> JSObject::create(
   return obj;
 }
 
+uint32_t JSObject::sampleAllocationSite(
+    Runtime &runtime,
+    AllocationSite &site) {
+  // Only the class of the object is read, and the object is not kept, so the
+  // read barrier is not needed.
+  if (JSObject *last = site.lastObject.getNoBarrierUnsafe(runtime)) {
+    HiddenClass *clazz = last->getClass(runtime);
+    // Dictionaries are usually used as hash maps, whose size says nothing
+    // about the next object.
+    if (!clazz->isDictionary())
+      site.numProperties =
+          std::max(site.numProperties, clazz->getNumProperties());
+  }
+  return site.numProperties;
+}
+
 void JSObject::initializeLazyObject(
     Runtime &runtime,
     Handle<JSObject> lazyObject) {
@@ -216,11 +234,21 @@ CallResult<bool> JSObject::setParent(
     }
   }
   // 9.
+  invalidateCachedPrototype(self, runtime);
   self->parent_.set(runtime, parent, runtime.getHeap());
   // 10.
   return true;
 }
 
+void JSObject::invalidateCachedPrototype(JSObject *self, Runtime &runtime) {
+  if (LLVM_LIKELY(!self->flags_.cachedPrototype))
+    return;
+  // Every cached prototype chain is invalidated at once, so the flag is not
+  // needed anymore until the object is cached again.
+  self->flags_.cachedPrototype = 0;
+  runtime.invalidateProtoChainCaches();
+}
+
 void JSObject::allocateNewSlotStorage(
     Handle<JSObject> selfHandle,
     Runtime &runtime,
@@ -564,7 +592,7 @@ CallResult<Handle<JSArray>> JSObject::getOwnPropertyKeys(
        last != numIndexed;) {
     --last;
     --toLast;
-    tmpHandle = array->at(runtime, last).unboxToHV(runtime);
+    tmpHandle = array->at(runtime, last);
     JSArray::setElementAt(array, runtime, toLast, tmpHandle);
   }
 
@@ -577,7 +605,7 @@ CallResult<Handle<JSArray>> JSObject::getOwnPropertyKeys(
        toLast != 0;) {
     if (numIndexed) {
       uint32_t a =
-          (uint32_t)array->at(runtime, numIndexed - 1).getNumber(runtime);
+          (uint32_t)array->at(runtime, numIndexed - 1).getNumber();
       uint32_t b;
 
       if (indexNamesLast && (b = indexNames[indexNamesLast - 1]) > a) {
@@ -1025,6 +1053,41 @@ ExecutionStatus JSObject::getComputedDescriptor(
       selfHandle, runtime, *converted, propObj, tmpSymbolStorage, desc);
 }
 
+void JSObject::cachePrototypeProperty(
+    JSObject *self,
+    Runtime &runtime,
+    JSObject *holder,
+    SlotIndex slot,
+    PropertyCacheEntry *cacheEntry) {
+  // The receiver's class must change whenever its own properties do, which is
+  // not the case for dictionaries.
+  if (self->getClass(runtime)->isDictionary() ||
+      LLVM_UNLIKELY(
+          runtime.getProtoShapeEpoch() == Runtime::kInvalidProtoShapeEpoch))
+    return;
+  // Property caches are weak roots that are only updated by collections of
+  // the old generation, so they can't refer to young objects.
+  JSObject *parent = self->parent_.getNonNull(runtime);
+  if (runtime.getHeap().inYoungGen(parent) ||
+      runtime.getHeap().inYoungGen(holder))
+    return;
+
+  // Flag every object the lookup went through, so that modifying any of them
+  // invalidates the entry.
+  for (JSObject *cur = parent;; cur = cur->parent_.get(runtime)) {
+    assert(cur && "holder must be in the prototype chain");
+    cur->flags_.cachedPrototype = 1;
+    if (cur == holder)
+      break;
+  }
+
+  cacheEntry->protoClazz = self->clazz_;
+  cacheEntry->protoParent = self->parent_;
+  cacheEntry->protoHolder = CompressedPointer::encodeNonNull(holder, runtime);
+  cacheEntry->protoSlot = slot;
+  cacheEntry->protoEpoch = runtime.getProtoShapeEpoch();
+}
+
 CallResult<PseudoHandle<>> JSObject::getNamedWithReceiver_RJS(
     Handle<JSObject> selfHandle,
     Runtime &runtime,
@@ -1050,9 +1113,14 @@ CallResult<PseudoHandle<>> JSObject::getNamedWithReceiver_RJS(
           !desc.flags.accessor && !desc.flags.hostObject &&
           !desc.flags.proxyObject)) {
     // Populate the cache if requested.
-    if (cacheEntry && !propObj->getClass(runtime)->isDictionaryNoCache()) {
-      cacheEntry->clazz = propObj->getClassGCPtr();
-      cacheEntry->slot = desc.slot;
+    if (cacheEntry) {
+      if (propObj == *selfHandle) {
+        if (!propObj->getClass(runtime)->isDictionaryNoCache())
+          cacheEntry->insert(propObj->getClassGCPtr(), desc.slot);
+      } else {
+        cachePrototypeProperty(
+            selfHandle.get(), runtime, propObj, desc.slot, cacheEntry);
+      }
     }
     return createPseudoHandle(
         getNamedSlotValueUnsafe(propObj, runtime, desc).unboxToHV(runtime));
@@ -1875,6 +1943,7 @@ CallResult<bool> JSObject::deleteNamed(
       *selfHandle, runtime, desc, SmallHermesValue::encodeEmptyValue());
 
   // Perform the actual deletion.
+  invalidateCachedPrototype(*selfHandle, runtime);
   auto newClazz = HiddenClass::deleteProperty(
       runtime.makeHandle(selfHandle->clazz_), runtime, *pos);
   selfHandle->clazz_.setNonNull(runtime, *newClazz, runtime.getHeap());
@@ -1975,6 +2044,7 @@ CallResult<bool> JSObject::deleteComputed(
         *selfHandle, runtime, desc, SmallHermesValue::encodeEmptyValue());
 
     // Remove the property descriptor.
+    invalidateCachedPrototype(*selfHandle, runtime);
     auto newClazz = HiddenClass::deleteProperty(
         runtime.makeHandle(selfHandle->clazz_), runtime, *pos);
     selfHandle->clazz_.setNonNull(runtime, *newClazz, runtime.getHeap());
@@ -2564,6 +2634,7 @@ ExecutionStatus JSObject::seal(Handle<JSObject> selfHandle, Runtime &runtime) {
   if (selfHandle->flags_.sealed)
     return ExecutionStatus::RETURNED;
 
+  invalidateCachedPrototype(*selfHandle, runtime);
   auto newClazz = HiddenClass::makeAllNonConfigurable(
       runtime.makeHandle(selfHandle->clazz_), runtime);
   selfHandle->clazz_.setNonNull(runtime, *newClazz, runtime.getHeap());
@@ -2589,6 +2660,7 @@ ExecutionStatus JSObject::freeze(
   if (selfHandle->flags_.frozen)
     return ExecutionStatus::RETURNED;
 
+  invalidateCachedPrototype(*selfHandle, runtime);
   auto newClazz = HiddenClass::makeAllReadOnly(
       runtime.makeHandle(selfHandle->clazz_), runtime);
   selfHandle->clazz_.setNonNull(runtime, *newClazz, runtime.getHeap());
@@ -2605,6 +2677,7 @@ void JSObject::updatePropertyFlagsWithoutTransitions(
     PropertyFlags flagsToClear,
     PropertyFlags flagsToSet,
     OptValue<llvh::ArrayRef<SymbolID>> props) {
+  invalidateCachedPrototype(*selfHandle, runtime);
   auto newClazz = HiddenClass::updatePropertyFlagsWithoutTransitions(
       runtime.makeHandle(selfHandle->clazz_),
       runtime,
@@ -2728,6 +2801,7 @@ ExecutionStatus JSObject::addOwnPropertyImpl(
   assert(
       !selfHandle->flags_.proxyObject &&
       "Internal properties cannot be added to Proxy objects");
+  invalidateCachedPrototype(*selfHandle, runtime);
   // Add a new property to the class.
   // TODO: if we check for OOM here in the future, we must undo the slot
   // allocation.
@@ -2774,6 +2848,7 @@ CallResult<bool> JSObject::updateOwnProperty(
   // If the property flags changed, update them.
   if (updateStatus->second != desc.flags) {
     desc.flags = updateStatus->second;
+    invalidateCachedPrototype(*selfHandle, runtime);
     auto newClazz = HiddenClass::updateProperty(
         runtime.makeHandle(selfHandle->clazz_),
         runtime,
@@ -3038,7 +3113,7 @@ CallResult<uint32_t> appendAllPropertyNames(
     auto marker = gcScope.createMarker();
     for (unsigned i = 0, e = enumerableProps->getEndIndex(); i < e; ++i) {
       gcScope.flushToMarker(marker);
-      prop = enumerableProps->at(runtime, i).unboxToHV(runtime);
+      prop = enumerableProps->at(runtime, i);
       if (!needDedup) {
         // If no dedup is needed, add it directly.
         if (LLVM_UNLIKELY(
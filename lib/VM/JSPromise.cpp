@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JSPromise.h"
+
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSNativeFunctions.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/Runtime-inline.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// Indexes of the additional slots of the resolving functions.
+enum ResolvingFunctionSlotIndexes {
+  /// The promise to resolve, or undefined once either of the pair has been
+  /// called ([[AlreadyResolved]]).
+  promise,
+  /// The other function of the pair.
+  sibling,
+  COUNT
+};
+
+/// Take the pending exception out of \p runtime.
+/// \return the thrown value, or None if it must not be caught.
+llvh::Optional<Handle<>> takeCatchableException(Runtime &runtime) {
+  if (isUncatchableError(runtime.getThrownValue()))
+    return llvh::None;
+  auto thrown = runtime.makeHandle(runtime.getThrownValue());
+  runtime.clearThrownValue();
+  return thrown;
+}
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// class JSPromise
+
+const ObjectVTable JSPromise::vt{
+    VTable(CellKind::JSPromiseKind, cellSize<JSPromise>()),
+    JSPromise::_getOwnIndexedRangeImpl,
+    JSPromise::_haveOwnIndexedImpl,
+    JSPromise::_getOwnIndexedPropertyFlagsImpl,
+    JSPromise::_getOwnIndexedImpl,
+    JSPromise::_setOwnIndexedImpl,
+    JSPromise::_deleteOwnIndexedImpl,
+    JSPromise::_checkAllOwnIndexedImpl,
+};
+
+void JSPromiseBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  mb.addJSObjectOverlapSlots(JSObject::numOverlapSlots<JSPromise>());
+  JSObjectBuildMeta(cell, mb);
+  const auto *self = static_cast<const JSPromise *>(cell);
+  mb.setVTable(&JSPromise::vt);
+  mb.addField("result", &self->result_);
+  mb.addField("reactions", &self->reactions_);
+}
+
+PseudoHandle<JSPromise> JSPromise::create(
+    Runtime &runtime,
+    Handle<JSObject> parentHandle) {
+  auto *cell = runtime.makeAFixed<JSPromise>(
+      runtime,
+      parentHandle,
+      runtime.getHiddenClassForPrototype(
+          *parentHandle, numOverlapSlots<JSPromise>()));
+  return JSObjectInit::initToPseudoHandle(runtime, cell);
+}
+
+void JSPromise::createResolvingFunctions(
+    Handle<JSPromise> self,
+    Runtime &runtime,
+    MutableHandle<Callable> &resolve,
+    MutableHandle<Callable> &reject) {
+  auto makeFunction = [&runtime, self](bool isReject) {
+    auto fn = NativeFunction::createWithoutPrototype(
+        runtime,
+        /* isReject */ (void *)isReject,
+        promiseResolvingFunction,
+        Predefined::getSymbolID(Predefined::emptyString),
+        1,
+        ResolvingFunctionSlotIndexes::COUNT);
+    NativeFunction::setAdditionalSlotValue(
+        *fn,
+        runtime,
+        ResolvingFunctionSlotIndexes::promise,
+        SmallHermesValue::encodeObjectValue(*self, runtime));
+    return fn;
+  };
+  auto resolveFn = makeFunction(false);
+  auto rejectFn = makeFunction(true);
+  NativeFunction::setAdditionalSlotValue(
+      *resolveFn,
+      runtime,
+      ResolvingFunctionSlotIndexes::sibling,
+      SmallHermesValue::encodeObjectValue(*rejectFn, runtime));
+  NativeFunction::setAdditionalSlotValue(
+      *rejectFn,
+      runtime,
+      ResolvingFunctionSlotIndexes::sibling,
+      SmallHermesValue::encodeObjectValue(*resolveFn, runtime));
+  resolve = *resolveFn;
+  reject = *rejectFn;
+}
+
+ExecutionStatus JSPromise::resolve(
+    Handle<JSPromise> self,
+    Runtime &runtime,
+    Handle<> resolution) {
+  // 7. If SameValue(resolution, promise) is true, then
+  if (resolution.getHermesValue().getRaw() == self.getHermesValue().getRaw()) {
+    // a. Let selfResolutionError be a newly created TypeError object.
+    // b. Return RejectPromise(promise, selfResolutionError).
+    (void)runtime.raiseTypeError("Promise cannot be resolved with itself");
+    auto thrown = takeCatchableException(runtime);
+    if (!thrown)
+      return ExecutionStatus::EXCEPTION;
+    return reject(self, runtime, *thrown);
+  }
+
+  // 8. If Type(resolution) is not Object, then
+  auto resolutionObj = Handle<JSObject>::dyn_vmcast(resolution);
+  if (!resolutionObj) {
+    // a. Return FulfillPromise(promise, resolution).
+    return fulfill(self, runtime, resolution);
+  }
+
+  // 9. Let then be Get(resolution, "then").
+  auto thenRes = JSObject::getNamed_RJS(
+      resolutionObj, runtime, Predefined::getSymbolID(Predefined::then));
+  // 10. If then is an abrupt completion, then
+  if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION)) {
+    // a. Return RejectPromise(promise, then.[[Value]]).
+    auto thrown = takeCatchableException(runtime);
+    if (!thrown)
+      return ExecutionStatus::EXCEPTION;
+    return reject(self, runtime, *thrown);
+  }
+
+  // 11. Let thenAction be then.[[Value]].
+  // 12. If IsCallable(thenAction) is false, then
+  if (!vmisa<Callable>(thenRes->get())) {
+    // a. Return FulfillPromise(promise, resolution).
+    return fulfill(self, runtime, resolution);
+  }
+
+  // 13-15. Perform HostEnqueuePromiseJob(
+  //          NewPromiseResolveThenableJob(promise, resolution, thenAction)).
+  Runtime::Job job;
+  job.kind = Runtime::Job::Kind::PromiseResolveThenable;
+  job.operands[0] = self.getHermesValue();
+  job.operands[1] = resolution.getHermesValue();
+  job.operands[2] = thenRes->get();
+  runtime.enqueueJob(job);
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus
+JSPromise::fulfill(Handle<JSPromise> self, Runtime &runtime, Handle<> value) {
+  return settle(self, runtime, State::Fulfilled, value);
+}
+
+ExecutionStatus
+JSPromise::reject(Handle<JSPromise> self, Runtime &runtime, Handle<> reason) {
+  return settle(self, runtime, State::Rejected, reason);
+}
+
+ExecutionStatus JSPromise::settle(
+    Handle<JSPromise> self,
+    Runtime &runtime,
+    State state,
+    Handle<> value) {
+  assert(self->state_ == State::Pending && "Promise is already settled");
+  assert(state != State::Pending && "Promise must be settled");
+
+  // Detach the reactions before they can be observed again.
+  ArrayStorage *reactions = self->reactions_.get(runtime);
+  self->reactions_.setNull(runtime.getHeap());
+  self->result_.set(value.getHermesValue(), runtime.getHeap());
+  self->state_ = state;
+
+  // TriggerPromiseReactions enqueues a job per reaction, which doesn't
+  // allocate on the JS heap.
+  const bool isRejection = state == State::Rejected;
+  if (reactions) {
+    for (ArrayStorage::size_type i = 0, e = reactions->size(); i < e;
+         i += kReactionSize) {
+      Runtime::Job job;
+      job.kind = Runtime::Job::Kind::PromiseReaction;
+      job.isRejection = isRejection;
+      job.operands[0] = reactions->at(i + (isRejection ? 1 : 0));
+      job.operands[1] = value.getHermesValue();
+      job.operands[2] = reactions->at(i + 2);
+      job.operands[3] = reactions->at(i + 3);
+      runtime.enqueueJob(job);
+    }
+  }
+
+  // RejectPromise 7. If promise.[[PromiseIsHandled]] is false, perform
+  // HostPromiseRejectionTracker(promise, "reject").
+  if (isRejection && !self->isHandled_)
+    return trackRejection(self, runtime, false);
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSPromise::performThen(
+    Handle<JSPromise> self,
+    Runtime &runtime,
+    Handle<> onFulfilled,
+    Handle<> onRejected,
+    Handle<> capabilityTarget,
+    Handle<> capabilityReject) {
+  // 3-6. Handlers that are not callable are replaced by undefined, which
+  // means "pass the argument through".
+  HermesValue fulfillHandler = vmisa<Callable>(*onFulfilled)
+      ? *onFulfilled
+      : HermesValue::encodeUndefinedValue();
+  HermesValue rejectHandler = vmisa<Callable>(*onRejected)
+      ? *onRejected
+      : HermesValue::encodeUndefinedValue();
+
+  switch (self->state_) {
+    case State::Pending: {
+      // 9. If promise.[[PromiseState]] is pending, then append the reactions.
+      auto fulfillHandle = runtime.makeHandle(fulfillHandler);
+      auto rejectHandle = runtime.makeHandle(rejectHandler);
+      MutableHandle<ArrayStorage> reactions{
+          runtime, self->reactions_.get(runtime)};
+      if (!reactions) {
+        auto arrRes = ArrayStorage::create(runtime, kReactionSize);
+        if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        reactions = vmcast<ArrayStorage>(*arrRes);
+      }
+      for (Handle<> value :
+           {Handle<>(fulfillHandle),
+            Handle<>(rejectHandle),
+            capabilityTarget,
+            capabilityReject}) {
+        if (LLVM_UNLIKELY(
+                ArrayStorage::push_back(reactions, runtime, value) ==
+                ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+      }
+      self->reactions_.set(runtime, *reactions, runtime.getHeap());
+      break;
+    }
+    case State::Fulfilled:
+    case State::Rejected: {
+      // 10-11. The promise is already settled: enqueue the reaction job now.
+      const bool isRejection = self->state_ == State::Rejected;
+      Runtime::Job job;
+      job.kind = Runtime::Job::Kind::PromiseReaction;
+      job.isRejection = isRejection;
+      job.operands[0] = isRejection ? rejectHandler : fulfillHandler;
+      job.operands[1] = self->getResult();
+      job.operands[2] = *capabilityTarget;
+      job.operands[3] = *capabilityReject;
+      runtime.enqueueJob(job);
+      // 11.c. If promise.[[PromiseIsHandled]] is false, perform
+      // HostPromiseRejectionTracker(promise, "handle").
+      if (isRejection && !self->isHandled_) {
+        self->isHandled_ = true;
+        return trackRejection(self, runtime, true);
+      }
+      break;
+    }
+  }
+
+  // 12. Set promise.[[PromiseIsHandled]] to true.
+  self->isHandled_ = true;
+  return ExecutionStatus::RETURNED;
+}
+
+CallResult<Handle<JSPromise>> JSPromise::promiseResolve(
+    Runtime &runtime,
+    Handle<> value) {
+  // 1. If IsPromise(x) is true, then
+  if (auto promise = Handle<JSPromise>::dyn_vmcast(value)) {
+    // a. Let xConstructor be ? Get(x, "constructor").
+    auto ctorRes = JSObject::getNamed_RJS(
+        promise, runtime, Predefined::getSymbolID(Predefined::constructor));
+    if (LLVM_UNLIKELY(ctorRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    // b. If SameValue(xConstructor, C) is true, return x.
+    if (ctorRes->get().getRaw() == runtime.promiseConstructor.getRaw())
+      return promise;
+  }
+
+  // 2-4. Create a new promise and resolve it with x.
+  auto promise = runtime.makeHandle(create(runtime));
+  if (LLVM_UNLIKELY(
+          resolve(promise, runtime, value) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return promise;
+}
+
+ExecutionStatus JSPromise::runJob(
+    Runtime &runtime,
+    Runtime::Job::Kind kind,
+    bool isRejection,
+    llvh::ArrayRef<Handle<>> operands) {
+  if (kind == Runtime::Job::Kind::PromiseResolveThenable) {
+    // ES2022 27.2.2.2 NewPromiseResolveThenableJob.
+    auto promise = Handle<JSPromise>::vmcast(operands[0]);
+    auto thenable = operands[1];
+    auto then = Handle<Callable>::vmcast(operands[2]);
+    // a. Let resolvingFunctions be CreateResolvingFunctions(promiseToResolve).
+    MutableHandle<Callable> resolveFn{runtime};
+    MutableHandle<Callable> rejectFn{runtime};
+    createResolvingFunctions(promise, runtime, resolveFn, rejectFn);
+    // b. Let thenCallResult be Call(then, thenable,
+    //      « resolvingFunctions.[[Resolve]], resolvingFunctions.[[Reject]] »).
+    auto callRes = Callable::executeCall2(
+        then,
+        runtime,
+        thenable,
+        resolveFn.getHermesValue(),
+        rejectFn.getHermesValue());
+    if (LLVM_LIKELY(callRes != ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::RETURNED;
+    // c. If thenCallResult is an abrupt completion, then
+    //   i. Return Call(resolvingFunctions.[[Reject]], undefined,
+    //        « thenCallResult.[[Value]] »).
+    auto thrown = takeCatchableException(runtime);
+    if (!thrown)
+      return ExecutionStatus::EXCEPTION;
+    return Callable::executeCall1(
+               rejectFn, runtime, Runtime::getUndefinedValue(), **thrown)
+        .getStatus();
+  }
+
+  // ES2022 27.2.2.1 NewPromiseReactionJob.
+  assert(kind == Runtime::Job::Kind::PromiseReaction && "Unknown job kind");
+  auto handler = operands[0];
+  auto argument = operands[1];
+  auto capabilityTarget = operands[2];
+  auto capabilityReject = operands[3];
+
+  MutableHandle<> handlerResult{runtime, *argument};
+  bool isAbrupt = isRejection;
+  // d. If handler is empty, then the handler result is the argument.
+  // e. Else, let handlerResult be Call(handler, undefined, « argument »).
+  if (!handler->isUndefined()) {
+    auto callRes = Callable::executeCall1(
+        Handle<Callable>::vmcast(handler),
+        runtime,
+        Runtime::getUndefinedValue(),
+        *argument);
+    if (LLVM_LIKELY(callRes != ExecutionStatus::EXCEPTION)) {
+      handlerResult = callRes->get();
+      isAbrupt = false;
+    } else {
+      auto thrown = takeCatchableException(runtime);
+      if (!thrown)
+        return ExecutionStatus::EXCEPTION;
+      handlerResult = **thrown;
+      isAbrupt = true;
+    }
+  }
+
+  // f. If promiseCapability is undefined, then
+  if (capabilityTarget->isUndefined()) {
+    // i. Assert: handlerResult is not an abrupt completion.
+    // The only handlers without capability are the ones resuming async
+    // functions, which don't throw. Report it from the job if they do.
+    if (LLVM_UNLIKELY(isAbrupt && !handler->isUndefined())) {
+      runtime.setThrownValue(*handlerResult);
+      return ExecutionStatus::EXCEPTION;
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  // The capability of a promise derived by then() with %Promise%: settle it
+  // directly, since nothing else can resolve it.
+  if (auto derived = Handle<JSPromise>::dyn_vmcast(capabilityTarget)) {
+    if (capabilityReject->isUndefined()) {
+      return isAbrupt ? reject(derived, runtime, handlerResult)
+                      : resolve(derived, runtime, handlerResult);
+    }
+  }
+
+  // g-i. Call the resolving function of the capability.
+  return Callable::executeCall1(
+             Handle<Callable>::vmcast(
+                 isAbrupt ? capabilityReject : capabilityTarget),
+             runtime,
+             Runtime::getUndefinedValue(),
+             *handlerResult)
+      .getStatus();
+}
+
+ExecutionStatus JSPromise::trackRejection(
+    Handle<JSPromise> self,
+    Runtime &runtime,
+    bool handled) {
+  auto tracker = Handle<Callable>::dyn_vmcast(
+      Handle<>(&runtime.promiseRejectionTracker_));
+  if (!tracker)
+    return ExecutionStatus::RETURNED;
+  return Callable::executeCall3(
+             tracker,
+             runtime,
+             Runtime::getUndefinedValue(),
+             self.getHermesValue(),
+             HermesValue::encodeStringValue(runtime.getPredefinedString(
+                 handled ? Predefined::handle : Predefined::reject)),
+             self->result_)
+      .getStatus();
+}
+
+//===----------------------------------------------------------------------===//
+// Resolving functions
+
+/// ES2022 27.2.1.3.1 Promise Reject Functions and 27.2.1.3.2 Promise Resolve
+/// Functions. The context tells which one the callee is.
+CallResult<HermesValue>
+promiseResolvingFunction(void *ctx, Runtime &runtime, NativeArgs args) {
+  const bool isReject = (bool)ctx;
+  auto *callee = vmcast<NativeFunction>(
+      runtime.getCurrentFrame()->getCalleeClosureUnsafe());
+  SmallHermesValue promiseVal = NativeFunction::getAdditionalSlotValue(
+      callee, runtime, ResolvingFunctionSlotIndexes::promise);
+  // 5. If alreadyResolved.[[Value]] is true, return undefined.
+  if (promiseVal.isUndefined())
+    return HermesValue::encodeUndefinedValue();
+
+  // 6. Set alreadyResolved.[[Value]] to true.
+  auto promise =
+      runtime.makeHandle(vmcast<JSPromise>(promiseVal.getObject(runtime)));
+  auto *sibling = vmcast<NativeFunction>(
+      NativeFunction::getAdditionalSlotValue(
+          callee, runtime, ResolvingFunctionSlotIndexes::sibling)
+          .getObject(runtime));
+  NativeFunction::setAdditionalSlotValue(
+      callee,
+      runtime,
+      ResolvingFunctionSlotIndexes::promise,
+      SmallHermesValue::encodeUndefinedValue());
+  NativeFunction::setAdditionalSlotValue(
+      sibling,
+      runtime,
+      ResolvingFunctionSlotIndexes::promise,
+      SmallHermesValue::encodeUndefinedValue());
+
+  auto status = isReject
+      ? JSPromise::reject(promise, runtime, args.getArgHandle(0))
+      : JSPromise::resolve(promise, runtime, args.getArgHandle(0));
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return HermesValue::encodeUndefinedValue();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -170,6 +170,23 @@ ExecutionStatus JSRegExp::initialize(
   llvh::SmallVector<char16_t, 16> patternText16;
   pattern->appendUTF16String(patternText16);
 
+  // Reuse the bytecode if the pattern was compiled with these flags before.
+  RegExpCache &cache = runtime.getRegExpCache();
+  auto sflags = regex::SyntaxFlags::fromString(flagsText16);
+  if (sflags) {
+    if (const RegExpCache::Entry *entry =
+            cache.lookup(patternText16, *sflags)) {
+      if (LLVM_UNLIKELY(
+              initializeGroupNameMappingObj(
+                  runtime, selfHandle, entry->groupNames) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      initialize(selfHandle, runtime, pattern, flags, entry->bytecode);
+      return ExecutionStatus::RETURNED;
+    }
+  }
+
   // Build the regex.
   regex::Regex<regex::UTF16RegexTraits> regex(patternText16, flagsText16);
 
@@ -178,43 +195,43 @@ ExecutionStatus JSRegExp::initialize(
         TwineChar16("Invalid RegExp: ") +
         regex::constants::messageForError(regex.getError()));
   }
-  // The regex is valid. Compile and store its bytecode.
-  auto bytecode = regex.compile();
-  // Also store the name mappings.
+  // The regex is valid. Compile it, and store its bytecode and name mappings.
+  RegExpCache::Entry compiled;
+  compiled.bytecode = regex.compile();
+  auto &groupNamesMapping = regex.getGroupNamesMapping();
+  for (const auto &groupName : regex.getOrderedNamedGroups())
+    compiled.groupNames.emplace_back(groupName, groupNamesMapping[groupName]);
   if (LLVM_UNLIKELY(
           initializeGroupNameMappingObj(
-              runtime,
-              selfHandle,
-              regex.getOrderedNamedGroups(),
-              regex.getGroupNamesMapping()) == ExecutionStatus::EXCEPTION)) {
+              runtime, selfHandle, compiled.groupNames) ==
+          ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  initialize(selfHandle, runtime, pattern, flags, bytecode);
+  initialize(selfHandle, runtime, pattern, flags, compiled.bytecode);
+  cache.insert(patternText16, regex.flags(), std::move(compiled));
   return ExecutionStatus::RETURNED;
 }
 
 ExecutionStatus JSRegExp::initializeGroupNameMappingObj(
     Runtime &runtime,
     Handle<JSRegExp> selfHandle,
-    std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
-    regex::ParsedGroupNamesMapping &parsedMappings) {
+    llvh::ArrayRef<std::pair<regex::GroupName, uint32_t>> groupNames) {
   GCScope gcScope(runtime);
-  if (parsedMappings.size() == 0)
+  if (groupNames.empty())
     return ExecutionStatus::RETURNED;
 
-  auto objRes = JSObject::create(runtime, parsedMappings.size());
+  auto objRes = JSObject::create(runtime, groupNames.size());
   auto obj = runtime.makeHandle(objRes.get());
 
   MutableHandle<HermesValue> numberHandle{runtime};
-  for (const auto &identifier : orderedNamedGroups) {
+  for (const auto &groupName : groupNames) {
     GCScopeMarkerRAII marker{gcScope};
-    auto symbolRes =
-        runtime.getIdentifierTable().getSymbolHandle(runtime, identifier);
+    auto symbolRes = runtime.getIdentifierTable().getSymbolHandle(
+        runtime, groupName.first);
     if (LLVM_UNLIKELY(symbolRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    auto idx = parsedMappings[identifier];
-    numberHandle.set(HermesValue::encodeNumberValue(idx));
+    numberHandle.set(HermesValue::encodeNumberValue(groupName.second));
     auto res = JSObject::defineNewOwnProperty(
         obj,
         runtime,
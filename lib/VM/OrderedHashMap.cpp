@@ -7,32 +7,93 @@
 
 #include "hermes/VM/OrderedHashMap.h"
 
+#include "hermes/Support/CheckedMalloc.h"
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/Operations.h"
 
+#include <vector>
+
 namespace hermes {
 namespace vm {
 //===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-const VTable HashMapEntry::vt{
-    CellKind::HashMapEntryKind,
-    cellSize<HashMapEntry>()};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.setVTable(&HashMapEntry::vt);
-  mb.addField("key", &self->key);
-  mb.addField("value", &self->value);
-  mb.addField("prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("nextEntryInBucket", &self->nextEntryInBucket);
+// class OrderedHashTable
+
+const VTable OrderedHashTable::vt{
+    CellKind::OrderedHashTableKind,
+    cellSize<OrderedHashTable>()};
+
+void OrderedHashTableBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  const auto *self = static_cast<const OrderedHashTable *>(cell);
+  mb.setVTable(&OrderedHashTable::vt);
+  mb.addField("entries", &self->entries_);
+  mb.addField("next", &self->next_);
 }
 
-CallResult<PseudoHandle<HashMapEntry>> HashMapEntry::create(Runtime &runtime) {
-  return createPseudoHandle(runtime.makeAFixed<HashMapEntry>());
+OrderedHashTable::OrderedHashTable(
+    Runtime &runtime,
+    Handle<SegmentedArray> entries,
+    uint32_t capacity)
+    : entries_(runtime, entries.get(), runtime.getHeap()),
+      capacity_(capacity) {}
+
+CallResult<PseudoHandle<OrderedHashTable>> OrderedHashTable::create(
+    Runtime &runtime,
+    uint32_t capacity) {
+  // Allocate all of the entries up front, so that appending never allocates.
+  auto arrRes = SegmentedArray::create(runtime, 2 * capacity, 2 * capacity);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto entries = runtime.makeHandle<SegmentedArray>(std::move(*arrRes));
+  return createPseudoHandle(
+      runtime.makeAFixed<OrderedHashTable>(runtime, entries, capacity));
+}
+
+bool OrderedHashTable::advance(
+    PointerBase &base,
+    OrderedHashTable *&table,
+    uint32_t &index) {
+  // Find the position in the table that the map uses now.
+  while (OrderedHashTable *next = table->next_.get(base)) {
+    if (table->cleared_) {
+      index = 0;
+    } else {
+      // A rehash moves the live entries in order, so the position in the next
+      // table is after the entries that were live before it.
+      uint32_t numLive = 0;
+      for (uint32_t i = 0, e = std::min(index, table->numEntries_); i < e;
+           ++i) {
+        numLive += !table->isErased(base, i);
+      }
+      index = numLive;
+    }
+    table = next;
+  }
+  for (; index < table->numEntries_; ++index) {
+    if (!table->isErased(base, index))
+      return true;
+  }
+  return false;
+}
+
+uint32_t OrderedHashTable::append(
+    Runtime &runtime,
+    HermesValue key,
+    HermesValue value) {
+  assert(numEntries_ < capacity_ && "The table is full");
+  SegmentedArray *entries = entries_.getNonNull(runtime);
+  uint32_t index = numEntries_++;
+  entries->set(runtime, 2 * index, key);
+  entries->set(runtime, 2 * index + 1, value);
+  return index;
+}
+
+void OrderedHashTable::erase(Runtime &runtime, uint32_t index) {
+  SegmentedArray *entries = entries_.getNonNull(runtime);
+  entries->setNonPtr(runtime, 2 * index, HermesValue::encodeEmptyValue());
+  entries->setNonPtr(runtime, 2 * index + 1, HermesValue::encodeEmptyValue());
 }
 
 //===----------------------------------------------------------------------===//
@@ -40,160 +101,121 @@ CallResult<PseudoHandle<HashMapEntry>> HashMapEntry::create(Runtime &runtime) {
 
 const VTable OrderedHashMap::vt{
     CellKind::OrderedHashMapKind,
-    cellSize<OrderedHashMap>()};
+    cellSize<OrderedHashMap>(),
+    OrderedHashMap::_finalizeImpl,
+    nullptr,
+    OrderedHashMap::_mallocSizeImpl};
 
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
   mb.setVTable(&OrderedHashMap::vt);
-  mb.addField("hashTable", &self->hashTable_);
-  mb.addField("firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("table", &self->table_);
 }
 
 OrderedHashMap::OrderedHashMap(
     Runtime &runtime,
-    Handle<ArrayStorageSmall> hashTableStorage)
-    : hashTable_(runtime, hashTableStorage.get(), runtime.getHeap()) {}
+    Handle<OrderedHashTable> table)
+    : table_(runtime, table.get(), runtime.getHeap()),
+      buckets_(allocateBuckets(2 * table->capacity_)),
+      numBuckets_(2 * table->capacity_) {}
 
 CallResult<PseudoHandle<OrderedHashMap>> OrderedHashMap::create(
     Runtime &runtime) {
-  auto arrRes =
-      ArrayStorageSmall::create(runtime, INITIAL_CAPACITY, INITIAL_CAPACITY);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+  auto tableRes = OrderedHashTable::create(runtime, INITIAL_CAPACITY);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime.makeHandle<ArrayStorageSmall>(*arrRes);
-
+  auto table = runtime.makeHandle<OrderedHashTable>(std::move(*tableRes));
   return createPseudoHandle(
-      runtime.makeAFixed<OrderedHashMap>(runtime, hashTableStorage));
+      runtime.makeAFixed<OrderedHashMap, HasFinalizer::Yes>(runtime, table));
 }
 
-void OrderedHashMap::removeLinkedListNode(
-    Runtime &runtime,
-    HashMapEntry *entry,
-    GC &gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.getNonNull(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
-  }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.getNonNull(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
-  }
-  entry->prevIterationEntry.setNull(runtime.getHeap());
+void OrderedHashMap::_finalizeImpl(GCCell *cell, GC &) {
+  auto *self = vmcast<OrderedHashMap>(cell);
+  free(self->buckets_);
 }
 
-static HashMapEntry *castToMapEntry(SmallHermesValue shv, PointerBase &base) {
-  if (shv.isEmpty())
-    return nullptr;
-  return vmcast<HashMapEntry>(shv.getObject(base));
+size_t OrderedHashMap::_mallocSizeImpl(GCCell *cell) {
+  auto *self = vmcast<OrderedHashMap>(cell);
+  return self->numBuckets_ * sizeof(Bucket);
 }
 
-HashMapEntry *OrderedHashMap::lookupInBucket(
-    Runtime &runtime,
-    uint32_t bucket,
-    HermesValue key) {
+OrderedHashMap::Bucket *OrderedHashMap::allocateBuckets(uint32_t numBuckets) {
   assert(
-      hashTable_.getNonNull(runtime)->size() == capacity_ &&
-      "Inconsistent capacity");
-  auto *entry =
-      castToMapEntry(hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  return entry;
+      (numBuckets & (numBuckets - 1)) == 0 &&
+      "numBuckets must be a power of 2");
+  auto *buckets =
+      static_cast<Bucket *>(checkedMalloc2(numBuckets, sizeof(Bucket)));
+  std::fill_n(buckets, numBuckets, Bucket{EMPTY, 0});
+  return buckets;
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
-    Handle<OrderedHashMap> self,
-    Runtime &runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the appropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
+OrderedHashMap::Bucket *
+OrderedHashMap::lookup(PointerBase &base, HermesValue key, uint32_t hash) {
+  OrderedHashTable *table = table_.getNonNull(base);
+  const uint32_t mask = numBuckets_ - 1;
+  // Quadratic probing visits every bucket of a power of 2 sized index, and
+  // the index is at most half full, so this always reaches an empty bucket.
+  for (uint32_t i = hash & mask, step = 1;; i = (i + step++) & mask) {
+    Bucket *bucket = &buckets_[i];
+    if (bucket->entry == EMPTY)
+      return nullptr;
+    if (bucket->entry != ERASED && bucket->hash == hash &&
+        isSameValueZero(table->keyAt(base, bucket->entry), key)) {
+      return bucket;
     }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
   }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
-  }
-  assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
+}
 
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
+void OrderedHashMap::addToIndex(
+    Bucket *buckets,
+    uint32_t numBuckets,
+    uint32_t entry,
+    uint32_t hash) {
+  const uint32_t mask = numBuckets - 1;
+  uint32_t i = hash & mask;
+  for (uint32_t step = 1; buckets[i].entry < ERASED; ++step)
+    i = (i + step) & mask;
+  buckets[i] = Bucket{entry, hash};
+}
 
-  // Create a new hash table.
-  auto arrRes = ArrayStorageSmall::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+ExecutionStatus OrderedHashMap::rehash(
+    Handle<OrderedHashMap> self,
+    Runtime &runtime,
+    uint32_t newCapacity) {
+  assert(self->size_ <= newCapacity && "The new table is too small");
+  auto tableRes = OrderedHashTable::create(runtime, newCapacity);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto newHashTable = runtime.makeHandle<ArrayStorageSmall>(*arrRes);
-
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
-  MutableHandle<> keyHandle{runtime};
-  GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.getNonNull(runtime)->size();
-       i < len;
-       ++i) {
-    entry =
-        castToMapEntry(self->hashTable_.getNonNull(runtime)->at(i), runtime);
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket.setNull(runtime.getHeap());
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket).getObject(runtime)),
-            runtime.getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->set(
-          bucket,
-          SmallHermesValue::encodeObjectValue(*entry, runtime),
-          runtime.getHeap());
+  auto newTable = runtime.makeHandle<OrderedHashTable>(std::move(*tableRes));
+  OrderedHashTable *oldTable = self->table_.getNonNull(runtime);
+
+  // The index holds the hashes of the keys, so they need not be computed
+  // again.
+  std::vector<uint32_t> hashes(oldTable->numEntries_);
+  for (uint32_t i = 0; i < self->numBuckets_; ++i) {
+    const Bucket &bucket = self->buckets_[i];
+    if (bucket.entry < ERASED)
+      hashes[bucket.entry] = bucket.hash;
+  }
 
-      entry = *oldNextInBucket;
-    }
+  const uint32_t newNumBuckets = 2 * newCapacity;
+  Bucket *newBuckets = allocateBuckets(newNumBuckets);
+  for (uint32_t i = 0, e = oldTable->numEntries_; i < e; ++i) {
+    if (oldTable->isErased(runtime, i))
+      continue;
+    uint32_t entry = newTable->append(
+        runtime, oldTable->keyAt(runtime, i), oldTable->valueAt(runtime, i));
+    addToIndex(newBuckets, newNumBuckets, entry, hashes[i]);
   }
+  assert(newTable->numEntries_ == self->size_ && "Inconsistent size");
 
-  self->hashTable_.setNonNull(runtime, newHashTable.get(), runtime.getHeap());
-  assert(
-      self->hashTable_.getNonNull(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  oldTable->next_.set(runtime, newTable.get(), runtime.getHeap());
+  self->table_.setNonNull(runtime, newTable.get(), runtime.getHeap());
+  free(self->buckets_);
+  self->buckets_ = newBuckets;
+  self->numBuckets_ = newNumBuckets;
   return ExecutionStatus::RETURNED;
 }
 
@@ -201,27 +223,20 @@ bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime &runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  uint32_t keyHash = hash(runtime, key);
+  return self->lookup(runtime, key.get(), keyHash);
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  uint32_t keyHash = hash(runtime, key);
+  Bucket *bucket = self->lookup(runtime, key.get(), keyHash);
+  if (!bucket) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return self->table_.getNonNull(runtime)->valueAt(runtime, bucket->entry);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -229,162 +244,92 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime &runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  uint32_t keyHash = hash(runtime, key);
+  if (Bucket *bucket = self->lookup(runtime, key.get(), keyHash)) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), runtime.getHeap());
+    self->table_.getNonNull(runtime)->setValue(
+        runtime, bucket->entry, value.get());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime.makeHandle(std::move(*crtRes));
-  newMapEntry->key.set(key.get(), runtime.getHeap());
-  newMapEntry->value.set(value.get(), runtime.getHeap());
-  auto *curBucketFront =
-      castToMapEntry(self->hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, runtime.getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.getNonNull(runtime)->set(
-      bucket,
-      SmallHermesValue::encodeObjectValue(*newMapEntry, runtime),
-      runtime.getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.getNonNull(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, runtime.getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(runtime, previousLastEntry, runtime.getHeap());
+
+  OrderedHashTable *table = self->table_.getNonNull(runtime);
+  if (table->numEntries_ == table->capacity_) {
+    // The table is full. Compact it, and grow it unless at most half of its
+    // entries are alive.
+    uint32_t newCapacity = table->capacity_;
+    if (self->size_ >= newCapacity / 2) {
+      if (LLVM_UNLIKELY(newCapacity == MAX_CAPACITY)) {
+        return runtime.raiseRangeError("Map or Set exceeds the maximum size");
+      }
+      newCapacity *= 2;
+    }
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, newCapacity) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    table = self->table_.getNonNull(runtime);
   }
 
+  uint32_t entry = table->append(runtime, key.get(), value.get());
+  addToIndex(self->buckets_, self->numBuckets_, entry, keyHash);
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      castToMapEntry(self->hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  uint32_t keyHash = hash(runtime, key);
+  Bucket *bucket = self->lookup(runtime, key.get(), keyHash);
+  if (!bucket) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, runtime.getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.getNonNull(runtime)->set(
-        bucket,
-        entry->nextEntryInBucket
-            ? SmallHermesValue::encodeObjectValue(entry->nextEntryInBucket)
-            : SmallHermesValue::encodeEmptyValue(),
-        runtime.getHeap());
-  }
-
-  entry->markDeleted(runtime);
+  // Leave the entry in place, so that the position of iterators in the table
+  // stays valid.
+  OrderedHashTable *table = self->table_.getNonNull(runtime);
+  table->erase(runtime, bucket->entry);
+  bucket->entry = ERASED;
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, runtime.getHeap());
+  if (self->size_ < table->capacity_ / 4 &&
+      table->capacity_ > INITIAL_CAPACITY) {
+    // Less than a quarter of the table is alive, shrink it. The new table is
+    // smaller than the current one, so allocating it cannot throw.
+    auto status = rehash(self, runtime, table->capacity_ / 2);
+    (void)status;
+    assert(status == ExecutionStatus::RETURNED && "Shrinking cannot fail");
   }
-
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
-    Runtime &runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
-    // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
-  }
-
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
-  }
-  return entry;
-}
-
-void OrderedHashMap::clear(Runtime &runtime) {
-  if (!firstIterationEntry_) {
-    // Empty set.
-    return;
+ExecutionStatus OrderedHashMap::clear(
+    Handle<OrderedHashMap> self,
+    Runtime &runtime) {
+  if (self->table_.getNonNull(runtime)->numEntries_ == 0) {
+    // Nothing was added since the table was created.
+    return ExecutionStatus::RETURNED;
   }
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = castToMapEntry(hashTable_.getNonNull(runtime)->at(i), runtime);
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted(runtime);
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.getNonNull(runtime)->setNonPtr(
-        i, SmallHermesValue::encodeEmptyValue(), runtime.getHeap());
+  auto tableRes = OrderedHashTable::create(runtime, INITIAL_CAPACITY);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-  // Resize the hash table to the initial size.
-  ArrayStorageSmall::resizeWithinCapacity(
-      hashTable_.getNonNull(runtime), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, runtime.getHeap());
-  firstIterationEntry_.getNonNull(runtime)->prevIterationEntry.setNull(
-      runtime.getHeap());
-  size_ = 0;
+  auto newTable = runtime.makeHandle<OrderedHashTable>(std::move(*tableRes));
+
+  // Leave the entries of the old table alone, iterators in it continue from
+  // the start of the new table.
+  OrderedHashTable *oldTable = self->table_.getNonNull(runtime);
+  oldTable->cleared_ = true;
+  oldTable->next_.set(runtime, newTable.get(), runtime.getHeap());
+  self->table_.setNonNull(runtime, newTable.get(), runtime.getHeap());
+  free(self->buckets_);
+  self->numBuckets_ = 2 * INITIAL_CAPACITY;
+  self->buckets_ = allocateBuckets(self->numBuckets_);
+  self->size_ = 0;
+  return ExecutionStatus::RETURNED;
 }
 
 } // namespace vm
@@ -44,16 +44,20 @@ bool InlineCacheProfiler::insertICMiss(
     uint32_t instOffset,
     SymbolID &propertyID,
     ClassId objectHiddenClassId,
-    ClassId cachedHiddenClassId) {
+    ClassId cachedHiddenClassId,
+    bool megamorphic) {
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
   // record the hidden class pair for the source location
   auto hcPair =
       std::pair<ClassId, ClassId>(objectHiddenClassId, cachedHiddenClassId);
   auto icRecord =
       std::pair<PropertyId, HiddenClassPair>(propertyID.unsafeGetRaw(), hcPair);
-  icMiss.insertMiss(icRecord);
+  icMiss.insertMiss(icRecord, megamorphic);
 
   ++totalMisses_;
+  if (megamorphic) {
+    ++totalMegamorphicMisses_;
+  }
   return true;
 }
 
@@ -68,6 +72,16 @@ bool InlineCacheProfiler::insertICHit(
   return true;
 }
 
+bool InlineCacheProfiler::insertICPolymorphicHit(
+    CodeBlock *codeblock,
+    uint32_t instOffset) {
+  ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
+  icMiss.incrementPolymorphicHit();
+
+  ++totalPolymorphicHits_;
+  return true;
+}
+
 JSArray *&InlineCacheProfiler::getHiddenClassArray() {
   return cachedHiddenClassesRawPtr_;
 }
@@ -171,12 +185,16 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
             << std::get<2>(loc) << "] ";
 
     // output inline caching statistics
+    uint64_t totalAccess =
+        icMiss.missCount + icMiss.hitCount + icMiss.polymorphicHitCount;
     std::stringstream stream;
     stream << std::fixed << std::setprecision(1)
-           << (1. * icMiss.missCount) / (icMiss.missCount + icMiss.hitCount);
+           << (1. * icMiss.missCount) / totalAccess;
     std::string missRatio = stream.str();
-    ostream << "total access: " << icMiss.missCount + icMiss.hitCount
-            << ", miss ratio: " << missRatio << "\n";
+    ostream << "total access: " << totalAccess << ", miss ratio: " << missRatio
+            << ", polymorphic hits: " << icMiss.polymorphicHitCount
+            << ", megamorphic misses: " << icMiss.megamorphicMissCount
+            << "\n";
   } else {
     ostream << "[No Loc]\n";
   }
@@ -188,7 +206,8 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 /// The source locations are ranked in the descending order of IC misses.
 ///
 /// An example of output for a specific source location is as follows:
-/// [filename:line:column] total access: 2661, miss ratio: 0.3
+/// [filename:line:column] total access: 2661, miss ratio: 0.3,
+///   polymorphic hits: 120, megamorphic misses: 0
 ///  property: children, inline cache misses: 427
 ///    <type, domNamespace, children, childIndex, context, footer>
 ///    <domNamespace, type, children, childIndex, context, footer>
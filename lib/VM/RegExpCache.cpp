@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+namespace hermes {
+namespace vm {
+
+RegExpCache::Key RegExpCache::makeKey(
+    llvh::ArrayRef<char16_t> pattern,
+    regex::SyntaxFlags flags) {
+  Key key;
+  key.reserve(pattern.size() + 1);
+  key.push_back(flags.toByte());
+  key.append(pattern.begin(), pattern.end());
+  return key;
+}
+
+size_t RegExpCache::entrySize(const Key &key, const Entry &entry) {
+  size_t size = sizeof(EntryList::value_type) +
+      key.capacity() * sizeof(char16_t) + entry.bytecode.capacity() +
+      entry.groupNames.capacity() * sizeof(entry.groupNames[0]);
+  for (const auto &groupName : entry.groupNames)
+    size += groupName.first.capacity_in_bytes();
+  return size;
+}
+
+const RegExpCache::Entry *RegExpCache::lookup(
+    llvh::ArrayRef<char16_t> pattern,
+    regex::SyntaxFlags flags) {
+  if (capacity_ == 0)
+    return nullptr;
+  auto it = index_.find(makeKey(pattern, flags));
+  if (it == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  // Move the entry to the front, as the most recently used.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return &it->second->second;
+}
+
+void RegExpCache::insert(
+    llvh::ArrayRef<char16_t> pattern,
+    regex::SyntaxFlags flags,
+    Entry entry) {
+  if (capacity_ == 0)
+    return;
+  Key key = makeKey(pattern, flags);
+  if (index_.count(key))
+    return;
+  if (entries_.size() == capacity_) {
+    const auto &lru = entries_.back();
+    mallocSize_ -= entrySize(lru.first, lru.second);
+    index_.erase(lru.first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(std::move(key), std::move(entry));
+  mallocSize_ += entrySize(entries_.front().first, entries_.front().second);
+  index_.emplace(entries_.front().first, entries_.begin());
+}
+
+} // namespace vm
+} // namespace hermes
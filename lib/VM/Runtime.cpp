@@ -29,6 +29,7 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/JSPromise.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/OrderedHashMap.h"
@@ -239,9 +240,13 @@ Runtime::Runtime(
           createRuntimeCommonStorage(runtimeConfig.getTraceEnabled())),
       stackPointer_(),
       crashMgr_(runtimeConfig.getCrashMgr()),
+      regExpCache_(runtimeConfig.getRegExpCacheSize()),
       crashCallbackKey_(
           crashMgr_->registerCallback([this](int fd) { crashCallback(fd); })),
       codeCoverageProfiler_(std::make_unique<CodeCoverageProfiler>(*this)),
+      jitContext_(
+          runtimeConfig.getEnableJIT(),
+          runtimeConfig.getJITThreshold()),
       gcEventCallback_(runtimeConfig.getGCConfig().getCallback()) {
   assert(
       (void *)this == (void *)(HandleRootOwner *)this &&
@@ -520,8 +525,9 @@ void Runtime::markRoots(
   {
     MarkRootsPhaseTimer timer(*this, RootAcceptor::Section::Jobs);
     acceptor.beginRootSection(RootAcceptor::Section::Jobs);
-    for (Callable *&f : jobQueue_)
-      acceptor.acceptPtr(f);
+    for (Job &job : jobQueue_)
+      for (PinnedHermesValue &operand : job.operands)
+        acceptor.accept(operand);
     acceptor.endRootSection();
   }
 
@@ -630,8 +636,10 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor, bool markLongLived) {
     for (auto &rm : runtimeModuleList_)
       rm.markLongLivedWeakRoots(acceptor);
   }
-  for (auto &rm : runtimeModuleList_)
+  for (auto &rm : runtimeModuleList_) {
     rm.markDomainRef(acceptor);
+    rm.markAllocationSites(acceptor);
+  }
   for (auto &fn : customMarkWeakRootFuncs_)
     fn(&getHeap(), acceptor);
   acceptor.endRootSection();
@@ -821,9 +829,18 @@ void Runtime::printArrayCensus(llvh::raw_ostream &os) {
   arraySizeToCountAndWastedSlots.clear();
   getHeap().forAllObjs([&arraySizeToCountAndWastedSlots, this](GCCell *cell) {
     if (JSArray *arr = dyn_vmcast<JSArray>(cell)) {
-      JSArray::StorageType *storage = arr->getIndexedStorage(*this);
-      const auto capacity = storage ? storage->totalCapacityOfSpine() : 0;
-      const auto sz = storage ? storage->size(*this) : 0;
+      uint32_t capacity = 0;
+      uint32_t sz = 0;
+      if (arr->hasDoubleElements()) {
+        if (DoubleStorage *storage = arr->getDoubleStorage(*this)) {
+          capacity = storage->capacity();
+          sz = storage->size();
+        }
+      } else if (
+          JSArray::StorageType *storage = arr->getIndexedStorage(*this)) {
+        capacity = storage->totalCapacityOfSpine();
+        sz = storage->size(*this);
+      }
       const auto key = std::make_pair(capacity, arr->getAllocatedSize());
       arraySizeToCountAndWastedSlots[key].first++;
       arraySizeToCountAndWastedSlots[key].second += capacity - sz;
@@ -978,7 +995,10 @@ CallResult<HermesValue> Runtime::runBytecode(
     }
     if (getVMExperimentFlags() & experiments::MAdviseRandom) {
       bytecode->madvise(oscompat::MAdvice::Random);
-    } else if (getVMExperimentFlags() & experiments::MAdviseSequential) {
+    } else if (
+        getVMExperimentFlags() &
+        (experiments::MAdviseSequential |
+         experiments::MAdviseStartupSequential)) {
       bytecode->madvise(oscompat::MAdvice::Sequential);
     }
     if (getVMExperimentFlags() & experiments::VerifyBytecodeChecksum) {
@@ -1006,6 +1026,21 @@ CallResult<HermesValue> Runtime::runBytecode(
     }
   }
 
+  // Running the global code is the startup of a persistent bytecode file.
+  // Afterwards, its pages are mostly touched by calls to arbitrary functions.
+  // The provider outlives this call in persistentBCProviders_.
+  hbc::BCProvider *startupBytecode =
+      flags.persistent ? bytecode.get() : nullptr;
+  const auto &startupGuard = llvh::make_scope_exit([this, startupBytecode] {
+    if (!startupBytecode)
+      return;
+    if (getVMExperimentFlags() & experiments::MAdviseStartupSequential)
+      startupBytecode->madvise(oscompat::MAdvice::Random);
+    if (auto *tracker = startupBytecode->getPageAccessTracker())
+      tracker->markStartupComplete();
+  });
+  (void)startupGuard;
+
   GCScope scope(*this);
 
   Handle<Domain> domain = makeHandle(Domain::create(*this));
@@ -1682,6 +1717,14 @@ void Runtime::initJSBuiltins(
     auto symID = jsBuiltin.symID;
     auto builtinIndex = jsBuiltin.builtinIndex;
 
+    // spawnAsync drives async functions with Promise, so it comes with the
+    // native Promise instead of the internal bytecode when that is in use.
+    if (builtinIndex == BuiltinMethod::HermesBuiltin_spawnAsync &&
+        hasNativePromise()) {
+      builtins[builtinIndex] = createAsyncFunctionSpawner(*this);
+      continue;
+    }
+
     // Try to get the JS function from jsBuiltinsObj.
     auto getRes = JSObject::getNamed_RJS(
         jsBuiltinsObj, *this, Predefined::getSymbolID((Predefined::Str)symID));
@@ -1771,23 +1814,40 @@ void Runtime::freezeBuiltins() {
   builtinsFrozen_ = true;
 }
 
-ExecutionStatus Runtime::drainJobs() {
+ExecutionStatus Runtime::drainJobs(size_t maxJobs) {
   GCScope gcScope{*this};
-  MutableHandle<Callable> job{*this};
   // Note that new jobs can be enqueued during the draining.
-  while (!jobQueue_.empty()) {
+  for (size_t i = 0; i < maxJobs && !jobQueue_.empty(); ++i) {
     GCScopeMarkerRAII marker{gcScope};
 
-    job = jobQueue_.front();
+    // Move the operands into handles before popping the job, since running it
+    // may allocate and enqueue more jobs.
+    const Job &front = jobQueue_.front();
+    const Job::Kind kind = front.kind;
+    const bool isRejection = front.isRejection;
+    static_assert(Job::kNumOperands == 4, "Update the handles below");
+    const Handle<> operands[] = {
+        makeHandle(front.operands[0]),
+        makeHandle(front.operands[1]),
+        makeHandle(front.operands[2]),
+        makeHandle(front.operands[3])};
     jobQueue_.pop_front();
 
-    // Jobs are guaranteed to behave as thunks.
-    auto callRes =
-        Callable::executeCall0(job, *this, Runtime::getUndefinedValue());
+    ExecutionStatus status;
+    if (kind == Job::Kind::Call) {
+      // Jobs are guaranteed to behave as thunks.
+      status = Callable::executeCall0(
+                   Handle<Callable>::vmcast(operands[0]),
+                   *this,
+                   Runtime::getUndefinedValue())
+                   .getStatus();
+    } else {
+      status = JSPromise::runJob(*this, kind, isRejection, operands);
+    }
 
     // Early return to signal the caller. Note that the exceptional job has been
     // popped, so re-invocation would pick up from the next available job.
-    if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
   }
@@ -2080,8 +2140,9 @@ void Runtime::recordHiddenClass(
     const Inst *cacheMissInst,
     SymbolID symbolID,
     HiddenClass *objectHiddenClass,
-    HiddenClass *cachedHiddenClass) {
+    PropertyCacheEntry *cacheEntry) {
   auto offset = codeBlock->getOffsetOf(cacheMissInst);
+  HiddenClass *cachedHiddenClass = cacheEntry->clazz.get(*this, getHeap());
 
   // inline caching hit
   if (objectHiddenClass == cachedHiddenClass) {
@@ -2089,6 +2150,14 @@ void Runtime::recordHiddenClass(
     return;
   }
 
+  // polymorphic inline caching hit
+  SlotIndex polySlot;
+  if (cacheEntry->findPolymorphic(
+          CompressedPointer::encode(objectHiddenClass, *this), polySlot)) {
+    inlineCacheProfiler_.insertICPolymorphicHit(codeBlock, offset);
+    return;
+  }
+
   // inline caching miss
   assert(objectHiddenClass != nullptr && "object hidden class should exist");
   // prevent object hidden class from being GC-ed
@@ -2103,7 +2172,12 @@ void Runtime::recordHiddenClass(
   }
   // add the record to inline caching profiler
   inlineCacheProfiler_.insertICMiss(
-      codeBlock, offset, symbolID, objectHiddenClassId, cachedHiddenClassId);
+      codeBlock,
+      offset,
+      symbolID,
+      objectHiddenClassId,
+      cachedHiddenClassId,
+      cacheEntry->megamorphic);
 }
 
 void Runtime::getInlineCacheProfilerInfo(llvh::raw_ostream &ostream) {
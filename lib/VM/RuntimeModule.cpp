@@ -407,6 +407,11 @@ void RuntimeModule::markLongLivedWeakRoots(WeakRootAcceptor &acceptor) {
   }
 }
 
+void RuntimeModule::markAllocationSites(WeakRootAcceptor &acceptor) {
+  for (CodeBlock *codeBlock : allocationSiteCodeBlocks_)
+    codeBlock->markAllocationSites(acceptor);
+}
+
 llvh::Optional<Handle<HiddenClass>> RuntimeModule::findCachedLiteralHiddenClass(
     Runtime &runtime,
     unsigned keyBufferIndex,
@@ -443,7 +448,8 @@ void RuntimeModule::tryCacheLiteralHiddenClass(
 size_t RuntimeModule::additionalMemorySize() const {
   return stringIDMap_.capacity() * sizeof(SymbolID) +
       objectLiteralHiddenClasses_.getMemorySize() +
-      templateMap_.getMemorySize();
+      templateMap_.getMemorySize() +
+      allocationSiteCodeBlocks_.capacity() * sizeof(CodeBlock *);
 }
 
 #ifdef HERMES_MEMORY_INSTRUMENTATION
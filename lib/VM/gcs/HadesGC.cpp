@@ -18,8 +18,9 @@
 #include "hermes/VM/RootAndSlotAcceptorDefault.h"
 
 #include <array>
+#include <atomic>
+#include <cmath>
 #include <functional>
-#include <stack>
 
 #pragma GCC diagnostic push
 
@@ -38,6 +39,15 @@ static const char *kCompacteeNameForCrashMgr = "COMPACT";
 // We have a target max pause time of 50ms.
 static constexpr size_t kTargetMaxPauseMs = 50;
 
+// Grow the YG while less than 15% of it survives on average, and shrink it
+// once more than half of it does.
+static constexpr double kYGLowSurvivalRatio = 0.15;
+static constexpr double kYGHighSurvivalRatio = 0.5;
+
+// Never let the YG drop below 1/16th of its segment, regardless of the
+// configured minimum size.
+static constexpr double kYGSmallestSizeFactor = 1.0 / 16;
+
 // A free list cell is always variable-sized.
 const VTable HadesGC::OldGen::FreelistCell::vt{
     CellKind::FreelistKind,
@@ -279,6 +289,15 @@ class HadesGC::CollectionStats final {
     sizeAfter_ = sz;
   }
 
+  /// Record how the marking work was split between threads in a parallel
+  /// collection.
+  void setMarkingWorkerStats(
+      std::vector<uint64_t> markedBytesPerWorker,
+      std::vector<uint64_t> stealsPerWorker) {
+    markedBytesPerWorker_ = std::move(markedBytesPerWorker);
+    stealsPerWorker_ = std::move(stealsPerWorker);
+  }
+
   /// Record that a collection is beginning right now.
   void setBeginTime() {
     assert(beginTime_ == Clock::time_point{} && "Begin time already set");
@@ -351,7 +370,9 @@ class HadesGC::CollectionStats final {
         /*size*/ BeforeAndAfter{sizeBefore_, sizeAfter_},
         /*external*/ BeforeAndAfter{externalBefore_, afterExternalBytes()},
         /*survivalRatio*/ survivalRatio(),
-        /*tags*/ std::move(tags_)};
+        /*tags*/ std::move(tags_),
+        /*markedBytesPerWorker*/ std::move(markedBytesPerWorker_),
+        /*stealsPerWorker*/ std::move(stealsPerWorker_)};
   }
 
  private:
@@ -369,6 +390,8 @@ class HadesGC::CollectionStats final {
   uint64_t sizeAfter_{0};
   uint64_t sweptBytes_{0};
   uint64_t sweptExternalBytes_{0};
+  std::vector<uint64_t> markedBytesPerWorker_;
+  std::vector<uint64_t> stealsPerWorker_;
 
 #ifndef NDEBUG
   bool usedDbg_{false};
@@ -392,6 +415,216 @@ template <>
   return CompressedPointer::encodeNonNull(a, base);
 }
 
+/// A fixed set of helper threads that each run the same task alongside the
+/// thread that starts it. Used to split marking and evacuation work across
+/// several threads.
+class HadesGC::WorkerPool {
+ public:
+  /// Start \p numHelpers threads, which wait until a task is run.
+  explicit WorkerPool(size_t numHelpers) {
+    for (size_t i = 0; i < numHelpers; ++i)
+      threads_.emplace_back([this, i] { worker(i + 1); });
+  }
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      shutdown_ = true;
+    }
+    taskCV_.notify_all();
+    for (std::thread &thread : threads_)
+      thread.join();
+  }
+
+  /// \return the number of threads that run each task, including the caller.
+  size_t numWorkers() const {
+    return threads_.size() + 1;
+  }
+
+  /// Run \p fn on every helper thread and on the calling thread, passing each
+  /// a distinct worker index. The calling thread is always index 0.
+  /// Returns once every thread has finished.
+  void run(const std::function<void(size_t)> &fn) {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      assert(!task_ && "Tasks cannot be nested");
+      task_ = &fn;
+      pending_ = threads_.size();
+      ++generation_;
+    }
+    taskCV_.notify_all();
+    fn(0);
+    std::unique_lock<std::mutex> lk(mtx_);
+    doneCV_.wait(lk, [this] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+ private:
+  void worker(size_t index) {
+    oscompat::set_thread_name("hades-worker");
+    uint64_t lastGeneration = 0;
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+      taskCV_.wait(lk, [this, lastGeneration] {
+        return shutdown_ || generation_ != lastGeneration;
+      });
+      if (shutdown_)
+        return;
+      lastGeneration = generation_;
+      const std::function<void(size_t)> *task = task_;
+      lk.unlock();
+      (*task)(index);
+      lk.lock();
+      if (--pending_ == 0)
+        doneCV_.notify_one();
+    }
+  }
+
+  std::mutex mtx_;
+  /// Signalled when a new task is available, or the pool is shutting down.
+  std::condition_variable taskCV_;
+  /// Signalled when the last helper finishes a task.
+  std::condition_variable doneCV_;
+  /// The task being run, or null between tasks.
+  const std::function<void(size_t)> *task_{nullptr};
+  /// Incremented for every task, so helpers can tell a new one has started.
+  uint64_t generation_{0};
+  /// The number of helpers that have not yet finished the current task.
+  size_t pending_{0};
+  bool shutdown_{false};
+  std::vector<std::thread> threads_;
+};
+
+/// Stacks of cells to visit for the threads of one parallel GC phase. Each
+/// thread owns a stack that only it pushes onto and pops from. When some
+/// thread is idle, busy threads move batches of cells to a stealable list,
+/// from which idle threads take them. The phase is complete once every thread
+/// is out of work.
+class HadesGC::WorkStealingStacks {
+ public:
+  explicit WorkStealingStacks(size_t numWorkers) : workers_(numWorkers) {}
+
+  /// Visit the cells on \p local, the stack owned by worker \p idx, by passing
+  /// each to \p visit, which may push more cells onto \p local. Returns once
+  /// every worker is out of work, or as soon as \p shouldStop returns true, in
+  /// which case unvisited cells are left on \p local and in the stealable
+  /// lists.
+  template <typename VisitFn, typename StopFn>
+  void drain(
+      size_t idx,
+      std::vector<GCCell *> &local,
+      VisitFn visit,
+      StopFn shouldStop) {
+    while (true) {
+      while (!local.empty() && !shouldStop()) {
+        GCCell *const cell = local.back();
+        local.pop_back();
+        visit(cell);
+        // Only give work away when another thread is waiting for it, so that
+        // the common case stays free of synchronization.
+        if (local.size() >= 2 * kStealBatch &&
+            numIdle_.load(std::memory_order_relaxed))
+          share(idx, local);
+      }
+      if (!local.empty())
+        return;
+      if (take(idx, local))
+        continue;
+      // Out of work. Wait for another thread to offer some, or for every
+      // thread to become idle, at which point no more work can appear.
+      numIdle_.fetch_add(1);
+      while (true) {
+        if (numStealable_.load()) {
+          numIdle_.fetch_sub(1);
+          if (take(idx, local))
+            break;
+          numIdle_.fetch_add(1);
+        }
+        if (numIdle_.load() == workers_.size() && !numStealable_.load())
+          return;
+        if (shouldStop())
+          return;
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /// Move the cells left in the stealable lists onto \p dest.
+  void takeRemaining(std::vector<GCCell *> &dest) {
+    for (Worker &worker : workers_) {
+      dest.insert(dest.end(), worker.stealable.begin(), worker.stealable.end());
+      worker.stealable.clear();
+    }
+    numStealable_ = 0;
+  }
+
+  /// \return the number of batches that worker \p idx took from others.
+  uint64_t steals(size_t idx) const {
+    return workers_[idx].steals;
+  }
+
+ private:
+  struct Worker {
+    /// Cells offered to idle workers. Protected by mtx.
+    std::vector<GCCell *> stealable;
+    std::mutex mtx;
+    uint64_t steals{0};
+  };
+
+  /// The number of cells moved at once between a local stack and a stealable
+  /// list.
+  static constexpr size_t kStealBatch = 64;
+
+  /// Move a batch of cells from the top of \p local to the stealable list of
+  /// worker \p idx.
+  void share(size_t idx, std::vector<GCCell *> &local) {
+    Worker &self = workers_[idx];
+    std::lock_guard<std::mutex> lk{self.mtx};
+    self.stealable.insert(
+        self.stealable.end(), local.end() - kStealBatch, local.end());
+    local.resize(local.size() - kStealBatch);
+    numStealable_.fetch_add(kStealBatch);
+  }
+
+  /// Refill the empty stack \p local of worker \p idx from its own stealable
+  /// list, or failing that, from another worker's.
+  /// \return true if any work was found.
+  bool take(size_t idx, std::vector<GCCell *> &local) {
+    if (!numStealable_.load())
+      return false;
+    if (takeFrom(workers_[idx], local))
+      return true;
+    const size_t numWorkers = workers_.size();
+    for (size_t i = 1; i < numWorkers; ++i) {
+      if (takeFrom(workers_[(idx + i) % numWorkers], local)) {
+        ++workers_[idx].steals;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Move a batch of cells from the stealable list of \p victim to \p local.
+  /// \return true if any cells were moved.
+  bool takeFrom(Worker &victim, std::vector<GCCell *> &local) {
+    std::lock_guard<std::mutex> lk{victim.mtx};
+    std::vector<GCCell *> &cells = victim.stealable;
+    if (cells.empty())
+      return false;
+    const size_t num = std::min(kStealBatch, cells.size());
+    local.insert(local.end(), cells.end() - num, cells.end());
+    cells.resize(cells.size() - num);
+    numStealable_.fetch_sub(num);
+    return true;
+  }
+
+  /// Never resized, since Worker cannot be moved.
+  std::vector<Worker> workers_;
+  /// The total number of cells in all stealable lists.
+  std::atomic<size_t> numStealable_{0};
+  /// The number of workers that have run out of work.
+  std::atomic<size_t> numIdle_{0};
+};
+
 template <bool CompactionEnabled>
 class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
                                     public WeakRootAcceptor {
@@ -458,6 +691,8 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
   LLVM_NODISCARD T forwardCell(GCCell *const cell) {
     assert(
         HeapSegment::getCellMarkBit(cell) && "Cannot forward unmarked object");
+    if (stacks_)
+      return forwardCellInParallel<T>(cell);
     if (cell->hasMarkedForwardingPointer()) {
       // Get the forwarding pointer from the header of the object.
       CompressedPointer forwardedCell = cell->getMarkedForwardingPointer();
@@ -554,6 +789,101 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
     return evacuatedBytes_;
   }
 
+  void addEvacuatedBytes(uint64_t bytes) {
+    evacuatedBytes_ += bytes;
+  }
+
+  /// Records the slots of OG cells that must be forwarded, to be forwarded
+  /// later by an EvacAcceptor. This lets several threads scan dirty cards
+  /// before any cell is promoted, since promotion modifies the OG.
+  class DirtySlotRecorder final : public SlotAcceptor {
+   public:
+    explicit DirtySlotRecorder(EvacAcceptor &evac) : evac_{evac} {}
+
+    void accept(GCPointerBase &ptr) override {
+      if (needsForwarding(CompressedPointer{ptr}, &ptr))
+        evac_.recordedPointers_.push_back(&ptr);
+    }
+
+    void accept(GCHermesValue &hv) override {
+      if (hv.isPointer() &&
+          needsForwarding(static_cast<GCCell *>(hv.getPointer()), &hv))
+        evac_.recordedValues_.push_back(&hv);
+    }
+
+    void accept(GCSmallHermesValue &hv) override {
+      if (hv.isPointer() && needsForwarding(hv.getPointer(), &hv))
+        evac_.recordedSmallValues_.push_back(&hv);
+    }
+
+    void accept(const GCSymbolID &sym) override {}
+
+   private:
+    EvacAcceptor &evac_;
+
+    /// \return true if \p ptr, stored at \p heapLoc, must be forwarded.
+    /// Otherwise dirty the card of \p heapLoc if needed, like acceptHeap.
+    template <typename T>
+    bool needsForwarding(T ptr, void *heapLoc) {
+      if (evac_.shouldForward(ptr))
+        return true;
+      if (CompactionEnabled && evac_.gc.compactee_.contains(ptr))
+        HeapSegment::cardTableCovering(heapLoc)->dirtyCardForAddress(heapLoc);
+      return false;
+    }
+  };
+
+  /// Prepare to evacuate as worker \p idx of a parallel YG collection that
+  /// balances work with \p stacks. Until endParallel, copied cells are kept
+  /// on this acceptor's stack instead of the copy list, and are promoted into
+  /// buffers of the OG that are allocated under \p promotionMutex.
+  void beginParallel(
+      WorkStealingStacks &stacks,
+      size_t idx,
+      std::mutex &promotionMutex) {
+    assert(!isTrackingIDs_ && "Cannot track object moves in parallel");
+    assert(!copyListHead_ && "Copy list must be empty");
+    stacks_ = &stacks;
+    workerIndex_ = idx;
+    promotionMutex_ = &promotionMutex;
+  }
+
+  /// Forward the slots recorded by a DirtySlotRecorder, then scan copied
+  /// cells until every thread of the collection is out of work.
+  void evacuateInParallel() {
+    for (GCPointerBase *ptr : recordedPointers_)
+      accept(*ptr);
+    for (GCHermesValue *hv : recordedValues_)
+      accept(*hv);
+    for (GCSmallHermesValue *hv : recordedSmallValues_)
+      accept(*hv);
+    recordedPointers_.clear();
+    recordedValues_.clear();
+    recordedSmallValues_.clear();
+    stacks_->drain(
+        workerIndex_,
+        copiedCells_,
+        [this](GCCell *cell) { gc.markCell(cell, *this); },
+        [] { return false; });
+    assert(copiedCells_.empty() && "Parallel evacuation stopped early");
+  }
+
+  /// Finish a parallel evacuation, after every thread has stopped. Marks the
+  /// cells promoted into this acceptor's buffers, which could not be marked
+  /// while other threads were setting mark bits nearby, and frees the unused
+  /// end of the last buffer.
+  void endParallel() {
+    retirePromotionBuffer();
+    for (const auto &range : promotedRanges_) {
+      for (GCCell *cell = range.first; cell < range.second;
+           cell = cell->nextCell())
+        HeapSegment::setCellMarkBit(cell);
+    }
+    promotedRanges_.clear();
+    stacks_ = nullptr;
+    promotionMutex_ = nullptr;
+  }
+
   CopyListCell *pop() {
     if (!copyListHead_) {
       return nullptr;
@@ -567,6 +897,11 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
   }
 
  private:
+  /// The size of the OG blocks that each thread of a parallel collection
+  /// promotes cells into. Larger cells are allocated individually.
+  static constexpr uint32_t kPromotionBufferSize = 32 * 1024;
+  static constexpr uint32_t kMaxBufferedCellSize = kPromotionBufferSize / 4;
+
   HadesGC &gc;
   PointerBase &pointerBase_;
   /// The copy list is managed implicitly in the body of each copied YG object.
@@ -574,10 +909,121 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
   const bool isTrackingIDs_;
   uint64_t evacuatedBytes_{0};
 
+  /// The stacks shared by the threads of a parallel collection, or null when
+  /// evacuating on a single thread.
+  WorkStealingStacks *stacks_{nullptr};
+  size_t workerIndex_{0};
+  /// Serializes OG allocations between the threads of a parallel collection.
+  std::mutex *promotionMutex_{nullptr};
+
+  /// Cells copied by this thread whose fields have not been scanned yet. Used
+  /// instead of the copy list during parallel collections.
+  std::vector<GCCell *> copiedCells_;
+
+  /// Slots found by a DirtySlotRecorder, to be forwarded by this acceptor.
+  std::vector<GCPointerBase *> recordedPointers_;
+  std::vector<GCHermesValue *> recordedValues_;
+  std::vector<GCSmallHermesValue *> recordedSmallValues_;
+
+  /// The free part of the current promotion buffer.
+  char *bufferStart_{nullptr};
+  char *bufferLevel_{nullptr};
+  char *bufferEnd_{nullptr};
+
+  /// The range of cells promoted into each of this acceptor's promotion
+  /// buffers, which are marked in endParallel.
+  llvh::SmallVector<std::pair<GCCell *, GCCell *>, 4> promotedRanges_;
+
   void push(CopyListCell *cell) {
     cell->next_ = copyListHead_;
     copyListHead_ = CompressedPointer::encodeNonNull(cell, pointerBase_);
   }
+
+  /// Like forwardCell, but may race with other threads to forward \p cell.
+  /// Every thread copies the cell, and the one that installs its forwarding
+  /// pointer first wins. The others give back their copies.
+  template <typename T>
+  LLVM_NODISCARD T forwardCellInParallel(GCCell *const cell) {
+    KindAndSize header;
+    if (CompressedPointer forwardedCell =
+            cell->getMarkedForwardingPointerAtomic(header))
+      return convertPtr<T>(pointerBase_, forwardedCell);
+    const uint32_t cellSize = header.getSize();
+    GCCell *const newCell = allocPromoted(cellSize);
+    std::memcpy(newCell, cell, cellSize);
+    // Another thread may have forwarded the cell during the copy, so restore
+    // the header that was read before it.
+    newCell->setKindAndSize(header);
+    if (CompressedPointer forwardedCell = cell->trySetMarkedForwardingPointer(
+            header, CompressedPointer::encodeNonNull(newCell, pointerBase_))) {
+      freePromoted(newCell, cellSize);
+      return convertPtr<T>(pointerBase_, forwardedCell);
+    }
+    assert(newCell->isValid() && "Cell was copied incorrectly");
+    HeapSegment::setCellHead(newCell, cellSize);
+    evacuatedBytes_ += cellSize;
+    copiedCells_.push_back(newCell);
+    return convertPtr<T>(pointerBase_, newCell);
+  }
+
+  /// Allocate \p sz bytes in the OG for a cell promoted in parallel.
+  GCCell *allocPromoted(uint32_t sz) {
+    if (sz > kMaxBufferedCellSize) {
+      std::lock_guard<std::mutex> lk{*promotionMutex_};
+      return gc.oldGen_.allocPromotionBuffer(sz, sz, sz);
+    }
+    const size_t avail = bufferEnd_ - bufferLevel_;
+    // Never leave a gap too small to hold a FreelistCell.
+    if (sz > avail || (sz < avail && avail - sz < minAllocationSize())) {
+      std::lock_guard<std::mutex> lk{*promotionMutex_};
+      retirePromotionBuffer();
+      uint32_t bufferSize;
+      bufferStart_ = bufferLevel_ =
+          reinterpret_cast<char *>(gc.oldGen_.allocPromotionBuffer(
+              sz, kPromotionBufferSize, bufferSize));
+      bufferEnd_ = bufferStart_ + bufferSize;
+    }
+    GCCell *const cell = reinterpret_cast<GCCell *>(bufferLevel_);
+    bufferLevel_ += sz;
+    return cell;
+  }
+
+  /// Give back \p newCell, of size \p sz, after losing the race to forward a
+  /// cell. It must be the latest allocation from allocPromoted.
+  void freePromoted(GCCell *newCell, uint32_t sz) {
+    if (sz > kMaxBufferedCellSize) {
+      // Individually allocated cells are already marked. Leave a dead cell in
+      // their place, which the next OG collection will free.
+      constructCell<FillerCell>(newCell, sz);
+      return;
+    }
+    assert(
+        reinterpret_cast<char *>(newCell) + sz == bufferLevel_ &&
+        "Can only free the latest promoted cell");
+    bufferLevel_ -= sz;
+  }
+
+  /// Record the cells promoted into the current promotion buffer, and free
+  /// the rest of it.
+  /// \pre promotionMutex_ is held, or no other thread is running.
+  void retirePromotionBuffer() {
+    if (!bufferStart_)
+      return;
+    if (bufferLevel_ == bufferStart_) {
+      // The start of the buffer was marked when it was allocated, so it
+      // cannot be freed. Leave a dead cell, which the next OG collection will
+      // free.
+      constructCell<FillerCell>(bufferStart_, bufferEnd_ - bufferStart_);
+    } else {
+      promotedRanges_.emplace_back(
+          reinterpret_cast<GCCell *>(bufferStart_),
+          reinterpret_cast<GCCell *>(bufferLevel_));
+      if (bufferLevel_ != bufferEnd_)
+        gc.oldGen_.freePromotionBuffer(
+            bufferLevel_, bufferEnd_ - bufferLevel_);
+    }
+    bufferStart_ = bufferLevel_ = bufferEnd_ = nullptr;
+  }
 };
 
 class MarkWorklist {
@@ -691,11 +1137,17 @@ class MarkWorklist {
 class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
                                     public WeakRefAcceptor {
  public:
-  MarkAcceptor(HadesGC &gc)
+  /// \param numHelpers The number of additional acceptors to create for the
+  ///   other threads of a parallel marking pool. Must be called on the
+  ///   mutator, since the symbol table may not be read concurrently.
+  MarkAcceptor(HadesGC &gc, size_t numHelpers = 0)
       : gc{gc},
         pointerBase_{gc.getPointerBase()},
         markedSymbols_{gc.gcCallbacks_.getSymbolsEnd()},
-        writeBarrierMarkedSymbols_{gc.gcCallbacks_.getSymbolsEnd()} {}
+        writeBarrierMarkedSymbols_{gc.gcCallbacks_.getSymbolsEnd()} {
+    for (size_t i = 0; i < numHelpers; ++i)
+      helpers_.emplace_back(new MarkAcceptor{gc});
+  }
 
   void acceptHeap(GCCell *cell, const void *heapLoc) {
     assert(cell && "Cannot pass null pointer to acceptHeap");
@@ -815,9 +1267,32 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
     byteDrainRate_ = rate;
   }
 
-  /// \return the total number of bytes marked so far.
+  /// \return the total number of bytes marked so far, by this acceptor and
+  /// any parallel marking helpers.
   uint64_t markedBytes() const {
-    return markedBytes_;
+    uint64_t total = markedBytes_;
+    for (const auto &helper : helpers_)
+      total += helper->markedBytes_;
+    return total;
+  }
+
+  /// \return true if this acceptor has helpers for parallel marking.
+  bool hasHelpers() const {
+    return !helpers_.empty();
+  }
+
+  /// Fill \p markedBytes and \p steals with the number of bytes marked and
+  /// the number of steals performed by each marking thread. Index 0 is this
+  /// acceptor.
+  void getWorkerStats(
+      std::vector<uint64_t> &markedBytes,
+      std::vector<uint64_t> &steals) const {
+    markedBytes.assign({markedBytes_});
+    steals.assign({steals_});
+    for (const auto &helper : helpers_) {
+      markedBytes.push_back(helper->markedBytes_);
+      steals.push_back(helper->steals_);
+    }
   }
 
   /// Drain the mark stack of cells to be processed.
@@ -851,42 +1326,64 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
   /// \return true if there is any remaining work in the local worklist.
   bool drainSomeWork(const size_t markLimit) {
     assert(gc.gcMutex_ && "Must hold the GC lock while accessing mark bits.");
-    // Pull any new items off the global worklist.
-    auto cells = globalWorklist_.drain();
-    for (GCCell *cell : cells) {
-      assert(
-          cell->isValid() && "Invalid cell received off the global worklist");
-      assert(
-          !gc.inYoungGen(cell) &&
-          "Shouldn't ever traverse a YG object in this loop");
-      HERMES_SLOW_ASSERT(
-          gc.dbgContains(cell) && "Non-heap cell found in global worklist");
-      if (!HeapSegment::getCellMarkBit(cell)) {
-        // Cell has not yet been marked.
-        push(cell);
-      }
-    }
+    pullGlobalWork();
 
     size_t numMarkedBytes = 0;
     assert(markLimit && "markLimit must be non-zero!");
-    while (!localWorklist_.empty() && numMarkedBytes < markLimit) {
-      GCCell *const cell = localWorklist_.top();
-      localWorklist_.pop();
-      assert(cell->isValid() && "Invalid cell in marking");
-      assert(HeapSegment::getCellMarkBit(cell) && "Discovered unmarked object");
-      assert(
-          !gc.inYoungGen(cell) &&
-          "Shouldn't ever traverse a YG object in this loop");
-      HERMES_SLOW_ASSERT(
-          gc.dbgContains(cell) && "Non-heap object discovered during marking");
-      const auto sz = cell->getAllocatedSize();
-      numMarkedBytes += sz;
-      gc.markCell(cell, *this);
-    }
+    while (!localWorklist_.empty() && numMarkedBytes < markLimit)
+      numMarkedBytes += markNext();
     markedBytes_ += numMarkedBytes;
     return !localWorklist_.empty();
   }
 
+  /// Drain the worklist using this acceptor and its helpers, each on its own
+  /// thread of \p pool. Threads that run out of work steal from the others.
+  /// Marking stops early if the mutator asks the background thread to pause,
+  /// in which case any unfinished work is moved back to this acceptor's local
+  /// worklist.
+  /// \pre \p pool has at least one extra thread per helper.
+  /// \return true if there is any remaining work in the local worklist.
+  bool drainInParallel(WorkerPool &pool) {
+    assert(gc.gcMutex_ && "Must hold the GC lock while accessing mark bits.");
+    assert(
+        helpers_.size() < pool.numWorkers() &&
+        "Need a thread for each marking acceptor");
+    pullGlobalWork();
+
+    llvh::SmallVector<MarkAcceptor *, 8> workers{this};
+    for (auto &helper : helpers_)
+      workers.push_back(helper.get());
+    WorkStealingStacks stacks{workers.size()};
+    for (MarkAcceptor *worker : workers)
+      worker->parallel_ = &stacks;
+    pool.run([&workers](size_t idx) {
+      if (idx < workers.size())
+        workers[idx]->markInParallel(idx);
+    });
+
+    // Collect what the helpers left behind. The helpers' symbols are merged
+    // later, in markedSymbols().
+    stacks.takeRemaining(localWorklist_);
+    for (size_t i = 0, e = workers.size(); i < e; ++i) {
+      MarkAcceptor *worker = workers[i];
+      worker->parallel_ = nullptr;
+      worker->steals_ += stacks.steals(i);
+      if (worker == this)
+        continue;
+      localWorklist_.insert(
+          localWorklist_.end(),
+          worker->localWorklist_.begin(),
+          worker->localWorklist_.end());
+      worker->localWorklist_.clear();
+      reachableWeakMaps_.insert(
+          reachableWeakMaps_.end(),
+          worker->reachableWeakMaps_.begin(),
+          worker->reachableWeakMaps_.end());
+      worker->reachableWeakMaps_.clear();
+    }
+    return !localWorklist_.empty();
+  }
+
   MarkWorklist &globalWorklist() {
     return globalWorklist_;
   }
@@ -903,6 +1400,8 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
   llvh::BitVector &markedSymbols() {
     assert(gc.gcMutex_ && "Cannot call markedSymbols without a lock");
     markedSymbols_ |= writeBarrierMarkedSymbols_;
+    for (const auto &helper : helpers_)
+      markedSymbols_ |= helper->markedSymbols_;
     // No need to clear writeBarrierMarkedSymbols_, or'ing it again won't change
     // the bit vector.
     return markedSymbols_;
@@ -915,7 +1414,18 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
   /// A worklist local to the marking thread, that is only pushed onto by the
   /// marking thread. If this is empty, the global worklist must be consulted
   /// to ensure that pointers modified in write barriers are handled.
-  std::stack<GCCell *, std::vector<GCCell *>> localWorklist_;
+  std::vector<GCCell *> localWorklist_;
+
+  /// Acceptors used by the other threads during parallel marking. Only the
+  /// acceptor owned by the GC has helpers.
+  std::vector<std::unique_ptr<MarkAcceptor>> helpers_;
+
+  /// The stacks of the parallel drain in progress, or null when marking on a
+  /// single thread.
+  WorkStealingStacks *parallel_{nullptr};
+
+  /// The number of batches of cells this acceptor took from other acceptors.
+  uint64_t steals_{0};
 
   /// A worklist that other threads may add to as objects to be marked and
   /// considered alive. These objects will *not* have their mark bits set,
@@ -948,13 +1458,20 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
   uint64_t markedBytes_{0};
 
   void push(GCCell *cell) {
-    assert(
-        !HeapSegment::getCellMarkBit(cell) &&
-        "A marked object should never be pushed onto a worklist");
     assert(
         !gc.inYoungGen(cell) &&
         "Shouldn't ever push a YG object onto the worklist");
-    HeapSegment::setCellMarkBit(cell);
+    if (parallel_) {
+      // Another marking thread may have marked the cell since the caller
+      // checked its mark bit. Only the thread that sets the bit pushes it.
+      if (!HeapSegment::setCellMarkBitAtomic(cell))
+        return;
+    } else {
+      assert(
+          !HeapSegment::getCellMarkBit(cell) &&
+          "A marked object should never be pushed onto a worklist");
+      HeapSegment::setCellMarkBit(cell);
+    }
     // There could be a race here: however, the mutator will never change a
     // cell's kind after initialization. The GC thread might to a free cell, but
     // only during sweeping, not concurrently with this operation. Therefore
@@ -962,10 +1479,66 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
     if (vmisa<JSWeakMap>(cell)) {
       reachableWeakMaps_.push_back(vmcast<JSWeakMap>(cell));
     } else {
-      localWorklist_.push(cell);
+      localWorklist_.push_back(cell);
+    }
+  }
+
+  /// Move any cells added by write barriers onto the local worklist.
+  void pullGlobalWork() {
+    auto cells = globalWorklist_.drain();
+    for (GCCell *cell : cells) {
+      assert(
+          cell->isValid() && "Invalid cell received off the global worklist");
+      assert(
+          !gc.inYoungGen(cell) &&
+          "Shouldn't ever traverse a YG object in this loop");
+      HERMES_SLOW_ASSERT(
+          gc.dbgContains(cell) && "Non-heap cell found in global worklist");
+      if (!HeapSegment::getCellMarkBit(cell)) {
+        // Cell has not yet been marked.
+        push(cell);
+      }
     }
   }
 
+  /// Pop one cell off the local worklist and mark its fields.
+  /// \return the size of the cell.
+  size_t markNext() {
+    GCCell *const cell = localWorklist_.back();
+    localWorklist_.pop_back();
+    return markFields(cell);
+  }
+
+  /// Mark the fields of \p cell, which was taken off a worklist.
+  /// \return the size of the cell.
+  size_t markFields(GCCell *cell) {
+    assert(cell->isValid() && "Invalid cell in marking");
+    assert(HeapSegment::getCellMarkBit(cell) && "Discovered unmarked object");
+    assert(
+        !gc.inYoungGen(cell) &&
+        "Shouldn't ever traverse a YG object in this loop");
+    HERMES_SLOW_ASSERT(
+        gc.dbgContains(cell) && "Non-heap object discovered during marking");
+    const auto sz = cell->getAllocatedSize();
+    gc.markCell(cell, *this);
+    return sz;
+  }
+
+  /// The body of thread \p idx in drainInParallel. Marks until every thread
+  /// is out of work, or until the mutator asks the background thread to
+  /// pause.
+  void markInParallel(size_t idx) {
+    uint64_t numMarkedBytes = 0;
+    parallel_->drain(
+        idx,
+        localWorklist_,
+        [this, &numMarkedBytes](GCCell *cell) {
+          numMarkedBytes += markFields(cell);
+        },
+        [this] { return gc.ogPaused_.load(std::memory_order_relaxed); });
+    markedBytes_ += numMarkedBytes;
+  }
+
   template <typename T>
   T concurrentReadImpl(const T &valRef) {
     using Storage =
@@ -1275,6 +1848,19 @@ size_t HadesGC::OldGen::getMemorySize() const {
 // Assume about 30% of the YG will survive initially.
 constexpr double kYGInitialSurvivalRatio = 0.3;
 
+/// \return the fraction of a YG segment of \p segmentSize bytes that \p size
+/// from the GCConfig corresponds to, or \p defaultFactor if it is 0.
+static double ygSizeFactorFromConfig(
+    uint64_t size,
+    size_t segmentSize,
+    double defaultFactor) {
+  if (!size)
+    return defaultFactor;
+  return std::min(
+      std::max(static_cast<double>(size) / segmentSize, kYGSmallestSizeFactor),
+      1.0);
+}
+
 HadesGC::OldGen::OldGen(HadesGC &gc) : gc_(gc) {}
 
 HadesGC::HadesGC(
@@ -1295,9 +1881,25 @@ HadesGC::HadesGC(
           // At least one YG segment and one OG segment.
           2 * AlignedStorage::size())},
       provider_(std::move(provider)),
+      ygMinSizeFactor_{std::min(
+          ygSizeFactorFromConfig(
+              gcConfig.getMinYoungGenSize(), HeapSegment::maxSize(), 0.25),
+          ygSizeFactorFromConfig(
+              gcConfig.getMaxYoungGenSize(), HeapSegment::maxSize(), 1.0))},
+      ygMaxSizeFactor_{ygSizeFactorFromConfig(
+          gcConfig.getMaxYoungGenSize(), HeapSegment::maxSize(), 1.0)},
       oldGen_{*this},
       backgroundExecutor_{
           kConcurrentGC ? std::make_unique<Executor>() : nullptr},
+      markingThreads_{
+          kConcurrentGC ? std::max(gcConfig.getMarkingThreads(), 1u) : 1},
+      evacuationThreads_{
+          kConcurrentGC ? std::max(gcConfig.getEvacuationThreads(), 1u) : 1},
+      workerPool_{
+          std::max(markingThreads_, evacuationThreads_) > 1
+              ? std::make_unique<WorkerPool>(
+                    std::max(markingThreads_, evacuationThreads_) - 1)
+              : nullptr},
       promoteYGToOG_{!gcConfig.getAllocInYoung()},
       revertToYGAtTTI_{gcConfig.getRevertToYGAtTTI()},
       overwriteDeadYGObjects_{gcConfig.getOverwriteDeadYGObjects()},
@@ -1305,8 +1907,11 @@ HadesGC::HadesGC(
       ygAverageSurvivalBytes_{
           /*weight*/ 0.5,
           /*init*/ kYGInitialSizeFactor * HeapSegment::maxSize() *
-              kYGInitialSurvivalRatio} {
+              kYGInitialSurvivalRatio},
+      ygAverageSurvivalRatio_{/*weight*/ 0.5, kYGInitialSurvivalRatio} {
   (void)vmExperimentFlags;
+  ygSizeFactor_ = std::min(
+      std::max(ygSizeFactor_, ygMinSizeFactor_), ygMaxSizeFactor_);
   std::lock_guard<Mutex> lk(gcMutex_);
   crashMgr_->setCustomData("HermesGC", getKindAsStr().c_str());
   // createSegment relies on member variables and should not be called until
@@ -1460,6 +2065,14 @@ void HadesGC::printStats(JSONEmitter &json) {
   json.emitKey("stats");
   json.openDict();
   json.emitKeyValue("Num compactions", numCompactions_);
+  json.emitKeyValue(
+      "Young gen size",
+      static_cast<uint64_t>(
+          std::lround(ygSizeFactor_ * HeapSegment::maxSize())));
+  json.emitKeyValue(
+      "Young gen survival ratio", static_cast<double>(ygAverageSurvivalRatio_));
+  json.emitKey("Young gen pause histogram");
+  printPauseHistogram(json, ygCumulativeStats_);
   json.closeDict();
   json.closeDict();
 }
@@ -1573,7 +2186,7 @@ void HadesGC::oldGenCollection(std::string cause, bool forceCompaction) {
   // This assignment will reset any leftover memory from the last collection. We
   // leave the last marker alive to avoid a race condition with setting
   // concurrentPhase_, oldGenMarker_ and the write barrier.
-  oldGenMarker_.reset(new MarkAcceptor{*this});
+  oldGenMarker_.reset(new MarkAcceptor{*this, markingThreads_ - 1});
   {
     // Roots are marked before a marking thread is spun up, so that the root
     // marking is atomic.
@@ -1682,8 +2295,11 @@ void HadesGC::incrementalCollect(bool backgroundThread) {
       if (!kConcurrentGC && ygCollectionStats_)
         ygCollectionStats_->addCollectionType("marking");
       // Drain some work from the mark worklist. If the work has finished
-      // completely, move on to CompleteMarking.
-      if (!oldGenMarker_->drainSomeWork())
+      // completely, move on to CompleteMarking. Parallel marking runs until
+      // the worklist is empty or the mutator asks for the lock.
+      if (!(oldGenMarker_->hasHelpers()
+                ? oldGenMarker_->drainInParallel(*workerPool_)
+                : oldGenMarker_->drainSomeWork()))
         concurrentPhase_ = Phase::CompleteMarking;
       break;
     case Phase::CompleteMarking:
@@ -1848,7 +2464,13 @@ void HadesGC::completeMarking() {
     gcCallbacks_.markRootsForCompleteMarking(nameAcceptor);
   }
   // Drain the marking queue.
-  oldGenMarker_->drainAllWork();
+  if (oldGenMarker_->hasHelpers()) {
+    bool workLeft = oldGenMarker_->drainInParallel(*workerPool_);
+    assert(!workLeft && "Parallel marking stopped early in a STW pause");
+    (void)workLeft;
+  } else {
+    oldGenMarker_->drainAllWork();
+  }
   assert(
       oldGenMarker_->globalWorklist().empty() &&
       "Marking worklist wasn't drained");
@@ -1867,6 +2489,12 @@ void HadesGC::completeMarking() {
 
   // Now free symbols and weak refs.
   gcCallbacks_.freeSymbols(oldGenMarker_->markedSymbols());
+  if (oldGenMarker_->hasHelpers()) {
+    std::vector<uint64_t> markedBytes, steals;
+    oldGenMarker_->getWorkerStats(markedBytes, steals);
+    ogCollectionStats_->setMarkingWorkerStats(
+        std::move(markedBytes), std::move(steals));
+  }
   // NOTE: If sweeping is done concurrently with YG collection, weak references
   // could be handled during the sweep pass instead of the mark pass. The read
   // barrier will need to be updated to handle the case where a WeakRef points
@@ -2214,12 +2842,41 @@ void *HadesGC::allocLongLived(uint32_t sz) {
 }
 
 GCCell *HadesGC::OldGen::alloc(uint32_t sz) {
+  assert(gc_.gcMutex_ && "gcMutex_ must be held before calling oldGenAlloc");
+  return allocImpl(sz);
+}
+
+GCCell *HadesGC::OldGen::allocPromotionBuffer(
+    uint32_t minSize,
+    uint32_t maxSize,
+    uint32_t &size) {
+  assert(minSize <= maxSize && "Invalid promotion buffer size");
+  if (GCCell *cell = search(maxSize)) {
+    size = maxSize;
+    return cell;
+  }
+  size = minSize;
+  return allocImpl(minSize);
+}
+
+void HadesGC::OldGen::freePromotionBuffer(char *addr, uint32_t sz) {
+  assert(sz >= minAllocationSize() && "Freeing too small of a block");
+  for (size_t i = 0, e = segments_.size(); i < e; ++i) {
+    if (segments_[i].contains(addr)) {
+      addCellToFreelist(addr, sz, &segmentBuckets_[i][getFreelistBucket(sz)]);
+      incrementAllocatedBytes(-static_cast<int32_t>(sz));
+      return;
+    }
+  }
+  llvm_unreachable("Promotion buffer is not in the old gen");
+}
+
+GCCell *HadesGC::OldGen::allocImpl(uint32_t sz) {
   assert(
       isSizeHeapAligned(sz) &&
       "Should be aligned before entering this function");
   assert(sz >= minAllocationSize() && "Allocating too small of an object");
   assert(sz <= maxAllocationSize() && "Allocating too large of an object");
-  assert(gc_.gcMutex_ && "gcMutex_ must be held before calling oldGenAlloc");
   if (GCCell *cell = search(sz)) {
     return cell;
   }
@@ -2368,11 +3025,19 @@ GCCell *HadesGC::OldGen::search(uint32_t sz) {
   return nullptr;
 }
 
-template <typename Acceptor>
-void HadesGC::youngGenEvacuateImpl(Acceptor &acceptor, bool doCompaction) {
+template <bool CompactionEnabled>
+void HadesGC::youngGenEvacuateImpl(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    bool doCompaction) {
+#ifndef HERMESVM_EXCEPTION_ON_OOM
+  // Moves can't be reported to the ID tracker from several threads at once.
+  // An OOM exception couldn't be propagated from a helper thread either.
+  if (evacuationThreads_ > 1 && !isTrackingIDs())
+    return youngGenEvacuateInParallel(acceptor, doCompaction);
+#endif
   // Marking each object puts it onto an embedded free list.
   {
-    DroppingAcceptor<Acceptor> nameAcceptor{acceptor};
+    DroppingAcceptor<EvacAcceptor<CompactionEnabled>> nameAcceptor{acceptor};
     markRoots(nameAcceptor, /*markLongLived*/ doCompaction);
   }
   // Find old-to-young pointers, as they are considered roots for YG
@@ -2397,6 +3062,49 @@ void HadesGC::youngGenEvacuateImpl(Acceptor &acceptor, bool doCompaction) {
   markWeakRoots(acceptor, /*markLongLived*/ doCompaction);
 }
 
+template <bool CompactionEnabled>
+void HadesGC::youngGenEvacuateInParallel(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    bool doCompaction) {
+  assert(
+      workerPool_ && workerPool_->numWorkers() >= evacuationThreads_ &&
+      "Not enough threads for parallel evacuation");
+  std::vector<std::unique_ptr<EvacAcceptor<CompactionEnabled>>> helpers;
+  llvh::SmallVector<EvacAcceptor<CompactionEnabled> *, 8> acceptors{
+      &acceptor};
+  for (size_t i = 1; i < evacuationThreads_; ++i) {
+    helpers.emplace_back(new EvacAcceptor<CompactionEnabled>{*this});
+    acceptors.push_back(helpers.back().get());
+  }
+  WorkStealingStacks stacks{acceptors.size()};
+  std::mutex promotionMutex;
+  for (size_t i = 0, e = acceptors.size(); i < e; ++i)
+    acceptors[i]->beginParallel(stacks, i, promotionMutex);
+
+  // Find old-to-young pointers before anything is promoted, so that the OG can
+  // be scanned by several threads without racing with promotions into it.
+  scanDirtyCardsInParallel<CompactionEnabled>(acceptors);
+  // Roots are forwarded on this thread alone, since the root acceptors aren't
+  // thread-safe. The cells they copy are shared out by the stacks.
+  {
+    DroppingAcceptor<EvacAcceptor<CompactionEnabled>> nameAcceptor{acceptor};
+    markRoots(nameAcceptor, /*markLongLived*/ doCompaction);
+  }
+  workerPool_->run([&acceptors](size_t idx) {
+    if (idx < acceptors.size())
+      acceptors[idx]->evacuateInParallel();
+  });
+  for (auto *evac : acceptors) {
+    evac->endParallel();
+    if (evac != &acceptor)
+      acceptor.addEvacuatedBytes(evac->evacuatedBytes());
+  }
+
+  // Mark weak roots. We only need to update the long lived weak roots if we are
+  // evacuating part of the OG.
+  markWeakRoots(acceptor, /*markLongLived*/ doCompaction);
+}
+
 void HadesGC::youngGenCollection(
     std::string cause,
     bool forceOldGenCollection) {
@@ -2505,12 +3213,18 @@ void HadesGC::youngGenCollection(
     // Move external memory accounting from YG to OG as well.
     transferExternalMemoryToOldGen();
 
-    // Potentially resize the YG if this collection did not meet our pause time
-    // goals. Exclude compacting collections and the portion of YG time spent on
-    // incremental OG collections, since they distort pause times and are
-    // unaffected by YG size.
-    if (!doCompaction)
+    // Potentially resize the YG based on how much of it survived and whether
+    // this collection met our pause time goals. Exclude compacting collections
+    // and the portion of YG time spent on incremental OG collections, since
+    // they distort pause times and are unaffected by YG size.
+    if (!doCompaction) {
+      // An empty YG (e.g. back-to-back collections) says nothing about the
+      // survival rate.
+      if (heapBytes.before)
+        ygAverageSurvivalRatio_.update(
+            static_cast<double>(heapBytes.after) / heapBytes.before);
       updateYoungGenSizeFactor();
+    }
 
     // The effective end of our YG is no longer accurate for multiple reasons:
     // 1. transferExternalMemoryToOldGen resets the effectiveEnd to be the end.
@@ -2663,22 +3377,30 @@ void HadesGC::transferExternalMemoryToOldGen() {
 
 void HadesGC::updateYoungGenSizeFactor() {
   assert(
-      ygSizeFactor_ <= 1.0 && ygSizeFactor_ >= 0.25 && "YG size out of range.");
+      ygSizeFactor_ <= ygMaxSizeFactor_ && ygSizeFactor_ >= ygMinSizeFactor_ &&
+      "YG size out of range.");
   const auto ygDuration = ygCollectionStats_->getElapsedTime().count();
-  // If the YG collection has taken less than 20% of our budgeted time, increase
-  // the size of the YG by 10%.
-  if (ygDuration < kTargetMaxPauseMs * 0.2)
-    ygSizeFactor_ = std::min(ygSizeFactor_ * 1.1, 1.0);
+  const double survivalRatio = ygAverageSurvivalRatio_;
   // If the YG collection has taken more than 40% of our budgeted time, decrease
   // the size of the YG by 10%. This is meant to leave some time for OG work.
-  // However, don't let the YG size drop below 25% of the segment size.
-  else if (ygDuration > kTargetMaxPauseMs * 0.4)
-    ygSizeFactor_ = std::max(ygSizeFactor_ * 0.9, 0.25);
-}
-
-template <bool CompactionEnabled>
+  // Do the same if most of the YG survives, since a larger YG would then mostly
+  // mean copying more per collection. However, don't let the YG size drop below
+  // the configured minimum.
+  if (ygDuration > kTargetMaxPauseMs * 0.4 ||
+      survivalRatio > kYGHighSurvivalRatio)
+    ygSizeFactor_ = std::max(ygSizeFactor_ * 0.9, ygMinSizeFactor_);
+  // If the YG collection has taken less than 20% of our budgeted time and
+  // little of the YG survives, increase the size of the YG by 10%, up to the
+  // configured maximum.
+  else if (
+      ygDuration < kTargetMaxPauseMs * 0.2 &&
+      survivalRatio < kYGLowSurvivalRatio)
+    ygSizeFactor_ = std::min(ygSizeFactor_ * 1.1, ygMaxSizeFactor_);
+}
+
+template <bool CompactionEnabled, typename Acceptor>
 void HadesGC::scanDirtyCardsForSegment(
-    SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
+    SlotVisitor<Acceptor> &visitor,
     HeapSegment &seg) {
   const auto &cardTable = seg.cardTable();
   // Use level instead of end in case the OG segment is still in bump alloc
@@ -2772,7 +3494,7 @@ void HadesGC::scanDirtyCards(EvacAcceptor<CompactionEnabled> &acceptor) {
     // It is safe to hold this reference across a push_back into
     // oldGen_.segments_ since references into a deque are not invalidated.
     HeapSegment &seg = oldGen_[i];
-    scanDirtyCardsForSegment(visitor, seg);
+    scanDirtyCardsForSegment<CompactionEnabled>(visitor, seg);
     // Do not clear the card table if the OG thread is currently marking to
     // prepare for a compaction. Note that we should clear the card tables if
     // the compaction is currently ongoing.
@@ -2783,7 +3505,34 @@ void HadesGC::scanDirtyCards(EvacAcceptor<CompactionEnabled> &acceptor) {
   // No need to search dirty cards in the compactee segment if it is
   // currently being evacuated, since it will be scanned fully.
   if (preparingCompaction)
-    scanDirtyCardsForSegment(visitor, *compactee_.segment);
+    scanDirtyCardsForSegment<CompactionEnabled>(visitor, *compactee_.segment);
+}
+
+template <bool CompactionEnabled>
+void HadesGC::scanDirtyCardsInParallel(
+    llvh::ArrayRef<EvacAcceptor<CompactionEnabled> *> acceptors) {
+  using Recorder = typename EvacAcceptor<CompactionEnabled>::DirtySlotRecorder;
+  const bool preparingCompaction =
+      CompactionEnabled && !compactee_.evacActive();
+  // Hand out segments one at a time. When preparing a compaction, the
+  // compactee is scanned as one extra segment, just after the OG.
+  const size_t segEnd = oldGen_.numSegments();
+  const size_t numSegs = segEnd + preparingCompaction;
+  std::atomic<size_t> nextSeg{0};
+  workerPool_->run([&](size_t idx) {
+    if (idx >= acceptors.size())
+      return;
+    Recorder recorder{*acceptors[idx]};
+    SlotVisitor<Recorder> visitor{recorder};
+    size_t i;
+    while ((i = nextSeg.fetch_add(1, std::memory_order_relaxed)) < numSegs) {
+      HeapSegment &seg = i < segEnd ? oldGen_[i] : *compactee_.segment;
+      scanDirtyCardsForSegment<CompactionEnabled>(visitor, seg);
+      // See scanDirtyCards for when the card tables can be cleared.
+      if (!preparingCompaction)
+        seg.cardTable().clear();
+    }
+  });
 }
 
 void HadesGC::finalizeYoungGenObjects() {
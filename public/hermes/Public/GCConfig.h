@@ -93,6 +93,15 @@ struct GCAnalyticsEvent {
 
   /// A list of metadata tags to annotate this event with.
   std::vector<std::string> tags;
+
+  /// The number of bytes marked by each thread that took part in marking,
+  /// indexed by worker. Empty if the collection did not mark in parallel.
+  std::vector<uint64_t> markedBytesPerWorker{};
+
+  /// The number of times each marking thread took work from another thread's
+  /// mark stack, indexed by worker. Empty if the collection did not mark in
+  /// parallel.
+  std::vector<uint64_t> stealsPerWorker{};
 };
 
 /// Parameters to control a tripwire function called when the live set size
@@ -190,6 +199,25 @@ enum class GCEventKind {
   /* Whether to use mprotect on GC metadata between GCs. */              \
   F(constexpr, bool, ProtectMetadata, false)                             \
                                                                          \
+  /* Number of threads, including the background collector thread, */   \
+  /* that mark the old generation. Values above 1 enable parallel */     \
+  /* marking in Hades when concurrent GC is available. */                \
+  F(constexpr, unsigned, MarkingThreads, 1)                              \
+                                                                         \
+  /* Number of threads, including the mutator, that evacuate */          \
+  /* the young generation. Values above 1 enable parallel */             \
+  /* evacuation in Hades when concurrent GC is available. */             \
+  F(constexpr, unsigned, EvacuationThreads, 1)                           \
+                                                                         \
+  /* Lower bound on the part of the young generation segment that is */ \
+  /* filled between collections. 0 selects a quarter of the segment. */  \
+  F(constexpr, gcheapsize_t, MinYoungGenSize, 0)                         \
+                                                                         \
+  /* Upper bound on the part of the young generation segment that is */ \
+  /* filled between collections, which also caps the resident memory */  \
+  /* the young generation can grow to. 0 selects the whole segment. */   \
+  F(constexpr, gcheapsize_t, MaxYoungGenSize, 0)                         \
+                                                                         \
   /* Callout for an analytics event. */                                  \
   F(HERMES_NON_CONSTEXPR,                                                \
     std::function<void(const GCAnalyticsEvent &)>,                       \
@@ -96,6 +96,15 @@ class PinnedHermesValue;
   /* all bytecode buffers > 64 kB passed to Hermes must be mmap:ed. */ \
   F(constexpr, bool, TrackIO, false)                                   \
                                                                        \
+  /* Share bytecode loaded through the API with the other runtimes  */ \
+  /* in the process that load identical bytecode, instead of each   */ \
+  /* runtime keeping its own copy. */                                  \
+  F(constexpr, bool, ShareBytecode, false)                             \
+                                                                       \
+  /* Number of compiled patterns the RegExp constructor keeps for   */ \
+  /* reuse. 0 disables the cache. */                                   \
+  F(constexpr, unsigned, RegExpCacheSize, 64)                          \
+                                                                       \
   /* Enable contents of HermesInternal */                              \
   F(constexpr, bool, EnableHermesInternal, true)                       \
                                                                        \
@@ -111,6 +120,12 @@ class PinnedHermesValue;
   /* Choose whether generators are enabled. */                         \
   F(constexpr, bool, EnableGenerator, true)                            \
                                                                        \
+  /* Compile hot functions to native code, where supported. */         \
+  F(constexpr, bool, EnableJIT, false)                                 \
+                                                                       \
+  /* Number of calls after which a function is compiled by the JIT. */  \
+  F(constexpr, uint32_t, JITThreshold, 1000)                           \
+                                                                       \
   /* An interface for managing crashes. */                             \
   F(HERMES_NON_CONSTEXPR,                                              \
     std::shared_ptr<CrashManager>,                                     \
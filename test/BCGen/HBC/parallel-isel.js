@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generating bytecode on several threads must not change it.
+// RUN: %hermesc -O -dump-bytecode %s > %t.serial
+// RUN: %hermesc -O -j4 -dump-bytecode %s | diff %t.serial -
+// RUN: %hermesc -O0 -g -dump-bytecode %s > %t.serial-g
+// RUN: %hermesc -O0 -g -j4 -dump-bytecode %s | diff %t.serial-g -
+// RUN: %hermesc -O -emit-binary -out %t.serial.hbc %s
+// RUN: %hermesc -O -j4 -emit-binary -out %t.parallel.hbc %s
+// RUN: cmp %t.serial.hbc %t.parallel.hbc
+
+var glob = 'global';
+
+function regexps(s) {
+  return /a+b/.test(s) || /(c|d)*/g.exec(s);
+}
+
+function bigints() {
+  return 12345678901234567890n + 98765432109876543210n;
+}
+
+function outer(x) {
+  var y = x + 1;
+  function middle(z) {
+    function inner() {
+      return x + y + z + glob;
+    }
+    return inner;
+  }
+  return middle;
+}
+
+function literals() {
+  return [{a: 1, b: 'two'}, [3, 4, 5], 'six', /seven/];
+}
+
+function loops(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) {
+    switch (i % 4) {
+      case 0:
+        sum += i;
+        break;
+      case 1:
+        sum -= i;
+        break;
+      case 2:
+        sum *= 2;
+        break;
+      default:
+        sum = sum.toString().length;
+    }
+  }
+  return sum;
+}
+
+function exceptions(f) {
+  try {
+    return f();
+  } catch (e) {
+    return e.message;
+  } finally {
+    print('done');
+  }
+}
+
+print(regexps('aab'), bigints(), outer(1)(2)(), literals(), loops(10));
+print(exceptions(function() { throw new Error('err'); }));
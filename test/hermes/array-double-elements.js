@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Arrays that only hold numbers keep them as raw doubles. Check that
+// reads, writes, holes and the switch to generic elements behave normally.
+
+// Literal arrays of numbers.
+var a = [1.5, 2.25, -0, NaN, 3];
+print(a.length, a[0], a[1], 1 / a[2], a[3], a[4]);
+// CHECK: 5 1.5 2.25 -Infinity NaN 3
+a[1] = 0.125;
+print(a.join());
+// CHECK-NEXT: 1.5,0.125,0,NaN,3
+
+// Storing a non-number switches to generic elements.
+a[2] = "s";
+a.push({});
+print(a.length, a[0], a[2], typeof a[5]);
+// CHECK-NEXT: 6 1.5 s object
+
+// Holes and lengths.
+var h = new Array(5);
+h[1] = 1.5;
+h[3] = 2.5;
+print(h.length, 0 in h, 1 in h, h[1], h[3], h[4]);
+// CHECK-NEXT: 5 false true 1.5 2.5 undefined
+delete h[1];
+print(1 in h, h.indexOf(2.5));
+// CHECK-NEXT: false 3
+h.length = 2;
+print(h.length, h[3]);
+// CHECK-NEXT: 2 undefined
+h.length = 4;
+print(h.length, 3 in h);
+// CHECK-NEXT: 4 false
+
+// Growth to the left and right, and far indexes.
+var g = [];
+g[3] = 0.5;
+g[0] = 1.5;
+g[10] = 2.5;
+print(g.length, g[0], g[3], g[10], 5 in g);
+// CHECK-NEXT: 11 1.5 0.5 2.5 false
+g[100000000] = 3.5;
+print(g.length, g[100000000], g[3]);
+// CHECK-NEXT: 100000001 3.5 0.5
+
+// Sort, reverse, map and concat.
+var s = [3.5, -1.25, 2, NaN, 0.5];
+s.sort();
+print(s.join());
+// CHECK-NEXT: -1.25,0.5,2,3.5,NaN
+var n = [3.5, -1.25, 2, 0.5];
+n.sort(function (x, y) { return x - y; });
+print(n.join());
+// CHECK-NEXT: -1.25,0.5,2,3.5
+print(s.reverse().join());
+// CHECK-NEXT: NaN,3.5,2,0.5,-1.25
+print([1.5, 2.5].map(function (x) { return x * 2; }).join());
+// CHECK-NEXT: 3,5
+print([1.5, 2.5].map(function (x) { return "v" + x; }).join());
+// CHECK-NEXT: v1.5,v2.5
+print([0.5].concat([1.5, 2.5], 3).join());
+// CHECK-NEXT: 0.5,1.5,2.5,3
+
+// Frozen and sealed arrays.
+var f = Object.freeze([1.5, 2.5]);
+f[0] = 9;
+print(f[0], Object.isFrozen(f));
+// CHECK-NEXT: 1.5 true
+var se = Object.seal([1.5]);
+se[0] = 4.5;
+se[1] = 5.5;
+print(se.length, se[0]);
+// CHECK-NEXT: 1 4.5
+
+// JSON.
+print(JSON.stringify([1.5, -0, NaN, 2]));
+// CHECK-NEXT: [1.5,0,null,2]
+print(JSON.stringify(new Array(2)));
+// CHECK-NEXT: [null,null]
+var j = JSON.parse("[1.5,2.5]");
+j[0] = 0.25;
+print(j.join());
+// CHECK-NEXT: 0.25,2.5
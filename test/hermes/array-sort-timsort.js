@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array.prototype.sort and TypedArray.prototype.sort, on inputs that take
+// the direct paths for numbers, strings and typed arrays and on ones that
+// do not.
+
+print('sort');
+// CHECK-LABEL: sort
+
+// The default comparison orders numbers by their strings.
+print([10, 9, 1, -1, 0.5, -0, 1e21, 100, NaN, Infinity, 2].sort());
+// CHECK-NEXT: -1,0,0.5,1,10,100,1e+21,2,9,Infinity,NaN
+print(['b', 'a', 'ab', '', 'B', 'é', 'aa'].sort());
+// CHECK-NEXT: ,B,a,aa,ab,b,é
+
+// Mixed elements, holes and undefined take the generic path.
+var mixed = [3, 'b', undefined, , 1, 'a', null];
+mixed.sort();
+print(mixed.length, mixed, 3 in mixed, 6 in mixed);
+// CHECK-NEXT: 7 1,3,a,b,,, true false
+
+// Sorting is stable.
+var recs = [];
+for (var i = 0; i < 100; ++i) recs.push({k: i % 7, i: i});
+recs.sort(function(a, b) { return a.k - b.k; });
+var stable = true;
+for (var i = 1; i < recs.length; ++i) {
+  if (recs[i - 1].k > recs[i].k ||
+      (recs[i - 1].k === recs[i].k && recs[i - 1].i > recs[i].i))
+    stable = false;
+}
+print(stable);
+// CHECK-NEXT: true
+
+// Mostly sorted input, with runs in both directions.
+var runs = [];
+for (var i = 0; i < 1000; ++i) runs.push(i);
+for (var i = 2000; i > 1000; --i) runs.push(i);
+runs.push(500.5, -1);
+var calls = 0;
+runs.sort(function(a, b) { ++calls; return a - b; });
+var ok = true;
+for (var i = 1; i < runs.length; ++i) ok = ok && runs[i - 1] <= runs[i];
+print(ok, runs.length, runs[0], runs[501], calls < 2200);
+// CHECK-NEXT: true 2002 -1 500 true
+
+// A comparator that throws leaves the array unchanged.
+var arr = [5, 1, 4, 2, 3];
+try {
+  arr.sort(function(a, b) {
+    if (a === 2 || b === 2) throw new Error('cmp');
+    return a - b;
+  });
+} catch (e) {
+  print(e.message, arr);
+}
+// CHECK-NEXT: cmp 5,1,4,2,3
+
+// Frozen arrays cannot be sorted in place.
+try {
+  Object.freeze([2, 1]).sort();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+// Array-likes.
+var obj = {length: 3, 0: 'c', 1: 'a', 2: 'b'};
+Array.prototype.sort.call(obj);
+print(obj[0], obj[1], obj[2]);
+// CHECK-NEXT: a b c
+
+// TypedArrays sort numerically, with -0 before +0 and NaN last.
+var f = new Float64Array([3, NaN, -0, 0, -Infinity, 1.5, NaN, -2]);
+f.sort();
+print(Array.prototype.map.call(f, function(x) {
+  return Object.is(x, -0) ? '-0' : String(x);
+}).join());
+// CHECK-NEXT: -Infinity,-2,-0,0,1.5,3,NaN,NaN
+print(new Int8Array([5, -3, 127, -128, 0]).sort());
+// CHECK-NEXT: -128,-3,0,5,127
+print(new Uint32Array([4000000000, 2, 10]).sort());
+// CHECK-NEXT: 2,10,4000000000
+print(new BigInt64Array([5n, -3n, 0n]).sort());
+// CHECK-NEXT: -3,0,5
+print(new Float32Array([2, 10, 1]).sort(function(a, b) { return b - a; }));
+// CHECK-NEXT: 10,2,1
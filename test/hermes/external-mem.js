@@ -67,7 +67,7 @@ s = null;
 
 // Larger than max heap fails.
 try {
-    s = strOfSize(6000000);
+    s = strOfSize(12000000);
     print('no exception');
 } catch (x) {
     print(x)
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -gc-evacuation-threads=4 -gc-init-heap=4M %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-evacuation-threads=2 -gc-marking-threads=3 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-evacuation-threads=4 -gc-print-stats %s 2>&1 >/dev/null | %FileCheck --check-prefix=STATS %s
+
+print('parallel evacuation');
+// CHECK-LABEL: parallel evacuation
+
+// Old objects that keep pointing at young ones, so that every young
+// collection has dirty cards to scan.
+var holders = [];
+for (var i = 0; i < 64; ++i) holders.push({slot: null, values: []});
+gc();
+
+function makeList(n, tag) {
+  var head = null;
+  for (var i = 0; i < n; ++i) head = {value: i, tag: tag, next: head};
+  return head;
+}
+
+function sumList(head) {
+  var sum = 0;
+  for (; head; head = head.next) sum += head.value;
+  return sum;
+}
+
+// Objects reachable from many places at once, so that several threads race
+// to copy them.
+var shared = [];
+for (var round = 0; round < 200; ++round) {
+  var obj = {round: round, list: makeList(50, 's' + round)};
+  for (var j = 0; j < holders.length; ++j) {
+    holders[j].slot = obj;
+    if (round % 20 === 0) holders[j].values.push(obj);
+  }
+  shared.push(obj);
+  // Large arrays are promoted outside of the per-thread buffers.
+  if (round % 10 === 0) shared.push(new Array(5000).fill(round));
+  // Garbage to trigger young collections.
+  for (var k = 0; k < 100; ++k) makeList(10, 'garbage');
+}
+
+var total = 0;
+for (var i = 0; i < shared.length; ++i) {
+  if (Array.isArray(shared[i])) total += shared[i][4999];
+  else total += sumList(shared[i].list) + shared[i].round;
+}
+print(total);
+// CHECK-NEXT: 266800
+
+var consistent = true;
+for (var j = 0; j < holders.length; ++j) {
+  if (holders[j].slot !== shared[shared.length - 1] ||
+      holders[j].values.length !== 10 ||
+      holders[j].values[3] !== holders[0].values[3])
+    consistent = false;
+}
+print(consistent);
+// CHECK-NEXT: true
+
+// Weak references to young objects must be updated or cleared.
+var keys = [];
+var map = new WeakMap();
+for (var i = 0; i < 1000; ++i) {
+  var key = {i: i};
+  if (i % 2 === 0) keys.push(key);
+  map.set(key, makeList(3, 'w'));
+}
+for (var k = 0; k < 200; ++k) makeList(10, 'garbage');
+gc();
+var found = 0;
+for (var i = 0; i < keys.length; ++i)
+  if (sumList(map.get(keys[i])) === 3) ++found;
+print(found);
+// CHECK-NEXT: 500
+
+// STATS: "gcPauseHistogram": {
+// STATS: "Young gen pause histogram": {
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -gc-marking-threads=4 -gc-init-heap=4M %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-marking-threads=2 -gc-alloc-young=false %s | %FileCheck --match-full-lines %s
+
+print('parallel marking');
+// CHECK-LABEL: parallel marking
+
+// A wide tree gives the marking threads plenty of work to share.
+function makeTree(depth) {
+  if (depth === 0) return {leaf: 'v' + depth, sym: Symbol('leaf')};
+  var node = {children: []};
+  for (var i = 0; i < 4; ++i) node.children.push(makeTree(depth - 1));
+  return node;
+}
+
+function countLeaves(node) {
+  if (!node.children) return typeof node.sym === 'symbol' ? 1 : 0;
+  var sum = 0;
+  for (var i = 0; i < node.children.length; ++i)
+    sum += countLeaves(node.children[i]);
+  return sum;
+}
+
+// A long list is a single chain, so only one thread can make progress on it.
+function makeList(n) {
+  var head = null;
+  for (var i = 0; i < n; ++i) head = {value: i, next: head};
+  return head;
+}
+
+function sumList(head) {
+  var sum = 0;
+  for (; head; head = head.next) sum += head.value;
+  return sum;
+}
+
+var tree = makeTree(7);
+var list = makeList(20000);
+var keys = [];
+var map = new WeakMap();
+for (var i = 0; i < 1000; ++i) {
+  var key = {i: i};
+  keys.push(key);
+  map.set(key, {value: makeList(3)});
+}
+
+// Churn the heap so that collections start while the mutator is running.
+var garbage;
+for (var round = 0; round < 20; ++round) {
+  garbage = [];
+  for (var i = 0; i < 5000; ++i) garbage.push({a: i, b: [i, i + 1]});
+}
+gc();
+gc();
+
+print(countLeaves(tree), sumList(list));
+// CHECK-NEXT: 16384 199990000
+
+var found = 0;
+for (var i = 0; i < keys.length; ++i)
+  if (sumList(map.get(keys[i]).value) === 3) ++found;
+print(found);
+// CHECK-NEXT: 1000
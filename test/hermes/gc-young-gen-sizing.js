@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-min-young-gen-size=512K -gc-max-young-gen-size=1M %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-min-young-gen-size=1M -gc-max-young-gen-size=1M -gc-print-stats %s 2>&1 >/dev/null | %FileCheck --check-prefix=FIXED %s
+
+print('young gen sizing');
+// CHECK-LABEL: young gen sizing
+
+function makeList(n) {
+  var head = null;
+  for (var i = 0; i < n; ++i) head = {value: i, next: head};
+  return head;
+}
+
+function sumList(head) {
+  var sum = 0;
+  for (; head; head = head.next) sum += head.value;
+  return sum;
+}
+
+// Almost nothing survives, which lets the young gen grow.
+var total = 0;
+for (var round = 0; round < 2000; ++round)
+  total += sumList(makeList(100));
+print(total);
+// CHECK-NEXT: 9900000
+
+// Then almost everything survives, which makes it shrink again.
+var kept = [];
+for (var round = 0; round < 200; ++round) kept.push(makeList(100));
+total = 0;
+for (var i = 0; i < kept.length; ++i) total += sumList(kept[i]);
+print(total);
+// CHECK-NEXT: 990000
+
+// FIXED: "Young gen size": 1048576,
+// FIXED: "Young gen survival ratio":
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -Xjit -Xjit-threshold=0 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xjit -Xjit-threshold=3 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('jit');
+// CHECK-LABEL: jit
+
+function sumTo(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) sum += i * 0.5;
+  return sum;
+}
+for (var i = 0; i < 5; ++i) sumTo(10);
+print(sumTo(1000));
+// CHECK-NEXT: 249750
+
+function arith(a, b) {
+  return [a + b, a - b, a * b, a / b, a % b, a & b, a | b, a << 2, -a];
+}
+print(arith(7, 2).join());
+// CHECK-NEXT: 9,5,14,3.5,1,2,7,28,-7
+print(arith('7', 2).join());
+// CHECK-NEXT: 72,5,14,3.5,1,2,7,28,-7
+
+function compare(a, b) {
+  var res = '';
+  res += a < b ? 'T' : 'F';
+  res += a <= b ? 'T' : 'F';
+  res += a > b ? 'T' : 'F';
+  res += a >= b ? 'T' : 'F';
+  if (!(a < b)) res += 'n';
+  if (!(a >= b)) res += 'N';
+  return res;
+}
+print(compare(1, 2), compare(2, 2), compare(NaN, 1), compare('b', 'a'));
+// CHECK-NEXT: TTFFN FTFTn FFFFnN FFTTn
+
+function truthy(x) {
+  if (x) return 'yes';
+  return 'no';
+}
+print(truthy(true), truthy(false), truthy(0), truthy('s'), truthy({}));
+// CHECK-NEXT: yes no no yes yes
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+function dist2(p) {
+  return p.x * p.x + p.y * p.y;
+}
+var total = 0;
+for (var i = 0; i < 100; ++i) total += dist2(new Point(i, 1));
+print(total);
+// CHECK-NEXT: 328450
+
+function makeCounter() {
+  var count = 0;
+  return function () {
+    return ++count;
+  };
+}
+var counter = makeCounter();
+counter();
+counter();
+print(counter());
+// CHECK-NEXT: 3
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+print(fib(20));
+// CHECK-NEXT: 6765
+
+function callsNative(arr) {
+  var s = 0;
+  for (var i = 0; i < arr.length; ++i) s += Math.max(arr[i], 2);
+  return s;
+}
+print(callsNative([1, 2, 3, 4]));
+// CHECK-NEXT: 11
+
+var obj = {
+  get value() {
+    return 42;
+  },
+};
+function readGetter(o) {
+  return o.value + 1;
+}
+print(readGetter(obj));
+// CHECK-NEXT: 43
+
+function throws(o) {
+  return o.prop;
+}
+function catches() {
+  try {
+    throws(undefined);
+  } catch (e) {
+    return e.constructor.name;
+  }
+  return 'none';
+}
+print(catches());
+// CHECK-NEXT: TypeError
+
+function rethrow(x) {
+  try {
+    if (x > 1) throw new Error('big ' + x);
+    return 'small';
+  } catch (e) {
+    return e.message;
+  }
+}
+print(rethrow(1), rethrow(5));
+// CHECK-NEXT: small big 5
+
+function strictEq(a, b) {
+  if (a === b) return 'same';
+  if (a == b) return 'loose';
+  return 'different';
+}
+print(strictEq(1, 1), strictEq(1, '1'), strictEq(1, 2), strictEq(NaN, NaN));
+// CHECK-NEXT: same loose different different
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The lexer scans strings, whitespace and numbers in blocks. Check tokens
+// that start, end or have escapes at every offset of a block, and that span
+// the chunks ASCII input is converted in.
+
+print('json parse lexer');
+// CHECK-LABEL: json parse lexer
+
+function hash(s) {
+  var h = 0;
+  for (var i = 0; i < s.length; ++i) h = (h * 31 + s.charCodeAt(i)) | 0;
+  return h;
+}
+
+// Strings of every length up to 40, with an escape at every position, in
+// both ASCII and UTF16 input.
+var ok = true;
+for (var len = 0; len <= 40; ++len) {
+  var plain = 'abcdefghijklmnopqrstuvwxyz0123456789ABCD'.slice(0, len);
+  for (var pos = 0; pos <= len; ++pos) {
+    var str = plain.slice(0, pos) + '"\\\n\t\u0001' + plain.slice(pos);
+    var back = JSON.parse(JSON.stringify([str, plain, pos]));
+    var back16 = JSON.parse(JSON.stringify([str, plain, pos, 'é']));
+    ok = ok && back[0] === str && back[1] === plain && back[2] === pos &&
+        back16[0] === str && back16[1] === plain && back16[3] === 'é';
+  }
+}
+print(ok);
+// CHECK-NEXT: true
+
+// Long strings and runs of whitespace cross the conversion chunks.
+var long = 'x'.repeat(5000) + '\\n' + 'y'.repeat(3000);
+var parsed = JSON.parse('   ' + ' '.repeat(2000) + '["' + long + '"' +
+    '\n'.repeat(1500) + ',  "' + 'z'.repeat(2500) + '"]' + '\t'.repeat(40));
+print(parsed[0].length, hash(parsed[0]), parsed[1].length);
+// CHECK-NEXT: 8001 -1820144246 2500
+
+// Control characters are rejected, other characters are not.
+try {
+  JSON.parse('"abcdefghijklmnopqrst\u001fuvw"');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+try {
+  JSON.parse('"abcdefghijklmnopqrst\u0000"');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+print(JSON.parse('"\u007f\u0080ÿĀ ￿  "').length);
+// CHECK-NEXT: 8
+
+// Unterminated strings.
+try {
+  JSON.parse('"' + 'a'.repeat(3000));
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+
+// Numbers, with and without the fast path.
+print(JSON.stringify(JSON.parse(
+    '[0, -0, 1, -1, 0.5, -0.25, 123456789012345, 1234567890123456789, ' +
+    '0.1, 0.3, 3.14159265358979, 1.7976931348623157e308, 5e-324, 1E3, ' +
+    '2.5e-3, 100.000, 0.000001, 9007199254740993, 1.00000000000000011]')));
+// CHECK-NEXT: [0,0,1,-1,0.5,-0.25,123456789012345,1234567890123456800,0.1,0.3,3.14159265358979,1.7976931348623157e+308,5e-324,1000,0.0025,100,0.000001,9007199254740992,1]
+print(1 / JSON.parse('-0'), 1 / JSON.parse('[-0.0]')[0], JSON.parse('42'));
+// CHECK-NEXT: -Infinity -Infinity 42
+var bad = ['01', '-', '.5', '00', '1e', '+1', '1..2'];
+for (var i = 0; i < bad.length; ++i) {
+  try {
+    JSON.parse('[' + bad[i] + ']');
+    print('parsed', bad[i]);
+  } catch (e) {
+    print(e.name);
+  }
+}
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
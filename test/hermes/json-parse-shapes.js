@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Objects with the same keys share a hidden class, which JSON.parse caches
+// by key sequence. Objects that cannot use the cache still come out right.
+
+print('json parse shapes');
+// CHECK-LABEL: json parse shapes
+
+// Many objects of a few shapes, in several orders.
+var rows = [];
+for (var i = 0; i < 200; ++i) {
+  if (i % 3 == 0) rows.push('{"id":' + i + ',"name":"n' + i + '","ok":true}');
+  else if (i % 3 == 1) rows.push('{"name":"n' + i + '","id":' + i + '}');
+  else rows.push('{"id":' + i + ',"name":"n' + i + '","ok":false,"x":1.5}');
+}
+var parsed = JSON.parse('[' + rows.join(',') + ']');
+print(parsed.length, JSON.stringify(parsed[0]), JSON.stringify(parsed[1]));
+// CHECK-NEXT: 200 {"id":0,"name":"n0","ok":true} {"name":"n1","id":1}
+print(JSON.stringify(parsed[197]), JSON.stringify(parsed[199]));
+// CHECK-NEXT: {"id":197,"name":"n197","ok":false,"x":1.5} {"name":"n199","id":199}
+print(Object.keys(parsed[197]), Object.keys(parsed[199]));
+// CHECK-NEXT: id,name,ok,x name,id
+parsed[3].extra = 1;
+delete parsed[6].name;
+print(JSON.stringify(parsed[3]), JSON.stringify(parsed[6]));
+// CHECK-NEXT: {"id":3,"name":"n3","ok":true,"extra":1} {"id":6,"ok":true}
+print(JSON.stringify(parsed[0]), JSON.stringify(parsed[9]));
+// CHECK-NEXT: {"id":0,"name":"n0","ok":true} {"id":9,"name":"n9","ok":true}
+
+// Nested objects of the same shape.
+var nested = JSON.parse('{"a":{"a":{"a":{}}},"b":{"a":{"a":{}}}}');
+print(JSON.stringify(nested), nested.a.a === nested.b.a);
+// CHECK-NEXT: {"a":{"a":{"a":{}}},"b":{"a":{"a":{}}}} false
+
+// Duplicate keys keep the position of the first and the last value.
+var dup = JSON.parse('[{"a":1,"b":2,"a":3},{"a":1,"b":2,"a":3}]');
+print(JSON.stringify(dup));
+// CHECK-NEXT: [{"a":3,"b":2},{"a":3,"b":2}]
+
+// Index-like keys are ordered first.
+var idx = JSON.parse('[{"b":1,"1":2,"a":3,"0":4},{"b":1,"1":2,"a":3,"0":4}]');
+print(Object.keys(idx[0]), Object.keys(idx[1]), idx[1][0], idx[1]['1']);
+// CHECK-NEXT: 0,1,b,a 0,1,b,a 4 2
+
+// __proto__ is an own property and does not change the prototype.
+var proto = JSON.parse('[{"__proto__":{"p":1}},{"__proto__":{"p":1}}]');
+print(proto[1].p, Object.getPrototypeOf(proto[1]) === Object.prototype,
+    JSON.stringify(proto[1]));
+// CHECK-NEXT: undefined true {"__proto__":{"p":1}}
+
+// Objects with more properties than a hidden class holds.
+function wide(n) {
+  var parts = [];
+  for (var i = 0; i < n; ++i) parts.push('"k' + i + '":' + i);
+  return '{' + parts.join(',') + '}';
+}
+var w = JSON.parse('[' + wide(64) + ',' + wide(64) + ',' + wide(65) + ',' +
+    wide(300) + ']');
+print(Object.keys(w[1]).length, w[1].k63, Object.keys(w[2]).length, w[2].k64);
+// CHECK-NEXT: 64 63 65 64
+print(Object.keys(w[3]).length, w[3].k0, w[3].k299, Object.keys(w[3])[150]);
+// CHECK-NEXT: 300 0 299 k150
+
+// A wide object nested inside a narrow one.
+var mixed = JSON.parse('{"x":1,"w":' + wide(100) + ',"y":2}');
+print(Object.keys(mixed), mixed.w.k99);
+// CHECK-NEXT: x,w,y 99
+
+// The reviver sees every property.
+var seen = [];
+JSON.parse('[{"a":1,"b":2},{"a":3,"b":4}]', function(k, v) {
+  seen.push(k);
+  return v;
+});
+print(seen);
+// CHECK-NEXT: a,b,0,a,b,1,
+
+// Syntax errors inside an object abandon the buffered properties.
+try {
+  JSON.parse('[{"a":1,"b":2},{"a":1,"b":}]');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+print(JSON.stringify(JSON.parse('{"a":1,"b":2}')));
+// CHECK-NEXT: {"a":1,"b":2}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// JSON.stringify reads the properties of plain objects and the elements of
+// arrays from their storage, unless toJSON or the replacer change them.
+
+print('stringify fast paths');
+// CHECK-LABEL: stringify fast paths
+
+// Objects of the same class, with nested objects and arrays.
+var list = [];
+for (var i = 0; i < 3; ++i)
+  list.push({id: i, name: 'n' + i, tags: ['a', i], nested: {x: i / 4}});
+print(JSON.stringify(list));
+// CHECK-NEXT: [{"id":0,"name":"n0","tags":["a",0],"nested":{"x":0}},{"id":1,"name":"n1","tags":["a",1],"nested":{"x":0.25}},{"id":2,"name":"n2","tags":["a",2],"nested":{"x":0.5}}]
+
+// Numbers.
+print(JSON.stringify([0, -0, 1.5, -2e-7, 1e21, 123456789012, NaN, Infinity]));
+// CHECK-NEXT: [0,0,1.5,-2e-7,1e+21,123456789012,null,null]
+
+// Strings that need escaping, and ones that do not.
+print(JSON.stringify({'a"b': 'x\ny', plain: 'abc', u: 'é', c: '\u0001'}));
+// CHECK-NEXT: {"a\"b":"x\ny","plain":"abc","u":"é","c":"\u0001"}
+
+// Non-enumerable, symbol, undefined and function properties are skipped.
+var o = {a: 1, f: function() {}, u: undefined, b: 2};
+Object.defineProperty(o, 'hidden', {value: 3, enumerable: false});
+o[Symbol('s')] = 4;
+print(JSON.stringify(o));
+// CHECK-NEXT: {"a":1,"b":2}
+
+// Getters are called.
+var g = {a: 1, get b() { return this.a + 1; }, c: 3};
+print(JSON.stringify(g));
+// CHECK-NEXT: {"a":1,"b":2,"c":3}
+
+// Index-like keys come first, in numeric order.
+print(JSON.stringify({b: 1, 2: 'two', a: 2, 1: 'one'}));
+// CHECK-NEXT: {"1":"one","2":"two","b":1,"a":2}
+
+// toJSON and the replacer may delete and change properties that are still
+// to be serialized.
+var m = {a: {toJSON: function() { delete m.b; m.c = 'changed'; return 1; }},
+         b: 2, c: 3};
+print(JSON.stringify(m));
+// CHECK-NEXT: {"a":1,"c":"changed"}
+var r = {a: 1, b: 2, c: 3};
+print(JSON.stringify(r, function(k, v) {
+  if (k === 'a') { r.c = 30; delete r.b; r.d = 4; }
+  return v;
+}));
+// CHECK-NEXT: {"a":1,"c":30}
+
+// The replacer sees the keys as strings and the holder as this.
+print(JSON.stringify({p: 1, q: [5, 6]}, function(k, v) {
+  return typeof v === 'number' ? typeof k + ':' + k + ':' + (this !== null) : v;
+}));
+// CHECK-NEXT: {"p":"string:p:true","q":["string:0:true","string:1:true"]}
+
+// Arrays: holes, prototype elements and elements changed by toJSON.
+var holes = [1, , 3];
+print(JSON.stringify(holes));
+// CHECK-NEXT: [1,null,3]
+Array.prototype[1] = 'proto';
+print(JSON.stringify(holes));
+// CHECK-NEXT: [1,"proto",3]
+delete Array.prototype[1];
+var arr = [{toJSON: function() { arr.length = 1; return 'x'; }}, 2, 3];
+print(JSON.stringify(arr));
+// CHECK-NEXT: ["x",null,null]
+
+// Indentation.
+print(JSON.stringify({a: [1, {b: 2}], c: {}, d: []}, null, 2));
+// CHECK-NEXT: {
+// CHECK-NEXT:   "a": [
+// CHECK-NEXT:     1,
+// CHECK-NEXT:     {
+// CHECK-NEXT:       "b": 2
+// CHECK-NEXT:     }
+// CHECK-NEXT:   ],
+// CHECK-NEXT:   "c": {},
+// CHECK-NEXT:   "d": []
+// CHECK-NEXT: }
+
+// A property list.
+print(JSON.stringify({a: 1, b: 2, c: 3}, ['c', 'a']));
+// CHECK-NEXT: {"c":3,"a":1}
+
+// More classes than are cached.
+var many = [];
+for (var i = 0; i < 40; ++i) {
+  var x = {};
+  x['k' + i] = i;
+  many.push(x);
+}
+var s = JSON.stringify(many.concat(many));
+print(s.length, s.slice(0, 30));
+// CHECK-NEXT: 841 [{"k0":0},{"k1":1},{"k2":2},{"
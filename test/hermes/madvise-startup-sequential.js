@@ -0,0 +1,24 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Advising sequential access during startup and random access afterwards
+// (MAdviseStartupSequential) must not change the behavior of the bytecode.
+// RUN: %hermesc -O -emit-binary -out %t.hbc %s
+// RUN: %hermes -Xvm-experiment-flags=32768 %t.hbc | %FileCheck --match-full-lines %s
+
+function later(n) {
+  var s = '';
+  for (var i = 0; i < n; ++i) s += String.fromCharCode(97 + i);
+  return s;
+}
+
+print('startup');
+// CHECK: startup
+setTimeout(function() {
+  print(later(5));
+}, 0);
+// CHECK-NEXT: abcde
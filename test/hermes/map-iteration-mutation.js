@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Iterators keep their position while the map is mutated, rehashed and
+// cleared under them.
+
+print('map iteration');
+// CHECK-LABEL: map iteration
+
+// Deleting the entry an iterator is at, and the ones ahead of it.
+var m = new Map([[1, 'a'], [2, 'b'], [3, 'c'], [4, 'd'], [5, 'e']]);
+var it = m.keys();
+print(it.next().value);
+// CHECK-NEXT: 1
+m.delete(1);
+m.delete(3);
+print(it.next().value, it.next().value);
+// CHECK-NEXT: 2 4
+m.set(6, 'f');
+print(it.next().value, it.next().value, it.next().done);
+// CHECK-NEXT: 5 6 true
+m.set(7, 'g');
+print(it.next().done);
+// CHECK-NEXT: true
+
+// Growing the map while iterating rehashes it.
+var grow = new Map();
+for (var i = 0; i < 4; ++i) grow.set(i, i);
+var seen = [];
+grow.forEach(function(v, k) {
+  seen.push(k);
+  if (k < 100) grow.set(k + 4, k + 4);
+});
+print(seen.length, seen[0], seen[seen.length - 1]);
+// CHECK-NEXT: 104 0 103
+
+// Deleting most of the map while iterating shrinks it.
+var shrink = new Map();
+for (var i = 0; i < 1000; ++i) shrink.set('k' + i, i);
+var it2 = shrink.entries();
+var first = it2.next().value;
+for (var i = 1; i < 990; ++i) shrink.delete('k' + i);
+print(first, shrink.size, it2.next().value, it2.next().value);
+// CHECK-NEXT: k0,0 11 k990,990 k991,991
+
+// Clearing restarts iterators at the entries added afterwards.
+var c = new Set(['x', 'y', 'z']);
+var it3 = c.values();
+print(it3.next().value);
+// CHECK-NEXT: x
+c.clear();
+c.add('after');
+print(it3.next().value, it3.next().done);
+// CHECK-NEXT: after true
+
+// Entries that are deleted and added again move to the end.
+var s = new Set([1, 2, 3]);
+s.delete(1);
+s.add(1);
+print([...s]);
+// CHECK-NEXT: 2,3,1
+
+// Keys are compared with SameValueZero.
+var z = new Map();
+z.set(-0, 'zero');
+z.set(NaN, 'nan');
+print(z.get(0), z.get(NaN), z.has(-0), z.size);
+// CHECK-NEXT: zero nan true 2
+
+// Many entries with every kind of key.
+var big = new Map();
+var objs = [];
+for (var i = 0; i < 100000; ++i) {
+  var o = {i: i};
+  objs.push(o);
+  big.set(o, i);
+  big.set('s' + i, i);
+  big.set(i + 0.5, i);
+}
+var ok = true;
+for (var i = 0; i < 100000; i += 7) {
+  ok = ok && big.get(objs[i]) === i && big.get('s' + i) === i &&
+      big.get(i + 0.5) === i;
+}
+print(big.size, ok, big.has({}), big.has('s100000'));
+// CHECK-NEXT: 300000 true false false
+for (var i = 0; i < 100000; ++i) big.delete(objs[i]);
+print(big.size, big.get('s5'));
+// CHECK-NEXT: 200000 5
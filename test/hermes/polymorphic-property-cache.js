@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+print('polymorphic property cache');
+// CHECK-LABEL: polymorphic property cache
+
+// Objects with the same property at different slots.
+function makeShapes() {
+  return [
+    {x: 1},
+    {a: 0, x: 2},
+    {a: 0, b: 0, x: 3},
+    {a: 0, b: 0, c: 0, x: 4},
+    {a: 0, b: 0, c: 0, d: 0, x: 5},
+    {a: 0, b: 0, c: 0, d: 0, e: 0, x: 6},
+  ];
+}
+
+function getX(o) {
+  return o.x;
+}
+
+function setX(o, v) {
+  o.x = v;
+}
+
+// Read sites seeing 2, 4 and 6 shapes.
+function sumX(objs, n) {
+  var sum = 0;
+  for (var iter = 0; iter < 10; ++iter)
+    for (var i = 0; i < n; ++i) sum += getX(objs[i]);
+  return sum;
+}
+var shapes = makeShapes();
+print(sumX(shapes, 2), sumX(shapes, 4), sumX(shapes, 6));
+// CHECK-NEXT: 30 100 210
+
+// Write sites seeing many shapes must store to the right slot.
+for (var iter = 0; iter < 3; ++iter)
+  for (var i = 0; i < shapes.length; ++i) setX(shapes[i], i * 10 + iter);
+print(shapes.map(getX).join());
+// CHECK-NEXT: 2,12,22,32,42,52
+print(JSON.stringify(shapes[3]));
+// CHECK-NEXT: {"a":0,"b":0,"c":0,"x":32}
+
+// Cached classes must stay valid across collections.
+shapes = makeShapes();
+sumX(shapes, 4);
+gc();
+print(sumX(makeShapes(), 4), sumX(shapes, 4));
+// CHECK-NEXT: 100 100
+
+// Mix own properties with properties found on different prototypes.
+function Base1() {}
+Base1.prototype.x = 'p1';
+function Base2() {}
+Base2.prototype.y = 0;
+Base2.prototype.x = 'p2';
+var mixed = [new Base1(), {x: 'own'}, new Base2(), {z: 0, x: 'own2'}];
+var res = [];
+for (var iter = 0; iter < 3; ++iter)
+  for (var i = 0; i < mixed.length; ++i) res.push(getX(mixed[i]));
+print(res.slice(0, 4).join(), res.slice(8).join());
+// CHECK-NEXT: p1,own,p2,own2 p1,own,p2,own2
+
+// A change to a cached prototype property must be observed.
+Base2.prototype.x = 'changed';
+print(getX(mixed[2]));
+// CHECK-NEXT: changed
+
+// Accessors and missing properties are never served from the cache.
+var withGetter = {
+  get x() {
+    return 'getter';
+  },
+};
+print(getX(withGetter), getX({}), getX(shapes[0]));
+// CHECK-NEXT: getter undefined 1
@@ -0,0 +1,362 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xmicrotask-queue %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xmicrotask-queue %s | %FileCheck --match-full-lines %s
+
+print('native promise');
+// CHECK-LABEL: native promise
+
+print(Object.prototype.toString.call(Promise.resolve()));
+// CHECK-NEXT: [object Promise]
+print(Promise.length, Promise.prototype.then.length);
+// CHECK-NEXT: 1 2
+
+try {
+  Promise(function() {});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  new Promise(1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  Promise.prototype.then.call({}, function() {});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+var p0 = Promise.resolve(1);
+print(Promise.resolve(p0) === p0);
+// CHECK-NEXT: true
+
+// Each test runs once the jobs of the previous one have all been drained.
+var tests = [];
+function test(name, fn) {
+  tests.push([name, fn]);
+}
+function runTests(i) {
+  if (i === tests.length) return;
+  print(tests[i][0]);
+  tests[i][1]();
+  setTimeout(function() {
+    runTests(i + 1);
+  }, 0);
+}
+
+test('ordering', function() {
+  Promise.resolve()
+    .then(function() { print('a1'); })
+    .then(function() { print('a2'); });
+  Promise.resolve()
+    .then(function() { print('b1'); })
+    .then(function() { print('b2'); });
+  print('sync');
+});
+// CHECK-LABEL: ordering
+// CHECK-NEXT: sync
+// CHECK-NEXT: a1
+// CHECK-NEXT: b1
+// CHECK-NEXT: a2
+// CHECK-NEXT: b2
+
+test('adoption', function() {
+  // Adopting the state of a promise takes two more ticks.
+  new Promise(function(res) {
+    res(Promise.resolve(1));
+  }).then(function(v) {
+    print('adopted', v);
+  });
+  Promise.resolve()
+    .then(function() { print('t1'); })
+    .then(function() { print('t2'); })
+    .then(function() { print('t3'); });
+});
+// CHECK-LABEL: adoption
+// CHECK-NEXT: t1
+// CHECK-NEXT: t2
+// CHECK-NEXT: adopted 1
+// CHECK-NEXT: t3
+
+test('thenables', function() {
+  var thenable = {
+    then: function(res) {
+      print('then called');
+      res(42);
+    },
+  };
+  Promise.resolve(thenable).then(function(v) {
+    print('thenable', v);
+  });
+  var bad = {};
+  Object.defineProperty(bad, 'then', {
+    get: function() {
+      throw new Error('bad then');
+    },
+  });
+  Promise.resolve(bad).catch(function(e) {
+    print('caught', e.message);
+  });
+  var resolveSelf;
+  var self = new Promise(function(res) {
+    resolveSelf = res;
+  });
+  resolveSelf(self);
+  self.catch(function(e) {
+    print('self', e.name);
+  });
+  print('after resolve');
+});
+// CHECK-LABEL: thenables
+// CHECK-NEXT: after resolve
+// CHECK-NEXT: then called
+// CHECK-NEXT: caught bad then
+// CHECK-NEXT: self TypeError
+// CHECK-NEXT: thenable 42
+
+test('settle once', function() {
+  new Promise(function(res, rej) {
+    res('first');
+    rej('second');
+    res('third');
+  }).then(function(v) {
+    print('once', v);
+  });
+  new Promise(function() {
+    throw new Error('boom');
+  }).catch(function(e) {
+    print('executor', e.message);
+  });
+  Promise.resolve()
+    .then(function() {
+      throw 'in handler';
+    })
+    .catch(function(e) {
+      print('handler threw', e);
+    });
+});
+// CHECK-LABEL: settle once
+// CHECK-NEXT: once first
+// CHECK-NEXT: executor boom
+// CHECK-NEXT: handler threw in handler
+
+test('finally', function() {
+  Promise.resolve('v')
+    .finally(function() {
+      print('finally 1');
+      return 'ignored';
+    })
+    .then(function(v) {
+      print('after finally', v);
+    });
+  Promise.reject('r')
+    .finally(function() {
+      print('finally 2');
+    })
+    .catch(function(e) {
+      print('after finally', e);
+    });
+  Promise.resolve('v')
+    .finally(function() {
+      throw 'override';
+    })
+    .catch(function(e) {
+      print('finally threw', e);
+    });
+});
+// CHECK-LABEL: finally
+// CHECK-NEXT: finally 1
+// CHECK-NEXT: finally 2
+// CHECK-NEXT: finally threw override
+// CHECK-NEXT: after finally v
+// CHECK-NEXT: after finally r
+
+test('all', function() {
+  var thenable = {
+    then: function(res) {
+      res(3);
+    },
+  };
+  Promise.all([1, Promise.resolve(2), thenable]).then(function(v) {
+    print('all', v.length, v);
+  });
+});
+// CHECK-LABEL: all
+// CHECK-NEXT: all 3 1,2,3
+
+test('all empty', function() {
+  Promise.all([]).then(function(v) {
+    print('all empty', Array.isArray(v), v.length);
+  });
+});
+// CHECK-LABEL: all empty
+// CHECK-NEXT: all empty true 0
+
+test('all rejected', function() {
+  Promise.all([1, Promise.reject('no'), 3]).catch(function(e) {
+    print('all rejected', e);
+  });
+});
+// CHECK-LABEL: all rejected
+// CHECK-NEXT: all rejected no
+
+test('all not iterable', function() {
+  Promise.all(5).catch(function(e) {
+    print('not iterable', e.name);
+  });
+});
+// CHECK-LABEL: all not iterable
+// CHECK-NEXT: not iterable TypeError
+
+test('allSettled', function() {
+  Promise.allSettled([1, Promise.reject('x')]).then(function(rs) {
+    print('allSettled', JSON.stringify(rs));
+  });
+});
+// CHECK-LABEL: allSettled
+// CHECK-NEXT: allSettled [{"status":"fulfilled","value":1},{"status":"rejected","reason":"x"}]
+
+test('any', function() {
+  Promise.any([Promise.reject('e1'), 'ok']).then(function(v) {
+    print('any', v);
+  });
+});
+// CHECK-LABEL: any
+// CHECK-NEXT: any ok
+
+test('any rejected', function() {
+  Promise.any([Promise.reject('e1'), Promise.reject('e2')]).catch(function(e) {
+    print('any rejected', e.name, e.message, e.errors);
+  });
+});
+// CHECK-LABEL: any rejected
+// CHECK-NEXT: any rejected AggregateError All promises were rejected e1,e2
+
+test('race', function() {
+  Promise.race([new Promise(function() {}), Promise.resolve('fast')]).then(
+    function(v) {
+      print('race', v);
+    },
+  );
+});
+// CHECK-LABEL: race
+// CHECK-NEXT: race fast
+
+test('capability', function() {
+  function FakePromise(executor) {
+    executor(
+      function(v) {
+        print('fake resolve', v);
+      },
+      function(e) {
+        print('fake reject', e);
+      },
+    );
+  }
+  Promise.resolve.call(FakePromise, 'x');
+  Promise.reject.call(FakePromise, 'y');
+  Promise.all.call(FakePromise, [1]);
+  try {
+    Promise.resolve.call(function() {}, 'z');
+  } catch (e) {
+    print(e.name);
+  }
+});
+// CHECK-LABEL: capability
+// CHECK-NEXT: fake resolve x
+// CHECK-NEXT: fake reject y
+// CHECK-NEXT: fake reject TypeError: Promise resolve is not callable
+// CHECK-NEXT: TypeError
+
+test('await', function() {
+  async function f() {
+    print('f start');
+    await undefined;
+    print('f after await');
+  }
+  f();
+  Promise.resolve()
+    .then(function() { print('p1'); })
+    .then(function() { print('p2'); });
+  print('sync end');
+});
+// CHECK-LABEL: await
+// CHECK-NEXT: f start
+// CHECK-NEXT: sync end
+// CHECK-NEXT: f after await
+// CHECK-NEXT: p1
+// CHECK-NEXT: p2
+
+test('async functions', function() {
+  async function add(a, b) {
+    var x = await a;
+    var y = await b;
+    return x + y;
+  }
+  add(1, Promise.resolve(2)).then(function(v) {
+    print('async result', v);
+  });
+});
+// CHECK-LABEL: async functions
+// CHECK-NEXT: async result 3
+
+test('async throw', function() {
+  async function thrower() {
+    await null;
+    throw new Error('async boom');
+  }
+  thrower().catch(function(e) {
+    print('async caught', e.message);
+  });
+});
+// CHECK-LABEL: async throw
+// CHECK-NEXT: async caught async boom
+
+test('async catch', function() {
+  async function catches() {
+    try {
+      await Promise.reject('inner');
+    } catch (e) {
+      return 'recovered ' + e;
+    }
+  }
+  catches().then(function(v) {
+    print(v);
+  });
+});
+// CHECK-LABEL: async catch
+// CHECK-NEXT: recovered inner
+
+test('rejection tracking', function() {
+  HermesInternal.enablePromiseRejectionTracker({
+    allRejections: true,
+    onUnhandled: function(id, error) {
+      print('unhandled', id, error);
+    },
+    onHandled: function(id, error) {
+      print('handled', id, error);
+    },
+  });
+  var handledLater = Promise.reject(new TypeError('t1'));
+  Promise.reject(new TypeError('t2')).catch(function() {});
+  setTimeout(function() {
+    handledLater.catch(function(e) {
+      print('caught late', e.message);
+    });
+  }, 200);
+});
+// CHECK-LABEL: rejection tracking
+// CHECK-NEXT: unhandled 0 TypeError: t1
+// CHECK-NEXT: handled 0 TypeError: t1
+// CHECK-NEXT: caught late t1
+
+runTests(0);
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xjit -Xjit-threshold=0 %s | %FileCheck --match-full-lines %s
+
+print('prototype chain property cache');
+// CHECK-LABEL: prototype chain property cache
+
+// Prototype objects are only cached once they are in the old generation.
+function warm(f) {
+  var res;
+  for (var i = 0; i < 3; ++i) {
+    res = f();
+    gc();
+  }
+  return res;
+}
+
+function A() {}
+A.prototype.m = function () {
+  return 'A.m';
+};
+function B() {}
+B.prototype = Object.create(A.prototype);
+B.prototype.n = function () {
+  return 'B.n';
+};
+function C() {}
+C.prototype = Object.create(B.prototype);
+
+function callM(o) {
+  return o.m();
+}
+var c = new C();
+print(warm(() => callM(c)), callM(new B()), callM(new A()));
+// CHECK-NEXT: A.m A.m A.m
+
+// Shadowing on an intermediate prototype must be observed.
+B.prototype.m = function () {
+  return 'B.m';
+};
+print(callM(c), callM(new A()));
+// CHECK-NEXT: B.m A.m
+warm(() => callM(c));
+delete B.prototype.m;
+print(callM(c));
+// CHECK-NEXT: A.m
+
+// Redefining the holder's property, including as an accessor.
+warm(() => callM(c));
+A.prototype.m = function () {
+  return 'A.m2';
+};
+print(callM(c));
+// CHECK-NEXT: A.m2
+warm(() => callM(c));
+Object.defineProperty(A.prototype, 'm', {
+  get: function () {
+    return () => 'getter';
+  },
+  configurable: true,
+});
+print(callM(c));
+// CHECK-NEXT: getter
+
+// Receivers of the same class with different prototypes.
+function getP(o) {
+  return o.p;
+}
+var proto1 = {p: 1};
+var proto2 = {p: 2};
+var o1 = Object.create(proto1);
+var o2 = Object.create(proto2);
+print(warm(() => getP(o1)), getP(o2), getP(o1));
+// CHECK-NEXT: 1 2 1
+
+// Changing the prototype of the receiver or of an object in the chain.
+Object.setPrototypeOf(o1, proto2);
+print(getP(o1));
+// CHECK-NEXT: 2
+var grand = {p: 'grand'};
+var mid = Object.create(grand);
+var leaf = Object.create(mid);
+print(warm(() => getP(leaf)));
+// CHECK-NEXT: grand
+Object.setPrototypeOf(mid, {p: 'other'});
+print(getP(leaf));
+// CHECK-NEXT: other
+
+// The receiver gaining an own property.
+var leaf2 = Object.create(grand);
+warm(() => getP(leaf2));
+leaf2.p = 'own';
+print(getP(leaf2), getP(Object.create(grand)));
+// CHECK-NEXT: own grand
+
+// Freezing the holder keeps the value.
+warm(() => getP(leaf2));
+Object.freeze(grand);
+print(getP(Object.create(grand)));
+// CHECK-NEXT: grand
+
+// Builtin methods found on Object.prototype.
+function callToString(o) {
+  return o.toString();
+}
+print(warm(() => callToString({})), callToString({a: 1}));
+// CHECK-NEXT: [object Object] [object Object]
+Object.prototype.toString = function () {
+  return 'patched';
+};
+print(callToString({}));
+// CHECK-NEXT: patched
+
+// Lazily initialized functions have their own properties.
+function getName(o) {
+  return o.name;
+}
+function f1() {}
+function f2() {}
+print(warm(() => getName(Object.create(f1))), getName(f2));
+// CHECK-NEXT: f1 f2
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: LC_ALL=en_US.UTF-8 %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Searches for regexes whose matches begin with one of a few characters skip
+// ahead to them.
+
+function show(m) {
+  return m === null ? 'null' : JSON.stringify(m.slice()) + ' ' + m.index;
+}
+
+print('regexp first chars');
+// CHECK-LABEL: regexp first chars
+
+var line = 'x'.repeat(1000) + ' level=warn msg=disk ' + 'y'.repeat(37) +
+    ' level=error code=7';
+print(show(/level=(\w+)/.exec(line)));
+// CHECK-NEXT: ["level=warn","warn"] 1001
+print(line.replace(/level=/g, 'L:').slice(-30));
+// CHECK-NEXT: yyyyyyyyyyyyyyy L:error code=7
+print(show(/(?:warn|error) (\w+)=/.exec(line)));
+// CHECK-NEXT: ["warn msg=","msg"] 1007
+print(show(/[ce]ode?=(\d)/.exec(line)));
+// CHECK-NEXT: ["code=7","7"] 1071
+
+// Loops and alternations.
+print(show(/(?:ab|cd){2}/.exec('a'.repeat(50) + 'abcdab')));
+// CHECK-NEXT: ["abcd"] 50
+print(show(/(?:ab)+?c/.exec('-'.repeat(40) + 'ababc')));
+// CHECK-NEXT: ["ababc"] 40
+print(show(/z+q/.exec('z'.repeat(20) + 'zq')));
+// CHECK-NEXT: ["zzzzzzzzzzzzzzzzzzzzzq"] 0
+print(show(/[a-c]z/.exec('.'.repeat(30) + 'dzbz')));
+// CHECK-NEXT: ["bz"] 32
+print(show(/(a+)+b/.exec('-'.repeat(1000) + 'a'.repeat(28) + 'cab')));
+// CHECK-NEXT: ["ab","a"] 1029
+
+// Non-ASCII first characters, in ASCII and UTF-16 input.
+print(show(/é(.)/.exec('a'.repeat(30) + 'éx')));
+// CHECK-NEXT: ["éx","x"] 30
+print(show(/é/.exec('a'.repeat(30))));
+// CHECK-NEXT: null
+print(show(/文|b/.exec('a'.repeat(30) + 'b')));
+// CHECK-NEXT: ["b"] 30
+
+// Unicode regexes do not match within a surrogate pair.
+print(show(/\ude00/u.exec('😀 \ude00')));
+// CHECK-NEXT: ["\ude00"] 3
+print(show(/\ude00/.exec('😀 \ude00')));
+// CHECK-NEXT: ["\ude00"] 1
+print(show(/x/u.exec('😀'.repeat(20) + 'x')));
+// CHECK-NEXT: ["x"] 40
+
+// Global and sticky searches.
+var re = /b/g;
+re.lastIndex = 5;
+print(show(re.exec('bbbbbbbbbb' + 'a'.repeat(20))), re.lastIndex);
+// CHECK-NEXT: ["b"] 5 6
+re = /b/y;
+re.lastIndex = 3;
+print(show(re.exec('aaab')), show(re.exec('aaab')));
+// CHECK-NEXT: ["b"] 3 null
+print(show(/(?:)a/.exec('bba')), show(/a|/.exec('bb')));
+// CHECK-NEXT: ["a"] 2 [""] 0
+print('AbA'.split(/b/i), 'a-b_c'.split(/[-_]/));
+// CHECK-NEXT: A,A a,b,c
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: LC_ALL=en_US.UTF-8 %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Regexes that backtrack catastrophically on these inputs. The searches are
+// handed over to the PikeVM, which must find the same matches and captures as
+// the backtracking matcher would.
+
+function show(m) {
+  return m === null ? 'null' : JSON.stringify(m.slice()) + ' ' + m.index;
+}
+
+print('regexp pikevm');
+// CHECK-LABEL: regexp pikevm
+
+print(show(/(a+)+b/.exec('a'.repeat(28) + 'cab')));
+// CHECK-NEXT: ["ab","a"] 29
+print(/^(a+)+$/.test('a'.repeat(30) + 'b'));
+// CHECK-NEXT: false
+print(show(/(x+x+)+y/.exec('x'.repeat(40))));
+// CHECK-NEXT: null
+print(/(a+)+b/.test('a'.repeat(100000)));
+// CHECK-NEXT: false
+
+// Captures of alternatives and loops.
+var m = /(a|aa)+c|(a+)b/.exec('a'.repeat(30) + 'b');
+print(m[0].length, m[1], m[2].length, m.index);
+// CHECK-NEXT: 31 undefined 30 0
+print(show(/(?:(a)|(b)|a)+c/.exec('ab'.repeat(12) + 'a'.repeat(20) + 'dabc')));
+// CHECK-NEXT: ["abc",null,"b"] 45
+
+// Non-greedy and counted loops.
+print(show(/((?:a|a)+?)(a*)b/.exec('a'.repeat(25) + 'caaab')));
+// CHECK-NEXT: ["aaab","a","aa"] 26
+print(show(/(?:a|a){10,}x/.exec('a'.repeat(30))));
+// CHECK-NEXT: null
+m = /(?:a|a)+y|(?:a|a){3,5}(a*)x/.exec('a'.repeat(30) + 'x');
+print(m[0].length, m[1].length, m.index);
+// CHECK-NEXT: 31 25 0
+
+// Anchors and word boundaries.
+print(show(/^(\w+\s?)*$/m.exec('a'.repeat(30) + '!\nab cd')));
+// CHECK-NEXT: ["ab cd","cd"] 32
+print(show(/(?:a+)+\b\W/.exec('a'.repeat(30) + 'b a!')));
+// CHECK-NEXT: ["a!"] 32
+
+// Flags and non-ASCII input.
+print(show(/(?:A|a)+B/i.exec('a'.repeat(30) + 'cAAb')));
+// CHECK-NEXT: ["AAb"] 31
+print(show(/(a+)+é/.exec('a'.repeat(30) + '!aé')));
+// CHECK-NEXT: ["aé","a"] 31
+var re = /(a+)+b/y;
+print(show(re.exec('a'.repeat(30) + 'c')), re.lastIndex);
+// CHECK-NEXT: null 0
+print(show(/(a|.)+z/u.exec('a'.repeat(30))));
+// CHECK-NEXT: null
+print(show(/(a|.)+z/u.exec('😀' + 'a'.repeat(30) + 'z')));
+// CHECK-NEXT: ["😀aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaz","a"] 0
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// String searches, case conversion and trimming take separate paths for ASCII
+// strings; check them against the mixed width ones.
+
+print('string ascii');
+// CHECK-LABEL: string ascii
+
+// Searches across every alignment of the vector blocks.
+var hay = 'abcdefghijklmnopqrstuvwxyz'.repeat(3) + 'needle' + 'xyz'.repeat(7);
+var res = [];
+for (var i = 0; i < 40; i += 3) res.push(hay.indexOf('needle', i));
+print(res.join(','));
+// CHECK-NEXT: 78,78,78,78,78,78,78,78,78,78,78,78,78,78
+print(hay.indexOf('needlf'), hay.indexOf('e'), hay.indexOf('zx'),
+      hay.indexOf(''), hay.indexOf('', 1000), hay.indexOf('xyz', 90));
+// CHECK-NEXT: -1 4 86 0 105 90
+print(hay.lastIndexOf('needle'), hay.lastIndexOf('xyz'),
+      hay.lastIndexOf('abc', 50), hay.lastIndexOf(''), hay.lastIndexOf('q', 0));
+// CHECK-NEXT: 78 102 26 105 -1
+print(hay.includes('needle', 78), hay.includes('needle', 79),
+      'aaab'.indexOf('aab'));
+// CHECK-NEXT: true false 1
+var rep = 'a'.repeat(40) + 'b';
+print(rep.indexOf('aab'), rep.indexOf('a'.repeat(20) + 'b'), rep.indexOf('ba'));
+// CHECK-NEXT: 38 20 -1
+
+// Mixed widths.
+var wide = 'é'.repeat(20) + 'needle' + '中';
+print(wide.indexOf('needle'), wide.indexOf('le中'), wide.lastIndexOf('é'));
+// CHECK-NEXT: 20 24 19
+print(hay.indexOf('中'), hay.indexOf('needle中'), 'xyz'.includes('é'));
+// CHECK-NEXT: -1 -1 false
+var wideAscii = ('é' + 'needle').slice(1);
+print(hay.indexOf(wideAscii), wide.indexOf(wideAscii));
+// CHECK-NEXT: 78 20
+
+// Split and replace.
+print('a01bb01ccc01'.split('01').join('|'),
+      'aaaa01'.repeat(3).split('01').length);
+// CHECK-NEXT: a|bb|ccc| 4
+print('x,y,,z'.split(',', 2).join('|'), 'é,ü,ö'.split(',').join('|'));
+// CHECK-NEXT: x|y é|ü|ö
+print('aaab'.replace('aab', '[$&]'), ('a'.repeat(33) + 'b').replace('b', 'f'));
+// CHECK-NEXT: a[aab] aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaf
+print('one two one'.replace('one', 'three'), 'é1é'.replace('1', '2'));
+// CHECK-NEXT: three two one é2é
+
+// Case conversion.
+var mixed = 'Hello, World! 0123456789 [@`{] ABCXYZ abcxyz ~';
+print(mixed.toLowerCase());
+// CHECK-NEXT: hello, world! 0123456789 [@`{] abcxyz abcxyz ~
+print(mixed.toUpperCase());
+// CHECK-NEXT: HELLO, WORLD! 0123456789 [@`{] ABCXYZ ABCXYZ ~
+print('already lower 123'.toLowerCase(), 'ALREADY UPPER'.toUpperCase());
+// CHECK-NEXT: already lower 123 ALREADY UPPER
+print(''.toUpperCase().length, 'A'.toLowerCase(), 'z'.toUpperCase(),
+      '@'.toLowerCase());
+// CHECK-NEXT: 0 a Z @
+print('ÉCOLE École'.toLowerCase(), 'straße'.toUpperCase());
+// CHECK-NEXT: école école STRASSE
+
+// Trimming.
+print('[' + ' \t\n\v\f\r abc \r\n'.trim() + ']',
+      '[' + '  abc  '.trimStart() + ']', '[' + '  abc  '.trimEnd() + ']');
+// CHECK-NEXT: [abc] [abc  ] [  abc]
+print('[' + ' \t '.trim() + ']', '[' + '  x  '.trim() + ']',
+      '[' + '\x08abc\x0e'.trim() + ']');
+// CHECK-NEXT: [] [x] [abc]
+
+// Repeating and padding copy what is already built.
+print('abc'.padStart(10, '12'), 'abc'.padEnd(10, '12'),
+      'abc'.padStart(4, 'xyz'), 'x'.padEnd(3) + '|',
+      'abc'.padEnd(9, 'abcdefgh'));
+// CHECK-NEXT: 1212121abc abc1212121 xabc x  | abcabcdef
+print('abc'.padEnd(11, 'é1'), 'é'.padStart(8, 'ab'), 'é.'.repeat(3));
+// CHECK-NEXT: abcé1é1é1é1 abababaé é.é.é.
+print('ab'.repeat(5), 'abc'.repeat(1), 'q'.repeat(7),
+      'abc'.padStart(1000, '0123456789').slice(990));
+// CHECK-NEXT: ababababab abc qqqqqqq 0123456abc
+print('xy'.repeat(1001).length, 'xy'.repeat(1001).lastIndexOf('yx'));
+// CHECK-NEXT: 2002 1999
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array.prototype.join and String.prototype.concat, which template literals
+// use, size their results exactly before copying the parts.
+
+print('join and concat');
+// CHECK-LABEL: join and concat
+
+// Results mixing ASCII and other characters.
+var parts = ['a', 'é', 'b', '中'];
+print(parts.join('-'), parts.join('—').length, 'x'.concat('y', 'é', 1));
+// CHECK-NEXT: a-é-b-中 7 xyé1
+print(['a', 'b'].join('é'), [1, 2, 3].join(), `t${1}é${'x'}`);
+// CHECK-NEXT: aéb 1,2,3 t1éx
+
+// Holes are read from the prototype chain, undefined and null are empty.
+var holes = [1, , 3, undefined, null];
+print(holes.join());
+// CHECK-NEXT: 1,,3,,
+Array.prototype[1] = 'proto';
+print(holes.join());
+// CHECK-NEXT: 1,proto,3,,
+delete Array.prototype[1];
+
+// toString of an element may change the array being joined.
+var changer = {
+  toString: function() {
+    arr[1] = 'changed';
+    arr.length = 3;
+    return 'o';
+  },
+};
+var arr = [changer, 'b', 'c', 'd'];
+print(arr.join('|'));
+// CHECK-NEXT: o|changed|c|
+
+// Array-likes and cycles.
+print(Array.prototype.join.call({length: 3, 0: 'x', 2: 'z'}, '+'));
+// CHECK-NEXT: x++z
+var cyc = [1, 2];
+cyc.push(cyc);
+print(cyc.join());
+// CHECK-NEXT: 1,2,
+
+// Large results.
+var many = [];
+for (var i = 0; i < 10000; ++i) many.push(i % 2 ? 'ab' : i);
+var joined = many.join('');
+print(joined.length, joined.slice(0, 12), joined.slice(-8));
+// CHECK-NEXT: 29445 0ab2ab4ab6ab ab9998ab
+var html = '';
+for (var i = 0; i < 1000; ++i) html += `<li id="${i}">${i % 3 ? 'x' : 'ü'}</li>`;
+print(html.length, html.slice(0, 20), html.slice(-16));
+// CHECK-NEXT: 18890 <li id="0">ü</li><li  id="999">ü</li>
@@ -87,6 +87,10 @@ static int executeHBCBytecodeFromCL(
                             .withInitHeapSize(cl::InitHeapSize.bytes)
                             .withMaxHeapSize(cl::MaxHeapSize.bytes)
                             .withOccupancyTarget(cl::OccupancyTarget)
+                            .withMarkingThreads(cl::GCMarkingThreads)
+                            .withEvacuationThreads(cl::GCEvacuationThreads)
+                            .withMinYoungGenSize(cl::GCMinYoungGenSize.bytes)
+                            .withMaxYoungGenSize(cl::GCMaxYoungGenSize.bytes)
                             .withSanitizeConfig(
                                 vm::GCSanitizeConfig::Builder()
                                     .withSanitizeRate(cl::GCSanitizeRate)
@@ -106,6 +110,8 @@ static int executeHBCBytecodeFromCL(
           .withES6Proxy(cl::ES6Proxy)
           .withIntl(cl::Intl)
           .withMicrotaskQueue(cl::MicrotaskQueue)
+          .withEnableJIT(cl::EnableJIT)
+          .withJITThreshold(cl::JITThreshold)
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
           .withTrackIO(cl::TrackBytecodeIO)
@@ -162,6 +168,8 @@ static vm::RuntimeConfig getReplRuntimeConfig() {
       .withES6Proxy(cl::ES6Proxy)
       .withIntl(cl::Intl)
       .withMicrotaskQueue(cl::MicrotaskQueue)
+      .withEnableJIT(cl::EnableJIT)
+      .withJITThreshold(cl::JITThreshold)
       .withEnableHermesInternal(cl::EnableHermesInternal)
       .withEnableHermesInternalTestMethods(cl::EnableHermesInternalTestMethods)
       .build();
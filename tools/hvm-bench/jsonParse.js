@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  // A payload of a few MB, like a large API response: records with short and
+  // long strings, escapes, non-ASCII text, integers and fractions, printed
+  // both compactly and indented.
+  var records = [];
+  for (var i = 0; i < 20000; i++) {
+    records.push({
+      id: i,
+      guid: 'a3f0c2d4-' + i + '-4b1e-9d7a-0c5e2f8b6a1d',
+      active: i % 3 !== 0,
+      balance: i * 12.375,
+      name: 'User éè ' + i,
+      about:
+        'Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do ' +
+        'eiusmod tempor incididunt ut labore et dolore magna aliqua.\n\t"' +
+        i +
+        '"',
+      tags: ['alpha', 'beta', 'gamma'],
+      location: {lat: -33.8688 + i / 1000, lng: 151.2093},
+    });
+  }
+  var compact = JSON.stringify(records);
+  var indented = JSON.stringify(records, null, 2);
+  var numIter = 10;
+
+  var count = 0;
+  for (var i = 0; i < numIter; i++) {
+    count += JSON.parse(compact).length;
+    count += JSON.parse(indented).length;
+  }
+
+  print(count === 2 * numIter * records.length ? 'done' : 'mismatch');
+})();
@@ -71,17 +71,26 @@ int main(int argc, char **argv) {
   llvh::llvm_shutdown_obj Y;
   llvh::cl::ParseCommandLineOptions(argc, argv, "Hermes VM driver\n");
 
-  llvh::ErrorOr<std::unique_ptr<llvh::MemoryBuffer>> FileBufOrErr =
-      llvh::MemoryBuffer::getFileOrSTDIN(InputFilename);
-
-  std::string filename = FileBufOrErr.get()->getBufferIdentifier().str();
-
-  if (!FileBufOrErr) {
-    llvh::errs() << "Error! Failed to open file: " << InputFilename << "\n";
-    return -1;
+  // Run the bytecode in place from a mapping of the file when possible, so
+  // that only the pages touched during execution are ever read. Fall back to
+  // reading the whole file (e.g. for stdin).
+  std::string filename = InputFilename;
+  std::unique_ptr<Buffer> buffer;
+  std::unique_ptr<llvh::MemoryBuffer> fileBuf;
+  if (InputFilename != "-")
+    buffer = MappedFileBuffer::create(InputFilename);
+  if (!buffer) {
+    llvh::ErrorOr<std::unique_ptr<llvh::MemoryBuffer>> FileBufOrErr =
+        llvh::MemoryBuffer::getFileOrSTDIN(InputFilename);
+    if (!FileBufOrErr) {
+      llvh::errs() << "Error! Failed to open file: " << InputFilename << "\n";
+      return -1;
+    }
+    fileBuf = std::move(*FileBufOrErr);
+    filename = fileBuf->getBufferIdentifier().str();
+    buffer = std::make_unique<MemoryBuffer>(fileBuf.get());
   }
 
-  auto buffer = std::make_unique<MemoryBuffer>(FileBufOrErr.get().get());
   auto ret =
       hbc::BCProviderFromBuffer::createBCProviderFromBuffer(std::move(buffer));
 
@@ -122,7 +131,10 @@ int main(int argc, char **argv) {
           .withES6Proxy(cl::ES6Proxy)
           .withIntl(cl::Intl)
           .withMicrotaskQueue(cl::MicrotaskQueue)
+          .withEnableJIT(cl::EnableJIT)
+          .withJITThreshold(cl::JITThreshold)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withVMExperimentFlags(cl::VMExperimentFlags)
           .withEnableHermesInternal(cl::EnableHermesInternal)
           .withEnableHermesInternalTestMethods(
               cl::EnableHermesInternalTestMethods)
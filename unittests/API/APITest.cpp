@@ -203,6 +203,27 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
 }
 
+TEST(HermesRuntimeSharedBytecodeTest, ShareBytecode) {
+  auto config =
+      ::hermes::vm::RuntimeConfig::Builder().withShareBytecode(true).build();
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS("var n = (this.n || 0) + 1;", bytecode));
+
+  // Each runtime keeps its own globals, whether it evaluates its own copy of
+  // the bytecode or the same prepared bytecode as the other one.
+  auto rt1 = makeHermesRuntime(config);
+  auto rt2 = makeHermesRuntime(config);
+  rt1->evaluateJavaScript(std::make_unique<StringBuffer>(bytecode), "a.js");
+  rt2->evaluateJavaScript(std::make_unique<StringBuffer>(bytecode), "b.js");
+  rt1->evaluateJavaScript(std::make_unique<StringBuffer>(bytecode), "a.js");
+  auto prep =
+      rt1->prepareJavaScript(std::make_unique<StringBuffer>(bytecode), "");
+  rt2->evaluatePreparedJavaScript(prep);
+  rt1.reset();
+  rt2->evaluatePreparedJavaScript(prep);
+  EXPECT_EQ(rt2->global().getProperty(*rt2, "n").getNumber(), 3);
+}
+
 TEST_F(HermesRuntimeTest, CompileWithSourceMapTest) {
   /* original source:
   const a: number = 12;
@@ -552,5 +552,50 @@ TEST(HBCBytecodeGen, BytecodeOptionHasAsync) {
   EXPECT_TRUE(bytecodeHasAsync->getBytecodeOptions().hasAsync);
 }
 
+TEST(HBCBytecodeGen, SharedBCProvider) {
+  auto bytecodeVec = bytecodeForSource("var x = 'shared';");
+  auto otherVec = bytecodeForSource("var x = 'other';");
+
+  // Separate copies of the same bytecode share one provider.
+  auto first = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+                   std::make_unique<VectorBuffer>(bytecodeVec))
+                   .first;
+  auto second = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+                    std::make_unique<VectorBuffer>(bytecodeVec))
+                    .first;
+  auto other = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+                   std::make_unique<VectorBuffer>(otherVec))
+                   .first;
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(other);
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+
+  // Bytecode followed by an epilogue is never shared.
+  auto withEpilogue = bytecodeVec;
+  withEpilogue.push_back('!');
+  auto epilogue = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+                      std::make_unique<VectorBuffer>(withEpilogue))
+                      .first;
+  ASSERT_TRUE(epilogue);
+  EXPECT_NE(first, epilogue);
+  EXPECT_EQ(1u, epilogue->getEpilogue().size());
+
+  // Once released, the bytecode is loaded again.
+  first.reset();
+  second.reset();
+  auto reloaded = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+                      std::make_unique<VectorBuffer>(bytecodeVec))
+                      .first;
+  ASSERT_TRUE(reloaded);
+  EXPECT_EQ(bytecodeVec.size(), reloaded->getRawBuffer().size());
+
+  // Invalid bytecode reports an error.
+  auto bad = BCProviderFromBuffer::createSharedBCProviderFromBuffer(
+      std::make_unique<VectorBuffer>(std::vector<uint8_t>{1, 2, 3}));
+  EXPECT_FALSE(bad.first);
+  EXPECT_FALSE(bad.second.empty());
+}
+
 } // end anonymous namespace
 #undef DEBUG_TYPE
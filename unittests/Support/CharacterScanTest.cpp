@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/CharacterScan.h"
+
+#include "gtest/gtest.h"
+
+#include <cctype>
+#include <string>
+
+using namespace hermes;
+
+namespace {
+
+/// Check findFirstOf against a plain search, for every start and end of
+/// \p str, so that the vectorized loop sees every alignment and tail length.
+template <typename CharT>
+void checkAllRanges(
+    const std::basic_string<CharT> &str,
+    llvh::ArrayRef<CharT> chars) {
+  const CharT *data = str.data();
+  for (size_t begin = 0; begin <= str.size(); ++begin) {
+    for (size_t end = begin; end <= str.size(); ++end) {
+      size_t expected = str.substr(0, end).find_first_of(
+          std::basic_string<CharT>(chars.begin(), chars.end()), begin);
+      const CharT *found = findFirstOf(data + begin, data + end, chars);
+      EXPECT_EQ(expected == std::string::npos ? end : expected, found - data)
+          << "begin " << begin << " end " << end;
+    }
+  }
+}
+
+/// Check findFirstNotOf and findFirstOfOrBelow against plain searches, like
+/// checkAllRanges.
+template <typename CharT>
+void checkAllRangesNotOfOrBelow(
+    const std::basic_string<CharT> &str,
+    llvh::ArrayRef<CharT> chars,
+    CharT bound) {
+  using UCharT = typename std::make_unsigned<CharT>::type;
+  std::basic_string<CharT> set(chars.begin(), chars.end());
+  const CharT *data = str.data();
+  for (size_t begin = 0; begin <= str.size(); ++begin) {
+    for (size_t end = begin; end <= str.size(); ++end) {
+      size_t expected = str.substr(0, end).find_first_not_of(set, begin);
+      const CharT *found = findFirstNotOf(data + begin, data + end, chars);
+      EXPECT_EQ(expected == std::string::npos ? end : expected, found - data)
+          << "not of, begin " << begin << " end " << end;
+
+      expected = begin;
+      while (expected < end && (UCharT)str[expected] >= (UCharT)bound &&
+             set.find(str[expected]) == std::string::npos)
+        ++expected;
+      found = findFirstOfOrBelow(data + begin, data + end, chars, bound);
+      EXPECT_EQ(expected, found - data)
+          << "of or below, begin " << begin << " end " << end;
+    }
+  }
+}
+
+/// Check findSubstring, findLastSubstring and findFirstInRange against plain
+/// searches, like checkAllRanges.
+template <typename CharT>
+void checkAllRangesSubstring(
+    const std::basic_string<CharT> &str,
+    const std::basic_string<CharT> &needle,
+    CharT lo,
+    CharT hi) {
+  using UCharT = typename std::make_unsigned<CharT>::type;
+  const CharT *data = str.data();
+  for (size_t begin = 0; begin <= str.size(); ++begin) {
+    for (size_t end = begin; end <= str.size(); ++end) {
+      size_t expected = str.substr(0, end).find(needle, begin);
+      const CharT *found =
+          findSubstring(data + begin, data + end, needle.data(), needle.size());
+      EXPECT_EQ(expected == std::string::npos ? end : expected, found - data)
+          << "substring, begin " << begin << " end " << end;
+
+      expected = str.substr(0, end).rfind(needle);
+      if (expected != std::string::npos && expected < begin)
+        expected = std::string::npos;
+      found = findLastSubstring(
+          data + begin, data + end, needle.data(), needle.size());
+      EXPECT_EQ(expected == std::string::npos ? end : expected, found - data)
+          << "last substring, begin " << begin << " end " << end;
+
+      expected = begin;
+      while (expected < end &&
+             ((UCharT)str[expected] < (UCharT)lo ||
+              (UCharT)str[expected] > (UCharT)hi))
+        ++expected;
+      found = findFirstInRange(data + begin, data + end, lo, hi);
+      EXPECT_EQ(expected, found - data)
+          << "in range, begin " << begin << " end " << end;
+    }
+  }
+}
+
+TEST(CharacterScanTest, ASCII) {
+  std::string str = "the quick brown fox jumps over the lazy dog 0123456789";
+  checkAllRanges<char>(str, {'z'});
+  checkAllRanges<char>(str, {'x', 'q'});
+  checkAllRanges<char>(str, {'9', 'o', ' ', 't'});
+  checkAllRanges<char>(str, {'!'});
+  checkAllRanges<char>(str, {'!', '?'});
+}
+
+TEST(CharacterScanTest, UTF16) {
+  std::u16string str =
+      u"été 中文 café \xd83d\xde00 the lazy dog, 0123";
+  checkAllRanges<char16_t>(str, {u'文'});
+  checkAllRanges<char16_t>(str, {u'd', u'é'});
+  checkAllRanges<char16_t>(str, {0xde00, u'3', u',', u'l'});
+  // Characters that share a byte with the ones in the string.
+  checkAllRanges<char16_t>(str, {0x01e9, 0x6500});
+}
+
+TEST(CharacterScanTest, NotOfOrBelowASCII) {
+  std::string str = "  \t\n  {\"key\": \"va\\lue\x01\xc3\xa9\"}   \r\n   x";
+  checkAllRangesNotOfOrBelow<char>(str, {' ', '\t', '\r', '\n'}, ' ');
+  checkAllRangesNotOfOrBelow<char>(str, {'"', '\\'}, ' ');
+  checkAllRangesNotOfOrBelow<char>(str, {'"'}, '\x01');
+}
+
+TEST(CharacterScanTest, NotOfOrBelowUTF16) {
+  std::u16string str =
+      u"    \"caf\u00e9\\u0041 \x1f \xd83d\xde00 \u2028 \u0120\""
+      u"  \t\t\t\t\t\t\t\t!";
+  checkAllRangesNotOfOrBelow<char16_t>(str, {u' ', u'\t', u'\r', u'\n'}, 0x20);
+  checkAllRangesNotOfOrBelow<char16_t>(str, {u'"', u'\\'}, 0x20);
+  // Characters whose low byte is below the bound.
+  checkAllRangesNotOfOrBelow<char16_t>(str, {0x0141}, 0x21);
+}
+
+TEST(CharacterScanTest, SubstringASCII) {
+  std::string str = "abcabcabd abcabcabcabd xyzabcabcabcabcabcabcabd abd";
+  checkAllRangesSubstring<char>(str, "abcabd", 'x', 'z');
+  checkAllRangesSubstring<char>(str, "abd", 'a', 'a');
+  checkAllRangesSubstring<char>(str, "d ", ' ', '\x7f');
+  checkAllRangesSubstring<char>(str, "b", '0', '9');
+  checkAllRangesSubstring<char>(str, "", 'a', 'z');
+}
+
+TEST(CharacterScanTest, SubstringUTF16) {
+  std::u16string str =
+      u"\u0161\u0161a\u0161 abc\u0161\u6161a\u0161b \u0161a\u0161b";
+  checkAllRangesSubstring<char16_t>(str, u"\u0161a\u0161b", u'a', u'c');
+  checkAllRangesSubstring<char16_t>(str, u"\u6161a", 0x100, 0x200);
+  checkAllRangesSubstring<char16_t>(str, u"b", u'b', u'b');
+  // Needles and ranges whose characters share a byte with the string's.
+  checkAllRangesSubstring<char16_t>(str, u"\u6161\u6161", 0x6100, 0x6160);
+}
+
+TEST(CharacterScanTest, ConvertASCIICase) {
+  std::string str;
+  for (int c = 0; c < 128; ++c)
+    str += (char)c;
+  std::string lower(str.size(), 0), upper(str.size(), 0);
+  convertASCIICase(str.data(), str.size(), &lower[0], false);
+  convertASCIICase(str.data(), str.size(), &upper[0], true);
+  for (int c = 0; c < 128; ++c) {
+    EXPECT_EQ(std::tolower(c), lower[c]) << c;
+    EXPECT_EQ(std::toupper(c), upper[c]) << c;
+  }
+}
+
+} // namespace
@@ -6,8 +6,13 @@
  */
 
 #include "hermes/Support/OSCompat.h"
+#include "llvh/ADT/SmallString.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
+#include <cstring>
+
 namespace {
 
 using namespace hermes;
@@ -137,5 +142,34 @@ TEST(OSCompatTest, GetProtections) {
     EXPECT_EQ(modes.size(), 0);
   }
 }
+
+TEST(OSCompatTest, MapFile) {
+  llvh::SmallString<64> path;
+  int fd;
+  ASSERT_FALSE(llvh::sys::fs::createTemporaryFile("mapfile", "bin", fd, path));
+  static const char contents[] = "mapped file contents";
+  {
+    llvh::raw_fd_ostream os(fd, /* shouldClose */ true);
+    os << contents;
+  }
+
+  size_t sz = 0;
+  auto result = oscompat::vm_map_file(path.c_str(), sz);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(sizeof(contents) - 1, sz);
+  EXPECT_EQ(0, reinterpret_cast<intptr_t>(*result) % oscompat::page_size());
+  EXPECT_EQ(0, memcmp(*result, contents, sz));
+  oscompat::vm_unmap_file(*result, sz);
+
+  // Empty files cannot be mapped.
+  {
+    std::error_code EC;
+    llvh::raw_fd_ostream os(path, EC);
+    ASSERT_FALSE(EC);
+  }
+  EXPECT_FALSE(oscompat::vm_map_file(path.c_str(), sz));
+  llvh::sys::fs::remove(path);
+  EXPECT_FALSE(oscompat::vm_map_file(path.c_str(), sz));
+}
 #endif
 } // namespace
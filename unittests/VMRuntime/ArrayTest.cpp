@@ -45,7 +45,7 @@ TEST_F(ArrayTest, CppAPITest) {
 
 // Obtain the value a couple of different ways and check its value.
 #define EXPECT_INDEX_VALUE(value, array, index)                        \
-  EXPECT_EQ(value, array->at(runtime, index).unboxToHV(runtime));      \
+  EXPECT_EQ(value, array->at(runtime, index));                         \
   ASSERT_TRUE(*array->getOwnComputedDescriptor(                        \
       array,                                                           \
       runtime,                                                         \
@@ -178,4 +178,35 @@ TEST_F(ArrayTest, TestLength) {
   EXPECT_CALLRESULT_DOUBLE(
       5.0, JSObject::getNamed_RJS(array, runtime, lengthID));
 }
+
+TEST_F(ArrayTest, DoubleElements) {
+  auto arrayRes = JSArray::createWithDoubleElements(runtime, 4);
+  ASSERT_FALSE(isException(arrayRes));
+  auto array = *arrayRes;
+  ASSERT_TRUE(array->hasDoubleElements());
+
+  // Numbers, including NaN, are stored without leaving double mode.
+  JSArray::setElementAt(array, runtime, 1, runtime.makeHandle(1.5_hd));
+  auto nan = std::numeric_limits<double>::quiet_NaN();
+  JSArray::setElementAt(
+      array,
+      runtime,
+      2,
+      runtime.makeHandle(HermesValue::encodeNumberValue(nan)));
+  ASSERT_TRUE(array->hasDoubleElements());
+  ASSERT_EQ(4u, JSArray::getLength(array.get(), runtime));
+  EXPECT_TRUE(array->at(runtime, 0).isEmpty());
+  EXPECT_EQ(1.5_hd, array->at(runtime, 1));
+  EXPECT_TRUE(std::isnan(array->at(runtime, 2).getNumber()));
+  EXPECT_TRUE(array->at(runtime, 3).isEmpty());
+
+  // Storing anything else converts the existing elements.
+  JSArray::setElementAt(
+      array, runtime, 3, runtime.makeHandle(HermesValue::encodeNullValue()));
+  ASSERT_FALSE(array->hasDoubleElements());
+  EXPECT_TRUE(array->at(runtime, 0).isEmpty());
+  EXPECT_EQ(1.5_hd, array->at(runtime, 1));
+  EXPECT_TRUE(std::isnan(array->at(runtime, 2).getNumber()));
+  EXPECT_TRUE(array->at(runtime, 3).isNull());
+}
 } // namespace
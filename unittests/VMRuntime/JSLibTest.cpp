@@ -972,7 +972,7 @@ TEST_F(JSLibTest, SmallSortTest) {
        "seven",
        "eight",
        "nine"});
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sbl, 0, sbl.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sbl, 0, sbl.v.size()));
   std::vector<std::string> expected = {
       "one",
       "two",
@@ -992,7 +992,7 @@ TEST_F(JSLibTest, SmallSortTest) {
     vs[i] = std::string(i, 'x');
   do {
     StringByLength sm(vs);
-    ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sm, 0, vs.size()));
+    ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sm, 0, vs.size()));
     for (unsigned i = 0; i < vs.size(); ++i)
       EXPECT_EQ(i, sm.v[i].size());
   } while (std::next_permutation(vs.begin(), vs.end()));
@@ -1021,7 +1021,7 @@ TEST_F(JSLibTest, HugeSortTest) {
   for (uint64_t i = 0; i < size; ++i)
     v[i] |= i;
   Uint64ByHigh32 ubh(v);
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&ubh, 0, ubh.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&ubh, 0, ubh.v.size()));
   for (uint64_t i = 0; i < size; ++i) {
     auto cur = ubh.v[i];
     EXPECT_EQ(i / 10, cur >> 32);
@@ -1045,7 +1045,68 @@ TEST_F(JSLibTest, HugeSortTest) {
     }
   };
   RandomLess rl;
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&rl, 0, 1000 * 1000));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&rl, 0, 1000 * 1000));
+}
+
+TEST_F(JSLibTest, SortRunsTest) {
+  // Count the comparisons and swaps of sorts of inputs made of runs.
+  struct CountingInts : public SortModel {
+    std::vector<int> v;
+    unsigned compares = 0;
+    unsigned swaps = 0;
+    int throwAt = -1;
+    CountingInts(std::vector<int> _v) : v(_v) {}
+    ExecutionStatus swap(uint32_t a, uint32_t b) override {
+      ++swaps;
+      std::swap(v[a], v[b]);
+      return ExecutionStatus::RETURNED;
+    }
+    CallResult<int> compare(uint32_t a, uint32_t b) override {
+      if ((int)compares++ == throwAt)
+        return ExecutionStatus::EXCEPTION;
+      return v[a] - v[b];
+    }
+  };
+  const int size = 10000;
+
+  // Sorted and reversed inputs take one pass and no more swaps than needed.
+  std::vector<int> sorted(size);
+  for (int i = 0; i < size; ++i)
+    sorted[i] = i;
+  CountingInts asc(sorted);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&asc, 0, size));
+  EXPECT_EQ(sorted, asc.v);
+  EXPECT_EQ(size - 1, (int)asc.compares);
+  EXPECT_EQ(0u, asc.swaps);
+  CountingInts desc(std::vector<int>(sorted.rbegin(), sorted.rend()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&desc, 0, size));
+  EXPECT_EQ(sorted, desc.v);
+  EXPECT_EQ(size - 1, (int)desc.compares);
+  EXPECT_EQ((unsigned)size / 2, desc.swaps);
+
+  // Appending a few elements to a sorted input needs few comparisons.
+  std::vector<int> appended(sorted);
+  for (int i = 0; i < 10; ++i)
+    appended.push_back(i * 1000 + 500);
+  CountingInts app(appended);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&app, 0, appended.size()));
+  std::sort(appended.begin(), appended.end());
+  EXPECT_EQ(appended, app.v);
+  EXPECT_LT(app.compares, (unsigned)size + 300);
+
+  // Only the range [begin, end) is sorted.
+  CountingInts part({5, 4, 3, 2, 1, 0});
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&part, 1, 5));
+  EXPECT_EQ((std::vector<int>{5, 1, 2, 3, 4, 0}), part.v);
+
+  // A failed comparison leaves the elements unchanged.
+  std::vector<int> shuffled(sorted);
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64());
+  CountingInts failing(shuffled);
+  failing.throwAt = size * 5;
+  ASSERT_EQ(ExecutionStatus::EXCEPTION, timSort(&failing, 0, size));
+  EXPECT_EQ(shuffled, failing.v);
+  EXPECT_EQ(0u, failing.swaps);
 }
 
 class JSLibMockedEnvironmentTest : public RuntimeTestFixtureBase {
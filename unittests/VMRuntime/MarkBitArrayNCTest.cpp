@@ -17,6 +17,7 @@
 
 #include <ios>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -94,6 +95,32 @@ TEST_F(MarkBitArrayNCTest, MarkGet) {
   }
 }
 
+TEST_F(MarkBitArrayNCTest, MarkAtomic) {
+  // Several threads race to mark the same range of bits, which share words.
+  // Each bit must be reported as newly marked exactly once.
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumIndices = 1024;
+  std::vector<size_t> newlyMarked(kNumThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([this, t, &newlyMarked] {
+      for (size_t i = 0; i < kNumIndices; ++i)
+        newlyMarked[t] += mba->markAtomic(i);
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  size_t total = 0;
+  for (size_t count : newlyMarked)
+    total += count;
+  EXPECT_EQ(kNumIndices, total);
+  for (size_t i = 0; i < kNumIndices; ++i)
+    EXPECT_TRUE(mba->at(i)) << "index " << i;
+  EXPECT_FALSE(mba->at(kNumIndices));
+  EXPECT_FALSE(mba->markAtomic(0));
+}
+
 TEST_F(MarkBitArrayNCTest, Initial) {
   for (char *addr : addrs) {
     size_t ind = mba->addressToIndex(addr);
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+#include "TestHelpers.h"
+
+#include "hermes/VM/JSRegExp.h"
+#include "hermes/VM/StringPrimitive.h"
+
+using namespace hermes::vm;
+using hermes::regex::SyntaxFlags;
+
+namespace {
+
+SyntaxFlags syntaxFlags(const char16_t *text) {
+  return *SyntaxFlags::fromString(
+      llvh::makeArrayRef(text, std::char_traits<char16_t>::length(text)));
+}
+
+RegExpCache::Entry entry(uint8_t marker) {
+  RegExpCache::Entry result;
+  result.bytecode.push_back(marker);
+  return result;
+}
+
+TEST(RegExpCacheTest, LookupInsert) {
+  RegExpCache cache{4};
+  EXPECT_EQ(nullptr, cache.lookup(createUTF16Ref(u"a+"), syntaxFlags(u"")));
+  cache.insert(createUTF16Ref(u"a+"), syntaxFlags(u""), entry(1));
+  cache.insert(createUTF16Ref(u"a+"), syntaxFlags(u"g"), entry(2));
+
+  auto *hit = cache.lookup(createUTF16Ref(u"a+"), syntaxFlags(u""));
+  ASSERT_NE(nullptr, hit);
+  EXPECT_EQ(1, hit->bytecode[0]);
+  hit = cache.lookup(createUTF16Ref(u"a+"), syntaxFlags(u"g"));
+  ASSERT_NE(nullptr, hit);
+  EXPECT_EQ(2, hit->bytecode[0]);
+  EXPECT_EQ(nullptr, cache.lookup(createUTF16Ref(u"a+"), syntaxFlags(u"i")));
+
+  EXPECT_EQ(2u, cache.getHits());
+  EXPECT_EQ(2u, cache.getMisses());
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_GT(cache.mallocSize(), 0u);
+}
+
+TEST(RegExpCacheTest, EvictLeastRecentlyUsed) {
+  RegExpCache cache{2};
+  cache.insert(createUTF16Ref(u"a"), syntaxFlags(u""), entry(1));
+  cache.insert(createUTF16Ref(u"b"), syntaxFlags(u""), entry(2));
+  // Use a, so that b is evicted first.
+  EXPECT_NE(nullptr, cache.lookup(createUTF16Ref(u"a"), syntaxFlags(u"")));
+  cache.insert(createUTF16Ref(u"c"), syntaxFlags(u""), entry(3));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_NE(nullptr, cache.lookup(createUTF16Ref(u"a"), syntaxFlags(u"")));
+  EXPECT_EQ(nullptr, cache.lookup(createUTF16Ref(u"b"), syntaxFlags(u"")));
+  EXPECT_NE(nullptr, cache.lookup(createUTF16Ref(u"c"), syntaxFlags(u"")));
+}
+
+TEST(RegExpCacheTest, Disabled) {
+  RegExpCache cache{0};
+  cache.insert(createUTF16Ref(u"a"), syntaxFlags(u""), entry(1));
+  EXPECT_EQ(nullptr, cache.lookup(createUTF16Ref(u"a"), syntaxFlags(u"")));
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.getHits());
+  EXPECT_EQ(0u, cache.getMisses());
+}
+
+using RegExpCacheRuntimeTest = RuntimeTestFixture;
+
+TEST_F(RegExpCacheRuntimeTest, ConstructorReusesBytecode) {
+  auto pattern = StringPrimitive::createNoThrow(
+      runtime, createUTF16Ref(u"(?<year>\\d{4})-(?<month>\\d\\d)"));
+  auto flags = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"g"));
+  RegExpCache &cache = runtime.getRegExpCache();
+  uint64_t hits = cache.getHits();
+  uint64_t misses = cache.getMisses();
+
+  auto first = runtime.makeHandle(JSRegExp::create(runtime));
+  ASSERT_RETURNED(JSRegExp::initialize(first, runtime, pattern, flags));
+  EXPECT_EQ(misses + 1, cache.getMisses());
+  auto second = runtime.makeHandle(JSRegExp::create(runtime));
+  ASSERT_RETURNED(JSRegExp::initialize(second, runtime, pattern, flags));
+  EXPECT_EQ(hits + 1, cache.getHits());
+
+  // The RegExps have the same flags and named groups.
+  EXPECT_TRUE(JSRegExp::getSyntaxFlags(*second).global);
+  auto groups = second->getGroupNameMappings(runtime);
+  ASSERT_TRUE(groups);
+  auto month = runtime.getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"month"));
+  ASSERT_RETURNED(month.getStatus());
+  auto index = JSObject::getNamed_RJS(groups, runtime, **month);
+  ASSERT_RETURNED(index.getStatus());
+  EXPECT_EQ(2, (*index)->getNumber());
+
+  // Invalid patterns are not cached, and still throw.
+  auto invalid = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"("));
+  auto third = runtime.makeHandle(JSRegExp::create(runtime));
+  EXPECT_EQ(
+      ExecutionStatus::EXCEPTION,
+      JSRegExp::initialize(third, runtime, invalid, flags));
+  runtime.clearThrownValue();
+  EXPECT_EQ(
+      ExecutionStatus::EXCEPTION,
+      JSRegExp::initialize(third, runtime, invalid, flags));
+  EXPECT_EQ(hits + 1, cache.getHits());
+}
+
+} // namespace
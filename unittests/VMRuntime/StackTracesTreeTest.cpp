@@ -735,6 +735,13 @@ function baz() {
             }
           ]
         },
+        {
+          "name": "global",
+          "scriptName": "eval.js",
+          "line": 14,
+          "col": 23,
+          "children": []
+        },
         {
           "name": "global",
           "scriptName": "eval.js",
@@ -742,6 +749,13 @@ function baz() {
           "col": 24,
           "children": []
         },
+        {
+          "name": "global",
+          "scriptName": "eval.js",
+          "line": 14,
+          "col": 12,
+          "children": []
+        },
         {
           "name": "global",
           "scriptName": "eval.js",
@@ -749,6 +763,13 @@ function baz() {
           "col": 13,
           "children": []
         },
+        {
+          "name": "global",
+          "scriptName": "eval.js",
+          "line": 14,
+          "col": 1,
+          "children": []
+        },
         {
           "name": "global",
           "scriptName": "eval.js",
@@ -46,7 +46,8 @@ gen() {
   sed -i.bak '$ d' $TMP_PROMISE_JS && \
   cat <<EOT >> $TMP_PROMISE_JS
 });
-if (HermesInternal?.hasPromise?.()) {
+// With the microtask queue, Promise is implemented natively.
+if (HermesInternal?.hasPromise?.() && !HermesInternal?.useEngineQueue?.()) {
   initPromise();
 }
 EOT